@@ -0,0 +1,26 @@
+/**
+ * @file    bench_bus.h
+ * @author  Steven Daglish
+ * @brief   Minimal in-memory I2C bus for benchmarking the driver on a host.
+ * @version 0.1
+ * @date    17 October 2026
+ *
+ * Every transfer succeeds instantly and reads return a valid SHT31
+ * measurement frame, so a benchmark measures only the driver's own cost.
+ */
+
+#ifndef _BENCH_BUS_H
+#define _BENCH_BUS_H
+
+#include "i2c_bus.h"
+#include <stdint.h>
+
+typedef struct
+{
+    uint8_t frame[6];
+    uint32_t transfers;
+} bench_bus_t;
+
+void bench_bus_init(bench_bus_t *state, i2c_bus_t *bus);
+
+#endif // _BENCH_BUS_H
@@ -0,0 +1,365 @@
+/**
+ * @file    bench_sht31.c
+ * @author  Steven Daglish
+ * @brief   Host benchmarks for the driver hot paths.
+ * @version 0.1
+ * @date    17 October 2026
+ *
+ * Prints one CSV line per benchmark:
+ *
+ *  name,ns_per_op,instructions_per_op
+ *
+ * instructions_per_op is -1 when the kernel does not allow hardware counters
+ * (e.g. in containers). With --check <file> every result is compared against
+ * the limits in the file (same columns, a limit of -1 is not checked) and
+ * the exit code is non-zero if any limit is exceeded.
+ */
+
+#define _GNU_SOURCE
+
+#include "bench_bus.h"
+#include "crc8.h"
+#include "sht31_conversion.h"
+#include "sht31_driver.h"
+
+#include <linux/perf_event.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <time.h>
+#include <unistd.h>
+
+#define MAX_RESULTS 32
+#define NAME_LENGTH 48
+
+typedef struct
+{
+    char name[NAME_LENGTH];
+    double ns_per_op;
+    double instructions_per_op;
+} result_t;
+
+typedef void (*bench_fn_t)(uint32_t iterations);
+
+static result_t results[MAX_RESULTS];
+static int result_count;
+static volatile uint32_t sink;
+
+///////////////////////////////////////////////////////////////////////////////
+// Measurement
+///////////////////////////////////////////////////////////////////////////////
+
+static int open_instruction_counter(void)
+{
+    struct perf_event_attr attr;
+
+    memset(&attr, 0, sizeof(attr));
+    attr.size           = sizeof(attr);
+    attr.type           = PERF_TYPE_HARDWARE;
+    attr.config         = PERF_COUNT_HW_INSTRUCTIONS;
+    attr.disabled       = 1;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv     = 1;
+
+    return (int)syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+}
+
+static uint64_t now_ns(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000u + (uint64_t)ts.tv_nsec;
+}
+
+static void run(const char *name, bench_fn_t fn, uint32_t iterations)
+{
+    result_t *result = &results[result_count++];
+    int counter      = open_instruction_counter();
+    long long count  = -1;
+
+    // Warm caches and branch predictors before measuring.
+    fn(iterations / 16 + 1);
+
+    if (counter >= 0)
+    {
+        ioctl(counter, PERF_EVENT_IOC_RESET, 0);
+        ioctl(counter, PERF_EVENT_IOC_ENABLE, 0);
+    }
+
+    uint64_t start = now_ns();
+    fn(iterations);
+    uint64_t end = now_ns();
+
+    if (counter >= 0)
+    {
+        ioctl(counter, PERF_EVENT_IOC_DISABLE, 0);
+        if (sizeof(count) != read(counter, &count, sizeof(count)))
+        {
+            count = -1;
+        }
+        close(counter);
+    }
+
+    snprintf(result->name, NAME_LENGTH, "%s", name);
+    result->ns_per_op           = (double)(end - start) / iterations;
+    result->instructions_per_op = (count < 0) ? -1.0
+                                              : (double)count / iterations;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Benchmarks
+///////////////////////////////////////////////////////////////////////////////
+
+static uint8_t words[64 * CRC8_WORD_SIZE];
+
+static void bench_crc8_word(uint32_t iterations)
+{
+    uint32_t acc = 0;
+    while (iterations--)
+    {
+        acc += crc8_word((uint16_t)iterations);
+    }
+    sink = acc;
+}
+
+static void bench_crc8_bitwise(uint32_t iterations)
+{
+    uint32_t acc = 0;
+    uint8_t data[2];
+    while (iterations--)
+    {
+        data[0] = iterations >> 8;
+        data[1] = iterations;
+        acc += crc8_bitwise(data, 2);
+    }
+    sink = acc;
+}
+
+static void bench_crc8_table_256(uint32_t iterations)
+{
+    uint32_t acc = 0;
+    uint8_t data[2];
+    while (iterations--)
+    {
+        data[0] = iterations >> 8;
+        data[1] = iterations;
+        acc += crc8_table_256(data, 2);
+    }
+    sink = acc;
+}
+
+static void bench_crc8_table_16(uint32_t iterations)
+{
+    uint32_t acc = 0;
+    uint8_t data[2];
+    while (iterations--)
+    {
+        data[0] = iterations >> 8;
+        data[1] = iterations;
+        acc += crc8_table_16(data, 2);
+    }
+    sink = acc;
+}
+
+// Cost per word when checking 64 words in one pass.
+static void bench_crc8_buffer(uint32_t iterations)
+{
+    uint32_t acc    = 0;
+    uint32_t passes = iterations / 64 + 1;
+    while (passes--)
+    {
+        acc += crc8_buffer(words, 64);
+    }
+    sink = acc;
+}
+
+static sht31_t sensor;
+
+static void bench_fetch_periodic_data(uint32_t iterations)
+{
+    uint32_t acc = 0;
+    while (iterations--)
+    {
+        acc += sht31_fetch_periodic_data(&sensor);
+        acc += sht31_return_temperature(&sensor);
+    }
+    sink = acc;
+}
+
+static void bench_single_shot(uint32_t iterations)
+{
+    uint32_t acc = 0;
+    while (iterations--)
+    {
+        acc += sht31_get_single_shot_data(&sensor);
+    }
+    sink = acc;
+}
+
+static void bench_to_centi_celsius(uint32_t iterations)
+{
+    int32_t acc = 0;
+    while (iterations--)
+    {
+        acc += sht31_temperature_to_centi_celsius((uint16_t)iterations);
+    }
+    sink = (uint32_t)acc;
+}
+
+static void bench_to_centi_percent(uint32_t iterations)
+{
+    uint32_t acc = 0;
+    while (iterations--)
+    {
+        acc += sht31_humidity_to_centi_percent((uint16_t)iterations);
+    }
+    sink = acc;
+}
+
+// Cost per sample when converting 256 samples at a time.
+static void bench_batch_to_centi_celsius(uint32_t iterations)
+{
+    static uint16_t raw[256];
+    static int16_t converted[256];
+    uint32_t passes = iterations / 256 + 1;
+
+    while (passes--)
+    {
+        sht31_temperatures_to_centi_celsius(raw, converted, 256);
+        raw[passes & 0xFF] += converted[0];
+    }
+    sink = converted[255];
+}
+
+// Reference: what callers did before, converting with floats.
+static void bench_float_celsius(uint32_t iterations)
+{
+    float acc = 0;
+    while (iterations--)
+    {
+        acc += -45.0f + 175.0f * (uint16_t)iterations / 65535.0f;
+    }
+    sink = (uint32_t)acc;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Reporting
+///////////////////////////////////////////////////////////////////////////////
+
+static void print_results(void)
+{
+    int i = 0;
+
+    printf("name,ns_per_op,instructions_per_op\n");
+    for (i = 0; i < result_count; i++)
+    {
+        printf("%s,%.2f,%.1f\n", results[i].name, results[i].ns_per_op,
+               results[i].instructions_per_op);
+    }
+}
+
+static const result_t *find_result(const char *name)
+{
+    int i = 0;
+
+    for (i = 0; i < result_count; i++)
+    {
+        if (0 == strcmp(name, results[i].name))
+        {
+            return &results[i];
+        }
+    }
+    return NULL;
+}
+
+static int check_limits(const char *path)
+{
+    FILE *file = fopen(path, "r");
+    char line[128];
+    int failures = 0;
+
+    if (NULL == file)
+    {
+        fprintf(stderr, "cannot open %s\n", path);
+        return 1;
+    }
+
+    while (fgets(line, sizeof(line), file))
+    {
+        char name[NAME_LENGTH];
+        double max_ns           = 0;
+        double max_instructions = 0;
+
+        if (('#' == line[0]) ||
+            (3 != sscanf(line, "%47[^,],%lf,%lf", name, &max_ns,
+                         &max_instructions)))
+        {
+            continue;
+        }
+
+        const result_t *result = find_result(name);
+        if (NULL == result)
+        {
+            fprintf(stderr, "FAIL %s: no such benchmark\n", name);
+            failures++;
+            continue;
+        }
+        if ((max_ns >= 0) && (result->ns_per_op > max_ns))
+        {
+            fprintf(stderr, "FAIL %s: %.2f ns/op > %.2f\n", name,
+                    result->ns_per_op, max_ns);
+            failures++;
+        }
+        if ((max_instructions >= 0) && (result->instructions_per_op >= 0) &&
+            (result->instructions_per_op > max_instructions))
+        {
+            fprintf(stderr, "FAIL %s: %.1f instructions/op > %.1f\n", name,
+                    result->instructions_per_op, max_instructions);
+            failures++;
+        }
+    }
+    fclose(file);
+
+    return failures ? 1 : 0;
+}
+
+int main(int argc, char **argv)
+{
+    i2c_bus_t bus;
+    bench_bus_t bus_state;
+    uint32_t i = 0;
+
+    bench_bus_init(&bus_state, &bus);
+    sht31_init(&sensor, &bus, DEFAULT_ADDRESS);
+
+    for (i = 0; i < 64; i++)
+    {
+        uint16_t value   = (uint16_t)(i * 2654435761u);
+        words[i * 3]     = value >> 8;
+        words[i * 3 + 1] = value & 0x00FF;
+        words[i * 3 + 2] = crc8_word(value);
+    }
+
+    run("crc8_word", bench_crc8_word, 1u << 22);
+    run("crc8_bitwise", bench_crc8_bitwise, 1u << 22);
+    run("crc8_table_256", bench_crc8_table_256, 1u << 22);
+    run("crc8_table_16", bench_crc8_table_16, 1u << 22);
+    run("crc8_buffer_per_word", bench_crc8_buffer, 1u << 22);
+    run("fetch_periodic_data", bench_fetch_periodic_data, 1u << 20);
+    run("single_shot", bench_single_shot, 1u << 20);
+    run("to_centi_celsius", bench_to_centi_celsius, 1u << 22);
+    run("to_centi_percent", bench_to_centi_percent, 1u << 22);
+    run("batch_to_centi_celsius_per_sample", bench_batch_to_centi_celsius,
+        1u << 22);
+    run("float_celsius_reference", bench_float_celsius, 1u << 22);
+
+    print_results();
+
+    if ((argc == 3) && (0 == strcmp(argv[1], "--check")))
+    {
+        return check_limits(argv[2]);
+    }
+    return 0;
+}
@@ -0,0 +1,183 @@
+/**
+ * @file    gatewayd.c
+ * @author  Steven Daglish
+ * @brief   Polls SHT31 sensors on several I2C buses at once and prints every
+ *          sample as CSV.
+ * @version 0.1
+ * @date    17 October 2026
+ *
+ *  gatewayd [-r repeatability] [-p cycle_period_ms] BUS...
+ *
+ * Each BUS is a node and the sensor addresses on it, e.g.
+ *
+ *  gatewayd -r 2 -p 1000 /dev/i2c-1=0x44,0x45 /dev/i2c-2=0x44
+ *
+ * Samples go to stdout as
+ *
+ *  timestamp_ms,bus,sensor,ok,centi_celsius,centi_percent,latency_us
+ *
+ * On SIGINT or SIGTERM the daemon stops, publishes what is still queued and
+ * prints a latency summary per bus to stderr.
+ */
+
+#include "gateway.h"
+#include "i2c_linux.h"
+#include "latency_histogram.h"
+#include "sht31_conversion.h"
+
+#include <pthread.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+static gateway_t gateway;
+static i2c_linux_t ports[GATEWAY_MAX_BUSES];
+static i2c_bus_t buses[GATEWAY_MAX_BUSES];
+
+static void print_sample(void *context, const gateway_sample_t *sample)
+{
+    (void)context;
+
+    printf("%lu,%u,%u,%u,%d,%u,%lu\n", (unsigned long)sample->timestamp_ms,
+           sample->bus, sample->sensor, sample->success ? 1u : 0u,
+           sht31_temperature_to_centi_celsius(sample->temperature),
+           sht31_humidity_to_centi_percent(sample->humidity),
+           (unsigned long)sample->latency_us);
+}
+
+static void print_latency(uint8_t bus)
+{
+    const latency_histogram_t *latency = gateway_bus_latency(&gateway, bus);
+
+    fprintf(stderr, "bus %u: %lu samples, p50 <= %lu us, p99 <= %lu us, "
+                    "max %lu us\n",
+            bus, (unsigned long)latency_histogram_count(latency),
+            (unsigned long)latency_histogram_percentile_us(latency, 50),
+            (unsigned long)latency_histogram_percentile_us(latency, 99),
+            (unsigned long)latency_histogram_max_us(latency));
+}
+
+/*
+ * Parses "path=addr,addr,..." in place and adds the bus.
+ */
+static bool add_bus(char *specification)
+{
+    uint8_t addresses[GATEWAY_MAX_SENSORS_PER_BUS];
+    uint8_t count    = 0;
+    uint8_t index    = gateway.bus_count;
+    char *separator  = strchr(specification, '=');
+    char *address    = NULL;
+    char *saveptr    = NULL;
+
+    if ((NULL == separator) || (index >= GATEWAY_MAX_BUSES))
+    {
+        return false;
+    }
+    *separator = '\0';
+
+    for (address = strtok_r(separator + 1, ",", &saveptr); NULL != address;
+         address = strtok_r(NULL, ",", &saveptr))
+    {
+        if (count >= GATEWAY_MAX_SENSORS_PER_BUS)
+        {
+            return false;
+        }
+        addresses[count++] = (uint8_t)strtoul(address, NULL, 0);
+    }
+
+    if (false == i2c_linux_open(&ports[index], specification, &buses[index]))
+    {
+        perror(specification);
+        return false;
+    }
+
+    return gateway_add_bus(&gateway, &buses[index], addresses, count,
+                           &gateway_monotonic_clock) >= 0;
+}
+
+static void usage(const char *name)
+{
+    fprintf(stderr,
+            "usage: %s [-r repeatability] [-p cycle_period_ms] "
+            "/dev/i2c-N=addr[,addr...]...\n",
+            name);
+}
+
+int main(int argc, char **argv)
+{
+    unsigned long repeatability   = SHT_REPEATABILITY_HIGH;
+    unsigned long cycle_period_ms = 1000;
+    int option                    = 0;
+    int signal_number             = 0;
+    uint8_t bus                   = 0;
+    sigset_t stop_signals;
+
+    while (-1 != (option = getopt(argc, argv, "r:p:")))
+    {
+        switch (option)
+        {
+        case 'r':
+            repeatability = strtoul(optarg, NULL, 0);
+            break;
+        case 'p':
+            cycle_period_ms = strtoul(optarg, NULL, 0);
+            break;
+        default:
+            usage(argv[0]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    if ((optind >= argc) || (repeatability > SHT_REPEATABILITY_HIGH))
+    {
+        usage(argv[0]);
+        return EXIT_FAILURE;
+    }
+
+    gateway_init(&gateway, (uint8_t)repeatability, cycle_period_ms,
+                 print_sample, NULL);
+
+    for (; optind < argc; optind++)
+    {
+        if (false == add_bus(argv[optind]))
+        {
+            fprintf(stderr, "cannot use bus %s\n", argv[optind]);
+            return EXIT_FAILURE;
+        }
+    }
+
+    setvbuf(stdout, NULL, _IOLBF, 0);
+
+    // Blocked before the threads start so they inherit the mask: the stop
+    // signals stay pending until sigwait() takes them here, and one sent
+    // at any moment cannot be lost.
+    sigemptyset(&stop_signals);
+    sigaddset(&stop_signals, SIGINT);
+    sigaddset(&stop_signals, SIGTERM);
+    pthread_sigmask(SIG_BLOCK, &stop_signals, NULL);
+
+    if (false == gateway_start(&gateway))
+    {
+        fprintf(stderr, "cannot start threads\n");
+        return EXIT_FAILURE;
+    }
+
+    sigwait(&stop_signals, &signal_number);
+
+    gateway_stop(&gateway);
+
+    for (bus = 0; bus < gateway.bus_count; bus++)
+    {
+        print_latency(bus);
+        i2c_linux_close(&ports[bus]);
+    }
+    if (gateway_dropped(&gateway))
+    {
+        fprintf(stderr, "%lu samples dropped\n",
+                (unsigned long)gateway_dropped(&gateway));
+    }
+
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,89 @@
+/**
+ * @file    crc8.h
+ * @author  Steven Daglish
+ * @brief   CRC-8 engine used to validate SHT3x data words.
+ * @version 0.1
+ * @date    17 October 2026
+ *
+ * CRC-8 formula from page 14 of SHT spec pdf:
+ *
+ *  Polynomial      0x31 (x8 + x5 + x4 + 1)
+ *  Initialization  0xFF
+ *  Final XOR       0x00
+ *
+ * Test data 0xBE, 0xEF should yield 0x92.
+ *
+ * The engine used by crc8_calculate() is chosen at compile time by defining
+ * CRC8_ENGINE as one of the CRC8_ENGINE_* values below:
+ *
+ *  CRC8_ENGINE_BITWISE     No table, 8 shift/XOR steps per byte.
+ *  CRC8_ENGINE_TABLE_256   256 byte table, one lookup per byte (default).
+ *  CRC8_ENGINE_TABLE_16    16 byte table, two lookups per byte. For parts
+ *                          where flash is tight.
+ *
+ * Only the selected engine is compiled in unless CRC8_BUILD_ALL_ENGINES is
+ * defined, in which case every engine is available by name so they can be
+ * checked against each other.
+ */
+
+#ifndef _CRC8_H
+#define _CRC8_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define CRC8_POLYNOMIAL 0x31
+#define CRC8_INITIAL_VALUE 0xFF
+
+#define CRC8_ENGINE_BITWISE 0
+#define CRC8_ENGINE_TABLE_256 1
+#define CRC8_ENGINE_TABLE_16 2
+
+#ifndef CRC8_ENGINE
+#define CRC8_ENGINE CRC8_ENGINE_TABLE_256
+#endif
+
+// A data word as sent by the SHT3x: MSB, LSB, CRC.
+#define CRC8_WORD_SIZE 3
+
+/**
+ * @brief   Calculates the CRC of a buffer using the selected engine.
+ *
+ * @param data      Bytes to run the CRC over
+ * @param length    Number of bytes in data
+ * @return uint8_t  CRC value
+ */
+uint8_t crc8_calculate(const uint8_t *data, uint16_t length);
+
+/**
+ * @brief   Calculates the CRC of a 16 bit word, MSB first, as the SHT3x does.
+ *
+ * @param value
+ * @return uint8_t  CRC value
+ */
+uint8_t crc8_word(uint16_t value);
+
+/**
+ * @brief   Checks a buffer of consecutive SHT3x words (MSB, LSB, CRC) in one
+ * pass.
+ *
+ * @param buffer        word_count * CRC8_WORD_SIZE bytes
+ * @param word_count    Number of words in buffer
+ * @return uint16_t     Index of the first word whose CRC does not match, or
+ *                      word_count if every word is valid.
+ */
+uint16_t crc8_buffer(const uint8_t *buffer, uint16_t word_count);
+
+#if defined(CRC8_BUILD_ALL_ENGINES) || (CRC8_ENGINE == CRC8_ENGINE_BITWISE)
+uint8_t crc8_bitwise(const uint8_t *data, uint16_t length);
+#endif
+
+#if defined(CRC8_BUILD_ALL_ENGINES) || (CRC8_ENGINE == CRC8_ENGINE_TABLE_256)
+uint8_t crc8_table_256(const uint8_t *data, uint16_t length);
+#endif
+
+#if defined(CRC8_BUILD_ALL_ENGINES) || (CRC8_ENGINE == CRC8_ENGINE_TABLE_16)
+uint8_t crc8_table_16(const uint8_t *data, uint16_t length);
+#endif
+
+#endif // _CRC8_H
@@ -0,0 +1,236 @@
+// Its header pulls in <pthread.h>, so it is only included on Linux.
+#ifdef __linux__
+#include "gateway.h"
+#include <stddef.h>
+#include <time.h>
+
+// How long the publisher sleeps when the queue is empty.
+#define PUBLISHER_IDLE_NS 1000000
+
+static uint64_t monotonic_now_us(void *context)
+{
+    struct timespec now;
+
+    (void)context;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (uint64_t)now.tv_sec * 1000000u + now.tv_nsec / 1000;
+}
+
+static void monotonic_sleep_us(void *context, uint32_t us)
+{
+    struct timespec wait = {
+        .tv_sec  = us / 1000000u,
+        .tv_nsec = (long)(us % 1000000u) * 1000,
+    };
+
+    (void)context;
+    nanosleep(&wait, NULL);
+}
+
+const gateway_clock_t gateway_monotonic_clock = {
+    .context  = NULL,
+    .now_us   = monotonic_now_us,
+    .sleep_us = monotonic_sleep_us,
+};
+
+static bool is_running(gateway_t *gateway)
+{
+    return __atomic_load_n(&gateway->running, __ATOMIC_ACQUIRE);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Workers
+///////////////////////////////////////////////////////////////////////////////
+
+static void queue_result(void *context, uint8_t index, const sht31_t *sensor,
+                         bool success)
+{
+    gateway_worker_t *worker = context;
+    uint64_t now_us          = worker->clock.now_us(worker->clock.context);
+    uint32_t latency_us      = (uint32_t)(now_us - worker->cycle_started_us);
+
+    gateway_sample_t sample = {
+        .timestamp_ms = (uint32_t)(now_us / 1000),
+        .latency_us   = latency_us,
+        .temperature  = sht31_return_temperature(sensor),
+        .humidity     = sht31_return_humidity(sensor),
+        .bus          = worker->index,
+        .sensor       = index,
+        .success      = success,
+    };
+
+    latency_histogram_record(&worker->latency, latency_us);
+    __atomic_fetch_add(&worker->produced, 1, __ATOMIC_RELAXED);
+    gateway_queue_push(&worker->gateway->queue, &sample);
+}
+
+static void *worker_main(void *argument)
+{
+    gateway_worker_t *worker = argument;
+
+    while (is_running(worker->gateway))
+    {
+        uint64_t now_us = worker->clock.now_us(worker->clock.context);
+        bool collecting = worker->scheduler.collecting;
+
+        sht31_scheduler_service(&worker->scheduler, (uint32_t)(now_us / 1000));
+
+        if ((false == collecting) && worker->scheduler.collecting)
+        {
+            worker->cycle_started_us = now_us;
+        }
+
+        worker->clock.sleep_us(worker->clock.context,
+                               GATEWAY_POLL_INTERVAL_US);
+    }
+    return NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Publisher
+///////////////////////////////////////////////////////////////////////////////
+
+static void publish_queued(gateway_t *gateway)
+{
+    gateway_sample_t sample;
+
+    while (gateway_queue_pop(&gateway->queue, &sample))
+    {
+        gateway->publish(gateway->publish_context, &sample);
+        __atomic_fetch_add(&gateway->published, 1, __ATOMIC_RELAXED);
+    }
+}
+
+static void *publisher_main(void *argument)
+{
+    gateway_t *gateway         = argument;
+    const struct timespec idle = {.tv_sec = 0, .tv_nsec = PUBLISHER_IDLE_NS};
+
+    while (is_running(gateway))
+    {
+        publish_queued(gateway);
+        nanosleep(&idle, NULL);
+    }
+    return NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Set up
+///////////////////////////////////////////////////////////////////////////////
+
+void gateway_init(gateway_t *gateway, uint8_t repeatability,
+                  uint32_t cycle_period_ms, gateway_publish_t publish,
+                  void *context)
+{
+    gateway->bus_count       = 0;
+    gateway->repeatability   = repeatability;
+    gateway->cycle_period_ms = cycle_period_ms;
+    gateway->publish         = publish;
+    gateway->publish_context = context;
+    gateway->published       = 0;
+    gateway->running         = false;
+    gateway_queue_init(&gateway->queue, gateway->cells, GATEWAY_QUEUE_SIZE);
+}
+
+int gateway_add_bus(gateway_t *gateway, const i2c_bus_t *bus,
+                    const uint8_t *addresses, uint8_t count,
+                    const gateway_clock_t *clock)
+{
+    uint8_t i = 0;
+
+    if ((gateway->bus_count >= GATEWAY_MAX_BUSES) ||
+        (count > GATEWAY_MAX_SENSORS_PER_BUS))
+    {
+        return -1;
+    }
+
+    gateway_worker_t *worker = &gateway->workers[gateway->bus_count];
+
+    worker->gateway          = gateway;
+    worker->index            = gateway->bus_count;
+    worker->clock            = *clock;
+    worker->cycle_started_us = 0;
+    worker->produced         = 0;
+    latency_histogram_init(&worker->latency);
+
+    for (i = 0; i < count; i++)
+    {
+        sht31_init(&worker->sensors[i], bus, addresses[i]);
+    }
+    sht31_scheduler_init(&worker->scheduler, worker->sensors, count,
+                         gateway->repeatability, gateway->cycle_period_ms,
+                         queue_result, worker);
+
+    return gateway->bus_count++;
+}
+
+bool gateway_start(gateway_t *gateway)
+{
+    uint8_t started = 0;
+
+    __atomic_store_n(&gateway->running, true, __ATOMIC_RELEASE);
+
+    if (0 != pthread_create(&gateway->publisher, NULL, publisher_main,
+                            gateway))
+    {
+        __atomic_store_n(&gateway->running, false, __ATOMIC_RELEASE);
+        return false;
+    }
+
+    for (started = 0; started < gateway->bus_count; started++)
+    {
+        gateway_worker_t *worker = &gateway->workers[started];
+
+        if (0 != pthread_create(&worker->thread, NULL, worker_main, worker))
+        {
+            break;
+        }
+    }
+
+    if (started < gateway->bus_count)
+    {
+        gateway->bus_count = started;
+        gateway_stop(gateway);
+        return false;
+    }
+    return true;
+}
+
+void gateway_stop(gateway_t *gateway)
+{
+    uint8_t i = 0;
+
+    __atomic_store_n(&gateway->running, false, __ATOMIC_RELEASE);
+
+    for (i = 0; i < gateway->bus_count; i++)
+    {
+        pthread_join(gateway->workers[i].thread, NULL);
+    }
+    pthread_join(gateway->publisher, NULL);
+
+    // Workers are stopped, so whatever is queued now is all there will be.
+    publish_queued(gateway);
+}
+
+uint32_t gateway_published(const gateway_t *gateway)
+{
+    return __atomic_load_n(&gateway->published, __ATOMIC_RELAXED);
+}
+
+uint32_t gateway_dropped(const gateway_t *gateway)
+{
+    return gateway_queue_dropped(&gateway->queue);
+}
+
+uint32_t gateway_bus_produced(const gateway_t *gateway, uint8_t bus)
+{
+    return __atomic_load_n(&gateway->workers[bus].produced, __ATOMIC_RELAXED);
+}
+
+const latency_histogram_t *gateway_bus_latency(const gateway_t *gateway,
+                                               uint8_t bus)
+{
+    return &gateway->workers[bus].latency;
+}
+
+#endif // __linux__
@@ -0,0 +1,151 @@
+/**
+ * @file    gateway.h
+ * @author  Steven Daglish
+ * @brief   Polls many I2C buses at once on a Linux gateway: one worker
+ *          thread per bus, one publisher thread for the results.
+ * @version 0.1
+ * @date    17 October 2026
+ *
+ * Each worker runs an sht31_scheduler over the sensors on its bus and pushes
+ * every result into a lock-free queue. Workers share nothing else, so adding
+ * a bus adds a thread that never waits on the others. The publisher drains
+ * the queue and hands each sample to the publish callback.
+ *
+ * Every bus has its own clock, so a bus can be a real /dev/i2c-N (use
+ * gateway_monotonic_clock) or a simulated bus that keeps its own time.
+ *
+ * Latency is measured per sample from the start of the conversion to the
+ * result being queued and kept in a histogram per bus.
+ *
+ * The source only builds where __linux__ is defined.
+ */
+
+#ifndef _GATEWAY_H
+#define _GATEWAY_H
+
+#include "gateway_queue.h"
+#include "i2c_bus.h"
+#include "latency_histogram.h"
+#include "sht31_driver.h"
+#include "sht31_scheduler.h"
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+
+#define GATEWAY_MAX_BUSES 16
+#define GATEWAY_MAX_SENSORS_PER_BUS 16
+#define GATEWAY_QUEUE_SIZE 1024
+
+// How long a worker sleeps between services of its scheduler.
+#define GATEWAY_POLL_INTERVAL_US 1000
+
+typedef struct
+{
+    void *context;
+    uint64_t (*now_us)(void *context);
+    void (*sleep_us)(void *context, uint32_t us);
+} gateway_clock_t;
+
+/**
+ * @brief   CLOCK_MONOTONIC and nanosleep().
+ */
+extern const gateway_clock_t gateway_monotonic_clock;
+
+/**
+ * @brief   Called on the publisher thread for every sample, in queue order.
+ */
+typedef void (*gateway_publish_t)(void *context,
+                                  const gateway_sample_t *sample);
+
+struct gateway;
+
+typedef struct
+{
+    struct gateway *gateway;
+    uint8_t index;
+    sht31_t sensors[GATEWAY_MAX_SENSORS_PER_BUS];
+    sht31_scheduler_t scheduler;
+    gateway_clock_t clock;
+    latency_histogram_t latency;
+    uint64_t cycle_started_us;
+    uint32_t produced;
+    pthread_t thread;
+} gateway_worker_t;
+
+typedef struct gateway
+{
+    gateway_worker_t workers[GATEWAY_MAX_BUSES];
+    uint8_t bus_count;
+    uint8_t repeatability;
+    uint32_t cycle_period_ms;
+
+    gateway_queue_t queue;
+    gateway_queue_cell_t cells[GATEWAY_QUEUE_SIZE];
+    gateway_publish_t publish;
+    void *publish_context;
+    uint32_t published;
+
+    bool running;
+    pthread_t publisher;
+} gateway_t;
+
+/**
+ * @brief
+ *
+ * @param gateway
+ * @param repeatability     0 = low, 1 = medium, 2 = high
+ * @param cycle_period_ms   Per bus, see sht31_scheduler_init()
+ * @param publish
+ * @param context           Passed to publish
+ */
+void gateway_init(gateway_t *gateway, uint8_t repeatability,
+                  uint32_t cycle_period_ms, gateway_publish_t publish,
+                  void *context);
+
+/**
+ * @brief   Adds a bus and the sensors on it. Only before gateway_start().
+ *
+ * @param gateway
+ * @param bus
+ * @param addresses     Address of each sensor
+ * @param count         Up to GATEWAY_MAX_SENSORS_PER_BUS
+ * @param clock         Time source for this bus' worker
+ * @return int          Index of the bus in samples, or -1 if full
+ */
+int gateway_add_bus(gateway_t *gateway, const i2c_bus_t *bus,
+                    const uint8_t *addresses, uint8_t count,
+                    const gateway_clock_t *clock);
+
+/**
+ * @brief   Starts the publisher and one worker per bus.
+ *
+ * @return true
+ * @return false    A thread could not be created; any started are stopped
+ */
+bool gateway_start(gateway_t *gateway);
+
+/**
+ * @brief   Stops the workers, then publishes whatever is still queued and
+ * stops the publisher.
+ */
+void gateway_stop(gateway_t *gateway);
+
+/**
+ * @brief   Samples handed to the publish callback so far.
+ */
+uint32_t gateway_published(const gateway_t *gateway);
+
+/**
+ * @brief   Samples lost because the queue was full.
+ */
+uint32_t gateway_dropped(const gateway_t *gateway);
+
+/**
+ * @brief   Samples produced by one bus' worker so far.
+ */
+uint32_t gateway_bus_produced(const gateway_t *gateway, uint8_t bus);
+
+const latency_histogram_t *gateway_bus_latency(const gateway_t *gateway,
+                                               uint8_t bus);
+
+#endif // _GATEWAY_H
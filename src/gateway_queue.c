@@ -0,0 +1,101 @@
+#include "gateway_queue.h"
+
+#ifdef __linux__
+#include <stddef.h>
+
+bool gateway_queue_init(gateway_queue_t *queue, gateway_queue_cell_t *cells,
+                        uint32_t capacity)
+{
+    uint32_t i = 0;
+
+    if ((capacity < 2) || (0 != (capacity & (capacity - 1))))
+    {
+        return false;
+    }
+
+    // Cell i is free for the producer that claims position i.
+    for (i = 0; i < capacity; i++)
+    {
+        cells[i].sequence = i;
+    }
+
+    queue->cells            = cells;
+    queue->mask             = capacity - 1;
+    queue->enqueue_position = 0;
+    queue->dropped          = 0;
+    queue->dequeue_position = 0;
+    __atomic_thread_fence(__ATOMIC_RELEASE);
+
+    return true;
+}
+
+bool gateway_queue_push(gateway_queue_t *queue,
+                        const gateway_sample_t *sample)
+{
+    gateway_queue_cell_t *cell = NULL;
+    uint32_t position =
+        __atomic_load_n(&queue->enqueue_position, __ATOMIC_RELAXED);
+
+    for (;;)
+    {
+        cell = &queue->cells[position & queue->mask];
+        uint32_t sequence =
+            __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+        int32_t difference = (int32_t)(sequence - position);
+
+        if (0 == difference)
+        {
+            if (__atomic_compare_exchange_n(&queue->enqueue_position,
+                                            &position, position + 1, true,
+                                            __ATOMIC_RELAXED,
+                                            __ATOMIC_RELAXED))
+            {
+                break;
+            }
+            // position now holds the current value; try again with it.
+        }
+        else if (difference < 0)
+        {
+            // The cell still holds a sample from a lap ago: full.
+            __atomic_fetch_add(&queue->dropped, 1, __ATOMIC_RELAXED);
+            return false;
+        }
+        else
+        {
+            position =
+                __atomic_load_n(&queue->enqueue_position, __ATOMIC_RELAXED);
+        }
+    }
+
+    cell->sample = *sample;
+    __atomic_store_n(&cell->sequence, position + 1, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+bool gateway_queue_pop(gateway_queue_t *queue, gateway_sample_t *sample)
+{
+    uint32_t position          = queue->dequeue_position;
+    gateway_queue_cell_t *cell = &queue->cells[position & queue->mask];
+    uint32_t sequence = __atomic_load_n(&cell->sequence, __ATOMIC_ACQUIRE);
+
+    if (sequence != position + 1)
+    {
+        return false;
+    }
+
+    *sample                 = cell->sample;
+    queue->dequeue_position = position + 1;
+    // Hand the cell to the producer one lap ahead.
+    __atomic_store_n(&cell->sequence, position + queue->mask + 1,
+                     __ATOMIC_RELEASE);
+
+    return true;
+}
+
+uint32_t gateway_queue_dropped(const gateway_queue_t *queue)
+{
+    return __atomic_load_n(&queue->dropped, __ATOMIC_RELAXED);
+}
+
+#endif // __linux__
@@ -0,0 +1,91 @@
+/**
+ * @file    gateway_queue.h
+ * @author  Steven Daglish
+ * @brief   Lock-free bounded queue of samples, many producers, one consumer.
+ * @version 0.1
+ * @date    17 October 2026
+ *
+ * Each cell carries a sequence number saying whose turn it is: a producer
+ * claims a position with one compare and swap, writes the sample and then
+ * publishes it by bumping the sequence; the consumer waits for that bump.
+ * No producer ever waits on another, and a full queue drops the sample and
+ * counts it rather than blocking.
+ *
+ * Hosted builds only (GCC __atomic builtins): the source only builds where
+ * __linux__ is defined. The storage is supplied by the caller and its size
+ * must be a power of two.
+ */
+
+#ifndef _GATEWAY_QUEUE_H
+#define _GATEWAY_QUEUE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define GATEWAY_QUEUE_CACHE_LINE 64
+
+typedef struct
+{
+    uint32_t timestamp_ms;
+    uint32_t latency_us;
+    uint16_t temperature;
+    uint16_t humidity;
+    uint8_t bus;
+    uint8_t sensor;
+    bool success;
+} gateway_sample_t;
+
+typedef struct
+{
+    uint32_t sequence;
+    gateway_sample_t sample;
+} gateway_queue_cell_t;
+
+typedef struct
+{
+    gateway_queue_cell_t *cells;
+    uint32_t mask;
+
+    // Producers and the consumer write different lines.
+    uint8_t pad_producers[GATEWAY_QUEUE_CACHE_LINE];
+    uint32_t enqueue_position;
+    uint32_t dropped;
+    uint8_t pad_consumer[GATEWAY_QUEUE_CACHE_LINE];
+    uint32_t dequeue_position;
+} gateway_queue_t;
+
+/**
+ * @brief
+ *
+ * @param queue
+ * @param cells     Caller owned array of capacity cells
+ * @param capacity  Power of two, at least 2
+ * @return true
+ * @return false    capacity is not a usable size
+ */
+bool gateway_queue_init(gateway_queue_t *queue, gateway_queue_cell_t *cells,
+                        uint32_t capacity);
+
+/**
+ * @brief   Any thread. Adds a sample if there is room.
+ *
+ * @return true
+ * @return false    Queue full, sample dropped and counted
+ */
+bool gateway_queue_push(gateway_queue_t *queue,
+                        const gateway_sample_t *sample);
+
+/**
+ * @brief   Consumer thread only. Removes the oldest sample.
+ *
+ * @return true
+ * @return false    Queue empty
+ */
+bool gateway_queue_pop(gateway_queue_t *queue, gateway_sample_t *sample);
+
+/**
+ * @brief   Number of samples dropped because the queue was full.
+ */
+uint32_t gateway_queue_dropped(const gateway_queue_t *queue);
+
+#endif // _GATEWAY_QUEUE_H
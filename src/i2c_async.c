@@ -0,0 +1,189 @@
+#include "i2c_async.h"
+#include <stddef.h>
+
+#define READ_BIT 0x01
+
+static bool bus_submit(void *context, i2c_async_transfer_t *transfer)
+{
+    return i2c_async_engine_submit(context, transfer);
+}
+
+void i2c_async_engine_init(i2c_async_engine_t *engine,
+                           const i2c_async_port_t *port, i2c_async_bus_t *bus)
+{
+    engine->port       = port;
+    engine->transfer   = NULL;
+    engine->state      = I2C_ASYNC_IDLE;
+    engine->position   = 0;
+    engine->result     = I2C_ASYNC_OK;
+    engine->interrupts = 0;
+    engine->completed  = 0;
+    engine->nacks      = 0;
+    engine->bus_errors = 0;
+
+    bus->context = engine;
+    bus->submit  = bus_submit;
+}
+
+bool i2c_async_engine_submit(i2c_async_engine_t *engine,
+                             i2c_async_transfer_t *transfer)
+{
+    if (I2C_ASYNC_IDLE != engine->state)
+    {
+        return false;
+    }
+
+    engine->transfer = transfer;
+    engine->position = 0;
+    engine->result   = I2C_ASYNC_OK;
+    engine->state    = I2C_ASYNC_START;
+    engine->port->start(engine->port->context);
+    return true;
+}
+
+static void stop(i2c_async_engine_t *engine, i2c_async_result_t result)
+{
+    engine->result = result;
+    engine->state  = I2C_ASYNC_STOP;
+    engine->port->stop(engine->port->context);
+}
+
+static void address_read(i2c_async_engine_t *engine)
+{
+    engine->state = I2C_ASYNC_ADDRESS_READ;
+    engine->port->write(engine->port->context,
+                        (engine->transfer->address << 1) | READ_BIT);
+}
+
+/*
+ * Next step once the address or a byte has been written and acked.
+ */
+static void after_write(i2c_async_engine_t *engine)
+{
+    const i2c_async_transfer_t *transfer = engine->transfer;
+
+    if (engine->position < transfer->write_length)
+    {
+        engine->state = I2C_ASYNC_WRITE;
+        engine->port->write(engine->port->context,
+                            transfer->write[engine->position++]);
+    }
+    else if (transfer->read_length > 0)
+    {
+        engine->position = 0;
+        engine->state    = I2C_ASYNC_RESTART;
+        engine->port->restart(engine->port->context);
+    }
+    else
+    {
+        stop(engine, I2C_ASYNC_OK);
+    }
+}
+
+static void read_next(i2c_async_engine_t *engine)
+{
+    bool last = (engine->position + 1 >= engine->transfer->read_length);
+
+    engine->state = I2C_ASYNC_READ;
+    engine->port->read(engine->port->context, false == last);
+}
+
+static void finish(i2c_async_engine_t *engine)
+{
+    i2c_async_transfer_t *transfer = engine->transfer;
+    i2c_async_result_t result      = engine->result;
+
+    if (I2C_ASYNC_NACK == result)
+    {
+        engine->nacks++;
+    }
+    else if (I2C_ASYNC_BUS_ERROR == result)
+    {
+        engine->bus_errors++;
+    }
+    engine->completed++;
+
+    // Idle before the callback, so it can submit the next transaction.
+    engine->transfer = NULL;
+    engine->state    = I2C_ASYNC_IDLE;
+
+    if (NULL != transfer->callback)
+    {
+        transfer->callback(transfer, result);
+    }
+}
+
+void i2c_async_engine_interrupt(i2c_async_engine_t *engine)
+{
+    const i2c_async_port_t *port   = engine->port;
+    i2c_async_transfer_t *transfer = engine->transfer;
+
+    engine->interrupts++;
+
+    switch (engine->state)
+    {
+    case I2C_ASYNC_START:
+        // Address only probes go out as a write.
+        if ((transfer->write_length > 0) || (0 == transfer->read_length))
+        {
+            engine->state = I2C_ASYNC_ADDRESS_WRITE;
+            port->write(port->context, transfer->address << 1);
+        }
+        else
+        {
+            address_read(engine);
+        }
+        break;
+    case I2C_ASYNC_ADDRESS_WRITE:
+    case I2C_ASYNC_WRITE:
+        if (false == port->acked(port->context))
+        {
+            stop(engine, I2C_ASYNC_NACK);
+            break;
+        }
+        after_write(engine);
+        break;
+    case I2C_ASYNC_RESTART:
+        address_read(engine);
+        break;
+    case I2C_ASYNC_ADDRESS_READ:
+        if (false == port->acked(port->context))
+        {
+            stop(engine, I2C_ASYNC_NACK);
+            break;
+        }
+        read_next(engine);
+        break;
+    case I2C_ASYNC_READ:
+        transfer->read[engine->position++] = port->received(port->context);
+        if (engine->position < transfer->read_length)
+        {
+            read_next(engine);
+        }
+        else
+        {
+            stop(engine, I2C_ASYNC_OK);
+        }
+        break;
+    case I2C_ASYNC_STOP:
+        finish(engine);
+        break;
+    default:
+        // Spurious: nothing in progress.
+        break;
+    }
+}
+
+void i2c_async_engine_bus_error(i2c_async_engine_t *engine)
+{
+    if (I2C_ASYNC_IDLE == engine->state)
+    {
+        return;
+    }
+    stop(engine, I2C_ASYNC_BUS_ERROR);
+}
+
+bool i2c_async_engine_busy(const i2c_async_engine_t *engine)
+{
+    return I2C_ASYNC_IDLE != engine->state;
+}
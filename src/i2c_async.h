@@ -0,0 +1,138 @@
+/**
+ * @file    i2c_async.h
+ * @author  Steven Daglish
+ * @brief   Interrupt driven counterpart of i2c_bus.h: a transaction is
+ *          submitted and a callback says when it is done.
+ * @version 0.1
+ * @date    17 October 2026
+ *
+ * A transaction has the same shape as i2c_bus_t transfer: START, an
+ * optional write, a repeated START and an optional read, then STOP. With
+ * nothing to write or read it is just the address, which probes for a
+ * device. The descriptor and its buffers belong to the bus until the
+ * callback has run.
+ *
+ * The callback runs in interrupt context, so it should only record the
+ * result or submit the next transaction.
+ *
+ * i2c_async_engine_t is the byte level state machine behind a submit. A
+ * backend supplies an i2c_async_port_t that starts each bus step on the
+ * hardware and calls i2c_async_engine_interrupt() from its interrupt
+ * handler when the step is done, so the CPU only runs for a few
+ * instructions per byte.
+ */
+
+#ifndef _I2C_ASYNC_H
+#define _I2C_ASYNC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum
+{
+    I2C_ASYNC_OK,
+    I2C_ASYNC_NACK,
+    I2C_ASYNC_BUS_ERROR
+} i2c_async_result_t;
+
+typedef struct i2c_async_transfer i2c_async_transfer_t;
+
+typedef void (*i2c_async_callback_t)(i2c_async_transfer_t *transfer,
+                                     i2c_async_result_t result);
+
+struct i2c_async_transfer
+{
+    uint8_t address;
+    const uint8_t *write;
+    uint8_t write_length;
+    uint8_t *read;
+    uint8_t read_length;
+    i2c_async_callback_t callback;
+    void *context; // For the callback
+};
+
+typedef struct
+{
+    void *context;
+
+    // Returns false, without calling back, if a transaction is in progress.
+    bool (*submit)(void *context, i2c_async_transfer_t *transfer);
+} i2c_async_bus_t;
+
+/**
+ * @brief   One step of a transaction on the hardware. Each function starts
+ * the step and returns; the backend then calls i2c_async_engine_interrupt()
+ * once it has finished. read clocks in one byte and then acks it (or nacks
+ * it, for the last byte) before reporting.
+ */
+typedef struct
+{
+    void *context;
+    void (*start)(void *context);
+    void (*restart)(void *context);
+    void (*stop)(void *context);
+    void (*write)(void *context, uint8_t data);
+    void (*read)(void *context, bool ack);
+    bool (*acked)(void *context);       // After write
+    uint8_t (*received)(void *context); // After read
+} i2c_async_port_t;
+
+typedef enum
+{
+    I2C_ASYNC_IDLE,
+    I2C_ASYNC_START,
+    I2C_ASYNC_ADDRESS_WRITE,
+    I2C_ASYNC_WRITE,
+    I2C_ASYNC_RESTART,
+    I2C_ASYNC_ADDRESS_READ,
+    I2C_ASYNC_READ,
+    I2C_ASYNC_STOP
+} i2c_async_state_t;
+
+typedef struct
+{
+    const i2c_async_port_t *port;
+    i2c_async_transfer_t *transfer;
+    volatile i2c_async_state_t state;
+    uint8_t position;
+    i2c_async_result_t result;
+
+    // Counters
+    uint32_t interrupts;
+    uint32_t completed;
+    uint32_t nacks;
+    uint32_t bus_errors;
+} i2c_async_engine_t;
+
+/**
+ * @brief   Sets up an idle engine and fills in bus so drivers can submit to
+ * it.
+ */
+void i2c_async_engine_init(i2c_async_engine_t *engine,
+                           const i2c_async_port_t *port, i2c_async_bus_t *bus);
+
+/**
+ * @brief   Starts a transaction. Called through the bus handle.
+ *
+ * @return true     Started; the callback will follow
+ * @return false    Busy
+ */
+bool i2c_async_engine_submit(i2c_async_engine_t *engine,
+                             i2c_async_transfer_t *transfer);
+
+/**
+ * @brief   The step started last has finished. Call from the interrupt
+ * handler only.
+ */
+void i2c_async_engine_interrupt(i2c_async_engine_t *engine);
+
+/**
+ * @brief   The hardware saw a bus collision or timed out. Sends a STOP and
+ * fails the transaction with I2C_ASYNC_BUS_ERROR. Call from the interrupt
+ * handler only.
+ */
+void i2c_async_engine_bus_error(i2c_async_engine_t *engine);
+
+bool i2c_async_engine_busy(const i2c_async_engine_t *engine);
+
+#endif // _I2C_ASYNC_H
@@ -0,0 +1,116 @@
+#include "i2c_async_pic24.h"
+
+#ifdef __PIC24FJ256GA702__
+#include <stddef.h>
+#include <xc.h>
+
+static i2c_async_engine_t engine;
+
+// A read is two hardware steps, the byte and then its ack; the engine only
+// hears about the second.
+static volatile bool receiving;
+static volatile bool receive_ack;
+static volatile uint8_t received;
+
+static void port_start(void *context)
+{
+    (void)context;
+    I2C1CONLbits.SEN = 1;
+}
+
+static void port_restart(void *context)
+{
+    (void)context;
+    I2C1CONLbits.RSEN = 1;
+}
+
+static void port_stop(void *context)
+{
+    (void)context;
+    I2C1CONLbits.PEN = 1;
+}
+
+static void port_write(void *context, uint8_t data)
+{
+    (void)context;
+    I2C1TRN = data;
+}
+
+static void port_read(void *context, bool ack)
+{
+    (void)context;
+    receiving         = true;
+    receive_ack       = ack;
+    I2C1CONLbits.RCEN = 1;
+}
+
+static bool port_acked(void *context)
+{
+    (void)context;
+    return 0 == I2C1STATbits.ACKSTAT;
+}
+
+static uint8_t port_received(void *context)
+{
+    (void)context;
+    return received;
+}
+
+static const i2c_async_port_t port = {
+    .context  = NULL,
+    .start    = port_start,
+    .restart  = port_restart,
+    .stop     = port_stop,
+    .write    = port_write,
+    .read     = port_read,
+    .acked    = port_acked,
+    .received = port_received,
+};
+
+void i2c_async_pic24_init(uint16_t brg, i2c_async_bus_t *bus)
+{
+    I2C1CONL = 0;
+    I2C1BRG  = brg;
+
+    receiving   = false;
+    receive_ack = false;
+    received    = 0;
+    i2c_async_engine_init(&engine, &port, bus);
+
+    IFS1bits.MI2C1IF   = 0;
+    IPC4bits.MI2C1IP   = I2C_ASYNC_PIC24_PRIORITY;
+    IEC1bits.MI2C1IE   = 1;
+    I2C1CONLbits.I2CEN = 1;
+}
+
+const i2c_async_engine_t *i2c_async_pic24_engine(void)
+{
+    return &engine;
+}
+
+void __attribute__((interrupt, no_auto_psv)) _MI2C1Interrupt(void)
+{
+    IFS1bits.MI2C1IF = 0;
+
+    if (I2C1STATbits.BCL || I2C1STATbits.IWCOL)
+    {
+        I2C1STATbits.BCL   = 0;
+        I2C1STATbits.IWCOL = 0;
+        receiving          = false;
+        i2c_async_engine_bus_error(&engine);
+        return;
+    }
+
+    if (receiving)
+    {
+        receiving          = false;
+        received           = I2C1RCV;
+        I2C1CONLbits.ACKDT = receive_ack ? 0 : 1;
+        I2C1CONLbits.ACKEN = 1;
+        return;
+    }
+
+    i2c_async_engine_interrupt(&engine);
+}
+
+#endif // __PIC24FJ256GA702__
@@ -0,0 +1,44 @@
+/**
+ * @file    i2c_async_pic24.h
+ * @author  Steven Daglish
+ * @brief   i2c_async.h on the PIC24FJ256GA702 I2C1 master, driven from its
+ *          interrupt.
+ * @version 0.1
+ * @date    17 October 2026
+ *
+ * Every bus step (START, a byte, an ack, STOP) ends with an MI2C1
+ * interrupt, and the handler starts the next one. The CPU is only needed
+ * for those few instructions, not for the whole of each byte.
+ *
+ * The I2C master needs the CPU to start each step, so DMA cannot move a
+ * whole transaction on its own here; one interrupt per step is the least
+ * the peripheral allows.
+ */
+
+#ifndef _I2C_ASYNC_PIC24_H
+#define _I2C_ASYNC_PIC24_H
+
+#include "i2c_async.h"
+#include <stdint.h>
+
+// Interrupt priority for MI2C1, 1 (lowest) to 7.
+#ifndef I2C_ASYNC_PIC24_PRIORITY
+#define I2C_ASYNC_PIC24_PRIORITY 4
+#endif
+
+/**
+ * @brief   Enables I2C1 as a master and its interrupt, and fills in bus.
+ *
+ * @param brg   Baud rate generator reload value for the wanted SCL
+ *              frequency, from the I2C section of the family reference
+ *              manual, e.g. 37 for 400 kHz at FCY = 16 MHz
+ * @param bus
+ */
+void i2c_async_pic24_init(uint16_t brg, i2c_async_bus_t *bus);
+
+/**
+ * @brief   The engine behind the bus, for its counters.
+ */
+const i2c_async_engine_t *i2c_async_pic24_engine(void);
+
+#endif // _I2C_ASYNC_PIC24_H
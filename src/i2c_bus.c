@@ -0,0 +1,66 @@
+#include "i2c_bus.h"
+#include "i2c_driver.h"
+#include <stddef.h>
+
+static void driver_start(void *context)
+{
+    (void)context;
+    i2c_driver_start();
+}
+
+static void driver_stop(void *context)
+{
+    (void)context;
+    i2c_driver_stop();
+}
+
+static bool driver_send_address_write(void *context, uint8_t address)
+{
+    (void)context;
+    return i2c_driver_send_address_write(address);
+}
+
+static bool driver_send_address_read(void *context, uint8_t address)
+{
+    (void)context;
+    return i2c_driver_send_address_read(address);
+}
+
+static bool driver_send_data(void *context, uint8_t data)
+{
+    (void)context;
+    return i2c_driver_send_data(data);
+}
+
+static uint8_t driver_read_data(void *context, bool ack)
+{
+    (void)context;
+    return i2c_driver_read_data(ack);
+}
+
+static bool driver_read_block(void *context, uint8_t *data, uint8_t length)
+{
+    (void)context;
+    return i2c_driver_read_block(data, length);
+}
+
+static bool driver_write_block(void *context, const uint8_t *data,
+                               uint8_t length)
+{
+    (void)context;
+    return i2c_driver_write_block(data, length);
+}
+
+const i2c_bus_t i2c_driver_bus = {
+    .context            = NULL,
+    .start              = driver_start,
+    .stop               = driver_stop,
+    .send_address_write = driver_send_address_write,
+    .send_address_read  = driver_send_address_read,
+    .send_data          = driver_send_data,
+    .read_data          = driver_read_data,
+    .read_block         = driver_read_block,
+    .write_block        = driver_write_block,
+    .transfer           = NULL,
+    .bus_clear          = NULL,
+};
@@ -0,0 +1,51 @@
+/**
+ * @file    i2c_bus.h
+ * @author  Steven Daglish
+ * @brief   A handle for one I2C bus, so drivers are not tied to the single
+ *          bus behind i2c_driver.h.
+ * @version 0.1
+ * @date    17 October 2026
+ *
+ * Every function is passed the bus' context pointer, letting one backend
+ * drive several physical buses. The functions mirror i2c_driver.h.
+ *
+ * transfer is optional. Backends where each bus operation is expensive (a
+ * syscall, a DMA set up) can provide it to run a whole transaction at once:
+ * START, an optional write, a repeated START and an optional read, then
+ * STOP. Drivers use it when it is not NULL and fall back to the byte level
+ * functions otherwise.
+ *
+ * bus_clear is optional too. It frees a bus whose SDA is held low by a
+ * device that lost track of a transfer: SCL is clocked (up to 9 times) until
+ * SDA is released, then a STOP is sent. It returns false if SDA stays low.
+ * Recovery code skips that step when it is NULL.
+ */
+
+#ifndef _I2C_BUS_H
+#define _I2C_BUS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct i2c_bus
+{
+    void *context;
+    void (*start)(void *context);
+    void (*stop)(void *context);
+    bool (*send_address_write)(void *context, uint8_t address);
+    bool (*send_address_read)(void *context, uint8_t address);
+    bool (*send_data)(void *context, uint8_t data);
+    uint8_t (*read_data)(void *context, bool ack);
+    bool (*read_block)(void *context, uint8_t *data, uint8_t length);
+    bool (*write_block)(void *context, const uint8_t *data, uint8_t length);
+    bool (*transfer)(void *context, uint8_t address, const uint8_t *write,
+                     uint8_t write_length, uint8_t *read, uint8_t read_length);
+    bool (*bus_clear)(void *context);
+} i2c_bus_t;
+
+/**
+ * @brief   The bus implemented by i2c_driver.h.
+ */
+extern const i2c_bus_t i2c_driver_bus;
+
+#endif // _I2C_BUS_H
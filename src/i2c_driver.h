@@ -45,4 +45,26 @@ bool i2c_driver_send_data(uint8_t data);
 
 uint8_t i2c_driver_read_data(bool ack);
 
+/**
+ * @brief   Reads a block of bytes in one transfer. Every byte is acked apart
+ * from the last one, which is nacked to end the read.
+ *
+ * @param data      Buffer the bytes are read into
+ * @param length    Number of bytes to read
+ * @return true     All bytes read
+ * @return false    Bus error
+ */
+bool i2c_driver_read_block(uint8_t *data, uint8_t length);
+
+/**
+ * @brief   Writes a block of bytes in one transfer, stopping at the first
+ * byte that is not acked.
+ *
+ * @param data      Bytes to send
+ * @param length    Number of bytes to send
+ * @return true     Every byte acked
+ * @return false    A byte was not acked
+ */
+bool i2c_driver_write_block(const uint8_t *data, uint8_t length);
+
 #endif // _I2C_DRIVER_H
@@ -0,0 +1,72 @@
+#include "i2c_driver_linux.h"
+
+#ifdef __linux__
+
+static i2c_linux_t port = {.fd = -1};
+static i2c_bus_t port_bus;
+
+bool i2c_driver_linux_open(const char *path)
+{
+    return i2c_linux_open(&port, path, &port_bus);
+}
+
+void i2c_driver_linux_close(void)
+{
+    i2c_linux_close(&port);
+}
+
+const i2c_bus_t *i2c_driver_linux_bus(void)
+{
+    return &port_bus;
+}
+
+const i2c_linux_t *i2c_driver_linux_port(void)
+{
+    return &port;
+}
+
+void i2c_driver_create(void)
+{
+}
+
+void i2c_driver_start(void)
+{
+    port_bus.start(port_bus.context);
+}
+
+void i2c_driver_stop(void)
+{
+    port_bus.stop(port_bus.context);
+}
+
+bool i2c_driver_send_address_write(uint8_t address)
+{
+    return port_bus.send_address_write(port_bus.context, address);
+}
+
+bool i2c_driver_send_address_read(uint8_t address)
+{
+    return port_bus.send_address_read(port_bus.context, address);
+}
+
+bool i2c_driver_send_data(uint8_t data)
+{
+    return port_bus.send_data(port_bus.context, data);
+}
+
+uint8_t i2c_driver_read_data(bool ack)
+{
+    return port_bus.read_data(port_bus.context, ack);
+}
+
+bool i2c_driver_read_block(uint8_t *data, uint8_t length)
+{
+    return port_bus.read_block(port_bus.context, data, length);
+}
+
+bool i2c_driver_write_block(const uint8_t *data, uint8_t length)
+{
+    return port_bus.write_block(port_bus.context, data, length);
+}
+
+#endif // __linux__
@@ -0,0 +1,45 @@
+/**
+ * @file    i2c_driver_linux.h
+ * @author  Steven Daglish
+ * @brief   Implements i2c_driver.h on a Linux i2c-dev node, so the single
+ *          sensor API runs on a Linux gateway.
+ * @version 0.1
+ * @date    17 October 2026
+ *
+ * See i2c_linux.h for how byte level calls are batched. Sensor handles set
+ * up on i2c_driver_linux_bus() use whole transactions and see every NACK.
+ *
+ * The source only builds where __linux__ is defined, so it can sit in src/
+ * next to the firmware backends.
+ */
+
+#ifndef _I2C_DRIVER_LINUX_H
+#define _I2C_DRIVER_LINUX_H
+
+#include "i2c_bus.h"
+#include "i2c_driver.h"
+#include "i2c_linux.h"
+
+/**
+ * @brief   Opens the node every i2c_driver_* call goes to. Must be called
+ * before i2c_driver_create().
+ *
+ * @param path      e.g. "/dev/i2c-1"
+ * @return true
+ * @return false    The node could not be opened
+ */
+bool i2c_driver_linux_open(const char *path);
+
+void i2c_driver_linux_close(void);
+
+/**
+ * @brief   The opened node as a bus, for sht31_init().
+ */
+const i2c_bus_t *i2c_driver_linux_bus(void);
+
+/**
+ * @brief   The port behind the bus, for its counters.
+ */
+const i2c_linux_t *i2c_driver_linux_port(void);
+
+#endif // _I2C_DRIVER_LINUX_H
@@ -0,0 +1,216 @@
+#include "i2c_linux.h"
+
+#ifdef __linux__
+#include "i2c_linux_syscalls.h"
+#include <stddef.h>
+
+static bool run(i2c_linux_t *port, struct i2c_msg *messages, uint32_t count)
+{
+    port->ioctls++;
+
+    if ((int)count != i2c_linux_sys_rdwr(port->fd, messages, count))
+    {
+        port->failed_transfers++;
+        return false;
+    }
+    return true;
+}
+
+static void set_write(struct i2c_msg *message, uint8_t address,
+                      const uint8_t *data, uint8_t length)
+{
+    message->addr  = address;
+    message->flags = 0;
+    message->len   = length;
+    // The kernel only reads from a write message's buffer.
+    message->buf   = (uint8_t *)data;
+}
+
+static void set_read(struct i2c_msg *message, uint8_t address, uint8_t *data,
+                     uint8_t length)
+{
+    message->addr  = address;
+    message->flags = I2C_M_RD;
+    message->len   = length;
+    message->buf   = data;
+}
+
+static bool linux_transfer(void *context, uint8_t address,
+                           const uint8_t *write, uint8_t write_length,
+                           uint8_t *read, uint8_t read_length)
+{
+    i2c_linux_t *port = context;
+    struct i2c_msg messages[2];
+    uint32_t count = 0;
+
+    if (write_length > 0)
+    {
+        set_write(&messages[count++], address, write, write_length);
+    }
+    if (read_length > 0)
+    {
+        set_read(&messages[count++], address, read, read_length);
+    }
+
+    if (0 == count)
+    {
+        // Address only, e.g. probing for a device.
+        set_write(&messages[count++], address, NULL, 0);
+    }
+
+    return run(port, messages, count);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Byte level functions, buffered into one transfer
+///////////////////////////////////////////////////////////////////////////////
+
+static bool flush_write(i2c_linux_t *port)
+{
+    struct i2c_msg message;
+
+    if (false == port->write_pending)
+    {
+        return true;
+    }
+
+    port->write_pending = false;
+    set_write(&message, port->address, port->write_data, port->write_length);
+    return run(port, &message, 1);
+}
+
+static bool read_with_pending_write(i2c_linux_t *port, uint8_t *data,
+                                    uint8_t length)
+{
+    struct i2c_msg messages[2];
+    uint32_t count = 0;
+
+    if (port->write_pending)
+    {
+        set_write(&messages[count++], port->address, port->write_data,
+                  port->write_length);
+        port->write_pending = false;
+    }
+    set_read(&messages[count++], port->read_address, data, length);
+
+    return run(port, messages, count);
+}
+
+static void linux_start(void *context)
+{
+    // A repeated START keeps any pending write, so it goes out with the read
+    // that follows.
+    (void)context;
+}
+
+static void linux_stop(void *context)
+{
+    flush_write(context);
+}
+
+static bool linux_send_address_write(void *context, uint8_t address)
+{
+    i2c_linux_t *port = context;
+
+    flush_write(port);
+    port->address       = address;
+    port->write_length  = 0;
+    port->write_pending = true;
+    return true;
+}
+
+static bool linux_send_address_read(void *context, uint8_t address)
+{
+    i2c_linux_t *port = context;
+
+    port->read_address = address;
+    return true;
+}
+
+static bool linux_send_data(void *context, uint8_t data)
+{
+    i2c_linux_t *port = context;
+
+    if ((false == port->write_pending) ||
+        (port->write_length >= I2C_LINUX_MAX_WRITE))
+    {
+        return false;
+    }
+
+    port->write_data[port->write_length++] = data;
+    return true;
+}
+
+static uint8_t linux_read_data(void *context, bool ack)
+{
+    uint8_t data = 0xFF;
+
+    // Each call is a transfer of its own; use read_block for more than one
+    // byte.
+    (void)ack;
+    read_with_pending_write(context, &data, 1);
+    return data;
+}
+
+static bool linux_read_block(void *context, uint8_t *data, uint8_t length)
+{
+    return read_with_pending_write(context, data, length);
+}
+
+static bool linux_write_block(void *context, const uint8_t *data,
+                              uint8_t length)
+{
+    uint8_t i = 0;
+
+    for (i = 0; i < length; i++)
+    {
+        if (false == linux_send_data(context, data[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Opening and closing
+///////////////////////////////////////////////////////////////////////////////
+
+bool i2c_linux_open(i2c_linux_t *port, const char *path, i2c_bus_t *bus)
+{
+    port->fd               = i2c_linux_sys_open(path);
+    port->write_length     = 0;
+    port->write_pending    = false;
+    port->ioctls           = 0;
+    port->failed_transfers = 0;
+
+    if (port->fd < 0)
+    {
+        return false;
+    }
+
+    bus->context            = port;
+    bus->start              = linux_start;
+    bus->stop               = linux_stop;
+    bus->send_address_write = linux_send_address_write;
+    bus->send_address_read  = linux_send_address_read;
+    bus->send_data          = linux_send_data;
+    bus->read_data          = linux_read_data;
+    bus->read_block         = linux_read_block;
+    bus->write_block        = linux_write_block;
+    bus->transfer           = linux_transfer;
+    // i2c-dev gives user space no bus clear; adapters recover on their own.
+    bus->bus_clear          = NULL;
+    return true;
+}
+
+void i2c_linux_close(i2c_linux_t *port)
+{
+    if (port->fd >= 0)
+    {
+        i2c_linux_sys_close(port->fd);
+        port->fd = -1;
+    }
+}
+
+#endif // __linux__
@@ -0,0 +1,61 @@
+/**
+ * @file    i2c_linux.h
+ * @author  Steven Daglish
+ * @brief   I2C bus on a Linux i2c-dev node (/dev/i2c-N).
+ * @version 0.1
+ * @date    17 October 2026
+ *
+ * Each transaction is a single I2C_RDWR ioctl: the write and the read of a
+ * command + read sequence go in as two messages joined by a repeated START.
+ *
+ * The bus provides transfer, which drivers use to hand over a whole
+ * transaction at once. The byte level functions are there for code written
+ * against i2c_driver.h: they are buffered and sent when the read is made or
+ * at STOP, so still cost one ioctl per transaction. Because nothing reaches
+ * the bus until then, the address and data functions always report an ACK;
+ * a NACK fails the read, or for a write only transaction is just counted in
+ * failed_transfers. Polling a sensor by its read header NACK needs transfer.
+ *
+ * The source only builds where __linux__ is defined, so it can sit in src/
+ * next to the firmware backends.
+ */
+
+#ifndef _I2C_LINUX_H
+#define _I2C_LINUX_H
+
+#include "i2c_bus.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define I2C_LINUX_MAX_WRITE 32
+
+typedef struct
+{
+    int fd;
+
+    // Byte level calls waiting to be sent
+    uint8_t address;
+    uint8_t write_data[I2C_LINUX_MAX_WRITE];
+    uint8_t write_length;
+    bool write_pending;
+    uint8_t read_address;
+
+    // Counters
+    uint32_t ioctls;
+    uint32_t failed_transfers;
+} i2c_linux_t;
+
+/**
+ * @brief   Opens the i2c-dev node and fills in bus.
+ *
+ * @param port
+ * @param path      e.g. "/dev/i2c-1"
+ * @param bus
+ * @return true
+ * @return false    The node could not be opened
+ */
+bool i2c_linux_open(i2c_linux_t *port, const char *path, i2c_bus_t *bus);
+
+void i2c_linux_close(i2c_linux_t *port);
+
+#endif // _I2C_LINUX_H
@@ -0,0 +1,29 @@
+// Its header pulls in <linux/i2c.h>, so it is only included on Linux.
+#ifdef __linux__
+#include "i2c_linux_syscalls.h"
+#include <fcntl.h>
+#include <linux/i2c-dev.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+int i2c_linux_sys_open(const char *path)
+{
+    return open(path, O_RDWR);
+}
+
+int i2c_linux_sys_close(int fd)
+{
+    return close(fd);
+}
+
+int i2c_linux_sys_rdwr(int fd, struct i2c_msg *messages, uint32_t count)
+{
+    struct i2c_rdwr_ioctl_data data = {
+        .msgs  = messages,
+        .nmsgs = count,
+    };
+
+    return ioctl(fd, I2C_RDWR, &data);
+}
+
+#endif // __linux__
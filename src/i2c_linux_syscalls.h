@@ -0,0 +1,34 @@
+/**
+ * @file    i2c_linux_syscalls.h
+ * @author  Steven Daglish
+ * @brief   The system calls the Linux i2c-dev backend makes, kept behind
+ *          functions so tests can replace them.
+ * @version 0.1
+ * @date    17 October 2026
+ */
+
+#ifndef _I2C_LINUX_SYSCALLS_H
+#define _I2C_LINUX_SYSCALLS_H
+
+#include <linux/i2c.h>
+#include <stdint.h>
+
+/**
+ * @brief   Opens an i2c-dev node, e.g. "/dev/i2c-1".
+ *
+ * @return int  File descriptor, or -1 on error
+ */
+int i2c_linux_sys_open(const char *path);
+
+int i2c_linux_sys_close(int fd);
+
+/**
+ * @brief   Runs count messages as one combined transfer (I2C_RDWR). The
+ * messages are joined by repeated STARTs and end with a single STOP.
+ *
+ * @return int  Number of messages transferred, or -1 on error (a NACK shows
+ *              up as ENXIO or EREMOTEIO depending on the adapter)
+ */
+int i2c_linux_sys_rdwr(int fd, struct i2c_msg *messages, uint32_t count);
+
+#endif // _I2C_LINUX_SYSCALLS_H
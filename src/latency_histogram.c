@@ -0,0 +1,108 @@
+#include "latency_histogram.h"
+
+#ifdef __linux__
+
+static uint8_t bucket_of(uint32_t latency_us)
+{
+    uint8_t bucket = 0;
+
+    while (latency_us)
+    {
+        bucket++;
+        latency_us >>= 1;
+    }
+    return bucket;
+}
+
+static uint32_t load(const uint32_t *counter)
+{
+    return __atomic_load_n(counter, __ATOMIC_RELAXED);
+}
+
+void latency_histogram_init(latency_histogram_t *histogram)
+{
+    uint8_t i = 0;
+
+    for (i = 0; i < LATENCY_HISTOGRAM_BUCKETS; i++)
+    {
+        histogram->buckets[i] = 0;
+    }
+    histogram->count  = 0;
+    histogram->max_us = 0;
+}
+
+void latency_histogram_record(latency_histogram_t *histogram,
+                              uint32_t latency_us)
+{
+    // Only the recording thread writes, so plain read-modify-write is safe;
+    // the atomic stores keep readers from seeing torn values.
+    uint8_t bucket = bucket_of(latency_us);
+
+    __atomic_store_n(&histogram->buckets[bucket],
+                     histogram->buckets[bucket] + 1, __ATOMIC_RELAXED);
+    __atomic_store_n(&histogram->count, histogram->count + 1,
+                     __ATOMIC_RELAXED);
+    if (latency_us > histogram->max_us)
+    {
+        __atomic_store_n(&histogram->max_us, latency_us, __ATOMIC_RELAXED);
+    }
+}
+
+uint32_t latency_histogram_count(const latency_histogram_t *histogram)
+{
+    return load(&histogram->count);
+}
+
+uint32_t latency_histogram_bucket(const latency_histogram_t *histogram,
+                                  uint8_t bucket)
+{
+    if (bucket >= LATENCY_HISTOGRAM_BUCKETS)
+    {
+        return 0;
+    }
+    return load(&histogram->buckets[bucket]);
+}
+
+uint32_t latency_histogram_max_us(const latency_histogram_t *histogram)
+{
+    return load(&histogram->max_us);
+}
+
+uint32_t latency_histogram_bucket_upper_us(uint8_t bucket)
+{
+    if (0 == bucket)
+    {
+        return 0;
+    }
+    if (bucket >= 32)
+    {
+        return UINT32_MAX;
+    }
+    return (UINT32_C(1) << bucket) - 1;
+}
+
+uint32_t latency_histogram_percentile_us(const latency_histogram_t *histogram,
+                                         uint8_t percent)
+{
+    uint32_t count  = latency_histogram_count(histogram);
+    uint64_t wanted = ((uint64_t)count * percent + 99) / 100;
+    uint64_t seen   = 0;
+    uint8_t bucket  = 0;
+
+    if (0 == count)
+    {
+        return 0;
+    }
+
+    for (bucket = 0; bucket < LATENCY_HISTOGRAM_BUCKETS; bucket++)
+    {
+        seen += latency_histogram_bucket(histogram, bucket);
+        if (seen >= wanted)
+        {
+            return latency_histogram_bucket_upper_us(bucket);
+        }
+    }
+    return latency_histogram_bucket_upper_us(LATENCY_HISTOGRAM_BUCKETS - 1);
+}
+
+#endif // __linux__
@@ -0,0 +1,57 @@
+/**
+ * @file    latency_histogram.h
+ * @author  Steven Daglish
+ * @brief   Power of two bucketed histogram of latencies in microseconds.
+ * @version 0.1
+ * @date    17 October 2026
+ *
+ * Bucket 0 holds 0 us, bucket n holds 2^(n-1) to 2^n - 1 us. One thread
+ * records; any thread may read the counts while it does.
+ *
+ * Counts are kept with GCC __atomic builtins, so the source only builds
+ * where __linux__ is defined, for the gateway.
+ */
+
+#ifndef _LATENCY_HISTOGRAM_H
+#define _LATENCY_HISTOGRAM_H
+
+#include <stdint.h>
+
+#define LATENCY_HISTOGRAM_BUCKETS 33
+
+typedef struct
+{
+    uint32_t buckets[LATENCY_HISTOGRAM_BUCKETS];
+    uint32_t count;
+    uint32_t max_us;
+} latency_histogram_t;
+
+void latency_histogram_init(latency_histogram_t *histogram);
+
+void latency_histogram_record(latency_histogram_t *histogram,
+                              uint32_t latency_us);
+
+uint32_t latency_histogram_count(const latency_histogram_t *histogram);
+
+uint32_t latency_histogram_bucket(const latency_histogram_t *histogram,
+                                  uint8_t bucket);
+
+uint32_t latency_histogram_max_us(const latency_histogram_t *histogram);
+
+/**
+ * @brief   Largest latency bucket holds, so the bucket a value lands in can
+ * be labelled.
+ */
+uint32_t latency_histogram_bucket_upper_us(uint8_t bucket);
+
+/**
+ * @brief   Upper bound of the bucket holding the given percentile.
+ *
+ * @param histogram
+ * @param percent       1 to 100
+ * @return uint32_t     Microseconds, or 0 if nothing has been recorded
+ */
+uint32_t latency_histogram_percentile_us(const latency_histogram_t *histogram,
+                                         uint8_t percent);
+
+#endif // _LATENCY_HISTOGRAM_H
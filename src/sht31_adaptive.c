@@ -0,0 +1,227 @@
+#include "sht31_adaptive.h"
+
+static const uint8_t level_repeatability[SHT31_ADAPTIVE_LEVELS] = {
+    SHT_REPEATABILITY_HIGH, SHT_REPEATABILITY_HIGH, SHT_REPEATABILITY_HIGH,
+    SHT_REPEATABILITY_HIGH, SHT_REPEATABILITY_MEDIUM};
+static const uint16_t level_period_ms[SHT31_ADAPTIVE_LEVELS] = {
+    2000, 1000, 500, 250, 100};
+
+void sht31_adaptive_default_config(sht31_adaptive_config_t *config)
+{
+    config->rise_temperature = 25;
+    config->rise_humidity    = 66;
+    config->fall_temperature = 10;
+    config->fall_humidity    = 26;
+    config->slope_window_ms  = 2000;
+    config->stable_windows   = 3;
+    config->min_level        = 0;
+    config->max_level        = SHT31_ADAPTIVE_LEVELS - 1;
+}
+
+bool sht31_adaptive_init(sht31_adaptive_t *adaptive, sht31_t *sensor,
+                         const sht31_adaptive_config_t *config)
+{
+    if ((config->max_level >= SHT31_ADAPTIVE_LEVELS) ||
+        (config->min_level > config->max_level))
+    {
+        return false;
+    }
+
+    adaptive->sensor        = sensor;
+    adaptive->config        = *config;
+    adaptive->running       = false;
+    adaptive->level         = config->min_level;
+    adaptive->restarting    = false;
+    adaptive->restart_at_ms = 0;
+    adaptive->next_fetch_ms = 0;
+    adaptive->has_reference = false;
+    adaptive->stable_count  = 0;
+    adaptive->level_changes = 0;
+
+    return true;
+}
+
+/*
+ * Starts periodic mode at the current level. The first result is ready one
+ * conversion time later, then once per period.
+ */
+static bool start_level(sht31_adaptive_t *adaptive, uint32_t now_ms)
+{
+    uint8_t repeatability = level_repeatability[adaptive->level];
+
+    if (false == sht31_send_periodic_data_acquisition_mode(
+                     adaptive->sensor, repeatability, adaptive->level))
+    {
+        return false;
+    }
+
+    adaptive->restarting    = false;
+    adaptive->next_fetch_ms = sht31_result_ready_ms(repeatability, now_ms);
+    return true;
+}
+
+static void change_level(sht31_adaptive_t *adaptive, uint8_t level,
+                         uint32_t now_ms)
+{
+    if (level == adaptive->level)
+    {
+        return;
+    }
+
+    // Still at the old rate if the break was not taken; the next comparison
+    // will try again.
+    if (false == sht31_break_command(adaptive->sensor))
+    {
+        return;
+    }
+
+    adaptive->level         = level;
+    adaptive->restarting    = true;
+    adaptive->restart_at_ms = now_ms + SHT31_ADAPTIVE_BREAK_MS;
+    adaptive->level_changes++;
+}
+
+static uint32_t rate_per_second(uint16_t now, uint16_t then, uint32_t age_ms)
+{
+    uint32_t change = (now > then) ? (uint32_t)(now - then)
+                                   : (uint32_t)(then - now);
+
+    return (change * 1000u) / age_ms;
+}
+
+static void adjust_level(sht31_adaptive_t *adaptive,
+                         const sht31_reading_t *reading)
+{
+    const sht31_adaptive_config_t *config = &adaptive->config;
+    uint32_t age_ms                       = 0;
+    uint32_t temperature_rate             = 0;
+    uint32_t humidity_rate                = 0;
+
+    if (false == adaptive->has_reference)
+    {
+        adaptive->reference     = *reading;
+        adaptive->has_reference = true;
+        return;
+    }
+
+    age_ms = reading->timestamp_ms - adaptive->reference.timestamp_ms;
+    if (age_ms < config->slope_window_ms)
+    {
+        return;
+    }
+
+    temperature_rate = rate_per_second(
+        reading->temperature, adaptive->reference.temperature, age_ms);
+    humidity_rate = rate_per_second(reading->humidity,
+                                    adaptive->reference.humidity, age_ms);
+    adaptive->reference = *reading;
+
+    if ((temperature_rate > config->rise_temperature) ||
+        (humidity_rate > config->rise_humidity))
+    {
+        adaptive->stable_count = 0;
+        change_level(adaptive, config->max_level, reading->timestamp_ms);
+        return;
+    }
+
+    if ((temperature_rate > config->fall_temperature) ||
+        (humidity_rate > config->fall_humidity))
+    {
+        adaptive->stable_count = 0;
+        return;
+    }
+
+    adaptive->stable_count++;
+    if ((adaptive->stable_count >= config->stable_windows) &&
+        (adaptive->level > config->min_level))
+    {
+        adaptive->stable_count = 0;
+        change_level(adaptive, adaptive->level - 1, reading->timestamp_ms);
+    }
+}
+
+/*
+ * Results keep to the grid set when the mode started, so a late service
+ * skips the ones it missed rather than fetching early.
+ */
+static void schedule_next_fetch(sht31_adaptive_t *adaptive, uint32_t now_ms)
+{
+    uint32_t period_ms = level_period_ms[adaptive->level];
+
+    do
+    {
+        adaptive->next_fetch_ms += period_ms;
+    } while ((int32_t)(adaptive->next_fetch_ms - now_ms) <= 0);
+}
+
+bool sht31_adaptive_start(sht31_adaptive_t *adaptive, uint32_t now_ms)
+{
+    adaptive->level         = adaptive->config.min_level;
+    adaptive->has_reference = false;
+    adaptive->stable_count  = 0;
+    adaptive->running       = start_level(adaptive, now_ms);
+
+    return adaptive->running;
+}
+
+bool sht31_adaptive_stop(sht31_adaptive_t *adaptive)
+{
+    adaptive->running    = false;
+    adaptive->restarting = false;
+
+    return sht31_break_command(adaptive->sensor);
+}
+
+sht31_poll_t sht31_adaptive_service(sht31_adaptive_t *adaptive,
+                                    uint32_t now_ms)
+{
+    sht31_reading_t reading;
+
+    if (false == adaptive->running)
+    {
+        return SHT31_POLL_IDLE;
+    }
+
+    if (adaptive->restarting)
+    {
+        if ((int32_t)(now_ms - adaptive->restart_at_ms) < 0)
+        {
+            return SHT31_POLL_BUSY;
+        }
+        return start_level(adaptive, now_ms) ? SHT31_POLL_BUSY
+                                              : SHT31_POLL_ERROR;
+    }
+
+    if ((int32_t)(now_ms - adaptive->next_fetch_ms) < 0)
+    {
+        return SHT31_POLL_BUSY;
+    }
+    schedule_next_fetch(adaptive, now_ms);
+
+    if (false == sht31_fetch_periodic_data(adaptive->sensor))
+    {
+        return SHT31_POLL_ERROR;
+    }
+
+    reading.timestamp_ms = now_ms;
+    reading.temperature  = sht31_return_temperature(adaptive->sensor);
+    reading.humidity     = sht31_return_humidity(adaptive->sensor);
+    adjust_level(adaptive, &reading);
+
+    return SHT31_POLL_DONE;
+}
+
+uint8_t sht31_adaptive_level(const sht31_adaptive_t *adaptive)
+{
+    return adaptive->level;
+}
+
+uint32_t sht31_adaptive_period_ms(uint8_t level)
+{
+    return (level < SHT31_ADAPTIVE_LEVELS) ? level_period_ms[level] : 0;
+}
+
+uint32_t sht31_adaptive_level_changes(const sht31_adaptive_t *adaptive)
+{
+    return adaptive->level_changes;
+}
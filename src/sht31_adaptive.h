@@ -0,0 +1,129 @@
+/**
+ * @file    sht31_adaptive.h
+ * @author  Steven Daglish
+ * @brief   Periodic acquisition whose rate follows how fast the readings are
+ *          changing.
+ * @version 0.1
+ * @date    17 October 2026
+ *
+ * The sensor runs in periodic mode at one of SHT31_ADAPTIVE_LEVELS levels:
+ *
+ *  Level   Rate        Repeatability
+ *  0       0.5 mps     High
+ *  1       1 mps       High
+ *  2       2 mps       High
+ *  3       4 mps       High
+ *  4       10 mps      Medium (less self heating at the fastest rate)
+ *
+ * Each new reading is compared with a reference reading taken at least
+ * slope_window_ms earlier. If either channel is changing faster than its
+ * rise threshold the controller jumps straight to max_level, so a transient
+ * is tracked as closely as possible from the next reading on. Once
+ * stable_windows comparisons in a row are at or below the fall thresholds
+ * it drops one level, down to min_level.
+ *
+ * A level change sends a break, waits SHT31_ADAPTIVE_BREAK_MS for the
+ * sensor to stop, then starts periodic mode at the new rate.
+ *
+ * Thresholds are in raw ticks per second: one temperature tick is
+ * 175 / 65535 C, one humidity tick 100 / 65535 %RH.
+ */
+
+#ifndef _SHT31_ADAPTIVE_H
+#define _SHT31_ADAPTIVE_H
+
+#include "sht31_driver.h"
+#include "sht31_ring_buffer.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SHT31_ADAPTIVE_LEVELS 5
+#define SHT31_ADAPTIVE_BREAK_MS 1
+
+typedef struct
+{
+    uint16_t rise_temperature;
+    uint16_t rise_humidity;
+    uint16_t fall_temperature;
+    uint16_t fall_humidity;
+    uint32_t slope_window_ms;
+    uint8_t stable_windows;
+    uint8_t min_level;
+    uint8_t max_level;
+} sht31_adaptive_config_t;
+
+typedef struct
+{
+    sht31_t *sensor;
+    sht31_adaptive_config_t config;
+
+    bool running;
+    uint8_t level;
+    bool restarting;
+    uint32_t restart_at_ms;
+    uint32_t next_fetch_ms;
+
+    bool has_reference;
+    sht31_reading_t reference;
+    uint8_t stable_count;
+
+    uint32_t level_changes;
+} sht31_adaptive_t;
+
+/**
+ * @brief   Fills in thresholds suited to a room: rise at about 4 C/min or
+ * 6 %RH/min, fall below 1.6 C/min or 2.4 %RH/min, over 2 second windows, all
+ * levels allowed.
+ */
+void sht31_adaptive_default_config(sht31_adaptive_config_t *config);
+
+/**
+ * @brief   Sets up the controller. Nothing is sent until
+ * sht31_adaptive_start().
+ *
+ * @param adaptive
+ * @param sensor
+ * @param config    Copied
+ * @return true
+ * @return false    Levels out of range or min_level above max_level
+ */
+bool sht31_adaptive_init(sht31_adaptive_t *adaptive, sht31_t *sensor,
+                         const sht31_adaptive_config_t *config);
+
+/**
+ * @brief   Starts periodic mode at min_level.
+ */
+bool sht31_adaptive_start(sht31_adaptive_t *adaptive, uint32_t now_ms);
+
+/**
+ * @brief   Stops periodic mode with a break.
+ */
+bool sht31_adaptive_stop(sht31_adaptive_t *adaptive);
+
+/**
+ * @brief   Fetches a result when one is due and adjusts the rate. Call at
+ * least every millisecond or so; between results nothing is sent.
+ *
+ * @return SHT31_POLL_IDLE  Not started
+ * @return SHT31_POLL_BUSY  No new result yet
+ * @return SHT31_POLL_DONE  The sensor handle holds a new reading
+ * @return SHT31_POLL_ERROR A fetch or mode command failed. Fetches carry on
+ *                          at the current rate; a failed mode change is
+ *                          retried on the next service.
+ */
+sht31_poll_t sht31_adaptive_service(sht31_adaptive_t *adaptive,
+                                    uint32_t now_ms);
+
+uint8_t sht31_adaptive_level(const sht31_adaptive_t *adaptive);
+
+/**
+ * @brief   Time between results at level.
+ */
+uint32_t sht31_adaptive_period_ms(uint8_t level);
+
+/**
+ * @brief   Number of rate changes since init.
+ */
+uint32_t sht31_adaptive_level_changes(const sht31_adaptive_t *adaptive);
+
+#endif // _SHT31_ADAPTIVE_H
@@ -0,0 +1,138 @@
+#include "sht31_aggregate.h"
+
+static void clear_channel(sht31_aggregate_channel_t *channel)
+{
+    channel->min            = UINT16_MAX;
+    channel->max            = 0;
+    channel->sum            = 0;
+    channel->sum_of_squares = 0;
+}
+
+static void add_value(sht31_aggregate_channel_t *channel, uint16_t value)
+{
+    if (value < channel->min)
+    {
+        channel->min = value;
+    }
+    if (value > channel->max)
+    {
+        channel->max = value;
+    }
+    channel->sum += value;
+    channel->sum_of_squares += (uint32_t)value * value;
+}
+
+/*
+ * variance = (n * sum(x^2) - sum(x)^2) / n^2, exact in 64 bits for up to
+ * 65535 readings of 16 bits.
+ */
+static void summarise(const sht31_aggregate_channel_t *channel, uint16_t count,
+                      sht31_aggregate_summary_t *summary)
+{
+    uint64_t square_of_sum = (uint64_t)channel->sum * channel->sum;
+    uint64_t spread = (uint64_t)count * channel->sum_of_squares - square_of_sum;
+
+    summary->min      = channel->min;
+    summary->max      = channel->max;
+    summary->mean     = (uint16_t)((channel->sum + (count / 2)) / count);
+    summary->variance = (uint32_t)(spread / ((uint64_t)count * count));
+}
+
+static void start_window(sht31_aggregate_t *aggregate, uint32_t start_ms)
+{
+    aggregate->started  = true;
+    aggregate->start_ms = start_ms;
+    aggregate->count    = 0;
+    clear_channel(&aggregate->temperature);
+    clear_channel(&aggregate->humidity);
+}
+
+static void emit_window(sht31_aggregate_t *aggregate)
+{
+    sht31_aggregate_record_t record;
+
+    if (0 == aggregate->count)
+    {
+        return;
+    }
+
+    record.start_ms = aggregate->start_ms;
+    record.count    = aggregate->count;
+    summarise(&aggregate->temperature, aggregate->count, &record.temperature);
+    summarise(&aggregate->humidity, aggregate->count, &record.humidity);
+
+    aggregate->records++;
+    aggregate->emit(aggregate->context, &record);
+
+    start_window(aggregate, aggregate->start_ms);
+}
+
+/*
+ * Closes the window if time_ms is past it and moves the start on to the
+ * window time_ms falls in, skipping any empty windows between.
+ */
+static void advance_window(sht31_aggregate_t *aggregate, uint32_t time_ms)
+{
+    uint32_t elapsed = time_ms - aggregate->start_ms;
+
+    if (((int32_t)elapsed < 0) || (elapsed < aggregate->window_ms))
+    {
+        return;
+    }
+
+    emit_window(aggregate);
+    start_window(aggregate, aggregate->start_ms +
+                                (elapsed / aggregate->window_ms) *
+                                    aggregate->window_ms);
+}
+
+void sht31_aggregate_init(sht31_aggregate_t *aggregate, uint32_t window_ms,
+                          sht31_aggregate_emit_t emit, void *context)
+{
+    aggregate->window_ms = window_ms;
+    aggregate->emit      = emit;
+    aggregate->context   = context;
+    aggregate->started   = false;
+    aggregate->start_ms  = 0;
+    aggregate->count     = 0;
+    aggregate->records   = 0;
+    clear_channel(&aggregate->temperature);
+    clear_channel(&aggregate->humidity);
+}
+
+void sht31_aggregate_add(sht31_aggregate_t *aggregate,
+                         const sht31_reading_t *reading)
+{
+    if (false == aggregate->started)
+    {
+        start_window(aggregate, reading->timestamp_ms);
+    }
+    advance_window(aggregate, reading->timestamp_ms);
+
+    add_value(&aggregate->temperature, reading->temperature);
+    add_value(&aggregate->humidity, reading->humidity);
+    aggregate->count++;
+
+    if (SHT31_AGGREGATE_MAX_COUNT == aggregate->count)
+    {
+        emit_window(aggregate);
+    }
+}
+
+void sht31_aggregate_service(sht31_aggregate_t *aggregate, uint32_t now_ms)
+{
+    if (aggregate->started)
+    {
+        advance_window(aggregate, now_ms);
+    }
+}
+
+void sht31_aggregate_flush(sht31_aggregate_t *aggregate)
+{
+    emit_window(aggregate);
+}
+
+uint32_t sht31_aggregate_records(const sht31_aggregate_t *aggregate)
+{
+    return aggregate->records;
+}
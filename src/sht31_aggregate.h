@@ -0,0 +1,106 @@
+/**
+ * @file    sht31_aggregate.h
+ * @author  Steven Daglish
+ * @brief   Folds readings into fixed time windows and emits one summary
+ *          (count, min, max, mean, variance) per window.
+ * @version 0.1
+ * @date    17 October 2026
+ *
+ * Each window keeps a count, minimum, maximum, sum and sum of squares per
+ * channel, so memory does not grow with the number of readings and adding a
+ * reading costs a few integer operations. The mean and variance are worked
+ * out, in integers, only when the window closes.
+ *
+ * Values stay in raw sensor ticks; convert the summary with
+ * sht31_conversion.h if needed. Windows are window_ms long and follow on
+ * from the first reading's timestamp. Windows with no readings are not
+ * emitted. A window with more than SHT31_AGGREGATE_MAX_COUNT readings is
+ * emitted early and carried on in a second record with the same start.
+ */
+
+#ifndef _SHT31_AGGREGATE_H
+#define _SHT31_AGGREGATE_H
+
+#include "sht31_ring_buffer.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Keeps count * sum of squares inside 64 bits for the variance.
+#define SHT31_AGGREGATE_MAX_COUNT UINT16_MAX
+
+typedef struct
+{
+    uint16_t min;
+    uint16_t max;
+    uint16_t mean;
+    uint32_t variance;  // Population variance, ticks squared, rounded down
+} sht31_aggregate_summary_t;
+
+typedef struct
+{
+    uint32_t start_ms;
+    uint16_t count;
+    sht31_aggregate_summary_t temperature;
+    sht31_aggregate_summary_t humidity;
+} sht31_aggregate_record_t;
+
+typedef void (*sht31_aggregate_emit_t)(void *context,
+                                       const sht31_aggregate_record_t *record);
+
+typedef struct
+{
+    uint16_t min;
+    uint16_t max;
+    uint32_t sum;
+    uint64_t sum_of_squares;
+} sht31_aggregate_channel_t;
+
+typedef struct
+{
+    uint32_t window_ms;
+    sht31_aggregate_emit_t emit;
+    void *context;
+
+    bool started;
+    uint32_t start_ms;
+    uint16_t count;
+    sht31_aggregate_channel_t temperature;
+    sht31_aggregate_channel_t humidity;
+    uint32_t records;
+} sht31_aggregate_t;
+
+/**
+ * @brief
+ *
+ * @param aggregate
+ * @param window_ms     Length of each window, more than 0
+ * @param emit          Called with each closed window
+ * @param context       Passed to emit
+ */
+void sht31_aggregate_init(sht31_aggregate_t *aggregate, uint32_t window_ms,
+                          sht31_aggregate_emit_t emit, void *context);
+
+/**
+ * @brief   Folds in a reading. If the reading belongs to a later window, the
+ * current one is emitted first.
+ */
+void sht31_aggregate_add(sht31_aggregate_t *aggregate,
+                         const sht31_reading_t *reading);
+
+/**
+ * @brief   Emits the current window if now_ms is past its end, so a window
+ * closes on time even when readings stop.
+ */
+void sht31_aggregate_service(sht31_aggregate_t *aggregate, uint32_t now_ms);
+
+/**
+ * @brief   Emits the current window now, however far through it is.
+ */
+void sht31_aggregate_flush(sht31_aggregate_t *aggregate);
+
+/**
+ * @brief   Number of records emitted so far.
+ */
+uint32_t sht31_aggregate_records(const sht31_aggregate_t *aggregate);
+
+#endif // _SHT31_AGGREGATE_H
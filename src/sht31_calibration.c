@@ -0,0 +1,69 @@
+#include "sht31_calibration.h"
+#include <stddef.h>
+
+const sht31_calibration_t sht31_calibration_none = {
+    .serial             = 0,
+    .temperature_gain   = SHT31_CALIBRATION_UNITY_GAIN,
+    .temperature_offset = 0,
+    .humidity_gain      = SHT31_CALIBRATION_UNITY_GAIN,
+    .humidity_offset    = 0,
+};
+
+bool sht31_calibration_table_init(sht31_calibration_table_t *table,
+                                  const sht31_calibration_t *entries,
+                                  uint16_t count)
+{
+    uint16_t i = 0;
+
+    // Strictly ascending, which the binary search relies on.
+    for (i = 1; i < count; i++)
+    {
+        if (entries[i].serial <= entries[i - 1].serial)
+        {
+            return false;
+        }
+    }
+
+    table->entries = entries;
+    table->count   = count;
+    return true;
+}
+
+const sht31_calibration_t *
+sht31_calibration_find(const sht31_calibration_table_t *table,
+                       uint32_t serial)
+{
+    uint16_t low    = 0;
+    uint16_t high   = table->count;
+    uint16_t middle = 0;
+
+    // Searches [low, high).
+    while (low < high)
+    {
+        middle = low + (high - low) / 2;
+
+        if (table->entries[middle].serial == serial)
+        {
+            return &table->entries[middle];
+        }
+        if (table->entries[middle].serial < serial)
+        {
+            low = middle + 1;
+        }
+        else
+        {
+            high = middle;
+        }
+    }
+    return NULL;
+}
+
+const sht31_calibration_t *
+sht31_calibration_lookup(const sht31_calibration_table_t *table,
+                         uint32_t serial)
+{
+    const sht31_calibration_t *calibration =
+        sht31_calibration_find(table, serial);
+
+    return (NULL == calibration) ? &sht31_calibration_none : calibration;
+}
@@ -0,0 +1,64 @@
+/**
+ * @file    sht31_calibration.h
+ * @author  Steven Daglish
+ * @brief   Per-device correction table keyed by serial number.
+ * @version 0.1
+ * @date    17 October 2026
+ *
+ * The table is an array of sht31_calibration_t sorted by serial number,
+ * supplied by the caller (it can live in flash). Lookups are a binary
+ * search, so a gateway with hundreds of sensors takes at most ten
+ * comparisons per lookup. Look a device up once, e.g. with the serial from
+ * sht31_read_serial_number() or a discovery entry, and keep the pointer;
+ * the conversions in sht31_conversion.h then apply it per sample.
+ */
+
+#ifndef _SHT31_CALIBRATION_H
+#define _SHT31_CALIBRATION_H
+
+#include "sht31_conversion.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct
+{
+    const sht31_calibration_t *entries;
+    uint16_t count;
+} sht31_calibration_table_t;
+
+/**
+ * @brief   Unity gain and no offset, for devices not in a table.
+ */
+extern const sht31_calibration_t sht31_calibration_none;
+
+/**
+ * @brief
+ *
+ * @param table
+ * @param entries   count entries in ascending serial number order
+ * @param count
+ * @return true
+ * @return false    entries are out of order or a serial number repeats
+ */
+bool sht31_calibration_table_init(sht31_calibration_table_t *table,
+                                  const sht31_calibration_t *entries,
+                                  uint16_t count);
+
+/**
+ * @brief   Finds the entry for a serial number.
+ *
+ * @return const sht31_calibration_t*   NULL if it is not in the table
+ */
+const sht31_calibration_t *
+sht31_calibration_find(const sht31_calibration_table_t *table,
+                       uint32_t serial);
+
+/**
+ * @brief   sht31_calibration_find(), falling back to sht31_calibration_none
+ * so the result can always be passed to a calibrated conversion.
+ */
+const sht31_calibration_t *
+sht31_calibration_lookup(const sht31_calibration_table_t *table,
+                         uint32_t serial);
+
+#endif // _SHT31_CALIBRATION_H
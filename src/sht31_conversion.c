@@ -0,0 +1,138 @@
+#include "sht31_conversion.h"
+
+#define CELSIUS_SPAN 17500
+#define CELSIUS_OFFSET -4500
+#define FAHRENHEIT_SPAN 31500
+#define FAHRENHEIT_OFFSET -4900
+#define HUMIDITY_SPAN 10000
+#define GAIN_SHIFT 15
+#define GAIN_ROUNDING (1L << (GAIN_SHIFT - 1))
+
+/*
+ * Returns round(raw * span / 65535).
+ *
+ * Dividing by 65535 is dividing by 65536 and multiplying by
+ * 1 / (1 - 2^-16) = 1 + 2^-16 + ..., so adding product >> 16 before the final
+ * shift corrects for the difference. For spans up to 31500 this matches the
+ * exact rounded result for every raw value and stays within 32 bits.
+ */
+static inline uint16_t scale(uint16_t raw, uint16_t span)
+{
+    uint32_t product = (uint32_t)raw * span;
+    return (product + (product >> 16) + 0x8000) >> 16;
+}
+
+int16_t sht31_temperature_to_centi_celsius(uint16_t raw)
+{
+    return CELSIUS_OFFSET + (int16_t)scale(raw, CELSIUS_SPAN);
+}
+
+int16_t sht31_temperature_to_centi_fahrenheit(uint16_t raw)
+{
+    return FAHRENHEIT_OFFSET + (int16_t)scale(raw, FAHRENHEIT_SPAN);
+}
+
+uint16_t sht31_humidity_to_centi_percent(uint16_t raw)
+{
+    return scale(raw, HUMIDITY_SPAN);
+}
+
+void sht31_temperatures_to_centi_celsius(const uint16_t *raw, int16_t *result,
+                                         uint16_t count)
+{
+    while (count--)
+    {
+        *result++ = CELSIUS_OFFSET + (int16_t)scale(*raw++, CELSIUS_SPAN);
+    }
+}
+
+void sht31_temperatures_to_centi_fahrenheit(const uint16_t *raw,
+                                            int16_t *result, uint16_t count)
+{
+    while (count--)
+    {
+        *result++ = FAHRENHEIT_OFFSET + (int16_t)scale(*raw++, FAHRENHEIT_SPAN);
+    }
+}
+
+void sht31_humidities_to_centi_percent(const uint16_t *raw, uint16_t *result,
+                                       uint16_t count)
+{
+    while (count--)
+    {
+        *result++ = scale(*raw++, HUMIDITY_SPAN);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Calibrated conversions
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Returns round(offset + value * gain / 32768). value is at most 13000 in
+ * size, so the product fits in 32 bits for any gain.
+ */
+static inline int32_t correct(int32_t value, uint16_t gain, int16_t offset)
+{
+    return offset + ((value * gain + GAIN_ROUNDING) >> GAIN_SHIFT);
+}
+
+static inline int16_t
+calibrated_celsius(uint16_t raw, const sht31_calibration_t *calibration)
+{
+    int32_t value = correct(CELSIUS_OFFSET + (int16_t)scale(raw, CELSIUS_SPAN),
+                            calibration->temperature_gain,
+                            calibration->temperature_offset);
+
+    if (value > INT16_MAX)
+    {
+        return INT16_MAX;
+    }
+    return (value < INT16_MIN) ? INT16_MIN : (int16_t)value;
+}
+
+static inline uint16_t
+calibrated_percent(uint16_t raw, const sht31_calibration_t *calibration)
+{
+    int32_t value = correct(scale(raw, HUMIDITY_SPAN),
+                            calibration->humidity_gain,
+                            calibration->humidity_offset);
+
+    if (value > HUMIDITY_SPAN)
+    {
+        return HUMIDITY_SPAN;
+    }
+    return (value < 0) ? 0 : (uint16_t)value;
+}
+
+int16_t sht31_temperature_to_calibrated_centi_celsius(
+    uint16_t raw, const sht31_calibration_t *calibration)
+{
+    return calibrated_celsius(raw, calibration);
+}
+
+uint16_t sht31_humidity_to_calibrated_centi_percent(
+    uint16_t raw, const sht31_calibration_t *calibration)
+{
+    return calibrated_percent(raw, calibration);
+}
+
+void sht31_temperatures_to_calibrated_centi_celsius(
+    const uint16_t *raw, int16_t *result, uint16_t count,
+    const sht31_calibration_t *calibration)
+{
+    while (count--)
+    {
+        *result++ = calibrated_celsius(*raw++, calibration);
+    }
+}
+
+void sht31_humidities_to_calibrated_centi_percent(
+    const uint16_t *raw, uint16_t *result, uint16_t count,
+    const sht31_calibration_t *calibration)
+{
+    while (count--)
+    {
+        *result++ = calibrated_percent(*raw++, calibration);
+    }
+}
@@ -0,0 +1,91 @@
+/**
+ * @file    sht31_conversion.h
+ * @author  Steven Daglish
+ * @brief   Converts raw SHT31 readings to physical units using integer maths
+ *          only.
+ * @version 0.1
+ * @date    17 October 2026
+ *
+ * Formulas from page 14 of SHT spec pdf:
+ *
+ *  T[C]  = -45 + 175 * raw / 65535
+ *  T[F]  = -49 + 315 * raw / 65535
+ *  RH[%] = 100 * raw / 65535
+ *
+ * Results are in hundredths (2512 = 25.12 C) and rounded to the nearest
+ * hundredth. Each conversion is one 16x16 bit multiply plus shifts, so there
+ * is no floating point or division on parts without an FPU.
+ *
+ * The calibrated conversions then apply a per-device correction,
+ *
+ *  corrected = offset + value * gain / 32768
+ *
+ * which costs one more multiply and add per sample. Gains are Q15 (32768
+ * is 1.0, so 0 to just under 2.0).
+ */
+
+#ifndef _SHT31_CONVERSION_H
+#define _SHT31_CONVERSION_H
+
+#include <stdint.h>
+
+// Gain of a device that needs no correction.
+#define SHT31_CALIBRATION_UNITY_GAIN 32768u
+
+/**
+ * @brief   Correction for one device, keyed by its serial number.
+ */
+typedef struct
+{
+    uint32_t serial;
+    uint16_t temperature_gain;  // Q15
+    int16_t temperature_offset; // Hundredths of a degree C
+    uint16_t humidity_gain;     // Q15
+    int16_t humidity_offset;    // Hundredths of a percent RH
+} sht31_calibration_t;
+
+int16_t sht31_temperature_to_centi_celsius(uint16_t raw);
+
+int16_t sht31_temperature_to_centi_fahrenheit(uint16_t raw);
+
+uint16_t sht31_humidity_to_centi_percent(uint16_t raw);
+
+/**
+ * @brief   Converts count raw temperatures to hundredths of a degree C.
+ *
+ * @param raw       Raw readings
+ * @param result    Converted values, may not overlap raw
+ * @param count     Number of readings
+ */
+void sht31_temperatures_to_centi_celsius(const uint16_t *raw, int16_t *result,
+                                         uint16_t count);
+
+void sht31_temperatures_to_centi_fahrenheit(const uint16_t *raw,
+                                            int16_t *result, uint16_t count);
+
+void sht31_humidities_to_centi_percent(const uint16_t *raw, uint16_t *result,
+                                       uint16_t count);
+
+/**
+ * @brief   sht31_temperature_to_centi_celsius() with a device's correction
+ * applied. The result saturates at the ends of int16_t.
+ */
+int16_t sht31_temperature_to_calibrated_centi_celsius(
+    uint16_t raw, const sht31_calibration_t *calibration);
+
+/**
+ * @brief   sht31_humidity_to_centi_percent() with a device's correction
+ * applied, limited to 0 to 100 %RH.
+ */
+uint16_t sht31_humidity_to_calibrated_centi_percent(
+    uint16_t raw, const sht31_calibration_t *calibration);
+
+void sht31_temperatures_to_calibrated_centi_celsius(
+    const uint16_t *raw, int16_t *result, uint16_t count,
+    const sht31_calibration_t *calibration);
+
+void sht31_humidities_to_calibrated_centi_percent(
+    const uint16_t *raw, uint16_t *result, uint16_t count,
+    const sht31_calibration_t *calibration);
+
+#endif // _SHT31_CONVERSION_H
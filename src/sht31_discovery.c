@@ -0,0 +1,357 @@
+#include "sht31_discovery.h"
+#include "crc8.h"
+#include <stddef.h>
+
+#define PROBE_ADDRESSES 2
+
+static const uint8_t probe_address[PROBE_ADDRESSES] = {DEFAULT_ADDRESS,
+                                                       SHT_ALTERNATE_ADDRESS};
+
+static void put_u32(uint8_t *out, uint32_t value)
+{
+    out[0] = value & 0xFF;
+    out[1] = (value >> 8) & 0xFF;
+    out[2] = (value >> 16) & 0xFF;
+    out[3] = value >> 24;
+}
+
+static uint32_t get_u32(const uint8_t *in)
+{
+    return in[0] | ((uint32_t)in[1] << 8) | ((uint32_t)in[2] << 16) |
+           ((uint32_t)in[3] << 24);
+}
+
+static bool known_address(uint8_t address)
+{
+    uint8_t i = 0;
+
+    for (i = 0; i < PROBE_ADDRESSES; i++)
+    {
+        if (probe_address[i] == address)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool sht31_discovery_init(sht31_discovery_t *discovery,
+                          const i2c_bus_t *const *buses, uint8_t bus_count)
+{
+    uint8_t i = 0;
+
+    if ((0 == bus_count) || (bus_count > SHT31_DISCOVERY_MAX_BUSES))
+    {
+        return false;
+    }
+
+    for (i = 0; i < bus_count; i++)
+    {
+        discovery->buses[i] = buses[i];
+    }
+    discovery->bus_count = bus_count;
+    discovery->count     = 0;
+    discovery->changed   = false;
+    discovery->scans     = 0;
+    discovery->dropped   = 0;
+
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Table
+///////////////////////////////////////////////////////////////////////////////
+
+static void fill_slot(sht31_discovery_t *discovery, uint8_t slot,
+                      const sht31_topology_entry_t *entry)
+{
+    discovery->entries[slot] = *entry;
+    discovery->misses[slot]  = 0;
+    discovery->present[slot] = true;
+    sht31_init(&discovery->sensors[slot], discovery->buses[entry->bus],
+               entry->address);
+}
+
+/*
+ * Puts a sensor in the first empty slot, with a fresh handle.
+ */
+static bool add_sensor(sht31_discovery_t *discovery,
+                       const sht31_topology_entry_t *entry)
+{
+    uint8_t slot = 0;
+
+    while ((slot < discovery->count) && discovery->present[slot])
+    {
+        slot++;
+    }
+
+    if (slot >= SHT31_DISCOVERY_MAX_SENSORS)
+    {
+        discovery->dropped++;
+        return false;
+    }
+
+    fill_slot(discovery, slot, entry);
+    if (slot == discovery->count)
+    {
+        discovery->count++;
+    }
+    return true;
+}
+
+/*
+ * Empties a slot. Empty slots at the end are given back.
+ */
+static void remove_sensor(sht31_discovery_t *discovery, uint8_t slot)
+{
+    discovery->present[slot] = false;
+    while ((discovery->count > 0) &&
+           (false == discovery->present[discovery->count - 1]))
+    {
+        discovery->count--;
+    }
+}
+
+/*
+ * Returns the slot of the sensor at address on bus, or
+ * SHT31_DISCOVERY_MAX_SENSORS if it is not in the table.
+ */
+static uint8_t find_sensor(const sht31_discovery_t *discovery, uint8_t bus,
+                           uint8_t address)
+{
+    uint8_t i = 0;
+
+    for (i = 0; i < discovery->count; i++)
+    {
+        if (discovery->present[i] && (discovery->entries[i].bus == bus) &&
+            (discovery->entries[i].address == address))
+        {
+            return i;
+        }
+    }
+    return SHT31_DISCOVERY_MAX_SENSORS;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Scanning
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * A device is only taken as a sensor if its status register reads back
+ * with a good CRC.
+ */
+static bool probe(const i2c_bus_t *bus, uint8_t address, uint32_t *serial)
+{
+    sht31_t sensor;
+
+    sht31_init(&sensor, bus, address);
+    return sht31_read_status_register(&sensor) &&
+           sht31_read_serial_number(&sensor, serial);
+}
+
+static void scan_address(sht31_discovery_t *discovery, uint8_t bus,
+                         uint8_t address)
+{
+    sht31_topology_entry_t found;
+    uint8_t slot  = find_sensor(discovery, bus, address);
+    bool answered = false;
+
+    // A sensor that is converting nacks the probe, so it is left alone.
+    if ((slot < SHT31_DISCOVERY_MAX_SENSORS) &&
+        discovery->sensors[slot].measuring)
+    {
+        return;
+    }
+
+    found.bus     = bus;
+    found.address = address;
+    answered      = probe(discovery->buses[bus], address, &found.serial);
+
+    if (slot >= SHT31_DISCOVERY_MAX_SENSORS)
+    {
+        if (answered)
+        {
+            add_sensor(discovery, &found);
+            discovery->changed = true;
+        }
+    }
+    else if (false == answered)
+    {
+        remove_sensor(discovery, slot);
+        discovery->changed = true;
+    }
+    else if (discovery->entries[slot].serial != found.serial)
+    {
+        // Another sensor at the same place: new handle, same slot.
+        fill_slot(discovery, slot, &found);
+        discovery->changed = true;
+    }
+    else
+    {
+        discovery->misses[slot] = 0;
+    }
+}
+
+static void scan_bus(sht31_discovery_t *discovery, uint8_t bus)
+{
+    uint8_t i = 0;
+
+    for (i = 0; i < PROBE_ADDRESSES; i++)
+    {
+        scan_address(discovery, bus, probe_address[i]);
+    }
+    discovery->scans++;
+}
+
+uint8_t sht31_discovery_scan(sht31_discovery_t *discovery)
+{
+    uint8_t bus = 0;
+
+    for (bus = 0; bus < discovery->bus_count; bus++)
+    {
+        scan_bus(discovery, bus);
+    }
+    return discovery->count;
+}
+
+bool sht31_discovery_report(sht31_discovery_t *discovery, uint8_t index,
+                            bool success)
+{
+    if ((index >= discovery->count) || (false == discovery->present[index]))
+    {
+        return false;
+    }
+
+    if (success)
+    {
+        discovery->misses[index] = 0;
+        return false;
+    }
+
+    if (++discovery->misses[index] < SHT31_DISCOVERY_MAX_MISSES)
+    {
+        return false;
+    }
+
+    scan_bus(discovery, discovery->entries[index].bus);
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Stored table
+///////////////////////////////////////////////////////////////////////////////
+
+static bool load(sht31_discovery_t *discovery, const uint8_t *stored,
+                 uint16_t length)
+{
+    sht31_topology_entry_t entry;
+    const uint8_t *in = NULL;
+    uint8_t count     = 0;
+    uint16_t size     = 0;
+
+    if ((NULL == stored) || (length < SHT31_TOPOLOGY_SIZE(0)))
+    {
+        return false;
+    }
+
+    count = stored[3];
+    size  = SHT31_TOPOLOGY_SIZE(count);
+    if ((SHT31_TOPOLOGY_MAGIC != stored[0]) ||
+        (SHT31_TOPOLOGY_VERSION != stored[1]) ||
+        (discovery->bus_count != stored[2]) || (0 == count) ||
+        (count > SHT31_DISCOVERY_MAX_SENSORS) || (length < size) ||
+        (crc8_calculate(stored, size - 1) != stored[size - 1]))
+    {
+        return false;
+    }
+
+    // Check every entry before taking any.
+    for (in = &stored[SHT31_TOPOLOGY_HEADER_SIZE]; in < &stored[size - 1];
+         in += SHT31_TOPOLOGY_ENTRY_SIZE)
+    {
+        if ((in[0] >= discovery->bus_count) || (false == known_address(in[1])))
+        {
+            return false;
+        }
+    }
+
+    discovery->count = 0;
+    for (in = &stored[SHT31_TOPOLOGY_HEADER_SIZE]; in < &stored[size - 1];
+         in += SHT31_TOPOLOGY_ENTRY_SIZE)
+    {
+        entry.bus     = in[0];
+        entry.address = in[1];
+        entry.serial  = get_u32(&in[2]);
+        add_sensor(discovery, &entry);
+    }
+    return true;
+}
+
+uint8_t sht31_discovery_boot(sht31_discovery_t *discovery,
+                             const uint8_t *stored, uint16_t length)
+{
+    if (load(discovery, stored, length))
+    {
+        discovery->changed = false;
+        return discovery->count;
+    }
+
+    discovery->count   = 0;
+    discovery->changed = true;
+    return sht31_discovery_scan(discovery);
+}
+
+uint16_t sht31_discovery_save(sht31_discovery_t *discovery, uint8_t *buffer,
+                              uint16_t size)
+{
+    uint8_t *out    = &buffer[SHT31_TOPOLOGY_HEADER_SIZE];
+    uint8_t sensors = 0;
+    uint16_t length = 0;
+    uint8_t i       = 0;
+
+    for (i = 0; i < discovery->count; i++)
+    {
+        sensors += discovery->present[i] ? 1 : 0;
+    }
+
+    length = SHT31_TOPOLOGY_SIZE(sensors);
+    if (size < length)
+    {
+        return 0;
+    }
+
+    buffer[0] = SHT31_TOPOLOGY_MAGIC;
+    buffer[1] = SHT31_TOPOLOGY_VERSION;
+    buffer[2] = discovery->bus_count;
+    buffer[3] = sensors;
+
+    for (i = 0; i < discovery->count; i++)
+    {
+        if (false == discovery->present[i])
+        {
+            continue;
+        }
+        out[0] = discovery->entries[i].bus;
+        out[1] = discovery->entries[i].address;
+        put_u32(&out[2], discovery->entries[i].serial);
+        out += SHT31_TOPOLOGY_ENTRY_SIZE;
+    }
+    buffer[length - 1] = crc8_calculate(buffer, length - 1);
+
+    discovery->changed = false;
+    return length;
+}
+
+uint8_t sht31_discovery_count(const sht31_discovery_t *discovery)
+{
+    return discovery->count;
+}
+
+sht31_t *sht31_discovery_sensor(sht31_discovery_t *discovery, uint8_t index)
+{
+    if ((index >= discovery->count) || (false == discovery->present[index]))
+    {
+        return NULL;
+    }
+    return &discovery->sensors[index];
+}
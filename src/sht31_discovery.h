@@ -0,0 +1,156 @@
+/**
+ * @file    sht31_discovery.h
+ * @author  Steven Daglish
+ * @brief   Finds the SHT3x sensors on a set of buses and keeps the result as
+ *          a topology table that can be stored and loaded on the next boot.
+ * @version 0.1
+ * @date    17 October 2026
+ *
+ * A scan probes DEFAULT_ADDRESS and SHT_ALTERNATE_ADDRESS on each bus. A
+ * device only counts as a sensor if its status register reads back with a
+ * good CRC, and its serial number is read and kept with it.
+ *
+ * On a warm start a stored table is loaded instead and nothing is sent on
+ * any bus. The table is trusted until a sensor in it stops responding:
+ * after SHT31_DISCOVERY_MAX_MISSES failures in a row reported for it, its
+ * bus alone is scanned again.
+ *
+ * Each sensor has a slot, and its index and handle stay the same across
+ * rescans for as long as it keeps answering. A sensor that has gone leaves
+ * its slot empty and a new one takes the first empty slot. A handle that is
+ * waiting on a single shot conversion is not probed, as the sensor nacks
+ * everything until the conversion is done; it is kept as it is.
+ *
+ * Stored table, multi-byte values little endian:
+ *
+ *  magic           SHT31_TOPOLOGY_MAGIC
+ *  version         SHT31_TOPOLOGY_VERSION
+ *  bus count       Buses the table was made for
+ *  sensor count    1 to SHT31_DISCOVERY_MAX_SENSORS
+ *  entries         Per sensor: bus index, address, 32 bit serial number
+ *  crc             crc8_calculate() over everything before it
+ *
+ * Entries are in slot order, leaving out empty slots. A scan into an empty
+ * table fills the slots in bus, then address order.
+ */
+
+#ifndef _SHT31_DISCOVERY_H
+#define _SHT31_DISCOVERY_H
+
+#include "i2c_bus.h"
+#include "sht31_driver.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifndef SHT31_DISCOVERY_MAX_BUSES
+#define SHT31_DISCOVERY_MAX_BUSES 4
+#endif
+
+#ifndef SHT31_DISCOVERY_MAX_SENSORS
+#define SHT31_DISCOVERY_MAX_SENSORS 8
+#endif
+
+// Failed accesses in a row before a sensor's bus is scanned again.
+#define SHT31_DISCOVERY_MAX_MISSES 3
+
+#define SHT31_TOPOLOGY_MAGIC 0x5D
+#define SHT31_TOPOLOGY_VERSION 1
+#define SHT31_TOPOLOGY_HEADER_SIZE 4
+#define SHT31_TOPOLOGY_ENTRY_SIZE 6
+#define SHT31_TOPOLOGY_SIZE(count)                                             \
+    (SHT31_TOPOLOGY_HEADER_SIZE + (count) * SHT31_TOPOLOGY_ENTRY_SIZE + 1)
+
+typedef struct
+{
+    uint8_t bus; // Index into the buses given to sht31_discovery_init()
+    uint8_t address;
+    uint32_t serial;
+} sht31_topology_entry_t;
+
+typedef struct
+{
+    const i2c_bus_t *buses[SHT31_DISCOVERY_MAX_BUSES];
+    uint8_t bus_count;
+
+    sht31_topology_entry_t entries[SHT31_DISCOVERY_MAX_SENSORS];
+    sht31_t sensors[SHT31_DISCOVERY_MAX_SENSORS];
+    uint8_t misses[SHT31_DISCOVERY_MAX_SENSORS];
+    bool present[SHT31_DISCOVERY_MAX_SENSORS]; // Slot holds a sensor
+    uint8_t count; // Slots in use, empty ones included
+
+    bool changed;     // Table differs from what was last loaded or saved
+    uint16_t scans;   // Buses scanned since init
+    uint16_t dropped; // Sensors found with no room left in the table
+} sht31_discovery_t;
+
+/**
+ * @brief   Sets up discovery with an empty table. Nothing is sent.
+ *
+ * @param discovery
+ * @param buses     Array of bus_count buses; the pointers are copied
+ * @param bus_count 1 to SHT31_DISCOVERY_MAX_BUSES
+ * @return true
+ * @return false    bus_count out of range
+ */
+bool sht31_discovery_init(sht31_discovery_t *discovery,
+                          const i2c_bus_t *const *buses, uint8_t bus_count);
+
+/**
+ * @brief   Loads a stored table if it is intact, was made for the same
+ * number of buses and lists at least one sensor; otherwise scans every bus.
+ *
+ * @param discovery
+ * @param stored    As written by sht31_discovery_save(), or NULL on a cold
+ *                  start
+ * @param length    Bytes in stored
+ * @return uint8_t  Number of slots
+ */
+uint8_t sht31_discovery_boot(sht31_discovery_t *discovery,
+                             const uint8_t *stored, uint16_t length);
+
+/**
+ * @brief   Scans every bus and updates the table.
+ *
+ * @return uint8_t  Number of slots
+ */
+uint8_t sht31_discovery_scan(sht31_discovery_t *discovery);
+
+/**
+ * @brief   Records how an access to a sensor went. Once a sensor has missed
+ * SHT31_DISCOVERY_MAX_MISSES times in a row its bus is scanned again. Only
+ * the slots of sensors that have gone, appeared or been replaced change.
+ *
+ * @param discovery
+ * @param index     Slot index
+ * @param success
+ * @return true     The bus was scanned again; check changed
+ * @return false
+ */
+bool sht31_discovery_report(sht31_discovery_t *discovery, uint8_t index,
+                            bool success);
+
+/**
+ * @brief   Writes the table for the next boot and clears changed.
+ *
+ * @param discovery
+ * @param buffer
+ * @param size
+ * @return uint16_t Bytes written, SHT31_TOPOLOGY_SIZE(count), or 0 if
+ *                  buffer is too small
+ */
+uint16_t sht31_discovery_save(sht31_discovery_t *discovery, uint8_t *buffer,
+                              uint16_t size);
+
+/**
+ * @brief   Number of slots. Empty slots below it are included.
+ */
+uint8_t sht31_discovery_count(const sht31_discovery_t *discovery);
+
+/**
+ * @brief   Handle for a sensor in the table, ready to use.
+ *
+ * @return sht31_t* NULL if index is out of range or the slot is empty
+ */
+sht31_t *sht31_discovery_sensor(sht31_discovery_t *discovery, uint8_t index);
+
+#endif // _SHT31_DISCOVERY_H
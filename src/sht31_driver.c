@@ -1,314 +1,1052 @@
 #include "sht31_driver.h"
+#include "crc8.h"
+#include <stddef.h>
 
+// Repeatability indexes are 0 = low, 1 = medium, 2 = high throughout.
 static const uint8_t periodic_mode_msb[5]    = {0x20, 0x21, 0x22, 0x23, 0x27};
-static const uint8_t periodic_mode_lsb[5][3] = {{0x32, 0x24, 0x2F},
-                                                {0x30, 0x26, 0x2D},
-                                                {0x36, 0x20, 0x2B},
-                                                {0x34, 0x22, 0x29},
-                                                {0x37, 0x21, 0x2A}};
+static const uint8_t periodic_mode_lsb[5][3] = {{0x2F, 0x24, 0x32},
+                                                {0x2D, 0x26, 0x30},
+                                                {0x2B, 0x20, 0x36},
+                                                {0x29, 0x22, 0x34},
+                                                {0x2A, 0x21, 0x37}};
 
-static uint16_t temperature     = 0;
-static uint16_t humidity        = 0;
-static uint16_t status_register = 0;
+// Indexed by [clock_stretch][repeatability].
+static const uint16_t single_shot_command[2][3] = {
+    {SHT_SINGLE_SHOT_MODE_LOW, SHT_SINGLE_SHOT_MODE_MEDIUM,
+     SHT_SINGLE_SHOT_MODE_HIGH},
+    {SHT_SINGLE_SHOT_MODE_LOW_CLOCK_STRETCH,
+     SHT_SINGLE_SHOT_MODE_MEDIUM_CLOCK_STRETCH,
+     SHT_SINGLE_SHOT_MODE_HIGH_CLOCK_STRETCH}};
+static const uint8_t single_shot_duration[3] = {
+    SHT_DURATION_LOW_MS, SHT_DURATION_MEDIUM_MS, SHT_DURATION_HIGH_MS};
 
-static bool send_address_write(void)
+// Indexed by sht31_alert_limit_t.
+static const uint16_t alert_write_command[SHT31_ALERT_LIMITS] = {
+    SHT_ALERT_WRITE_HIGH_SET, SHT_ALERT_WRITE_HIGH_CLEAR,
+    SHT_ALERT_WRITE_LOW_CLEAR, SHT_ALERT_WRITE_LOW_SET};
+static const uint16_t alert_read_command[SHT31_ALERT_LIMITS] = {
+    SHT_ALERT_READ_HIGH_SET, SHT_ALERT_READ_HIGH_CLEAR,
+    SHT_ALERT_READ_LOW_CLEAR, SHT_ALERT_READ_LOW_SET};
+
+#define MEASUREMENT_WORDS 2
+#define MEASUREMENT_FRAME_SIZE SHT_MEASUREMENT_FRAME_SIZE
+
+static sht31_t default_sensor = {
+    .bus     = &i2c_driver_bus,
+    .address = DEFAULT_ADDRESS,
+};
+
+static sht31_clock_t clock_ms;
+
+#ifdef SHT31_ENABLE_STATS
+static sht31_stats_clock_t stats_clock;
+
+#define STATS_ADD(sensor, counter, n) ((sensor)->stats.counter += (n))
+#define STATS_NOW() ((NULL != stats_clock) ? stats_clock() : 0)
+#define STATS_CALL_BEGIN() uint32_t stats_started = STATS_NOW()
+#define STATS_CALL_END(sensor, call)                                          \
+    do                                                                        \
+    {                                                                         \
+        (sensor)->stats.calls[call]++;                                        \
+        (sensor)->stats.call_ticks[call] += STATS_NOW() - stats_started;      \
+    } while (0)
+#else
+#define STATS_ADD(sensor, counter, n)
+#define STATS_CALL_BEGIN()
+#define STATS_CALL_END(sensor, call)
+#endif
+
+static void bus_start(sht31_t *sensor)
 {
-    bool ack = i2c_driver_send_address_write(DEFAULT_ADDRESS);
-    return ack;
+    STATS_ADD(sensor, starts, 1);
+    sensor->bus->start(sensor->bus->context);
 }
 
-static bool send_address_read(void)
+static void bus_stop(sht31_t *sensor)
 {
-    bool ack = i2c_driver_send_address_read(DEFAULT_ADDRESS);
-    return ack;
+    sensor->bus->stop(sensor->bus->context);
 }
 
-static bool send_data(uint8_t data)
+static bool check_ack(sht31_t *sensor, bool ack)
 {
-    bool ack = i2c_driver_send_data(data);
+    if (false == ack)
+    {
+        STATS_ADD(sensor, nacks, 1);
+        sensor->errors.nack++;
+    }
     return ack;
 }
 
-static bool send_16_bit_data(uint16_t data)
+static bool send_address_write(sht31_t *sensor)
+{
+    STATS_ADD(sensor, bytes_written, 1);
+    bool ack = sensor->bus->send_address_write(sensor->bus->context,
+                                               sensor->address);
+    return check_ack(sensor, ack);
+}
+
+static bool send_address_read(sht31_t *sensor)
+{
+    STATS_ADD(sensor, bytes_written, 1);
+    bool ack = sensor->bus->send_address_read(sensor->bus->context,
+                                              sensor->address);
+    return check_ack(sensor, ack);
+}
+
+static bool write_block(sht31_t *sensor, const uint8_t *data, uint8_t length)
+{
+    STATS_ADD(sensor, bytes_written, length);
+    bool ack = sensor->bus->write_block(sensor->bus->context, data, length);
+    return check_ack(sensor, ack);
+}
+
+static bool read_block(sht31_t *sensor, uint8_t *data, uint8_t length)
+{
+    STATS_ADD(sensor, bytes_read, length);
+    return sensor->bus->read_block(sensor->bus->context, data, length);
+}
+
+static void put_word(uint8_t *out, uint16_t word)
+{
+    out[0] = word >> 8;
+    out[1] = word & 0x00FF;
+}
+
+static uint8_t calculate_crc(uint16_t value)
 {
-    if (false == send_data(data >> 8))
+    return crc8_word(value);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Transactions
+//
+// Everything the driver sends is one of four transactions, each running from
+// a START to exactly one STOP whether or not the device acks:
+//
+//  write_command   S addr+W cmd P
+//  write_word      S addr+W cmd word crc P
+//  write_then_read S addr+W cmd Sr addr+R data P
+//  read_only       S addr+R data P
+//
+// Fetch and status reads are answered straight after a repeated START. Single
+// shot commands only start converting once the STOP is seen, so they are a
+// write_command followed by a separate read_only.
+//
+// The bytes after the address go out in one write_block. Buses that provide
+// transfer run each transaction in one call.
+///////////////////////////////////////////////////////////////////////////////
+
+static bool bus_transfer(sht31_t *sensor, const uint16_t *command,
+                         uint8_t *data, uint8_t length)
+{
+    uint8_t write[2];
+    uint8_t write_length = 0;
+
+    if (NULL != command)
     {
-        return false;
+        put_word(write, *command);
+        write_length = sizeof(write);
+        STATS_ADD(sensor, starts, 1);
+        STATS_ADD(sensor, bytes_written, 1 + write_length);
     }
-
-    if (false == send_data(data &= 0x00FF))
+    if (length > 0)
     {
-        return false;
+        STATS_ADD(sensor, starts, 1);
+        STATS_ADD(sensor, bytes_written, 1);
+        STATS_ADD(sensor, bytes_read, length);
     }
-    return true;
+
+    return sensor->bus->transfer(sensor->bus->context, sensor->address, write,
+                                 write_length, data, length);
 }
 
-static bool start_send_address_then_16_bit_command(uint16_t command)
+static bool transaction(sht31_t *sensor, const uint16_t *command,
+                        uint8_t *data, uint8_t length)
 {
-    i2c_driver_start();
+    bool success = true;
 
-    if (false == send_address_write())
+    if (NULL != sensor->bus->transfer)
     {
-        return false;
+        return check_ack(sensor, bus_transfer(sensor, command, data, length));
     }
 
-    if (false == send_16_bit_data(command))
+    bus_start(sensor);
+
+    if (NULL != command)
     {
-        return false;
+        uint8_t write[2];
+
+        put_word(write, *command);
+        success = send_address_write(sensor) &&
+                  write_block(sensor, write, sizeof(write));
+
+        if (success && (length > 0))
+        {
+            bus_start(sensor);
+        }
     }
 
-    return true;
+    if (success && (length > 0))
+    {
+        success = send_address_read(sensor) &&
+                  read_block(sensor, data, length);
+    }
+
+    bus_stop(sensor);
+
+    return success;
 }
 
-static bool start_send_address_read()
+static bool write_command(sht31_t *sensor, uint16_t command)
 {
-    i2c_driver_start();
-    if (false == send_address_read())
+    return transaction(sensor, &command, NULL, 0);
+}
+
+static bool write_word(sht31_t *sensor, uint16_t command, uint16_t word)
+{
+    uint8_t write[4 + 1];
+    bool success = false;
+
+    put_word(&write[0], command);
+    put_word(&write[2], word);
+    write[4] = calculate_crc(word);
+
+    if (NULL != sensor->bus->transfer)
     {
-        return false;
+        STATS_ADD(sensor, starts, 1);
+        STATS_ADD(sensor, bytes_written, 1 + sizeof(write));
+        return check_ack(sensor,
+                         sensor->bus->transfer(sensor->bus->context,
+                                               sensor->address, write,
+                                               sizeof(write), NULL, 0));
     }
-    return true;
+
+    bus_start(sensor);
+    success = send_address_write(sensor) &&
+              write_block(sensor, write, sizeof(write));
+    bus_stop(sensor);
+
+    return success;
 }
 
-// TODO: Refactor to improve efficiency and readability
-static uint8_t calculate_crc(uint16_t value)
+static bool write_then_read(sht31_t *sensor, uint16_t command, uint8_t *data,
+                            uint8_t length)
 {
-    /*
-     *
-     * CRC-8 formula from page 14 of SHT spec pdf
-     *
-     * Test data 0xBE, 0xEF should yield 0x92
-     *
-     * Initialization data 0xFF
-     * Polynomial 0x31 (x8 + x5 + x4 + 1)
-     * Final XOR 0x00
-     */
-
-    // const uint8_t len = 2;
-    const uint8_t POLYNOMIAL = 0x31;
-    uint8_t data             = 0;
-    uint8_t crc              = 0xFF;
-    uint8_t i                = 0;
+    return transaction(sensor, &command, data, length);
+}
 
-    data = value >> 8;
-    crc ^= data;
+static bool read_only(sht31_t *sensor, uint8_t *data, uint8_t length)
+{
+    return transaction(sensor, NULL, data, length);
+}
 
-    for (i = 8; i; --i)
+/*
+ * Whether a poll_read that started at started_ms and has made polls attempts
+ * has run out of time. Elapsed time counts once it has gone past limit_ms, as
+ * the clock only ticks in whole milliseconds.
+ */
+static bool polling_expired(uint32_t limit_ms, uint32_t started_ms,
+                            uint32_t polls)
+{
+    if (NULL != clock_ms)
     {
-        crc = (crc & 0x80) ? (crc << 1) ^ POLYNOMIAL : (crc << 1);
+        return (uint32_t)(clock_ms() - started_ms) > limit_ms;
     }
+    return polls >= limit_ms * SHT_SINGLE_SHOT_POLLS_PER_MS;
+}
 
-    data = value & 0x00FF;
-    crc ^= data;
+/*
+ * read_only for a single shot without clock stretching. The sensor nacks the
+ * read header until the conversion is done; those nacks are expected so are
+ * not counted as errors, and each attempt is its own START to STOP.
+ */
+static bool poll_read(sht31_t *sensor, uint8_t repeatability, uint8_t *data,
+                      uint8_t length)
+{
+    uint32_t limit_ms =
+        single_shot_duration[repeatability] + SHT_SINGLE_SHOT_POLL_MARGIN_MS;
+    uint32_t started_ms = (NULL != clock_ms) ? clock_ms() : 0;
+    uint32_t polls      = 0;
 
-    for (i = 8; i; --i)
+    for (polls = 0; false == polling_expired(limit_ms, started_ms, polls);
+         polls++)
     {
-        crc = (crc & 0x80) ? (crc << 1) ^ POLYNOMIAL : (crc << 1);
+        if (polls > 0)
+        {
+            STATS_ADD(sensor, retries, 1);
+        }
+
+        if (NULL != sensor->bus->transfer)
+        {
+            if (bus_transfer(sensor, NULL, data, length))
+            {
+                return true;
+            }
+            STATS_ADD(sensor, nacks, 1);
+            continue;
+        }
+
+        bus_start(sensor);
+        STATS_ADD(sensor, bytes_written, 1);
+        if (sensor->bus->send_address_read(sensor->bus->context,
+                                           sensor->address))
+        {
+            bool success = read_block(sensor, data, length);
+            bus_stop(sensor);
+            return success;
+        }
+        STATS_ADD(sensor, nacks, 1);
+        bus_stop(sensor);
     }
-    return crc;
+
+    sensor->errors.nack++;
+    return false;
 }
 
-void sht30_driver_create(void)
+/*
+ * Stores a whole measurement (temperature word, CRC, humidity word, CRC) and
+ * checks both CRCs.
+ */
+static bool store_measurement(sht31_t *sensor, const uint8_t *frame)
 {
-    i2c_driver_create();
+    sensor->temperature = ((uint16_t)frame[0] << 8) | frame[1];
+    sensor->humidity    = ((uint16_t)frame[3] << 8) | frame[4];
+
+    if (MEASUREMENT_WORDS != crc8_buffer(frame, MEASUREMENT_WORDS))
+    {
+        STATS_ADD(sensor, crc_failures, 1);
+        sensor->errors.crc++;
+        return false;
+    }
+    return true;
 }
 
-bool sht30_driver_send_soft_reset(void)
+/*
+ * Decodes a measurement frame, or a failed read when frame is NULL, into
+ * sample. Each word is checked on its own.
+ */
+static bool store_sample(sht31_t *sensor, const uint8_t *frame,
+                         uint32_t now_ms, sht31_sample_t *sample)
 {
-    i2c_driver_start();
+    sample->timestamp_ms    = now_ms;
+    sample->sequence        = sensor->sequence++;
+    sample->flags           = 0;
+    sample->temperature     = 0;
+    sample->humidity        = 0;
+    sample->status_register = 0;
 
-    if (false == send_address_write())
+    if (NULL == frame)
     {
         return false;
     }
 
-    if (false == send_16_bit_data(SOFT_RESET))
+    sample->temperature = ((uint16_t)frame[0] << 8) | frame[1];
+    sample->humidity    = ((uint16_t)frame[3] << 8) | frame[4];
+
+    if (1 == crc8_buffer(frame, 1))
+    {
+        sample->flags |= SHT31_SAMPLE_TEMPERATURE_VALID;
+    }
+    if (1 == crc8_buffer(&frame[CRC8_WORD_SIZE], 1))
+    {
+        sample->flags |= SHT31_SAMPLE_HUMIDITY_VALID;
+    }
+
+    if (SHT31_SAMPLE_MEASUREMENT_VALID != sample->flags)
     {
+        STATS_ADD(sensor, crc_failures, 1);
+        sensor->errors.crc++;
         return false;
     }
+    return true;
+}
 
-    i2c_driver_stop();
+///////////////////////////////////////////////////////////////////////////////
+// Sensor handle API
+///////////////////////////////////////////////////////////////////////////////
 
-    return true;
+void sht31_init(sht31_t *sensor, const i2c_bus_t *bus, uint8_t address)
+{
+    sensor->bus             = bus;
+    sensor->address         = address;
+    sensor->temperature     = 0;
+    sensor->humidity        = 0;
+    sensor->status_register = 0;
+    sensor->errors.nack     = 0;
+    sensor->errors.crc      = 0;
+    sensor->measuring       = false;
+    sensor->ready_at_ms     = 0;
+    sensor->sequence        = 0;
+#ifdef SHT31_ENABLE_STATS
+    sht31_stats_reset(sensor);
+#endif
 }
 
-bool sht30_driver_send_periodic_data_aquisition_mode(uint8_t repeatability,
-                                                     uint8_t mps)
+static bool send_soft_reset(sht31_t *sensor)
+{
+    return write_command(sensor, SOFT_RESET);
+}
+
+bool sht31_send_soft_reset(sht31_t *sensor)
 {
-    i2c_driver_start();
+    STATS_CALL_BEGIN();
+    bool success = send_soft_reset(sensor);
+    STATS_CALL_END(sensor, SHT31_CALL_SOFT_RESET);
+    return success;
+}
+
+static bool send_periodic_data_acquisition_mode(sht31_t *sensor,
+                                                uint8_t repeatability,
+                                                uint8_t mps)
+{
+    uint16_t command = ((uint16_t)periodic_mode_msb[mps] << 8) |
+                       periodic_mode_lsb[mps][repeatability];
+
+    return write_command(sensor, command);
+}
 
-    if (false == send_address_write())
+bool sht31_send_periodic_data_acquisition_mode(sht31_t *sensor,
+                                               uint8_t repeatability,
+                                               uint8_t mps)
+{
+    STATS_CALL_BEGIN();
+    bool success =
+        send_periodic_data_acquisition_mode(sensor, repeatability, mps);
+    STATS_CALL_END(sensor, SHT31_CALL_PERIODIC_MODE);
+    return success;
+}
+
+static bool fetch_periodic_data(sht31_t *sensor)
+{
+    uint8_t frame[MEASUREMENT_FRAME_SIZE];
+
+    if (false == write_then_read(sensor, FETCH_DATA, frame,
+                                 MEASUREMENT_FRAME_SIZE))
     {
         return false;
     }
-    if (false == send_data(periodic_mode_msb[mps]))
+    return store_measurement(sensor, frame);
+}
+
+bool sht31_fetch_periodic_data(sht31_t *sensor)
+{
+    STATS_CALL_BEGIN();
+    bool success = fetch_periodic_data(sensor);
+    STATS_CALL_END(sensor, SHT31_CALL_FETCH);
+    return success;
+}
+
+static bool fetch_sample(sht31_t *sensor, uint32_t now_ms,
+                         sht31_sample_t *sample)
+{
+    uint8_t frame[MEASUREMENT_FRAME_SIZE];
+
+    if (false == write_then_read(sensor, FETCH_DATA, frame,
+                                 MEASUREMENT_FRAME_SIZE))
     {
-        return false;
+        return store_sample(sensor, NULL, now_ms, sample);
     }
-    if (false == send_data(periodic_mode_lsb[mps][repeatability]))
+    return store_sample(sensor, frame, now_ms, sample);
+}
+
+bool sht31_fetch_sample(sht31_t *sensor, uint32_t now_ms,
+                        sht31_sample_t *sample)
+{
+    STATS_CALL_BEGIN();
+    bool success = fetch_sample(sensor, now_ms, sample);
+    STATS_CALL_END(sensor, SHT31_CALL_FETCH);
+    return success;
+}
+
+uint8_t sht31_fetch_samples(sht31_t *sensors, uint8_t count, uint32_t now_ms,
+                            sht31_sample_t *samples)
+{
+    uint8_t valid = 0;
+    uint8_t i     = 0;
+
+    for (i = 0; i < count; i++)
+    {
+        if (sht31_fetch_sample(&sensors[i], now_ms, &samples[i]))
+        {
+            valid++;
+        }
+    }
+    return valid;
+}
+
+uint16_t sht31_return_temperature(const sht31_t *sensor)
+{
+    return sensor->temperature;
+}
+
+uint16_t sht31_return_humidity(const sht31_t *sensor)
+{
+    return sensor->humidity;
+}
+
+/*
+ * Reads one CRC protected word. value is left alone unless the CRC matches.
+ */
+static bool read_word(sht31_t *sensor, uint16_t command, uint16_t *value)
+{
+    uint8_t word[CRC8_WORD_SIZE];
+
+    if (false == write_then_read(sensor, command, word, CRC8_WORD_SIZE))
     {
         return false;
     }
 
-    i2c_driver_stop();
+    if (1 != crc8_buffer(word, 1))
+    {
+        STATS_ADD(sensor, crc_failures, 1);
+        sensor->errors.crc++;
+        return false;
+    }
 
+    *value = ((uint16_t)word[0] << 8) | word[1];
     return true;
 }
 
-bool sht30_driver_fetch_periodic_data(void)
+static bool read_status_register(sht31_t *sensor)
+{
+    return read_word(sensor, READ_STATUS_ADDRESS, &sensor->status_register);
+}
+
+bool sht31_read_status_register(sht31_t *sensor)
+{
+    STATS_CALL_BEGIN();
+    bool success = read_status_register(sensor);
+    STATS_CALL_END(sensor, SHT31_CALL_READ_STATUS);
+    return success;
+}
+
+uint16_t sht31_return_status_register(const sht31_t *sensor)
 {
-    if (false == start_send_address_then_16_bit_command(FETCH_DATA))
+    return sensor->status_register;
+}
+
+static bool read_status_sample(sht31_t *sensor, sht31_sample_t *sample)
+{
+    if (false ==
+        read_word(sensor, READ_STATUS_ADDRESS, &sample->status_register))
     {
         return false;
     }
 
-    i2c_driver_start();
-    if (false == i2c_driver_send_address_read(DEFAULT_ADDRESS))
+    sample->flags |= SHT31_SAMPLE_STATUS_VALID;
+    return true;
+}
+
+bool sht31_read_status_sample(sht31_t *sensor, sht31_sample_t *sample)
+{
+    STATS_CALL_BEGIN();
+    bool success = read_status_sample(sensor, sample);
+    STATS_CALL_END(sensor, SHT31_CALL_READ_STATUS);
+    return success;
+}
+
+bool sht31_read_status(sht31_t *sensor, sht31_status_t *status)
+{
+    if (false == sht31_read_status_register(sensor))
     {
-        i2c_driver_stop();
         return false;
     }
 
-    // TODO: the =0 below can probably be removed
-    temperature = 0;
-    temperature = (i2c_driver_read_data(true) << 8);
-    temperature |= i2c_driver_read_data(true);
+    *status = sht31_decode_status(sensor->status_register);
+    return true;
+}
+
+sht31_status_t sht31_decode_status(uint16_t status_register)
+{
+    sht31_status_t status = {
+        .alert_pending = 0 != (status_register & SHT_STATUS_ALERT_PENDING),
+        .heater_on     = 0 != (status_register & SHT_STATUS_HEATER_ON),
+        .humidity_alert =
+            0 != (status_register & SHT_STATUS_HUMIDITY_ALERT),
+        .temperature_alert =
+            0 != (status_register & SHT_STATUS_TEMPERATURE_ALERT),
+        .reset_detected =
+            0 != (status_register & SHT_STATUS_RESET_DETECTED),
+        .command_failed =
+            0 != (status_register & SHT_STATUS_COMMAND_FAILED),
+        .write_checksum_failed =
+            0 != (status_register & SHT_STATUS_WRITE_CHECKSUM_FAILED),
+    };
+
+    return status;
+}
+
+uint16_t sht31_alert_limit_pack(uint16_t temperature, uint16_t humidity)
+{
+    return (humidity & 0xFE00) | (temperature >> 7);
+}
+
+void sht31_alert_limit_unpack(uint16_t limit, uint16_t *temperature,
+                              uint16_t *humidity)
+{
+    *temperature = (uint16_t)(limit << 7);
+    *humidity    = limit & 0xFE00;
+}
 
-    uint8_t crc            = i2c_driver_read_data(true);
-    uint8_t crc_calculated = calculate_crc(temperature);
+bool sht31_write_alert_limit(sht31_t *sensor, sht31_alert_limit_t limit,
+                             uint16_t temperature, uint16_t humidity)
+{
+    STATS_CALL_BEGIN();
+    bool success = false;
 
-    if (crc != crc_calculated)
+    if (limit < SHT31_ALERT_LIMITS)
     {
-        return false;
+        success = write_word(sensor, alert_write_command[limit],
+                             sht31_alert_limit_pack(temperature, humidity));
+    }
+    STATS_CALL_END(sensor, SHT31_CALL_WRITE_ALERT_LIMIT);
+    return success;
+}
+
+bool sht31_read_alert_limit(sht31_t *sensor, sht31_alert_limit_t limit,
+                            uint16_t *temperature, uint16_t *humidity)
+{
+    STATS_CALL_BEGIN();
+    uint16_t packed = 0;
+    bool success    = false;
+
+    if ((limit < SHT31_ALERT_LIMITS) &&
+        read_word(sensor, alert_read_command[limit], &packed))
+    {
+        sht31_alert_limit_unpack(packed, temperature, humidity);
+        success = true;
     }
+    STATS_CALL_END(sensor, SHT31_CALL_READ_ALERT_LIMIT);
+    return success;
+}
+
+static bool clear_status_register(sht31_t *sensor)
+{
+    return write_command(sensor, CLEAR_STATUS_ADDRESS);
+}
+
+bool sht31_clear_status_register(sht31_t *sensor)
+{
+    STATS_CALL_BEGIN();
+    bool success = clear_status_register(sensor);
+    STATS_CALL_END(sensor, SHT31_CALL_CLEAR_STATUS);
+    return success;
+}
+
+static bool break_command(sht31_t *sensor)
+{
+    return write_command(sensor, BREAK_COMMAND_ADDRESS);
+}
+
+bool sht31_break_command(sht31_t *sensor)
+{
+    STATS_CALL_BEGIN();
+    bool success = break_command(sensor);
+    STATS_CALL_END(sensor, SHT31_CALL_BREAK);
+    return success;
+}
+
+static bool send_art_command(sht31_t *sensor)
+{
+    return write_command(sensor, ART_COMMAND_ADDRESS);
+}
+
+bool sht31_send_art_command(sht31_t *sensor)
+{
+    STATS_CALL_BEGIN();
+    bool success = send_art_command(sensor);
+    STATS_CALL_END(sensor, SHT31_CALL_ART);
+    return success;
+}
+
+static bool set_heater(sht31_t *sensor, bool enable)
+{
+    return write_command(sensor, enable ? HEATER_ENABLE_ADDRESS
+                                        : HEATER_DISABLE_ADDRESS);
+}
 
-    // TODO: the =0 below can probably be removed
-    humidity = 0;
-    humidity = (i2c_driver_read_data(true) << 8);
-    humidity |= i2c_driver_read_data(true);
+bool sht31_set_heater(sht31_t *sensor, bool enable)
+{
+    STATS_CALL_BEGIN();
+    bool success = set_heater(sensor, enable);
+    STATS_CALL_END(sensor, SHT31_CALL_HEATER);
+    return success;
+}
 
-    crc            = i2c_driver_read_data(false);
-    crc_calculated = calculate_crc(humidity);
+static bool read_serial_number(sht31_t *sensor, uint32_t *serial)
+{
+    uint8_t frame[2 * CRC8_WORD_SIZE];
+    uint16_t high = 0;
+    uint16_t low  = 0;
 
-    if (crc != crc_calculated)
+    if (false == write_then_read(sensor, SHT_READ_SERIAL_NUMBER, frame,
+                                 sizeof(frame)))
     {
-        i2c_driver_stop();
         return false;
     }
 
-    i2c_driver_stop();
+    high = ((uint16_t)frame[0] << 8) | frame[1];
+    low  = ((uint16_t)frame[3] << 8) | frame[4];
+    if ((calculate_crc(high) != frame[2]) || (calculate_crc(low) != frame[5]))
+    {
+        STATS_ADD(sensor, crc_failures, 1);
+        sensor->errors.crc++;
+        return false;
+    }
 
+    *serial = ((uint32_t)high << 16) | low;
     return true;
 }
 
-uint16_t sht30_driver_return_temperature(void)
+bool sht31_read_serial_number(sht31_t *sensor, uint32_t *serial)
 {
-    return temperature;
+    STATS_CALL_BEGIN();
+    bool success = read_serial_number(sensor, serial);
+    STATS_CALL_END(sensor, SHT31_CALL_READ_SERIAL);
+    return success;
 }
 
-uint16_t sht30_driver_return_humidity(void)
+bool sht31_get_single_shot_data(sht31_t *sensor)
 {
-    return humidity;
+    return sht31_get_single_shot_data_in_mode(sensor, SHT_REPEATABILITY_HIGH,
+                                              true);
 }
 
-bool sht30_driver_read_status_register(void)
+static bool get_single_shot_data_in_mode(sht31_t *sensor,
+                                         uint8_t repeatability,
+                                         bool clock_stretch)
 {
-    if (false == start_send_address_then_16_bit_command(READ_STATUS_ADDRESS))
+    uint16_t command = single_shot_command[clock_stretch][repeatability];
+    uint8_t frame[MEASUREMENT_FRAME_SIZE];
+    bool success = false;
+
+    if (false == write_command(sensor, command))
     {
-        i2c_driver_stop();
         return false;
     }
 
-    if (false == start_send_address_read())
+    if (clock_stretch)
+    {
+        success = read_only(sensor, frame, MEASUREMENT_FRAME_SIZE);
+    }
+    else
+    {
+        success = poll_read(sensor, repeatability, frame,
+                            MEASUREMENT_FRAME_SIZE);
+    }
+
+    if (false == success)
     {
-        i2c_driver_stop();
         return false;
     }
+    return store_measurement(sensor, frame);
+}
 
-    // TODO: the =0 below can probably be removed
-    status_register = 0;
-    status_register = (i2c_driver_read_data(true) << 8);
-    status_register |= i2c_driver_read_data(true);
+bool sht31_get_single_shot_data_in_mode(sht31_t *sensor,
+                                        uint8_t repeatability,
+                                        bool clock_stretch)
+{
+    STATS_CALL_BEGIN();
+    bool success =
+        get_single_shot_data_in_mode(sensor, repeatability, clock_stretch);
+    STATS_CALL_END(sensor, SHT31_CALL_SINGLE_SHOT);
+    return success;
+}
 
-    uint8_t crc            = i2c_driver_read_data(false);
-    uint8_t crc_calculated = calculate_crc(temperature);
+void sht31_set_clock(sht31_clock_t clock)
+{
+    clock_ms = clock;
+}
 
-    if (crc != crc_calculated)
+uint8_t sht31_single_shot_duration_ms(uint8_t repeatability)
+{
+    return single_shot_duration[repeatability];
+}
+
+uint32_t sht31_result_ready_ms(uint8_t repeatability, uint32_t started_ms)
+{
+    return started_ms + single_shot_duration[repeatability] +
+           SHT_CLOCK_RESOLUTION_MS;
+}
+
+static bool begin_measurement(sht31_t *sensor, uint8_t repeatability,
+                              uint32_t now_ms)
+{
+    if (sensor->measuring)
+    {
+        return false;
+    }
+
+    if (false ==
+        write_command(sensor, single_shot_command[false][repeatability]))
     {
-        i2c_driver_stop();
         return false;
     }
 
-    i2c_driver_stop();
+    sensor->measuring   = true;
+    sensor->ready_at_ms = sht31_result_ready_ms(repeatability, now_ms);
 
     return true;
 }
 
-uint16_t sht30_driver_return_status_register(void)
+bool sht31_begin_measurement(sht31_t *sensor, uint8_t repeatability,
+                             uint32_t now_ms)
 {
-    return status_register;
+    STATS_CALL_BEGIN();
+    bool success = begin_measurement(sensor, repeatability, now_ms);
+    STATS_CALL_END(sensor, SHT31_CALL_BEGIN_MEASUREMENT);
+    return success;
 }
 
-bool sht30_driver_clear_status_register(void)
+/*
+ * Reads the result into frame once it is due.
+ */
+static sht31_poll_t poll_frame(sht31_t *sensor, uint32_t now_ms,
+                               uint8_t *frame)
 {
-    if (false == start_send_address_then_16_bit_command(CLEAR_STATUS_ADDRESS))
+    if (false == sensor->measuring)
     {
-        i2c_driver_stop();
-        return false;
+        return SHT31_POLL_IDLE;
     }
-    i2c_driver_stop();
-    return true;
+
+    // Signed difference so the check survives the millisecond counter
+    // wrapping.
+    if ((int32_t)(now_ms - sensor->ready_at_ms) < 0)
+    {
+        return SHT31_POLL_BUSY;
+    }
+
+    sensor->measuring = false;
+
+    return read_only(sensor, frame, MEASUREMENT_FRAME_SIZE) ? SHT31_POLL_DONE
+                                                            : SHT31_POLL_ERROR;
 }
 
-bool sht30_driver_break_command(void)
+static sht31_poll_t poll_measurement(sht31_t *sensor, uint32_t now_ms)
 {
-    if (false == start_send_address_then_16_bit_command(BREAK_COMMAND_ADDRESS))
+    uint8_t frame[MEASUREMENT_FRAME_SIZE];
+    sht31_poll_t result = poll_frame(sensor, now_ms, frame);
+
+    if (SHT31_POLL_DONE != result)
     {
-        i2c_driver_stop();
-        return false;
+        return result;
     }
-    i2c_driver_stop();
-    return true;
+
+    return store_measurement(sensor, frame) ? SHT31_POLL_DONE
+                                            : SHT31_POLL_ERROR;
 }
 
-// TODO Add the capability to get different single shot mode types 
-bool sht30_driver_get_single_shot_data(void)
+sht31_poll_t sht31_poll(sht31_t *sensor, uint32_t now_ms)
+{
+    STATS_CALL_BEGIN();
+    sht31_poll_t result = poll_measurement(sensor, now_ms);
+    STATS_CALL_END(sensor, SHT31_CALL_POLL);
+    return result;
+}
+
+static sht31_poll_t poll_sample(sht31_t *sensor, uint32_t now_ms,
+                                sht31_sample_t *sample)
+{
+    uint8_t frame[MEASUREMENT_FRAME_SIZE];
+    sht31_poll_t result = poll_frame(sensor, now_ms, frame);
+
+    if (SHT31_POLL_DONE == result)
+    {
+        return store_sample(sensor, frame, now_ms, sample) ? SHT31_POLL_DONE
+                                                           : SHT31_POLL_ERROR;
+    }
+    if (SHT31_POLL_ERROR == result)
+    {
+        store_sample(sensor, NULL, now_ms, sample);
+    }
+    return result;
+}
+
+sht31_poll_t sht31_poll_sample(sht31_t *sensor, uint32_t now_ms,
+                               sht31_sample_t *sample)
 {
-    start_send_address_then_16_bit_command(SHT_SINGLE_SHOT_MODE_HIGH_CLOCK_STRETCH);
-    i2c_driver_stop();
-    start_send_address_read();
+    STATS_CALL_BEGIN();
+    sht31_poll_t result = poll_sample(sensor, now_ms, sample);
+    STATS_CALL_END(sensor, SHT31_CALL_POLL);
+    return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Asynchronous API
+///////////////////////////////////////////////////////////////////////////////
 
-    // TODO: the =0 below can probably be removed
-    temperature = 0;
-    temperature = (i2c_driver_read_data(true) << 8);
-    temperature |= i2c_driver_read_data(true);
+void sht31_async_init(sht31_async_t *request, sht31_t *sensor,
+                      const i2c_async_bus_t *bus,
+                      sht31_async_callback_t callback, void *context)
+{
+    request->sensor   = sensor;
+    request->bus      = bus;
+    request->callback = callback;
+    request->context  = context;
+    request->busy     = false;
+}
 
-    uint8_t crc            = i2c_driver_read_data(true);
-    uint8_t crc_calculated = calculate_crc(temperature);
+/*
+ * Runs in interrupt context.
+ */
+static void fetch_done(i2c_async_transfer_t *transfer,
+                       i2c_async_result_t result)
+{
+    sht31_async_t *request = transfer->context;
+    sht31_t *sensor        = request->sensor;
+    bool success           = false;
 
-    if (crc != crc_calculated)
+    if (I2C_ASYNC_OK == result)
     {
-        i2c_driver_stop();
-        return false;
-//        return false;
+        success = store_measurement(sensor, request->frame);
+    }
+    else if (I2C_ASYNC_NACK == result)
+    {
+        STATS_ADD(sensor, nacks, 1);
+        sensor->errors.nack++;
     }
 
-    // TODO: the =0 below can probably be removed
-    humidity = 0;
-    humidity = (i2c_driver_read_data(true) << 8);
-    humidity |= i2c_driver_read_data(true);
+    request->busy = false;
+    if (NULL != request->callback)
+    {
+        request->callback(request, success);
+    }
+}
 
-    crc            = i2c_driver_read_data(false);
-    crc_calculated = calculate_crc(humidity);
+bool sht31_fetch_periodic_data_async(sht31_async_t *request)
+{
+    sht31_t *sensor                = request->sensor;
+    i2c_async_transfer_t *transfer = &request->transfer;
 
-    if (crc != crc_calculated)
+    if (request->busy)
     {
-        i2c_driver_stop();
         return false;
     }
 
-    i2c_driver_stop();
+    request->command[0]    = FETCH_DATA_MSB;
+    request->command[1]    = FETCH_DATA_LSB;
+    transfer->address      = sensor->address;
+    transfer->write        = request->command;
+    transfer->write_length = sizeof(request->command);
+    transfer->read         = request->frame;
+    transfer->read_length  = sizeof(request->frame);
+    transfer->callback     = fetch_done;
+    transfer->context      = request;
 
+    request->busy = true;
+    if (false == request->bus->submit(request->bus->context, transfer))
+    {
+        request->busy = false;
+        return false;
+    }
+
+    STATS_ADD(sensor, starts, 2);
+    STATS_ADD(sensor, bytes_written, 2 + sizeof(request->command));
+    STATS_ADD(sensor, bytes_read, sizeof(request->frame));
     return true;
 }
 
+bool sht31_async_busy(const sht31_async_t *request)
+{
+    return request->busy;
+}
+
+#ifdef SHT31_ENABLE_STATS
+const sht31_stats_t *sht31_stats(const sht31_t *sensor)
+{
+    return &sensor->stats;
+}
+
+void sht31_stats_reset(sht31_t *sensor)
+{
+    static const sht31_stats_t no_stats;
+
+    sensor->stats = no_stats;
+}
+
+void sht31_stats_count_retry(sht31_t *sensor)
+{
+    STATS_ADD(sensor, retries, 1);
+}
+
+void sht31_stats_set_clock(sht31_stats_clock_t clock)
+{
+    stats_clock = clock;
+}
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// Single sensor API
+///////////////////////////////////////////////////////////////////////////////
+
+void sht30_driver_create(void)
+{
+    i2c_driver_create();
+}
+
+bool sht30_driver_send_soft_reset(void)
+{
+    return sht31_send_soft_reset(&default_sensor);
+}
+
+bool sht30_driver_send_periodic_data_aquisition_mode(uint8_t repeatability,
+                                                     uint8_t mps)
+{
+    return sht31_send_periodic_data_acquisition_mode(&default_sensor,
+                                                     repeatability, mps);
+}
+
+bool sht30_driver_fetch_periodic_data(void)
+{
+    return sht31_fetch_periodic_data(&default_sensor);
+}
+
+bool sht30_driver_fetch_sample(uint32_t now_ms, sht31_sample_t *sample)
+{
+    return sht31_fetch_sample(&default_sensor, now_ms, sample);
+}
+
+uint16_t sht30_driver_return_temperature(void)
+{
+    return sht31_return_temperature(&default_sensor);
+}
+
+uint16_t sht30_driver_return_humidity(void)
+{
+    return sht31_return_humidity(&default_sensor);
+}
+
+bool sht30_driver_read_status_register(void)
+{
+    return sht31_read_status_register(&default_sensor);
+}
+
+uint16_t sht30_driver_return_status_register(void)
+{
+    return sht31_return_status_register(&default_sensor);
+}
+
+bool sht30_driver_read_status(sht31_status_t *status)
+{
+    return sht31_read_status(&default_sensor, status);
+}
+
+bool sht30_driver_clear_status_register(void)
+{
+    return sht31_clear_status_register(&default_sensor);
+}
+
+bool sht30_driver_break_command(void)
+{
+    return sht31_break_command(&default_sensor);
+}
+
+bool sht30_driver_set_heater(bool enable)
+{
+    return sht31_set_heater(&default_sensor, enable);
+}
+
+bool sht30_driver_get_single_shot_data(void)
+{
+    return sht31_get_single_shot_data(&default_sensor);
+}
@@ -9,13 +9,15 @@
 // DONE:    Add functionality to read status register
 // DONE:    Add functionality to clear status register
 // DONE:    Add Break command
-// TODO:    Add more stop commands after fails
-// TODO:    Add heater control
-// TODO:    Add single shot data acquisition
+// DONE:    Add more stop commands after fails
+// DONE:    Add heater control
+// DONE:    Add single shot data acquisition
 
 #ifndef _SHT30_DRIVER_H
 #define _SHT30_DRIVER_H
 
+#include "i2c_async.h"
+#include "i2c_bus.h"
 #include "i2c_driver.h"
 #include <stdbool.h>
 #include <stdint.h>
@@ -33,7 +35,524 @@
 #define READ_STATUS_ADDRESS 0xF32D
 #define CLEAR_STATUS_ADDRESS 0x3041
 #define BREAK_COMMAND_ADDRESS 0x3093
+#define ART_COMMAND_ADDRESS 0x2B32
+#define HEATER_ENABLE_ADDRESS 0x306D
+#define HEATER_DISABLE_ADDRESS 0x3066
+#define SHT_READ_SERIAL_NUMBER 0x3780
 #define SHT_SINGLE_SHOT_MODE_HIGH_CLOCK_STRETCH 0x2C06
+#define SHT_SINGLE_SHOT_MODE_MEDIUM_CLOCK_STRETCH 0x2C0D
+#define SHT_SINGLE_SHOT_MODE_LOW_CLOCK_STRETCH 0x2C10
+#define SHT_SINGLE_SHOT_MODE_HIGH 0x2400
+#define SHT_SINGLE_SHOT_MODE_MEDIUM 0x240B
+#define SHT_SINGLE_SHOT_MODE_LOW 0x2416
+#define SHT_ALTERNATE_ADDRESS 0x45
+
+// Alert limit commands. Each limit is one word: the top 7 bits of humidity
+// in bits 15..9 and the top 9 bits of temperature in bits 8..0.
+#define SHT_ALERT_READ_HIGH_SET 0xE11F
+#define SHT_ALERT_READ_HIGH_CLEAR 0xE114
+#define SHT_ALERT_READ_LOW_CLEAR 0xE109
+#define SHT_ALERT_READ_LOW_SET 0xE102
+#define SHT_ALERT_WRITE_HIGH_SET 0x611D
+#define SHT_ALERT_WRITE_HIGH_CLEAR 0x6116
+#define SHT_ALERT_WRITE_LOW_CLEAR 0x610B
+#define SHT_ALERT_WRITE_LOW_SET 0x6100
+
+// Status register bits.
+#define SHT_STATUS_ALERT_PENDING 0x8000
+#define SHT_STATUS_HEATER_ON 0x2000
+#define SHT_STATUS_HUMIDITY_ALERT 0x0800
+#define SHT_STATUS_TEMPERATURE_ALERT 0x0400
+#define SHT_STATUS_RESET_DETECTED 0x0010
+#define SHT_STATUS_COMMAND_FAILED 0x0002
+#define SHT_STATUS_WRITE_CHECKSUM_FAILED 0x0001
+
+#define SHT_REPEATABILITY_LOW 0
+#define SHT_REPEATABILITY_MEDIUM 1
+#define SHT_REPEATABILITY_HIGH 2
+
+// Maximum single shot conversion times from the datasheet, rounded up.
+#define SHT_DURATION_LOW_MS 5
+#define SHT_DURATION_MEDIUM_MS 7
+#define SHT_DURATION_HIGH_MS 16
+
+// Resolution of the now_ms times passed in. A command sent during a tick
+// stamped n can go out almost a whole tick after n, so a result is only
+// taken as ready this much after the conversion time.
+#define SHT_CLOCK_RESOLUTION_MS 1
+
+// A single shot read without clock stretching is retried while the sensor
+// nacks the read header because it is still converting, for up to the
+// conversion time plus this margin as measured by sht31_set_clock().
+#define SHT_SINGLE_SHOT_POLL_MARGIN_MS 2
+
+// With no clock set the retries are counted instead. A nacked header is a
+// START, 9 clocks and a STOP, so at least 10 us on a 1 MHz bus, the fastest
+// the sensor runs at. The count covers the time above at that speed only;
+// at 100 kHz a sensor that never acks holds the call ten times as long.
+#define SHT_SINGLE_SHOT_POLLS_PER_MS 100
+
+typedef enum
+{
+    SHT31_POLL_IDLE,
+    SHT31_POLL_BUSY,
+    SHT31_POLL_DONE,
+    SHT31_POLL_ERROR
+} sht31_poll_t;
+
+typedef struct
+{
+    uint16_t nack;
+    uint16_t crc;
+} sht31_error_counters_t;
+
+/**
+ * @brief   The status register decoded.
+ */
+typedef struct
+{
+    bool alert_pending : 1;         // Latched until the register is cleared
+    bool heater_on : 1;
+    bool humidity_alert : 1;        // Humidity outside its limits now
+    bool temperature_alert : 1;     // Temperature outside its limits now
+    bool reset_detected : 1;        // Since the register was last cleared
+    bool command_failed : 1;        // Last command not processed
+    bool write_checksum_failed : 1; // Last write had a bad CRC
+} sht31_status_t;
+
+/**
+ * @brief   The four alert limits. The ALERT pin goes high when a value rises
+ * above HIGH_SET or falls below LOW_SET, and low again once it is back
+ * between LOW_CLEAR and HIGH_CLEAR. Alerts are only checked in periodic mode.
+ */
+typedef enum
+{
+    SHT31_ALERT_HIGH_SET,
+    SHT31_ALERT_HIGH_CLEAR,
+    SHT31_ALERT_LOW_CLEAR,
+    SHT31_ALERT_LOW_SET,
+    SHT31_ALERT_LIMITS
+} sht31_alert_limit_t;
+
+// sht31_sample_t flags: which values in the sample passed their CRC.
+#define SHT31_SAMPLE_TEMPERATURE_VALID 0x01
+#define SHT31_SAMPLE_HUMIDITY_VALID 0x02
+#define SHT31_SAMPLE_STATUS_VALID 0x04
+#define SHT31_SAMPLE_MEASUREMENT_VALID                                        \
+    (SHT31_SAMPLE_TEMPERATURE_VALID | SHT31_SAMPLE_HUMIDITY_VALID)
+
+/**
+ * @brief   One reading, decoded straight from the bus into caller owned
+ * memory. 12 bytes with no padding on 16 and 32 bit targets, every member
+ * on its natural alignment so arrays of samples can be read in place.
+ */
+typedef struct
+{
+    uint32_t timestamp_ms;    // now_ms passed to the fetch
+    uint16_t temperature;     // Raw ticks
+    uint16_t humidity;        // Raw ticks
+    uint16_t status_register; // Only with SHT31_SAMPLE_STATUS_VALID
+    uint8_t sequence;         // Per sensor, every attempt, wraps
+    uint8_t flags;            // SHT31_SAMPLE_*
+} sht31_sample_t;
+
+// Millisecond counter used to time blocking calls, e.g. a systick count.
+typedef uint32_t (*sht31_clock_t)(void);
+
+#ifdef SHT31_ENABLE_STATS
+// Instrumentation, compiled in only when SHT31_ENABLE_STATS is defined.
+// Without it there is no stats member and no counting code at all.
+
+// Public calls that are counted and timed.
+typedef enum
+{
+    SHT31_CALL_SOFT_RESET,
+    SHT31_CALL_PERIODIC_MODE,
+    SHT31_CALL_FETCH,
+    SHT31_CALL_READ_STATUS,
+    SHT31_CALL_CLEAR_STATUS,
+    SHT31_CALL_BREAK,
+    SHT31_CALL_ART,
+    SHT31_CALL_SINGLE_SHOT,
+    SHT31_CALL_BEGIN_MEASUREMENT,
+    SHT31_CALL_POLL,
+    SHT31_CALL_WRITE_ALERT_LIMIT,
+    SHT31_CALL_READ_ALERT_LIMIT,
+    SHT31_CALL_HEATER,
+    SHT31_CALL_READ_SERIAL,
+    SHT31_CALL_COUNT
+} sht31_call_t;
+
+// Free running tick counter used to time calls, e.g. a hardware timer.
+typedef uint32_t (*sht31_stats_clock_t)(void);
+
+typedef struct
+{
+    uint32_t starts;
+    uint32_t bytes_written; // Address bytes included
+    uint32_t bytes_read;
+    uint32_t nacks; // Every NACK, including expected ones while polling
+    uint32_t crc_failures;
+    uint32_t retries;
+    uint32_t calls[SHT31_CALL_COUNT];
+    uint32_t call_ticks[SHT31_CALL_COUNT];
+} sht31_stats_t;
+#endif
+
+/**
+ * @brief   One SHT31 device. Holds where the device is and the last values
+ * read from it, so any number of sensors can be used at once.
+ */
+typedef struct sht31
+{
+    const i2c_bus_t *bus;
+    uint8_t address;
+    uint16_t temperature;
+    uint16_t humidity;
+    uint16_t status_register;
+    sht31_error_counters_t errors;
+    bool measuring;
+    uint32_t ready_at_ms;
+    uint8_t sequence; // Next sht31_sample_t sequence number
+#ifdef SHT31_ENABLE_STATS
+    sht31_stats_t stats;
+#endif
+} sht31_t;
+
+/**
+ * @brief   Sets up a sensor handle. Does not talk to the device.
+ *
+ * @param sensor
+ * @param bus       Bus the device is on, e.g. &i2c_driver_bus
+ * @param address   DEFAULT_ADDRESS or SHT_ALTERNATE_ADDRESS
+ */
+void sht31_init(sht31_t *sensor, const i2c_bus_t *bus, uint8_t address);
+
+// Temperature and humidity words, each with its CRC.
+#define SHT_MEASUREMENT_FRAME_SIZE 6
+
+typedef struct sht31_async sht31_async_t;
+
+/**
+ * @brief   Called from interrupt context when an asynchronous request ends.
+ * On success the sensor handle holds the new reading.
+ */
+typedef void (*sht31_async_callback_t)(sht31_async_t *request, bool success);
+
+/**
+ * @brief   An asynchronous request on one sensor over an i2c_async.h bus. It
+ * holds the transaction and its buffers, so must stay in scope until the
+ * callback has run.
+ */
+struct sht31_async
+{
+    sht31_t *sensor;
+    const i2c_async_bus_t *bus;
+    i2c_async_transfer_t transfer;
+    uint8_t command[2];
+    uint8_t frame[SHT_MEASUREMENT_FRAME_SIZE];
+    sht31_async_callback_t callback;
+    void *context; // For the callback
+    volatile bool busy;
+};
+
+/**
+ * @brief   Sets up a request. Nothing is sent.
+ *
+ * @param request
+ * @param sensor    Initialised sensor handle; its address is used and its
+ *                  readings and error counters are updated
+ * @param bus       Asynchronous bus the sensor is on
+ * @param callback  May be NULL
+ * @param context
+ */
+void sht31_async_init(sht31_async_t *request, sht31_t *sensor,
+                      const i2c_async_bus_t *bus,
+                      sht31_async_callback_t callback, void *context);
+
+/**
+ * @brief   sht31_fetch_periodic_data() without waiting: submits the fetch and
+ * returns. The CRCs are checked and the reading stored before the callback.
+ *
+ * @return true     Submitted
+ * @return false    This request or the bus is busy
+ */
+bool sht31_fetch_periodic_data_async(sht31_async_t *request);
+
+bool sht31_async_busy(const sht31_async_t *request);
+
+bool sht31_send_soft_reset(sht31_t *sensor);
+
+/**
+ * @brief
+ *
+ * @param sensor
+ * @param repeatability     0 = low, 1 = medium, 2 = high
+ * @param mps               0 = 0.5, 1 = 1, 2 = 2, 3 = 4, 4 = 10
+ * @return true
+ * @return false
+ */
+bool sht31_send_periodic_data_acquisition_mode(sht31_t *sensor,
+                                               uint8_t repeatability,
+                                               uint8_t mps);
+
+/**
+ * @brief   Fetches the latest periodic measurement from the sensor and stores
+ * it in the handle.
+ *
+ * @param sensor
+ * @return true
+ * @return false
+ */
+bool sht31_fetch_periodic_data(sht31_t *sensor);
+
+/**
+ * @brief   Fetches the latest periodic measurement straight into sample. The
+ * words are checked one by one, so a sample can carry a good temperature
+ * even if the humidity CRC failed. The reading in the handle is not
+ * touched.
+ *
+ * @param sensor
+ * @param now_ms    Stored as the sample timestamp
+ * @param sample    Always filled in; flags is 0 if nothing was read
+ * @return true     Both values valid
+ * @return false
+ */
+bool sht31_fetch_sample(sht31_t *sensor, uint32_t now_ms,
+                        sht31_sample_t *sample);
+
+/**
+ * @brief   sht31_fetch_sample() for count sensors in one call, samples[i]
+ * from sensors[i].
+ *
+ * @param sensors
+ * @param count
+ * @param now_ms
+ * @param samples   count samples, filled in place
+ * @return uint8_t  Number of samples with both values valid
+ */
+uint8_t sht31_fetch_samples(sht31_t *sensors, uint8_t count, uint32_t now_ms,
+                            sht31_sample_t *samples);
+
+uint16_t sht31_return_temperature(const sht31_t *sensor);
+
+uint16_t sht31_return_humidity(const sht31_t *sensor);
+
+/**
+ * @brief   Reads the status register into the handle. The stored value is
+ * only updated when its CRC matches.
+ */
+bool sht31_read_status_register(sht31_t *sensor);
+
+uint16_t sht31_return_status_register(const sht31_t *sensor);
+
+/**
+ * @brief   Reads the status register into sample->status_register and sets
+ * SHT31_SAMPLE_STATUS_VALID if its CRC matches. The rest of the sample is
+ * left alone, so it can follow a fetch into the same sample.
+ */
+bool sht31_read_status_sample(sht31_t *sensor, sht31_sample_t *sample);
+
+/**
+ * @brief   Reads the status register and decodes it.
+ *
+ * @param sensor
+ * @param status    Filled in when the read succeeds
+ * @return true
+ * @return false
+ */
+bool sht31_read_status(sht31_t *sensor, sht31_status_t *status);
+
+sht31_status_t sht31_decode_status(uint16_t status_register);
+
+/**
+ * @brief   Packs raw temperature and humidity into an alert limit word,
+ * keeping the resolution the sensor compares at.
+ */
+uint16_t sht31_alert_limit_pack(uint16_t temperature, uint16_t humidity);
+
+/**
+ * @brief   Unpacks an alert limit word to raw values (the dropped low bits
+ * read as zero).
+ */
+void sht31_alert_limit_unpack(uint16_t limit, uint16_t *temperature,
+                              uint16_t *humidity);
+
+/**
+ * @brief   Programs one alert limit. To sleep until something changes, set
+ * the limits, start periodic mode and wait for the ALERT pin; then read the
+ * status to see which channel fired.
+ *
+ * The limits go back to their defaults (above 60 C or 80 %RH, below -10 C
+ * or 20 %RH) on reset.
+ *
+ * @param sensor
+ * @param limit
+ * @param temperature   Raw ticks
+ * @param humidity      Raw ticks
+ * @return true
+ * @return false
+ */
+bool sht31_write_alert_limit(sht31_t *sensor, sht31_alert_limit_t limit,
+                             uint16_t temperature, uint16_t humidity);
+
+/**
+ * @brief   Reads one alert limit back as raw ticks.
+ */
+bool sht31_read_alert_limit(sht31_t *sensor, sht31_alert_limit_t limit,
+                            uint16_t *temperature, uint16_t *humidity);
+
+bool sht31_clear_status_register(sht31_t *sensor);
+
+bool sht31_break_command(sht31_t *sensor);
+
+/**
+ * @brief   Starts periodic acquisition in accelerated response time (ART)
+ * mode, 4 measurements per second.
+ *
+ * @param sensor
+ * @return true
+ * @return false
+ */
+bool sht31_send_art_command(sht31_t *sensor);
+
+/**
+ * @brief   Switches the on-chip heater on or off. The heater warms the sensor
+ * by a few degrees, which drives off condensation but skews readings while
+ * it is on and until the sensor cools again. The status register heater bit
+ * shows whether the command took.
+ *
+ * @param sensor
+ * @param enable
+ * @return true
+ * @return false
+ */
+bool sht31_set_heater(sht31_t *sensor, bool enable);
+
+/**
+ * @brief   Reads the sensor's unique 32 bit serial number (two CRC checked
+ * words, without clock stretching).
+ *
+ * @param sensor
+ * @param serial    Only written when both CRCs match
+ * @return true
+ * @return false
+ */
+bool sht31_read_serial_number(sht31_t *sensor, uint32_t *serial);
+
+/**
+ * @brief   Single shot measurement in high repeatability with clock
+ * stretching.
+ */
+bool sht31_get_single_shot_data(sht31_t *sensor);
+
+/**
+ * @brief   Single shot measurement in any mode. Blocks until the result has
+ * been read.
+ *
+ * With clock stretching the sensor holds SCL low until the result is ready.
+ * Without it the read header is retried until the sensor acks, leaving the
+ * bus free between attempts. It gives up once the conversion time plus
+ * SHT_SINGLE_SHOT_POLL_MARGIN_MS has passed on the sht31_set_clock() clock.
+ * With no clock set it gives up after a number of retries that only covers
+ * that time on a 1 MHz bus; see SHT_SINGLE_SHOT_POLLS_PER_MS.
+ *
+ * @param sensor
+ * @param repeatability     0 = low, 1 = medium, 2 = high
+ * @param clock_stretch
+ * @return true
+ * @return false
+ */
+bool sht31_get_single_shot_data_in_mode(sht31_t *sensor,
+                                        uint8_t repeatability,
+                                        bool clock_stretch);
+
+/**
+ * @brief   Sets the clock blocking reads time out against, shared by all
+ * sensors. NULL, the default, bounds them by a retry count instead.
+ */
+void sht31_set_clock(sht31_clock_t clock);
+
+/**
+ * @brief   Maximum conversion time of a single shot measurement.
+ *
+ * @param repeatability     0 = low, 1 = medium, 2 = high
+ * @return uint8_t          Milliseconds
+ */
+uint8_t sht31_single_shot_duration_ms(uint8_t repeatability);
+
+/**
+ * @brief   When the result of a measurement started at started_ms (a single
+ * shot, or the first of periodic mode) can be read, allowing for now_ms
+ * only having millisecond resolution.
+ *
+ * @param repeatability     0 = low, 1 = medium, 2 = high
+ * @param started_ms        now_ms when the command was sent
+ * @return uint32_t         Milliseconds
+ */
+uint32_t sht31_result_ready_ms(uint8_t repeatability, uint32_t started_ms);
+
+/**
+ * @brief   Starts a single shot measurement without clock stretching and
+ * returns straight away. Use sht31_poll() to collect the result.
+ *
+ * @param sensor
+ * @param repeatability     0 = low, 1 = medium, 2 = high
+ * @param now_ms            Current time in milliseconds
+ * @return true             Measurement started
+ * @return false            Device did not ack, or a measurement is already
+ *                          in progress
+ */
+bool sht31_begin_measurement(sht31_t *sensor, uint8_t repeatability,
+                             uint32_t now_ms);
+
+/**
+ * @brief   Checks on a measurement started with sht31_begin_measurement().
+ * Nothing is sent on the bus until the conversion time for the chosen
+ * repeatability has passed, after which the result is read and stored.
+ *
+ * @param sensor
+ * @param now_ms            Current time in milliseconds
+ * @return SHT31_POLL_IDLE  No measurement in progress
+ * @return SHT31_POLL_BUSY  Still converting, try again later
+ * @return SHT31_POLL_DONE  Temperature and humidity updated
+ * @return SHT31_POLL_ERROR Read failed (NACK or CRC)
+ */
+sht31_poll_t sht31_poll(sht31_t *sensor, uint32_t now_ms);
+
+/**
+ * @brief   sht31_poll() that decodes the result into sample, as
+ * sht31_fetch_sample() does. sample is only written once the result is
+ * read (SHT31_POLL_DONE or SHT31_POLL_ERROR).
+ */
+sht31_poll_t sht31_poll_sample(sht31_t *sensor, uint32_t now_ms,
+                               sht31_sample_t *sample);
+
+#ifdef SHT31_ENABLE_STATS
+/**
+ * @brief   Counters for one sensor since sht31_init() or the last reset.
+ */
+const sht31_stats_t *sht31_stats(const sht31_t *sensor);
+
+void sht31_stats_reset(sht31_t *sensor);
+
+/**
+ * @brief   Counts a retry made by code above the driver, e.g. a recovery
+ * layer repeating a failed call.
+ */
+void sht31_stats_count_retry(sht31_t *sensor);
+
+/**
+ * @brief   Sets the clock public calls are timed with, shared by all
+ * sensors. call_ticks stays at zero until a clock is set.
+ */
+void sht31_stats_set_clock(sht31_stats_clock_t clock);
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+// Single sensor API. Works on a default sensor at DEFAULT_ADDRESS on the bus
+// behind i2c_driver.h.
+///////////////////////////////////////////////////////////////////////////////
 
 void sht30_driver_create(void);
 
@@ -59,6 +578,8 @@ bool sht30_driver_send_periodic_data_aquisition_mode(uint8_t repeatability,
  */
 bool sht30_driver_fetch_periodic_data(void);
 
+bool sht30_driver_fetch_sample(uint32_t now_ms, sht31_sample_t *sample);
+
 /**
  * @brief Returns the latest temperature reading. The temperature reading is the
  * full 16bit value returned from the sht30 ic. No computations have been done
@@ -74,10 +595,14 @@ bool sht30_driver_read_status_register(void);
 
 uint16_t sht30_driver_return_status_register(void);
 
+bool sht30_driver_read_status(sht31_status_t *status);
+
 bool sht30_driver_clear_status_register(void);
 
 bool sht30_driver_break_command(void);
 
+bool sht30_driver_set_heater(bool enable);
+
 bool sht30_driver_get_single_shot_data(void);
 
 #endif // _SHT30_DRIVER_H
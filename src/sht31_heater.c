@@ -0,0 +1,157 @@
+#include "sht31_heater.h"
+
+void sht31_heater_default_config(sht31_heater_config_t *config)
+{
+    config->burst_ms         = 10000;
+    config->cooldown_ms      = 30000;
+    config->bursts           = 3;
+    config->trigger_humidity = 0xF332;
+}
+
+void sht31_heater_init(sht31_heater_t *heater, sht31_t *sensor,
+                       const sht31_heater_config_t *config)
+{
+    heater->sensor        = sensor;
+    heater->config        = *config;
+    heater->state         = SHT31_HEATER_IDLE;
+    heater->bursts_left   = 0;
+    heater->phase_ends_ms = 0;
+    heater->cycles        = 0;
+    heater->bursts        = 0;
+    heater->failures      = 0;
+    heater->rejected      = 0;
+
+    if (0 == heater->config.bursts)
+    {
+        heater->config.bursts = 1;
+    }
+}
+
+/*
+ * Sends the heater command and reads the status back to check it took.
+ */
+static bool switch_heater(sht31_heater_t *heater, bool enable)
+{
+    sht31_status_t status;
+
+    if (sht31_set_heater(heater->sensor, enable) &&
+        sht31_read_status(heater->sensor, &status) &&
+        (enable == status.heater_on))
+    {
+        return true;
+    }
+
+    heater->failures++;
+    return false;
+}
+
+static bool phase_over(const sht31_heater_t *heater, uint32_t now_ms)
+{
+    // Signed difference so the millisecond counter can wrap.
+    return (int32_t)(now_ms - heater->phase_ends_ms) >= 0;
+}
+
+static bool begin_burst(sht31_heater_t *heater, uint32_t now_ms)
+{
+    if (false == switch_heater(heater, true))
+    {
+        return false;
+    }
+
+    heater->state         = SHT31_HEATER_HEATING;
+    heater->phase_ends_ms = now_ms + heater->config.burst_ms;
+    heater->bursts_left--;
+    heater->bursts++;
+    return true;
+}
+
+static bool end_burst(sht31_heater_t *heater, uint32_t now_ms)
+{
+    if (false == switch_heater(heater, false))
+    {
+        return false;
+    }
+
+    heater->state         = SHT31_HEATER_COOLING;
+    heater->phase_ends_ms = now_ms + heater->config.cooldown_ms;
+    return true;
+}
+
+bool sht31_heater_start(sht31_heater_t *heater, uint32_t now_ms)
+{
+    if (SHT31_HEATER_IDLE != heater->state)
+    {
+        return false;
+    }
+
+    heater->bursts_left = heater->config.bursts;
+    if (begin_burst(heater, now_ms))
+    {
+        return true;
+    }
+
+    // Make sure a half taken command has not left it on.
+    sht31_set_heater(heater->sensor, false);
+    heater->bursts_left = 0;
+    return false;
+}
+
+bool sht31_heater_stop(sht31_heater_t *heater, uint32_t now_ms)
+{
+    heater->bursts_left = 0;
+
+    if (SHT31_HEATER_HEATING != heater->state)
+    {
+        return true;
+    }
+    return end_burst(heater, now_ms);
+}
+
+sht31_heater_state_t sht31_heater_service(sht31_heater_t *heater,
+                                          uint32_t now_ms)
+{
+    if ((SHT31_HEATER_IDLE == heater->state) ||
+        (false == phase_over(heater, now_ms)))
+    {
+        return heater->state;
+    }
+
+    if (SHT31_HEATER_HEATING == heater->state)
+    {
+        end_burst(heater, now_ms);
+    }
+    else if (heater->bursts_left > 0)
+    {
+        begin_burst(heater, now_ms);
+    }
+    else
+    {
+        heater->state = SHT31_HEATER_IDLE;
+        heater->cycles++;
+    }
+
+    return heater->state;
+}
+
+bool sht31_heater_accept(sht31_heater_t *heater, uint16_t humidity,
+                         uint32_t now_ms)
+{
+    if ((SHT31_HEATER_IDLE == heater->state) &&
+        (0 != heater->config.trigger_humidity) &&
+        (humidity >= heater->config.trigger_humidity))
+    {
+        sht31_heater_start(heater, now_ms);
+    }
+
+    if (SHT31_HEATER_IDLE != heater->state)
+    {
+        heater->rejected++;
+        return false;
+    }
+    return true;
+}
+
+sht31_heater_state_t sht31_heater_state(const sht31_heater_t *heater)
+{
+    return heater->state;
+}
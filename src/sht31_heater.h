@@ -0,0 +1,128 @@
+/**
+ * @file    sht31_heater.h
+ * @author  Steven Daglish
+ * @brief   Runs heater bursts to clear condensation without blocking the
+ *          sampling loop.
+ * @version 0.1
+ * @date    17 October 2026
+ *
+ * After condensation the humidity reading sits near 100 %RH for hours until
+ * the water on the sensor evaporates. A recovery cycle speeds that up:
+ *
+ *  HEATING     Heater on for burst_ms
+ *  COOLING     Heater off for cooldown_ms, so the sensor is back at ambient
+ *              before its readings are used again
+ *
+ * repeated for bursts bursts, then IDLE. Every heater command is checked
+ * against the status register heater bit. If a command fails, or the bit
+ * does not follow, it is tried again on the next service; the heater is
+ * never left on without the state saying so.
+ *
+ * Readings taken in a cycle are skewed by the heat. Pass each one through
+ * sht31_heater_accept(), which says whether to keep it and can also start a
+ * cycle itself when the humidity reaches trigger_humidity.
+ *
+ * Nothing here waits: sht31_heater_service() returns straight away and only
+ * touches the bus when a phase ends.
+ */
+
+#ifndef _SHT31_HEATER_H
+#define _SHT31_HEATER_H
+
+#include "sht31_driver.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum
+{
+    SHT31_HEATER_IDLE,
+    SHT31_HEATER_HEATING,
+    SHT31_HEATER_COOLING
+} sht31_heater_state_t;
+
+typedef struct
+{
+    uint32_t burst_ms;
+    uint32_t cooldown_ms;
+    uint8_t bursts;
+    uint16_t trigger_humidity; // Raw; 0 to only start cycles by hand
+} sht31_heater_config_t;
+
+typedef struct
+{
+    sht31_t *sensor;
+    sht31_heater_config_t config;
+
+    sht31_heater_state_t state;
+    uint8_t bursts_left;
+    uint32_t phase_ends_ms;
+
+    // Counters
+    uint32_t cycles;
+    uint32_t bursts;
+    uint32_t failures;
+    uint32_t rejected;
+} sht31_heater_t;
+
+/**
+ * @brief   Three 10 second bursts with 30 seconds to cool after each,
+ * started automatically at 95 %RH.
+ */
+void sht31_heater_default_config(sht31_heater_config_t *config);
+
+/**
+ * @brief   Sets up the controller, idle. Nothing is sent.
+ *
+ * @param heater
+ * @param sensor
+ * @param config    Copied. bursts of 0 is taken as 1.
+ */
+void sht31_heater_init(sht31_heater_t *heater, sht31_t *sensor,
+                       const sht31_heater_config_t *config);
+
+/**
+ * @brief   Starts a recovery cycle with the first burst.
+ *
+ * @return true
+ * @return false    Already running, or the heater did not come on (it is
+ *                  switched off again and the controller stays idle)
+ */
+bool sht31_heater_start(sht31_heater_t *heater, uint32_t now_ms);
+
+/**
+ * @brief   Ends the current burst now and goes on to cool down, with no
+ * further bursts.
+ *
+ * @return true
+ * @return false    The heater could not be confirmed off; try again
+ */
+bool sht31_heater_stop(sht31_heater_t *heater, uint32_t now_ms);
+
+/**
+ * @brief   Moves the cycle on when a phase ends. Call as often as the
+ * sampling loop runs.
+ *
+ * @return The state after the call
+ */
+sht31_heater_state_t sht31_heater_service(sht31_heater_t *heater,
+                                          uint32_t now_ms);
+
+/**
+ * @brief   Says whether a reading taken now should be kept. Readings taken
+ * while heating or cooling are not, and are counted in rejected.
+ *
+ * If idle with a trigger_humidity set and humidity at or above it, a cycle
+ * is started and this reading is rejected too.
+ *
+ * @param heater
+ * @param humidity  Raw humidity of the reading
+ * @param now_ms
+ * @return true     Keep the reading
+ * @return false    Drop or mark it
+ */
+bool sht31_heater_accept(sht31_heater_t *heater, uint16_t humidity,
+                         uint32_t now_ms);
+
+sht31_heater_state_t sht31_heater_state(const sht31_heater_t *heater);
+
+#endif // _SHT31_HEATER_H
@@ -0,0 +1,471 @@
+#include "sht31_log.h"
+#include "crc8.h"
+#include <stddef.h>
+
+#define LONG_FORM 0x80
+#define LONG_FORM_MASK 0xC0
+#define STEP_CHANGED 0x20
+#define LONG_FORM_RESERVED 0x1F
+
+#define SHORT_TEMPERATURE_SHIFT 4
+#define SHORT_TEMPERATURE_LIMIT 8
+#define SHORT_HUMIDITY_MASK 0x0F
+#define SHORT_HUMIDITY_LIMIT 16
+
+// Timestamp, temperature, humidity and at least one byte of step.
+#define MIN_PAYLOAD 9
+#define MAX_VARINT_SIZE 5
+
+static uint32_t zigzag_encode(int32_t value)
+{
+    return ((uint32_t)value << 1) ^ (uint32_t)(value >> 31);
+}
+
+static int32_t zigzag_decode(uint32_t value)
+{
+    return (int32_t)((value >> 1) ^ (0u - (value & 1u)));
+}
+
+static uint8_t put_varint(uint8_t *out, uint32_t value)
+{
+    uint8_t used = 0;
+
+    while (value >= 0x80)
+    {
+        out[used++] = (uint8_t)(value | 0x80);
+        value >>= 7;
+    }
+    out[used++] = (uint8_t)value;
+
+    return used;
+}
+
+static void put_u16(uint8_t *out, uint16_t value)
+{
+    out[0] = value & 0x00FF;
+    out[1] = value >> 8;
+}
+
+static void put_u32(uint8_t *out, uint32_t value)
+{
+    put_u16(&out[0], value & 0xFFFF);
+    put_u16(&out[2], value >> 16);
+}
+
+static uint16_t get_u16(const uint8_t *in)
+{
+    return (uint16_t)(in[0] | (in[1] << 8));
+}
+
+static uint32_t get_u32(const uint8_t *in)
+{
+    return get_u16(&in[0]) | ((uint32_t)get_u16(&in[2]) << 16);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Encoder
+///////////////////////////////////////////////////////////////////////////////
+
+bool sht31_log_encoder_init(sht31_log_encoder_t *encoder,
+                            uint8_t block_readings, sht31_log_write_t write,
+                            void *context)
+{
+    if ((0 == block_readings) ||
+        (block_readings > SHT31_LOG_MAX_BLOCK_READINGS))
+    {
+        return false;
+    }
+
+    encoder->write          = write;
+    encoder->context        = context;
+    encoder->block_readings = block_readings;
+    encoder->length         = 0;
+    encoder->count          = 0;
+    encoder->previous_step  = 0;
+    encoder->readings       = 0;
+    encoder->bytes          = 0;
+    encoder->failed_blocks  = 0;
+
+    return true;
+}
+
+static void write_keyframe(sht31_log_encoder_t *encoder,
+                           const sht31_reading_t *reading, uint32_t step)
+{
+    uint8_t *out = encoder->block;
+
+    out[0] = SHT31_LOG_SYNC;
+    put_u32(&out[SHT31_LOG_HEADER_SIZE], reading->timestamp_ms);
+    put_u16(&out[SHT31_LOG_HEADER_SIZE + 4], reading->temperature);
+    put_u16(&out[SHT31_LOG_HEADER_SIZE + 6], reading->humidity);
+
+    encoder->length = SHT31_LOG_HEADER_SIZE + 8;
+    encoder->length += put_varint(&out[encoder->length], step);
+}
+
+static void write_change(sht31_log_encoder_t *encoder,
+                         const sht31_reading_t *reading, uint32_t step)
+{
+    uint8_t *out = &encoder->block[encoder->length];
+    int32_t step_change  = (int32_t)(step - encoder->previous_step);
+    uint32_t temperature = zigzag_encode(
+        (int32_t)reading->temperature - encoder->previous.temperature);
+    uint32_t humidity = zigzag_encode((int32_t)reading->humidity -
+                                      encoder->previous.humidity);
+    uint8_t used = 1;
+
+    if ((0 == step_change) && (temperature < SHORT_TEMPERATURE_LIMIT) &&
+        (humidity < SHORT_HUMIDITY_LIMIT))
+    {
+        out[0] = (uint8_t)((temperature << SHORT_TEMPERATURE_SHIFT) | humidity);
+        encoder->length++;
+        return;
+    }
+
+    out[0] = LONG_FORM;
+    if (0 != step_change)
+    {
+        out[0] |= STEP_CHANGED;
+        used += put_varint(&out[used], zigzag_encode(step_change));
+    }
+    used += put_varint(&out[used], temperature);
+    used += put_varint(&out[used], humidity);
+
+    encoder->length += used;
+}
+
+bool sht31_log_append(sht31_log_encoder_t *encoder,
+                      const sht31_reading_t *reading)
+{
+    uint32_t step = 0;
+
+    if (0 != encoder->readings)
+    {
+        step = reading->timestamp_ms - encoder->previous.timestamp_ms;
+    }
+
+    if (0 == encoder->count)
+    {
+        write_keyframe(encoder, reading, step);
+    }
+    else
+    {
+        write_change(encoder, reading, step);
+    }
+
+    encoder->previous      = *reading;
+    encoder->previous_step = step;
+    encoder->count++;
+    encoder->readings++;
+
+    if (encoder->count >= encoder->block_readings)
+    {
+        return sht31_log_flush(encoder);
+    }
+    return true;
+}
+
+bool sht31_log_flush(sht31_log_encoder_t *encoder)
+{
+    uint16_t payload = encoder->length - SHT31_LOG_HEADER_SIZE;
+    bool written     = false;
+
+    if (0 == encoder->count)
+    {
+        return true;
+    }
+
+    encoder->block[1] = encoder->count;
+    put_u16(&encoder->block[2], payload);
+    encoder->block[encoder->length] =
+        crc8_calculate(encoder->block, encoder->length);
+    encoder->length++;
+
+    written = encoder->write(encoder->context, encoder->block, encoder->length);
+    if (written)
+    {
+        encoder->bytes += encoder->length;
+    }
+    else
+    {
+        encoder->failed_blocks++;
+    }
+
+    encoder->count  = 0;
+    encoder->length = 0;
+
+    return written;
+}
+
+uint32_t sht31_log_bytes(const sht31_log_encoder_t *encoder)
+{
+    return encoder->bytes;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Reader
+///////////////////////////////////////////////////////////////////////////////
+
+void sht31_log_reader_init(sht31_log_reader_t *reader, const uint8_t *data,
+                           uint32_t length)
+{
+    reader->data             = data;
+    reader->length           = length;
+    reader->position         = 0;
+    reader->payload          = NULL;
+    reader->payload_length   = 0;
+    reader->payload_position = 0;
+    reader->remaining        = 0;
+    reader->keyframe         = false;
+    reader->previous_step    = 0;
+    reader->corrupt_blocks   = 0;
+}
+
+/*
+ * True if a whole, undamaged block starts at position.
+ */
+static bool check_block(const sht31_log_reader_t *reader, uint32_t position,
+                        uint16_t *payload_length)
+{
+    const uint8_t *block = &reader->data[position];
+    uint32_t available   = 0;
+    uint16_t payload     = 0;
+
+    if ((position >= reader->length) ||
+        (reader->length - position < SHT31_LOG_HEADER_SIZE + 1))
+    {
+        return false;
+    }
+    available = reader->length - position - SHT31_LOG_HEADER_SIZE - 1;
+
+    if ((SHT31_LOG_SYNC != block[0]) || (0 == block[1]))
+    {
+        return false;
+    }
+
+    payload = get_u16(&block[2]);
+    if ((payload < MIN_PAYLOAD) || (payload > available) ||
+        (payload > UINT16_MAX - SHT31_LOG_HEADER_SIZE))
+    {
+        return false;
+    }
+
+    if (block[SHT31_LOG_HEADER_SIZE + payload] !=
+        crc8_calculate(block, SHT31_LOG_HEADER_SIZE + payload))
+    {
+        return false;
+    }
+
+    *payload_length = payload;
+    return true;
+}
+
+/*
+ * Moves to the next good block, skipping (and counting) damaged data.
+ */
+static bool open_block(sht31_log_reader_t *reader)
+{
+    uint16_t payload = 0;
+    bool lost        = false;
+
+    while (reader->position < reader->length)
+    {
+        if (check_block(reader, reader->position, &payload))
+        {
+            const uint8_t *block = &reader->data[reader->position];
+
+            reader->payload          = &block[SHT31_LOG_HEADER_SIZE];
+            reader->payload_length   = payload;
+            reader->payload_position = 0;
+            reader->remaining        = block[1];
+            reader->keyframe         = true;
+            reader->position += SHT31_LOG_HEADER_SIZE + payload + 1;
+
+            if (lost)
+            {
+                reader->corrupt_blocks++;
+            }
+            return true;
+        }
+
+        lost = true;
+        reader->position++;
+    }
+
+    if (lost)
+    {
+        reader->corrupt_blocks++;
+    }
+    return false;
+}
+
+static bool get_varint(sht31_log_reader_t *reader, uint32_t *value)
+{
+    uint32_t result = 0;
+    uint8_t shift   = 0;
+    uint8_t i       = 0;
+
+    for (i = 0; i < MAX_VARINT_SIZE; i++)
+    {
+        uint8_t byte = 0;
+
+        if (reader->payload_position >= reader->payload_length)
+        {
+            return false;
+        }
+        byte = reader->payload[reader->payload_position++];
+        result |= (uint32_t)(byte & 0x7F) << shift;
+        shift += 7;
+
+        if (0 == (byte & 0x80))
+        {
+            *value = result;
+            return true;
+        }
+    }
+    return false;
+}
+
+static bool decode_keyframe(sht31_log_reader_t *reader,
+                            sht31_reading_t *reading)
+{
+    reading->timestamp_ms    = get_u32(&reader->payload[0]);
+    reading->temperature     = get_u16(&reader->payload[4]);
+    reading->humidity        = get_u16(&reader->payload[6]);
+    reader->payload_position = 8;
+    reader->keyframe         = false;
+
+    return get_varint(reader, &reader->previous_step);
+}
+
+static bool decode_change(sht31_log_reader_t *reader, sht31_reading_t *reading)
+{
+    uint32_t step        = reader->previous_step;
+    uint32_t temperature = 0;
+    uint32_t humidity    = 0;
+    uint8_t tag          = 0;
+
+    if (reader->payload_position >= reader->payload_length)
+    {
+        return false;
+    }
+    tag = reader->payload[reader->payload_position++];
+
+    if (0 == (tag & LONG_FORM))
+    {
+        temperature = tag >> SHORT_TEMPERATURE_SHIFT;
+        humidity    = tag & SHORT_HUMIDITY_MASK;
+    }
+    else
+    {
+        if ((LONG_FORM != (tag & LONG_FORM_MASK)) ||
+            (0 != (tag & LONG_FORM_RESERVED)))
+        {
+            return false;
+        }
+        if (0 != (tag & STEP_CHANGED))
+        {
+            uint32_t step_change = 0;
+
+            if (false == get_varint(reader, &step_change))
+            {
+                return false;
+            }
+            step += (uint32_t)zigzag_decode(step_change);
+        }
+        if ((false == get_varint(reader, &temperature)) ||
+            (false == get_varint(reader, &humidity)))
+        {
+            return false;
+        }
+    }
+
+    reading->timestamp_ms = reader->previous.timestamp_ms + step;
+    reading->temperature =
+        (uint16_t)(reader->previous.temperature + zigzag_decode(temperature));
+    reading->humidity =
+        (uint16_t)(reader->previous.humidity + zigzag_decode(humidity));
+    reader->previous_step = step;
+
+    return true;
+}
+
+bool sht31_log_read(sht31_log_reader_t *reader, sht31_reading_t *reading)
+{
+    while (true)
+    {
+        bool decoded = false;
+
+        if ((0 == reader->remaining) && (false == open_block(reader)))
+        {
+            return false;
+        }
+
+        if (reader->keyframe)
+        {
+            decoded = decode_keyframe(reader, reading);
+        }
+        else
+        {
+            decoded = decode_change(reader, reading);
+        }
+
+        if (decoded)
+        {
+            reader->previous = *reading;
+            reader->remaining--;
+            return true;
+        }
+
+        // Passed its CRC but does not decode: drop the rest of the block.
+        reader->remaining = 0;
+        reader->corrupt_blocks++;
+    }
+}
+
+bool sht31_log_seek(sht31_log_reader_t *reader, uint32_t timestamp_ms)
+{
+    sht31_log_reader_t saved;
+    sht31_reading_t reading;
+    uint32_t position = 0;
+    uint32_t start    = 0;
+    uint16_t payload  = 0;
+
+    // Skip whole blocks that start before the reading wanted. A block that
+    // starts at or after it cannot hold anything earlier, so stop there.
+    while (check_block(reader, position, &payload))
+    {
+        uint32_t keyframe_ms =
+            get_u32(&reader->data[position + SHT31_LOG_HEADER_SIZE]);
+
+        if ((int32_t)(keyframe_ms - timestamp_ms) >= 0)
+        {
+            break;
+        }
+        start = position;
+        position += SHT31_LOG_HEADER_SIZE + payload + 1;
+    }
+
+    reader->position  = start;
+    reader->remaining = 0;
+
+    while (true)
+    {
+        saved = *reader;
+
+        if (false == sht31_log_read(reader, &reading))
+        {
+            return false;
+        }
+        if ((int32_t)(reading.timestamp_ms - timestamp_ms) >= 0)
+        {
+            *reader = saved;
+            return true;
+        }
+    }
+}
+
+uint32_t sht31_log_corrupt_blocks(const sht31_log_reader_t *reader)
+{
+    return reader->corrupt_blocks;
+}
@@ -0,0 +1,169 @@
+/**
+ * @file    sht31_log.h
+ * @author  Steven Daglish
+ * @brief   Compact binary log of timestamped readings: delta and zig-zag
+ *          varint coded, in self-contained blocks checked by CRC-8.
+ * @version 0.1
+ * @date    17 October 2026
+ *
+ * The log is a sequence of blocks. A block decodes on its own, so a reader
+ * can start at any block and a damaged block loses only its own readings.
+ *
+ *  sync            0xA5
+ *  count           Readings in the block, 1 to SHT31_LOG_MAX_BLOCK_READINGS
+ *  length          Payload bytes, 16 bit little endian
+ *  payload         Keyframe, then count - 1 coded readings
+ *  crc             crc8_calculate() over everything before it
+ *
+ * The keyframe holds the first reading in full (timestamp, temperature and
+ * humidity, little endian) and, as a varint, the timestamp step leading up
+ * to it. Each following reading is coded against the one before:
+ *
+ *  0ttthhhh        Short form, one byte. Same timestamp step as before,
+ *                  temperature moved by -4..3 and humidity by -8..7 (each
+ *                  zig-zag coded in its field).
+ *  10s00000 ...    Long form. If s is set a varint of the change in
+ *                  timestamp step follows, then varints of the temperature
+ *                  and humidity changes. All changes are zig-zag coded.
+ *
+ * Varints are 7 bits per byte, least significant group first, top bit set
+ * on every byte but the last.
+ *
+ * Readings sampled at a fixed rate whose values move by a few ticks take a
+ * byte each, against 8 bytes for the raw timestamp and words.
+ */
+
+#ifndef _SHT31_LOG_H
+#define _SHT31_LOG_H
+
+#include "sht31_ring_buffer.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SHT31_LOG_SYNC 0xA5
+
+#ifndef SHT31_LOG_MAX_BLOCK_READINGS
+#define SHT31_LOG_MAX_BLOCK_READINGS 64
+#endif
+
+#define SHT31_LOG_HEADER_SIZE 4
+#define SHT31_LOG_KEYFRAME_SIZE 13
+#define SHT31_LOG_MAX_CODED_SIZE 12
+#define SHT31_LOG_MAX_BLOCK_SIZE                                               \
+    (SHT31_LOG_HEADER_SIZE + SHT31_LOG_KEYFRAME_SIZE +                         \
+     ((SHT31_LOG_MAX_BLOCK_READINGS - 1) * SHT31_LOG_MAX_CODED_SIZE) + 1)
+
+/**
+ * @brief   Takes a finished block. Returns false if it could not be stored.
+ */
+typedef bool (*sht31_log_write_t)(void *context, const uint8_t *data,
+                                  uint16_t length);
+
+typedef struct
+{
+    sht31_log_write_t write;
+    void *context;
+    uint8_t block_readings;
+
+    uint8_t block[SHT31_LOG_MAX_BLOCK_SIZE];
+    uint16_t length;
+    uint8_t count;
+    sht31_reading_t previous;
+    uint32_t previous_step;
+
+    uint32_t readings;
+    uint32_t bytes;
+    uint32_t failed_blocks;
+} sht31_log_encoder_t;
+
+typedef struct
+{
+    const uint8_t *data;
+    uint32_t length;
+    uint32_t position;
+
+    // Block being decoded
+    const uint8_t *payload;
+    uint16_t payload_length;
+    uint16_t payload_position;
+    uint8_t remaining;
+    bool keyframe;
+    sht31_reading_t previous;
+    uint32_t previous_step;
+
+    uint32_t corrupt_blocks;
+} sht31_log_reader_t;
+
+/**
+ * @brief
+ *
+ * @param encoder
+ * @param block_readings    Readings per block, 1 to
+ *                          SHT31_LOG_MAX_BLOCK_READINGS. Fewer means more
+ *                          keyframes: quicker seeking and less lost to a bad
+ *                          block, at some cost in size.
+ * @param write             Called with each finished block
+ * @param context           Passed to write
+ * @return true
+ * @return false            block_readings is out of range
+ */
+bool sht31_log_encoder_init(sht31_log_encoder_t *encoder,
+                            uint8_t block_readings, sht31_log_write_t write,
+                            void *context);
+
+/**
+ * @brief   Adds a reading, writing out the block when it is full.
+ *
+ * @return true
+ * @return false    The block could not be written. It is dropped, counted,
+ *                  and the next reading starts a new block.
+ */
+bool sht31_log_append(sht31_log_encoder_t *encoder,
+                      const sht31_reading_t *reading);
+
+/**
+ * @brief   Writes out a part filled block, e.g. before power down. Does
+ * nothing if the block is empty.
+ */
+bool sht31_log_flush(sht31_log_encoder_t *encoder);
+
+/**
+ * @brief   Bytes handed to write so far.
+ */
+uint32_t sht31_log_bytes(const sht31_log_encoder_t *encoder);
+
+/**
+ * @brief   Reads a log held in memory. data must stay valid while the
+ * reader is used.
+ */
+void sht31_log_reader_init(sht31_log_reader_t *reader, const uint8_t *data,
+                           uint32_t length);
+
+/**
+ * @brief   Decodes the next reading. Blocks that fail their CRC are skipped
+ * and counted; decoding carries on from the next good block.
+ *
+ * @return true
+ * @return false    No more readings
+ */
+bool sht31_log_read(sht31_log_reader_t *reader, sht31_reading_t *reading);
+
+/**
+ * @brief   Positions the reader so the next read returns the first reading
+ * at or after timestamp_ms. Timestamps are expected to increase through the
+ * log; comparisons are wrap safe.
+ *
+ * Hops from block header to block header, so only the block holding the
+ * reading is decoded.
+ *
+ * @return true
+ * @return false    Every reading is before timestamp_ms
+ */
+bool sht31_log_seek(sht31_log_reader_t *reader, uint32_t timestamp_ms);
+
+/**
+ * @brief   Number of blocks skipped because they were damaged.
+ */
+uint32_t sht31_log_corrupt_blocks(const sht31_log_reader_t *reader);
+
+#endif // _SHT31_LOG_H
@@ -0,0 +1,69 @@
+#include "sht31_log_file.h"
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+bool sht31_log_file_open(sht31_log_file_t *file, const char *path)
+{
+    struct stat status;
+    void *map = NULL;
+
+    file->fd   = open(path, O_RDONLY);
+    file->map  = NULL;
+    file->size = 0;
+    if (file->fd < 0)
+    {
+        return false;
+    }
+
+    if ((0 != fstat(file->fd, &status)) ||
+        ((uint64_t)status.st_size > UINT32_MAX))
+    {
+        close(file->fd);
+        file->fd = -1;
+        return false;
+    }
+
+    // An empty log is valid, but mmap() refuses a zero length.
+    if (status.st_size > 0)
+    {
+        map = mmap(NULL, (size_t)status.st_size, PROT_READ, MAP_SHARED,
+                   file->fd, 0);
+        if (MAP_FAILED == map)
+        {
+            close(file->fd);
+            file->fd = -1;
+            return false;
+        }
+        file->map  = map;
+        file->size = (size_t)status.st_size;
+    }
+
+    sht31_log_reader_init(&file->reader, file->map, (uint32_t)file->size);
+    return true;
+}
+
+void sht31_log_file_close(sht31_log_file_t *file)
+{
+    if (NULL != file->map)
+    {
+        munmap((void *)file->map, file->size);
+        file->map = NULL;
+    }
+    if (file->fd >= 0)
+    {
+        close(file->fd);
+        file->fd = -1;
+    }
+    file->size = 0;
+}
+
+sht31_log_reader_t *sht31_log_file_reader(sht31_log_file_t *file)
+{
+    return &file->reader;
+}
+
+#endif // __linux__
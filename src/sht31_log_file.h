@@ -0,0 +1,50 @@
+/**
+ * @file    sht31_log_file.h
+ * @author  Steven Daglish
+ * @brief   Reads an sht31_log file on Linux by mapping it into memory.
+ * @version 0.1
+ * @date    17 October 2026
+ *
+ * The whole file is mapped read only and handed to an sht31_log_reader_t,
+ * so seeking only touches the pages it needs and nothing is copied.
+ *
+ * The source only builds where __linux__ is defined; the encoder and
+ * decoder in sht31_log.h build everywhere.
+ */
+
+#ifndef _SHT31_LOG_FILE_H
+#define _SHT31_LOG_FILE_H
+
+#include "sht31_log.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef struct
+{
+    int fd;
+    const uint8_t *map;
+    size_t size;
+    sht31_log_reader_t reader;
+} sht31_log_file_t;
+
+/**
+ * @brief
+ *
+ * @param file
+ * @param path
+ * @return true
+ * @return false    The file could not be opened or mapped, or is bigger
+ *                  than a reader can address (4 GiB)
+ */
+bool sht31_log_file_open(sht31_log_file_t *file, const char *path);
+
+void sht31_log_file_close(sht31_log_file_t *file);
+
+/**
+ * @brief   The reader over the mapped file, for sht31_log_read() and
+ * sht31_log_seek().
+ */
+sht31_log_reader_t *sht31_log_file_reader(sht31_log_file_t *file);
+
+#endif // _SHT31_LOG_FILE_H
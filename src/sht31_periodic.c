@@ -0,0 +1,85 @@
+#include "sht31_periodic.h"
+
+// Indexed by mps: 0.5, 1, 2, 4 and 10 measurements per second.
+static const uint16_t period_ms[5] = {2000, 1000, 500, 250, 100};
+
+static void begin(sht31_periodic_t *periodic, sht31_t *sensor,
+                  sht31_ring_buffer_t *ring, uint32_t period,
+                  uint32_t now_ms)
+{
+    periodic->sensor        = sensor;
+    periodic->ring          = ring;
+    periodic->period_ms     = period;
+    periodic->next_fetch_ms = now_ms + period;
+    periodic->running       = true;
+}
+
+bool sht31_periodic_start(sht31_periodic_t *periodic, sht31_t *sensor,
+                          sht31_ring_buffer_t *ring, uint8_t repeatability,
+                          uint8_t mps, uint32_t now_ms)
+{
+    periodic->running = false;
+
+    if (false ==
+        sht31_send_periodic_data_acquisition_mode(sensor, repeatability, mps))
+    {
+        return false;
+    }
+
+    begin(periodic, sensor, ring, period_ms[mps], now_ms);
+    return true;
+}
+
+bool sht31_periodic_start_art(sht31_periodic_t *periodic, sht31_t *sensor,
+                              sht31_ring_buffer_t *ring, uint32_t now_ms)
+{
+    periodic->running = false;
+
+    if (false == sht31_send_art_command(sensor))
+    {
+        return false;
+    }
+
+    begin(periodic, sensor, ring, SHT31_ART_PERIOD_MS, now_ms);
+    return true;
+}
+
+bool sht31_periodic_service(sht31_periodic_t *periodic, uint32_t now_ms)
+{
+    if (false == periodic->running)
+    {
+        return false;
+    }
+
+    if ((int32_t)(now_ms - periodic->next_fetch_ms) < 0)
+    {
+        return false;
+    }
+
+    periodic->next_fetch_ms += periodic->period_ms;
+    // If we have fallen more than a period behind, the sensor has only kept
+    // the latest reading, so resynchronise rather than fetching repeatedly.
+    if ((int32_t)(now_ms - periodic->next_fetch_ms) >= 0)
+    {
+        periodic->next_fetch_ms = now_ms + periodic->period_ms;
+    }
+
+    if (false == sht31_fetch_periodic_data(periodic->sensor))
+    {
+        return false;
+    }
+
+    sht31_reading_t reading = {
+        .timestamp_ms = now_ms,
+        .temperature  = sht31_return_temperature(periodic->sensor),
+        .humidity     = sht31_return_humidity(periodic->sensor),
+    };
+
+    return sht31_ring_buffer_push(periodic->ring, &reading);
+}
+
+bool sht31_periodic_stop(sht31_periodic_t *periodic)
+{
+    periodic->running = false;
+    return sht31_break_command(periodic->sensor);
+}
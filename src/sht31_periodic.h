@@ -0,0 +1,69 @@
+/**
+ * @file    sht31_periodic.h
+ * @author  Steven Daglish
+ * @brief   Periodic acquisition: fetches each measurement the sensor makes
+ *          and queues it, timestamped, in a ring buffer.
+ * @version 0.1
+ * @date    17 October 2026
+ *
+ * Call sht31_periodic_service() often (at least once per measurement
+ * period). The consumer drains the ring buffer in batches at its own pace.
+ */
+
+#ifndef _SHT31_PERIODIC_H
+#define _SHT31_PERIODIC_H
+
+#include "sht31_driver.h"
+#include "sht31_ring_buffer.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SHT31_ART_PERIOD_MS 250
+
+typedef struct
+{
+    sht31_t *sensor;
+    sht31_ring_buffer_t *ring;
+    uint32_t period_ms;
+    uint32_t next_fetch_ms;
+    bool running;
+} sht31_periodic_t;
+
+/**
+ * @brief   Puts the sensor in periodic mode and starts queueing readings.
+ *
+ * @param periodic
+ * @param sensor
+ * @param ring              Where readings are queued
+ * @param repeatability     0 = low, 1 = medium, 2 = high
+ * @param mps               0 = 0.5, 1 = 1, 2 = 2, 3 = 4, 4 = 10
+ * @param now_ms            Current time in milliseconds
+ * @return true
+ * @return false            Sensor did not ack
+ */
+bool sht31_periodic_start(sht31_periodic_t *periodic, sht31_t *sensor,
+                          sht31_ring_buffer_t *ring, uint8_t repeatability,
+                          uint8_t mps, uint32_t now_ms);
+
+/**
+ * @brief   As sht31_periodic_start() but in accelerated response time mode.
+ */
+bool sht31_periodic_start_art(sht31_periodic_t *periodic, sht31_t *sensor,
+                              sht31_ring_buffer_t *ring, uint32_t now_ms);
+
+/**
+ * @brief   Fetches a reading if one is due and pushes it to the ring buffer.
+ *
+ * @param periodic
+ * @param now_ms    Current time in milliseconds
+ * @return true     A reading was queued
+ * @return false    Nothing due, the fetch failed or the ring buffer was full
+ */
+bool sht31_periodic_service(sht31_periodic_t *periodic, uint32_t now_ms);
+
+/**
+ * @brief   Sends the break command to return the sensor to single shot mode.
+ */
+bool sht31_periodic_stop(sht31_periodic_t *periodic);
+
+#endif // _SHT31_PERIODIC_H
@@ -0,0 +1,340 @@
+#include "sht31_power.h"
+#include <stddef.h>
+
+#define PERIODIC_RATES 5
+#define NJ_PER_MV_NA_US 1000000000ull
+
+// Periodic rates by mps index, and datasheet typical conversion times.
+static const uint32_t periodic_period_ms[PERIODIC_RATES] = {
+    2000, 1000, 500, 250, 100};
+static const uint32_t typical_conversion_us[3] = {2500, 4500, 12500};
+
+void sht31_power_default_model(sht31_power_model_t *model)
+{
+    model->supply_mv        = 3300;
+    model->measuring_na     = 600000;
+    model->periodic_idle_na = 45000;
+    model->idle_na          = 200;
+}
+
+void sht31_power_default_config(sht31_power_config_t *config)
+{
+    config->mode             = SHT31_POWER_SINGLE_SHOT;
+    config->repeatability    = SHT_REPEATABILITY_HIGH;
+    config->sample_period_ms = 1000;
+    config->burst            = 1;
+    config->max_latency_ms   = 10;
+    config->wake_up_ms       = 1;
+}
+
+static bool periodic_mps(uint32_t period_ms, uint8_t *mps)
+{
+    uint8_t i = 0;
+
+    for (i = 0; i < PERIODIC_RATES; i++)
+    {
+        if (periodic_period_ms[i] == period_ms)
+        {
+            *mps = i;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool sht31_power_config_valid(const sht31_power_config_t *config)
+{
+    uint8_t mps = 0;
+
+    if ((config->repeatability > SHT_REPEATABILITY_HIGH) ||
+        (config->max_latency_ms >= config->sample_period_ms))
+    {
+        return false;
+    }
+
+    if (SHT31_POWER_PERIODIC == config->mode)
+    {
+        return periodic_mps(config->sample_period_ms, &mps);
+    }
+
+    return (config->burst > 0) &&
+           ((uint32_t)config->burst *
+                sht31_single_shot_duration_ms(config->repeatability) <
+            config->sample_period_ms);
+}
+
+bool sht31_power_init(sht31_power_t *power, sht31_t *sensor,
+                      const sht31_power_config_t *config)
+{
+    if (false == sht31_power_config_valid(config))
+    {
+        return false;
+    }
+
+    power->sensor        = sensor;
+    power->config        = *config;
+    power->running       = false;
+    power->restarting    = false;
+    power->restart_at_ms = 0;
+    power->next_ms       = 0;
+    power->burst_left    = 0;
+    power->samples       = 0;
+    power->failures      = 0;
+
+    return true;
+}
+
+bool sht31_power_start(sht31_power_t *power, uint32_t now_ms)
+{
+    const sht31_power_config_t *config = &power->config;
+    uint8_t mps                        = 0;
+
+    power->restarting = false;
+    power->burst_left = 0;
+    power->next_ms    = now_ms;
+
+    if (SHT31_POWER_PERIODIC == config->mode)
+    {
+        periodic_mps(config->sample_period_ms, &mps);
+        power->running = sht31_send_periodic_data_acquisition_mode(
+            power->sensor, config->repeatability, mps);
+        power->next_ms =
+            sht31_result_ready_ms(config->repeatability, now_ms);
+        return power->running;
+    }
+
+    power->running = true;
+    return true;
+}
+
+bool sht31_power_stop(sht31_power_t *power)
+{
+    power->running           = false;
+    power->restarting        = false;
+    power->burst_left        = 0;
+    power->sensor->measuring = false;
+
+    return sht31_break_command(power->sensor);
+}
+
+bool sht31_power_reconfigure(sht31_power_t *power,
+                             const sht31_power_config_t *config,
+                             uint32_t now_ms)
+{
+    bool was_running = power->running || power->restarting;
+
+    if (false == sht31_power_config_valid(config))
+    {
+        return false;
+    }
+
+    power->config = *config;
+    if (false == was_running)
+    {
+        return true;
+    }
+
+    if (false == sht31_power_stop(power))
+    {
+        return false;
+    }
+    power->restarting    = true;
+    power->restart_at_ms = now_ms + SHT31_POWER_BREAK_MS;
+    return true;
+}
+
+static bool due(uint32_t at_ms, uint32_t now_ms)
+{
+    // Signed difference so the millisecond counter can wrap.
+    return (int32_t)(now_ms - at_ms) >= 0;
+}
+
+/*
+ * Keeps to the grid set at start, so a late service skips what it missed.
+ */
+static void schedule_next(sht31_power_t *power, uint32_t now_ms)
+{
+    do
+    {
+        power->next_ms += power->config.sample_period_ms;
+    } while (due(power->next_ms, now_ms));
+}
+
+static sht31_poll_t count(sht31_power_t *power, sht31_poll_t result)
+{
+    if (SHT31_POLL_DONE == result)
+    {
+        power->samples++;
+    }
+    else if (SHT31_POLL_ERROR == result)
+    {
+        power->failures++;
+    }
+    return result;
+}
+
+static sht31_poll_t service_periodic(sht31_power_t *power, uint32_t now_ms)
+{
+    if (false == due(power->next_ms, now_ms))
+    {
+        return SHT31_POLL_BUSY;
+    }
+
+    schedule_next(power, now_ms);
+    return sht31_fetch_periodic_data(power->sensor) ? SHT31_POLL_DONE
+                                                    : SHT31_POLL_ERROR;
+}
+
+static sht31_poll_t service_single_shot(sht31_power_t *power, uint32_t now_ms)
+{
+    sht31_t *sensor       = power->sensor;
+    sht31_poll_t result   = SHT31_POLL_BUSY;
+    uint8_t repeatability = power->config.repeatability;
+
+    if (sensor->measuring)
+    {
+        result = sht31_poll(sensor, now_ms);
+        if (SHT31_POLL_BUSY == result)
+        {
+            return result;
+        }
+        power->burst_left--;
+    }
+    else if (due(power->next_ms, now_ms))
+    {
+        power->burst_left = power->config.burst;
+        schedule_next(power, now_ms);
+    }
+
+    // The rest of the burst follows straight on.
+    if ((power->burst_left > 0) &&
+        (false == sht31_begin_measurement(sensor, repeatability, now_ms)))
+    {
+        power->burst_left = 0;
+        result            = SHT31_POLL_ERROR;
+    }
+    return result;
+}
+
+sht31_poll_t sht31_power_service(sht31_power_t *power, uint32_t now_ms)
+{
+    if (power->restarting && due(power->restart_at_ms, now_ms))
+    {
+        if (false == sht31_power_start(power, now_ms))
+        {
+            return count(power, SHT31_POLL_ERROR);
+        }
+    }
+
+    if (false == power->running)
+    {
+        return power->restarting ? SHT31_POLL_BUSY : SHT31_POLL_IDLE;
+    }
+
+    if (SHT31_POWER_PERIODIC == power->config.mode)
+    {
+        return count(power, service_periodic(power, now_ms));
+    }
+    return count(power, service_single_shot(power, now_ms));
+}
+
+uint32_t sht31_power_sleep_ms(const sht31_power_t *power, uint32_t now_ms)
+{
+    const sht31_power_config_t *config = &power->config;
+    uint32_t deadline_ms               = 0;
+    int32_t sleep_ms                   = 0;
+
+    if (power->restarting)
+    {
+        deadline_ms = power->restart_at_ms;
+    }
+    else if (false == power->running)
+    {
+        return UINT32_MAX;
+    }
+    else if (power->sensor->measuring)
+    {
+        deadline_ms = power->sensor->ready_at_ms + config->max_latency_ms;
+    }
+    else if (SHT31_POWER_PERIODIC == config->mode)
+    {
+        deadline_ms = power->next_ms + config->max_latency_ms;
+    }
+    else
+    {
+        deadline_ms = power->next_ms;
+    }
+
+    sleep_ms = (int32_t)(deadline_ms - now_ms - config->wake_up_ms);
+    return (sleep_ms > 0) ? (uint32_t)sleep_ms : 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Energy estimates
+///////////////////////////////////////////////////////////////////////////////
+
+/*
+ * Charge drawn over one sample period, in nanoamp microseconds.
+ */
+static uint64_t period_charge(const sht31_power_model_t *model,
+                              const sht31_power_config_t *config)
+{
+    uint64_t period_us    = (uint64_t)config->sample_period_ms * 1000u;
+    uint64_t measuring_us = typical_conversion_us[config->repeatability];
+    uint32_t idle_na      = model->idle_na;
+
+    if (SHT31_POWER_PERIODIC == config->mode)
+    {
+        idle_na = model->periodic_idle_na;
+    }
+    else
+    {
+        measuring_us *= config->burst;
+    }
+
+    return measuring_us * model->measuring_na +
+           (period_us - measuring_us) * idle_na;
+}
+
+static uint32_t samples_per_period(const sht31_power_config_t *config)
+{
+    return (SHT31_POWER_PERIODIC == config->mode) ? 1 : config->burst;
+}
+
+uint32_t sht31_power_energy_per_sample_nj(const sht31_power_model_t *model,
+                                          const sht31_power_config_t *config)
+{
+    sht31_power_model_t typical;
+
+    if (false == sht31_power_config_valid(config))
+    {
+        return 0;
+    }
+    if (NULL == model)
+    {
+        sht31_power_default_model(&typical);
+        model = &typical;
+    }
+
+    return (uint32_t)((period_charge(model, config) * model->supply_mv) /
+                      (NJ_PER_MV_NA_US * samples_per_period(config)));
+}
+
+uint32_t sht31_power_average_current_na(const sht31_power_model_t *model,
+                                        const sht31_power_config_t *config)
+{
+    sht31_power_model_t typical;
+
+    if (false == sht31_power_config_valid(config))
+    {
+        return 0;
+    }
+    if (NULL == model)
+    {
+        sht31_power_default_model(&typical);
+        model = &typical;
+    }
+
+    return (uint32_t)(period_charge(model, config) /
+                      ((uint64_t)config->sample_period_ms * 1000u));
+}
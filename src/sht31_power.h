@@ -0,0 +1,175 @@
+/**
+ * @file    sht31_power.h
+ * @author  Steven Daglish
+ * @brief   Duty cycled sampling for battery nodes: periodic mode or timed
+ *          single shots, how long the MCU may sleep, and what each sample
+ *          costs in energy.
+ * @version 0.1
+ * @date    17 October 2026
+ *
+ * Two modes:
+ *
+ *  SHT31_POWER_PERIODIC    The sensor measures on its own at one of the
+ *                          periodic rates and idles at periodic idle current
+ *                          (about 45 uA) in between. sample_period_ms must be
+ *                          one of those rates' periods.
+ *  SHT31_POWER_SINGLE_SHOT Every sample_period_ms a burst of single shots
+ *                          is taken back to back; between bursts the sensor
+ *                          sits at its idle current (about 0.2 uA).
+ *
+ * Switching mode, or stopping, sends a break so the sensor leaves periodic
+ * mode and idles.
+ *
+ * sht31_power_sleep_ms() says how long the MCU can sleep before it must be
+ * awake for the next step: a burst starts on time, and a result is read no
+ * later than max_latency_ms after it is ready. wake_up_ms is taken off to
+ * cover the MCU's own wake time.
+ *
+ * Energy estimates use the sensor only (not the MCU or bus pull ups) with
+ * the datasheet typical currents and conversion times unless a model is
+ * given.
+ */
+
+#ifndef _SHT31_POWER_H
+#define _SHT31_POWER_H
+
+#include "sht31_driver.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Time the sensor needs after a break before it takes a new command.
+#define SHT31_POWER_BREAK_MS 1
+
+typedef enum
+{
+    SHT31_POWER_PERIODIC,
+    SHT31_POWER_SINGLE_SHOT
+} sht31_power_mode_t;
+
+typedef struct
+{
+    uint16_t supply_mv;
+    uint32_t measuring_na;
+    uint32_t periodic_idle_na;
+    uint32_t idle_na;
+} sht31_power_model_t;
+
+typedef struct
+{
+    sht31_power_mode_t mode;
+    uint8_t repeatability;
+    uint32_t sample_period_ms;
+    uint8_t burst;           // Single shots per period (single shot mode)
+    uint32_t max_latency_ms; // Longest a ready result may wait to be read
+    uint32_t wake_up_ms;     // MCU time from wake up to running
+} sht31_power_config_t;
+
+typedef struct
+{
+    sht31_t *sensor;
+    sht31_power_config_t config;
+
+    bool running;
+    bool restarting;
+    uint32_t restart_at_ms;
+    uint32_t next_ms; // Next burst start, or next periodic result
+    uint8_t burst_left;
+
+    uint32_t samples;
+    uint32_t failures;
+} sht31_power_t;
+
+/**
+ * @brief   Datasheet typical values at 3.3 V: 600 uA measuring, 45 uA idle
+ * in periodic mode, 0.2 uA idle in single shot mode.
+ */
+void sht31_power_default_model(sht31_power_model_t *model);
+
+/**
+ * @brief   One high repeatability single shot a second, read within 10 ms of
+ * being ready, with 1 ms for the MCU to wake.
+ */
+void sht31_power_default_config(sht31_power_config_t *config);
+
+/**
+ * @brief   Checks a configuration: repeatability in range, a latency
+ * shorter than the period, a burst of at least one that fits in the period,
+ * and in periodic mode a period the sensor supports.
+ */
+bool sht31_power_config_valid(const sht31_power_config_t *config);
+
+/**
+ * @brief   Sets up the layer. Nothing is sent until sht31_power_start().
+ *
+ * @param power
+ * @param sensor
+ * @param config    Copied
+ * @return true
+ * @return false    Invalid config
+ */
+bool sht31_power_init(sht31_power_t *power, sht31_t *sensor,
+                      const sht31_power_config_t *config);
+
+/**
+ * @brief   Starts sampling: periodic mode is started straight away; the
+ * first single shot burst starts on the next service.
+ *
+ * @return true
+ * @return false    The sensor did not take periodic mode
+ */
+bool sht31_power_start(sht31_power_t *power, uint32_t now_ms);
+
+/**
+ * @brief   Stops sampling and sends a break so the sensor idles.
+ */
+bool sht31_power_stop(sht31_power_t *power);
+
+/**
+ * @brief   Changes configuration while running. A break is sent and
+ * sampling restarts with the new configuration SHT31_POWER_BREAK_MS later.
+ *
+ * @return true
+ * @return false    Invalid config (nothing changes) or the break failed
+ */
+bool sht31_power_reconfigure(sht31_power_t *power,
+                             const sht31_power_config_t *config,
+                             uint32_t now_ms);
+
+/**
+ * @brief   Starts, reads or fetches whatever is due.
+ *
+ * @return SHT31_POLL_IDLE  Not started
+ * @return SHT31_POLL_BUSY  Nothing new
+ * @return SHT31_POLL_DONE  The sensor handle holds a new sample
+ * @return SHT31_POLL_ERROR A command or read failed; sampling carries on
+ */
+sht31_poll_t sht31_power_service(sht31_power_t *power, uint32_t now_ms);
+
+/**
+ * @brief   Longest the MCU can sleep from now_ms and still meet the sample
+ * period and latency. 0 means service now; UINT32_MAX that nothing is
+ * running.
+ */
+uint32_t sht31_power_sleep_ms(const sht31_power_t *power, uint32_t now_ms);
+
+/**
+ * @brief   Sensor energy per sample for a configuration, in nanojoules.
+ *
+ * @param model     NULL for the datasheet typical values
+ * @param config
+ * @return uint32_t 0 if config is invalid
+ */
+uint32_t sht31_power_energy_per_sample_nj(const sht31_power_model_t *model,
+                                          const sht31_power_config_t *config);
+
+/**
+ * @brief   Average sensor supply current for a configuration, in nanoamps.
+ *
+ * @param model     NULL for the datasheet typical values
+ * @param config
+ * @return uint32_t 0 if config is invalid
+ */
+uint32_t sht31_power_average_current_na(const sht31_power_model_t *model,
+                                        const sht31_power_config_t *config);
+
+#endif // _SHT31_POWER_H
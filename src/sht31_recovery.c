@@ -0,0 +1,251 @@
+#include "sht31_recovery.h"
+#include <stddef.h>
+
+typedef bool (*operation_t)(sht31_recovery_t *recovery, const void *argument);
+
+typedef struct
+{
+    uint8_t repeatability;
+    bool clock_stretch;
+} single_shot_argument_t;
+
+static uint32_t now_us(const sht31_recovery_t *recovery)
+{
+    return recovery->clock->now_us(recovery->clock->context);
+}
+
+static void sleep_us(const sht31_recovery_t *recovery, uint32_t us)
+{
+    recovery->clock->sleep_us(recovery->clock->context, us);
+}
+
+void sht31_recovery_default_config(sht31_recovery_config_t *config)
+{
+    config->max_attempts       = 4;
+    config->backoff_initial_us = 500;
+    config->backoff_max_us     = 8000;
+    config->budget_us          = 50000;
+    config->clear_after        = 2;
+    config->reset_after        = 3;
+}
+
+void sht31_recovery_init(sht31_recovery_t *recovery, sht31_t *sensor,
+                         const sht31_recovery_config_t *config,
+                         const sht31_recovery_clock_t *clock)
+{
+    recovery->sensor                 = sensor;
+    recovery->config                 = *config;
+    recovery->clock                  = clock;
+    recovery->periodic               = false;
+    recovery->periodic_repeatability = 0;
+    recovery->periodic_mps           = 0;
+    recovery->calls                  = 0;
+    recovery->retries                = 0;
+    recovery->recovered              = 0;
+    recovery->failed                 = 0;
+    recovery->over_budget            = 0;
+    recovery->bus_clears             = 0;
+    recovery->soft_resets            = 0;
+
+    if (0 == recovery->config.max_attempts)
+    {
+        recovery->config.max_attempts = 1;
+    }
+}
+
+/*
+ * Clears the bus and/or resets the sensor as the failure count calls for.
+ */
+static void escalate(sht31_recovery_t *recovery, uint8_t failures)
+{
+    const sht31_recovery_config_t *config = &recovery->config;
+    const i2c_bus_t *bus                  = recovery->sensor->bus;
+
+    if ((failures == config->clear_after) && (NULL != bus->bus_clear))
+    {
+        bus->bus_clear(bus->context);
+        recovery->bus_clears++;
+    }
+
+    if (failures == config->reset_after)
+    {
+        sht31_send_soft_reset(recovery->sensor);
+        sleep_us(recovery, SHT31_RECOVERY_SOFT_RESET_US);
+        recovery->soft_resets++;
+
+        if (recovery->periodic)
+        {
+            sht31_send_periodic_data_acquisition_mode(
+                recovery->sensor, recovery->periodic_repeatability,
+                recovery->periodic_mps);
+        }
+    }
+}
+
+/*
+ * Time escalate() may take. A bus clear is nine clocks and a STOP, shorter
+ * than any attempt; a reset is a command, the reset time and possibly the
+ * periodic mode command.
+ */
+static uint32_t escalation_us(const sht31_recovery_t *recovery,
+                              uint8_t failures, uint32_t slowest_us)
+{
+    const sht31_recovery_config_t *config = &recovery->config;
+    uint32_t cost_us                      = 0;
+
+    if ((failures == config->clear_after) &&
+        (NULL != recovery->sensor->bus->bus_clear))
+    {
+        cost_us += slowest_us;
+    }
+    if (failures == config->reset_after)
+    {
+        cost_us += SHT31_RECOVERY_SOFT_RESET_US + 2 * slowest_us;
+    }
+    return cost_us;
+}
+
+static bool run(sht31_recovery_t *recovery, operation_t operation,
+                const void *argument)
+{
+    const sht31_recovery_config_t *config = &recovery->config;
+    uint32_t started_us                   = now_us(recovery);
+    uint32_t backoff_us                   = config->backoff_initial_us;
+    uint32_t slowest_us                   = 0;
+    uint8_t failures                      = 0;
+
+    recovery->calls++;
+
+    while (true)
+    {
+        uint32_t attempt_us = now_us(recovery);
+        uint32_t elapsed_us = 0;
+        uint32_t needed_us  = 0;
+
+        if (operation(recovery, argument))
+        {
+            if (failures > 0)
+            {
+                recovery->recovered++;
+            }
+            return true;
+        }
+
+        failures++;
+        attempt_us = now_us(recovery) - attempt_us;
+        if (attempt_us > slowest_us)
+        {
+            slowest_us = attempt_us;
+        }
+
+        if (failures >= config->max_attempts)
+        {
+            break;
+        }
+
+        // Give up now unless recovery, the wait and another attempt as slow
+        // as the slowest so far all fit in what is left of the budget.
+        elapsed_us = now_us(recovery) - started_us;
+        needed_us  = escalation_us(recovery, failures, slowest_us) +
+                     backoff_us + slowest_us;
+        if ((elapsed_us > config->budget_us) ||
+            (config->budget_us - elapsed_us < needed_us))
+        {
+            recovery->over_budget++;
+            break;
+        }
+
+        escalate(recovery, failures);
+        sleep_us(recovery, backoff_us);
+        backoff_us = (backoff_us > config->backoff_max_us / 2)
+                         ? config->backoff_max_us
+                         : backoff_us * 2;
+
+        recovery->retries++;
+#ifdef SHT31_ENABLE_STATS
+        sht31_stats_count_retry(recovery->sensor);
+#endif
+    }
+
+    recovery->failed++;
+    return false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Operations
+///////////////////////////////////////////////////////////////////////////////
+
+static bool start_periodic(sht31_recovery_t *recovery, const void *argument)
+{
+    (void)argument;
+    return sht31_send_periodic_data_acquisition_mode(
+        recovery->sensor, recovery->periodic_repeatability,
+        recovery->periodic_mps);
+}
+
+static bool stop_periodic(sht31_recovery_t *recovery, const void *argument)
+{
+    (void)argument;
+    return sht31_break_command(recovery->sensor);
+}
+
+static bool fetch_periodic_data(sht31_recovery_t *recovery,
+                                const void *argument)
+{
+    (void)argument;
+    return sht31_fetch_periodic_data(recovery->sensor);
+}
+
+static bool get_single_shot_data(sht31_recovery_t *recovery,
+                                 const void *argument)
+{
+    const single_shot_argument_t *mode = argument;
+
+    return sht31_get_single_shot_data_in_mode(
+        recovery->sensor, mode->repeatability, mode->clock_stretch);
+}
+
+static bool read_status_register(sht31_recovery_t *recovery,
+                                 const void *argument)
+{
+    (void)argument;
+    return sht31_read_status_register(recovery->sensor);
+}
+
+bool sht31_recovery_start_periodic(sht31_recovery_t *recovery,
+                                   uint8_t repeatability, uint8_t mps)
+{
+    recovery->periodic_repeatability = repeatability;
+    recovery->periodic_mps           = mps;
+    recovery->periodic               = run(recovery, start_periodic, NULL);
+
+    return recovery->periodic;
+}
+
+bool sht31_recovery_stop_periodic(sht31_recovery_t *recovery)
+{
+    recovery->periodic = false;
+    return run(recovery, stop_periodic, NULL);
+}
+
+bool sht31_recovery_fetch_periodic_data(sht31_recovery_t *recovery)
+{
+    return run(recovery, fetch_periodic_data, NULL);
+}
+
+bool sht31_recovery_get_single_shot_data(sht31_recovery_t *recovery,
+                                         uint8_t repeatability,
+                                         bool clock_stretch)
+{
+    single_shot_argument_t mode = {
+        .repeatability = repeatability,
+        .clock_stretch = clock_stretch,
+    };
+
+    return run(recovery, get_single_shot_data, &mode);
+}
+
+bool sht31_recovery_read_status_register(sht31_recovery_t *recovery)
+{
+    return run(recovery, read_status_register, NULL);
+}
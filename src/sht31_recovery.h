@@ -0,0 +1,124 @@
+/**
+ * @file    sht31_recovery.h
+ * @author  Steven Daglish
+ * @brief   Retries failed sensor calls with backoff, bus clears and soft
+ *          resets, within a fixed time budget per call.
+ * @version 0.1
+ * @date    17 October 2026
+ *
+ * A failed attempt (NACK or CRC mismatch) is retried up to max_attempts
+ * times in all. The wait before each retry starts at backoff_initial_us
+ * and doubles up to backoff_max_us. Recovery escalates with the failures:
+ *
+ *  clear_after     After this many failed attempts the bus is cleared
+ *                  (i2c_bus_t bus_clear), if the bus can do it.
+ *  reset_after     After this many the sensor is soft reset. If periodic
+ *                  mode was started through sht31_recovery_start_periodic()
+ *                  it is started again straight after.
+ *
+ * Either step is skipped if set to 0.
+ *
+ * The time budget is hard. Before each retry the layer checks that the
+ * wait plus the slowest attempt seen so far still fits. If it would not,
+ * the call gives up early. The first attempt always runs, so the budget
+ * should cover at least one.
+ *
+ * Time comes from a caller supplied clock, as the driver has none.
+ */
+
+#ifndef _SHT31_RECOVERY_H
+#define _SHT31_RECOVERY_H
+
+#include "sht31_driver.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+// Datasheet maximum time from a soft reset until the sensor takes commands.
+#define SHT31_RECOVERY_SOFT_RESET_US 1500
+
+typedef struct
+{
+    void *context;
+    uint32_t (*now_us)(void *context);
+    void (*sleep_us)(void *context, uint32_t us);
+} sht31_recovery_clock_t;
+
+typedef struct
+{
+    uint8_t max_attempts;
+    uint32_t backoff_initial_us;
+    uint32_t backoff_max_us;
+    uint32_t budget_us;
+    uint8_t clear_after;
+    uint8_t reset_after;
+} sht31_recovery_config_t;
+
+typedef struct
+{
+    sht31_t *sensor;
+    sht31_recovery_config_t config;
+    const sht31_recovery_clock_t *clock;
+
+    // Periodic mode to restore after a soft reset
+    bool periodic;
+    uint8_t periodic_repeatability;
+    uint8_t periodic_mps;
+
+    // Counters
+    uint32_t calls;
+    uint32_t retries;
+    uint32_t recovered;
+    uint32_t failed;
+    uint32_t over_budget;
+    uint32_t bus_clears;
+    uint32_t soft_resets;
+} sht31_recovery_t;
+
+/**
+ * @brief   4 attempts, backoff from 500 us to 8 ms, 50 ms budget, bus clear
+ * after 2 failures and soft reset after 3.
+ */
+void sht31_recovery_default_config(sht31_recovery_config_t *config);
+
+/**
+ * @brief
+ *
+ * @param recovery
+ * @param sensor    Initialised sensor handle
+ * @param config    Copied. max_attempts of 0 is taken as 1.
+ * @param clock
+ */
+void sht31_recovery_init(sht31_recovery_t *recovery, sht31_t *sensor,
+                         const sht31_recovery_config_t *config,
+                         const sht31_recovery_clock_t *clock);
+
+/**
+ * @brief   sht31_send_periodic_data_acquisition_mode() with recovery. The
+ * mode is remembered and restored after any later soft reset.
+ */
+bool sht31_recovery_start_periodic(sht31_recovery_t *recovery,
+                                   uint8_t repeatability, uint8_t mps);
+
+/**
+ * @brief   sht31_break_command() with recovery. Forgets the periodic mode.
+ */
+bool sht31_recovery_stop_periodic(sht31_recovery_t *recovery);
+
+/**
+ * @brief   sht31_fetch_periodic_data() with recovery.
+ */
+bool sht31_recovery_fetch_periodic_data(sht31_recovery_t *recovery);
+
+/**
+ * @brief   sht31_get_single_shot_data_in_mode() with recovery.
+ */
+bool sht31_recovery_get_single_shot_data(sht31_recovery_t *recovery,
+                                         uint8_t repeatability,
+                                         bool clock_stretch);
+
+/**
+ * @brief   sht31_read_status_register() with recovery.
+ */
+bool sht31_recovery_read_status_register(sht31_recovery_t *recovery);
+
+#endif // _SHT31_RECOVERY_H
@@ -0,0 +1,82 @@
+#include "sht31_ring_buffer.h"
+
+/*
+ * The storage write must be visible before the index that publishes it, and
+ * the index must be read before the storage it guards. A compiler barrier is
+ * enough on a single core part; hosted builds get a full fence.
+ */
+#if defined(__XC16__)
+#define MEMORY_BARRIER() __asm__ volatile("" ::: "memory")
+#else
+#define MEMORY_BARRIER() __sync_synchronize()
+#endif
+
+#define MAX_CAPACITY 32768u
+
+bool sht31_ring_buffer_init(sht31_ring_buffer_t *ring,
+                            sht31_reading_t *storage, uint16_t capacity)
+{
+    if ((0 == capacity) || (capacity > MAX_CAPACITY) ||
+        (0 != (capacity & (capacity - 1))))
+    {
+        return false;
+    }
+
+    ring->storage = storage;
+    ring->mask    = capacity - 1;
+    ring->head    = 0;
+    ring->tail    = 0;
+    ring->dropped = 0;
+
+    return true;
+}
+
+bool sht31_ring_buffer_push(sht31_ring_buffer_t *ring,
+                            const sht31_reading_t *reading)
+{
+    uint16_t head = ring->head;
+    uint16_t tail = ring->tail;
+
+    // Indexes run freely and wrap at 65536; their difference is the fill.
+    if ((uint16_t)(head - tail) > ring->mask)
+    {
+        ring->dropped++;
+        return false;
+    }
+
+    MEMORY_BARRIER();
+    ring->storage[head & ring->mask] = *reading;
+    MEMORY_BARRIER();
+    ring->head = head + 1;
+
+    return true;
+}
+
+uint16_t sht31_ring_buffer_pop_batch(sht31_ring_buffer_t *ring,
+                                     sht31_reading_t *readings, uint16_t max)
+{
+    uint16_t tail      = ring->tail;
+    uint16_t available = (uint16_t)(ring->head - tail);
+    uint16_t count     = (available < max) ? available : max;
+    uint16_t i         = 0;
+
+    MEMORY_BARRIER();
+    for (i = 0; i < count; i++)
+    {
+        readings[i] = ring->storage[(uint16_t)(tail + i) & ring->mask];
+    }
+    MEMORY_BARRIER();
+    ring->tail = tail + count;
+
+    return count;
+}
+
+uint16_t sht31_ring_buffer_count(const sht31_ring_buffer_t *ring)
+{
+    return (uint16_t)(ring->head - ring->tail);
+}
+
+uint16_t sht31_ring_buffer_dropped(const sht31_ring_buffer_t *ring)
+{
+    return ring->dropped;
+}
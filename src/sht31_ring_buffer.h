@@ -0,0 +1,78 @@
+/**
+ * @file    sht31_ring_buffer.h
+ * @author  Steven Daglish
+ * @brief   Lock-free single producer, single consumer ring buffer of
+ *          timestamped readings.
+ * @version 0.1
+ * @date    17 October 2026
+ *
+ * One side (e.g. a timer interrupt or sampling task) pushes, the other
+ * (e.g. a telemetry task) pops. Neither side needs to disable interrupts or
+ * take a lock: the producer only writes head, the consumer only writes tail.
+ *
+ * The storage is supplied by the caller and its size must be a power of two,
+ * no bigger than 32768.
+ */
+
+#ifndef _SHT31_RING_BUFFER_H
+#define _SHT31_RING_BUFFER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef struct
+{
+    uint32_t timestamp_ms;
+    uint16_t temperature;
+    uint16_t humidity;
+} sht31_reading_t;
+
+typedef struct
+{
+    sht31_reading_t *storage;
+    uint16_t mask;
+    volatile uint16_t head;
+    volatile uint16_t tail;
+    volatile uint16_t dropped;
+} sht31_ring_buffer_t;
+
+/**
+ * @brief
+ *
+ * @param ring
+ * @param storage   Caller owned array of capacity readings
+ * @param capacity  Power of two, 1 to 32768
+ * @return true
+ * @return false    capacity is not a usable size
+ */
+bool sht31_ring_buffer_init(sht31_ring_buffer_t *ring,
+                            sht31_reading_t *storage, uint16_t capacity);
+
+/**
+ * @brief   Producer side. Adds a reading if there is room.
+ *
+ * @return true
+ * @return false    Buffer full, reading dropped and counted
+ */
+bool sht31_ring_buffer_push(sht31_ring_buffer_t *ring,
+                            const sht31_reading_t *reading);
+
+/**
+ * @brief   Consumer side. Removes up to max readings, oldest first.
+ *
+ * @param ring
+ * @param readings  Where the readings are copied to
+ * @param max       Size of readings
+ * @return uint16_t Number of readings copied
+ */
+uint16_t sht31_ring_buffer_pop_batch(sht31_ring_buffer_t *ring,
+                                     sht31_reading_t *readings, uint16_t max);
+
+uint16_t sht31_ring_buffer_count(const sht31_ring_buffer_t *ring);
+
+/**
+ * @brief   Number of readings dropped because the buffer was full.
+ */
+uint16_t sht31_ring_buffer_dropped(const sht31_ring_buffer_t *ring);
+
+#endif // _SHT31_RING_BUFFER_H
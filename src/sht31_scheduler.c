@@ -0,0 +1,115 @@
+#include "sht31_scheduler.h"
+
+void sht31_scheduler_init(sht31_scheduler_t *scheduler, sht31_t *sensors,
+                          uint8_t count, uint8_t repeatability,
+                          uint32_t cycle_period_ms,
+                          sht31_scheduler_callback_t callback, void *context)
+{
+    scheduler->sensors          = sensors;
+    scheduler->count            = count;
+    scheduler->repeatability    = repeatability;
+    scheduler->cycle_period_ms  = cycle_period_ms;
+    scheduler->callback         = callback;
+    scheduler->context          = context;
+    scheduler->collecting       = false;
+    scheduler->next             = 0;
+    scheduler->cycle_started_ms = 0;
+    scheduler->next_cycle_ms    = 0;
+    scheduler->cycles           = 0;
+}
+
+static void start_cycle(sht31_scheduler_t *scheduler, uint32_t now_ms)
+{
+    uint8_t i = 0;
+
+    // A sensor that nacks here is left idle and reported as failed when its
+    // turn to be collected comes round.
+    for (i = 0; i < scheduler->count; i++)
+    {
+        sht31_begin_measurement(&scheduler->sensors[i],
+                                scheduler->repeatability, now_ms);
+    }
+
+    scheduler->collecting       = true;
+    scheduler->next             = 0;
+    scheduler->cycle_started_ms = now_ms;
+}
+
+static void end_cycle(sht31_scheduler_t *scheduler, uint32_t now_ms)
+{
+    scheduler->collecting = false;
+    scheduler->cycles++;
+
+    if (0 == scheduler->cycle_period_ms)
+    {
+        scheduler->next_cycle_ms = now_ms;
+        return;
+    }
+
+    scheduler->next_cycle_ms =
+        scheduler->cycle_started_ms + scheduler->cycle_period_ms;
+    // Collection overran the period: start again now rather than trying to
+    // catch up.
+    if ((int32_t)(now_ms - scheduler->next_cycle_ms) > 0)
+    {
+        scheduler->next_cycle_ms = now_ms;
+    }
+}
+
+static uint8_t collect(sht31_scheduler_t *scheduler, uint32_t now_ms)
+{
+    uint32_t ready_ms = sht31_result_ready_ms(scheduler->repeatability,
+                                              scheduler->cycle_started_ms);
+    uint8_t collected = 0;
+
+    if ((int32_t)(now_ms - ready_ms) < 0)
+    {
+        return 0;
+    }
+
+    while (scheduler->next < scheduler->count)
+    {
+        uint8_t index      = scheduler->next;
+        sht31_t *sensor    = &scheduler->sensors[index];
+        sht31_poll_t state = sht31_poll(sensor, now_ms);
+
+        if (SHT31_POLL_BUSY == state)
+        {
+            break;
+        }
+
+        scheduler->callback(scheduler->context, index, sensor,
+                            SHT31_POLL_DONE == state);
+        scheduler->next++;
+        collected++;
+    }
+
+    if (scheduler->next >= scheduler->count)
+    {
+        end_cycle(scheduler, now_ms);
+    }
+    return collected;
+}
+
+uint8_t sht31_scheduler_service(sht31_scheduler_t *scheduler,
+                                uint32_t now_ms)
+{
+    if (scheduler->collecting)
+    {
+        return collect(scheduler, now_ms);
+    }
+
+    if ((scheduler->cycles > 0) &&
+        ((int32_t)(now_ms - scheduler->next_cycle_ms) < 0))
+    {
+        return 0;
+    }
+
+    start_cycle(scheduler, now_ms);
+    return 0;
+}
+
+uint32_t sht31_scheduler_cycles(const sht31_scheduler_t *scheduler)
+{
+    return scheduler->cycles;
+}
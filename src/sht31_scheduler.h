@@ -0,0 +1,90 @@
+/**
+ * @file    sht31_scheduler.h
+ * @author  Steven Daglish
+ * @brief   Round robin single shot measurements on several sensors with the
+ *          conversions overlapped.
+ * @version 0.1
+ * @date    17 October 2026
+ *
+ * Each cycle starts a no clock stretch conversion on every sensor back to
+ * back, then collects the results in the same order once the conversion time
+ * has passed. The bus is free while the sensors convert, so N sensors take
+ * one conversion time per cycle instead of N.
+ *
+ * Sensors are collected in the order they were started. A read takes longer
+ * on the bus than a command, so once the first sensor is ready every later
+ * one is too.
+ *
+ * Call sht31_scheduler_service() often; each result is handed to the
+ * callback as it is read.
+ */
+
+#ifndef _SHT31_SCHEDULER_H
+#define _SHT31_SCHEDULER_H
+
+#include "sht31_driver.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief   Called once per sensor per cycle, in sensor order.
+ *
+ * @param context   As given to sht31_scheduler_init()
+ * @param index     Position of the sensor in the sensors array
+ * @param sensor    Holds the new temperature and humidity when success
+ * @param success   false if the sensor nacked or the CRC failed
+ */
+typedef void (*sht31_scheduler_callback_t)(void *context, uint8_t index,
+                                           const sht31_t *sensor,
+                                           bool success);
+
+typedef struct
+{
+    sht31_t *sensors;
+    uint8_t count;
+    uint8_t repeatability;
+    uint32_t cycle_period_ms;
+    sht31_scheduler_callback_t callback;
+    void *context;
+
+    bool collecting;
+    uint8_t next;
+    uint32_t cycle_started_ms;
+    uint32_t next_cycle_ms;
+    uint32_t cycles;
+} sht31_scheduler_t;
+
+/**
+ * @brief   Sets up a scheduler. Nothing is sent until the first service.
+ *
+ * @param scheduler
+ * @param sensors           count initialised sensor handles, on any buses
+ * @param count
+ * @param repeatability     0 = low, 1 = medium, 2 = high
+ * @param cycle_period_ms   Time from the start of one cycle to the next, or 0
+ *                          to start the next cycle as soon as one completes
+ * @param callback
+ * @param context           Passed to callback
+ */
+void sht31_scheduler_init(sht31_scheduler_t *scheduler, sht31_t *sensors,
+                          uint8_t count, uint8_t repeatability,
+                          uint32_t cycle_period_ms,
+                          sht31_scheduler_callback_t callback, void *context);
+
+/**
+ * @brief   Starts a cycle if one is due, or collects every result that is
+ * ready.
+ *
+ * @param scheduler
+ * @param now_ms        Current time in milliseconds
+ * @return uint8_t      Number of results handed to the callback
+ */
+uint8_t sht31_scheduler_service(sht31_scheduler_t *scheduler,
+                                uint32_t now_ms);
+
+/**
+ * @brief   Number of cycles completed since sht31_scheduler_init().
+ */
+uint32_t sht31_scheduler_cycles(const sht31_scheduler_t *scheduler);
+
+#endif // _SHT31_SCHEDULER_H
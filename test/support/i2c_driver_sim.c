@@ -0,0 +1,54 @@
+#include "i2c_driver_sim.h"
+
+static i2c_sim_t *attached_sim;
+static i2c_bus_t sim_bus;
+
+void i2c_driver_sim_attach(i2c_sim_t *sim)
+{
+    attached_sim = sim;
+}
+
+void i2c_driver_create(void)
+{
+    i2c_sim_bus(attached_sim, &sim_bus);
+}
+
+void i2c_driver_start(void)
+{
+    sim_bus.start(sim_bus.context);
+}
+
+void i2c_driver_stop(void)
+{
+    sim_bus.stop(sim_bus.context);
+}
+
+bool i2c_driver_send_address_write(uint8_t address)
+{
+    return sim_bus.send_address_write(sim_bus.context, address);
+}
+
+bool i2c_driver_send_address_read(uint8_t address)
+{
+    return sim_bus.send_address_read(sim_bus.context, address);
+}
+
+bool i2c_driver_send_data(uint8_t data)
+{
+    return sim_bus.send_data(sim_bus.context, data);
+}
+
+uint8_t i2c_driver_read_data(bool ack)
+{
+    return sim_bus.read_data(sim_bus.context, ack);
+}
+
+bool i2c_driver_read_block(uint8_t *data, uint8_t length)
+{
+    return sim_bus.read_block(sim_bus.context, data, length);
+}
+
+bool i2c_driver_write_block(const uint8_t *data, uint8_t length)
+{
+    return sim_bus.write_block(sim_bus.context, data, length);
+}
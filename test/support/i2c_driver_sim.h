@@ -0,0 +1,22 @@
+/**
+ * @file    i2c_driver_sim.h
+ * @author  Steven Daglish
+ * @brief   Implements i2c_driver.h on top of a simulated bus, so code written
+ *          against the single bus API runs on a host.
+ * @version 0.1
+ * @date    17 October 2026
+ */
+
+#ifndef _I2C_DRIVER_SIM_H
+#define _I2C_DRIVER_SIM_H
+
+#include "i2c_driver.h"
+#include "i2c_sim.h"
+
+/**
+ * @brief   Routes every i2c_driver_* call to sim. Must be called before
+ * i2c_driver_create().
+ */
+void i2c_driver_sim_attach(i2c_sim_t *sim);
+
+#endif // _I2C_DRIVER_SIM_H
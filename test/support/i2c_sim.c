@@ -0,0 +1,701 @@
+#include "i2c_sim.h"
+#include "crc8.h"
+#include <stddef.h>
+
+#define BITS_PER_BYTE 9
+#define NS_PER_MS 1000000u
+
+// Power up: alert pending and reset detected.
+#define STATUS_POWER_UP 0x8010
+#define STATUS_ALERT_PENDING 0x8000
+#define STATUS_HEATER_ON 0x2000
+#define STATUS_RH_ALERT 0x0800
+#define STATUS_T_ALERT 0x0400
+#define STATUS_RESET_DETECTED 0x0010
+#define STATUS_COMMAND_FAILED 0x0002
+#define STATUS_WRITE_CRC_FAILED 0x0001
+
+#define ALERT_HIGH_SET 0
+#define ALERT_HIGH_CLEAR 1
+#define ALERT_LOW_CLEAR 2
+#define ALERT_LOW_SET 3
+
+// Datasheet defaults: set above 60 C or 80 %RH, below -10 C or 20 %RH;
+// clear below 58 C and 79 %RH, above -9 C and 22 %RH.
+static const uint16_t default_alert_limits[I2C_SIM_ALERT_LIMITS] = {
+    0xCD33, 0xCB2D, 0x3869, 0x3266};
+
+// Alert limit commands, in the same order.
+static const uint16_t alert_read_command[I2C_SIM_ALERT_LIMITS] = {
+    0xE11F, 0xE114, 0xE109, 0xE102};
+static const uint16_t alert_write_command[I2C_SIM_ALERT_LIMITS] = {
+    0x611D, 0x6116, 0x610B, 0x6100};
+
+// Datasheet maximum conversion times, low, medium and high repeatability.
+static const uint32_t duration_ns[3] = {4500000, 6500000, 15500000};
+
+///////////////////////////////////////////////////////////////////////////////
+// Timing
+///////////////////////////////////////////////////////////////////////////////
+
+static void clock_periods(i2c_sim_t *sim, uint32_t periods)
+{
+    uint64_t ns = (uint64_t)periods * sim->period_ns;
+    sim->time_ns += ns;
+    sim->busy_ns += ns;
+}
+
+static void clock_byte(i2c_sim_t *sim)
+{
+    clock_periods(sim, BITS_PER_BYTE);
+    sim->scl_cycles += BITS_PER_BYTE;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Device model
+///////////////////////////////////////////////////////////////////////////////
+
+static void device_reset(i2c_sim_device_t *device)
+{
+    uint8_t i = 0;
+
+    device->status_register   = STATUS_POWER_UP;
+    device->converting        = false;
+    device->result_ready      = false;
+    device->periodic          = false;
+    device->temperature_alert = false;
+    device->humidity_alert    = false;
+    device->alert_pin         = false;
+    device->command_length    = 0;
+    device->read_length       = 0;
+    device->read_position     = 0;
+
+    for (i = 0; i < I2C_SIM_ALERT_LIMITS; i++)
+    {
+        device->alert_limits[i] = default_alert_limits[i];
+    }
+}
+
+/*
+ * One channel's alert with hysteresis. Values and limits are compared at
+ * the resolution the limits are stored at.
+ */
+static bool track_alert(bool active, uint16_t value, const uint16_t *limits)
+{
+    if ((value > limits[ALERT_HIGH_SET]) || (value < limits[ALERT_LOW_SET]))
+    {
+        return true;
+    }
+    if ((value < limits[ALERT_HIGH_CLEAR]) &&
+        (value > limits[ALERT_LOW_CLEAR]))
+    {
+        return false;
+    }
+    return active;
+}
+
+static void check_alerts(i2c_sim_device_t *device)
+{
+    uint16_t temperature_limits[I2C_SIM_ALERT_LIMITS];
+    uint16_t humidity_limits[I2C_SIM_ALERT_LIMITS];
+    uint8_t i = 0;
+
+    for (i = 0; i < I2C_SIM_ALERT_LIMITS; i++)
+    {
+        temperature_limits[i] = device->alert_limits[i] & 0x01FF;
+        humidity_limits[i]    = device->alert_limits[i] >> 9;
+    }
+
+    device->temperature_alert =
+        track_alert(device->temperature_alert,
+                    device->measured_temperature >> 7, temperature_limits);
+    device->humidity_alert =
+        track_alert(device->humidity_alert, device->measured_humidity >> 9,
+                    humidity_limits);
+
+    device->status_register &= ~(STATUS_T_ALERT | STATUS_RH_ALERT);
+    if (device->temperature_alert)
+    {
+        device->status_register |= STATUS_T_ALERT | STATUS_ALERT_PENDING;
+    }
+    if (device->humidity_alert)
+    {
+        device->status_register |= STATUS_RH_ALERT | STATUS_ALERT_PENDING;
+    }
+    device->alert_pin = device->temperature_alert || device->humidity_alert;
+}
+
+static void latch_measurement(i2c_sim_device_t *device)
+{
+    device->measured_temperature = device->temperature;
+    device->measured_humidity    = device->humidity;
+    device->result_ready         = true;
+    device->measurements++;
+
+    if (device->status_register & STATUS_HEATER_ON)
+    {
+        device->measured_temperature += device->heater_rise;
+    }
+
+    if (device->periodic)
+    {
+        check_alerts(device);
+    }
+}
+
+static void update_device(i2c_sim_t *sim, i2c_sim_device_t *device)
+{
+    if (device->converting && (sim->time_ns >= device->ready_at_ns))
+    {
+        device->converting = false;
+        latch_measurement(device);
+    }
+
+    while (device->periodic && (sim->time_ns >= device->next_measurement_ns))
+    {
+        latch_measurement(device);
+        device->next_measurement_ns += device->period_ns;
+    }
+}
+
+static void load_word(i2c_sim_device_t *device, uint16_t value)
+{
+    uint8_t *data = &device->read_data[device->read_length];
+    uint8_t crc   = crc8_word(value);
+
+    if (device->corrupt_crc)
+    {
+        device->corrupt_crc--;
+        crc ^= 0xFF;
+    }
+
+    data[0] = value >> 8;
+    data[1] = value & 0x00FF;
+    data[2] = crc;
+    device->read_length += CRC8_WORD_SIZE;
+}
+
+static void load_measurement(i2c_sim_device_t *device)
+{
+    device->read_length   = 0;
+    device->read_position = 0;
+    load_word(device, device->measured_temperature);
+    load_word(device, device->measured_humidity);
+    device->result_ready = false;
+}
+
+static uint8_t repeatability_of(uint8_t lsb, const uint8_t lsbs[3])
+{
+    uint8_t repeatability = 0;
+
+    for (repeatability = 0; repeatability < 3; repeatability++)
+    {
+        if (lsbs[repeatability] == lsb)
+        {
+            break;
+        }
+    }
+    return repeatability;
+}
+
+static bool start_periodic(i2c_sim_t *sim, i2c_sim_device_t *device,
+                           uint8_t msb, uint8_t lsb)
+{
+    static const uint8_t msbs[5]    = {0x20, 0x21, 0x22, 0x23, 0x27};
+    static const uint32_t period[5] = {2000, 1000, 500, 250, 100};
+    static const uint8_t lsbs[5][3] = {{0x2F, 0x24, 0x32},
+                                       {0x2D, 0x26, 0x30},
+                                       {0x2B, 0x20, 0x36},
+                                       {0x29, 0x22, 0x34},
+                                       {0x2A, 0x21, 0x37}};
+    uint8_t mps = 0;
+
+    for (mps = 0; mps < 5; mps++)
+    {
+        if (msbs[mps] != msb)
+        {
+            continue;
+        }
+
+        uint8_t repeatability = repeatability_of(lsb, lsbs[mps]);
+        if (repeatability > 2)
+        {
+            return false;
+        }
+
+        device->periodic            = true;
+        device->result_ready        = false;
+        device->period_ns           = (uint64_t)period[mps] * NS_PER_MS;
+        device->next_measurement_ns = sim->time_ns + duration_ns[repeatability];
+        return true;
+    }
+    return false;
+}
+
+static bool start_single_shot(i2c_sim_t *sim, i2c_sim_device_t *device,
+                              uint8_t msb, uint8_t lsb)
+{
+    static const uint8_t stretch_lsbs[3]    = {0x10, 0x0D, 0x06};
+    static const uint8_t no_stretch_lsbs[3] = {0x16, 0x0B, 0x00};
+    uint8_t repeatability                   = 0;
+
+    if (0x2C == msb)
+    {
+        repeatability = repeatability_of(lsb, stretch_lsbs);
+    }
+    else if (0x24 == msb)
+    {
+        repeatability = repeatability_of(lsb, no_stretch_lsbs);
+    }
+    else
+    {
+        return false;
+    }
+
+    if ((repeatability > 2) || device->periodic)
+    {
+        return false;
+    }
+
+    device->converting    = true;
+    device->clock_stretch = (0x2C == msb);
+    device->result_ready  = false;
+    device->ready_at_ns   = sim->time_ns + duration_ns[repeatability];
+    return true;
+}
+
+/*
+ * Returns true if command is an alert limit command, which is then handled.
+ */
+static bool alert_limit_command(i2c_sim_device_t *device, uint16_t command)
+{
+    const uint8_t *word = &device->command[2];
+    uint8_t i           = 0;
+
+    for (i = 0; i < I2C_SIM_ALERT_LIMITS; i++)
+    {
+        if (alert_read_command[i] == command)
+        {
+            load_word(device, device->alert_limits[i]);
+            return true;
+        }
+        if (alert_write_command[i] != command)
+        {
+            continue;
+        }
+
+        if (I2C_SIM_MAX_WRITE != device->command_length)
+        {
+            device->status_register |= STATUS_COMMAND_FAILED;
+        }
+        else if (1 != crc8_buffer(word, 1))
+        {
+            device->status_register |= STATUS_WRITE_CRC_FAILED;
+        }
+        else
+        {
+            device->alert_limits[i] = ((uint16_t)word[0] << 8) | word[1];
+            device->status_register &=
+                ~(STATUS_COMMAND_FAILED | STATUS_WRITE_CRC_FAILED);
+        }
+        return true;
+    }
+    return false;
+}
+
+static void run_command(i2c_sim_t *sim, i2c_sim_device_t *device)
+{
+    uint8_t msb      = device->command[0];
+    uint8_t lsb      = device->command[1];
+    uint16_t command = ((uint16_t)msb << 8) | lsb;
+
+    device->commands++;
+    device->read_length   = 0;
+    device->read_position = 0;
+
+    if (alert_limit_command(device, command))
+    {
+        return;
+    }
+
+    switch (command)
+    {
+    case 0xE000:
+        if (device->periodic && device->result_ready)
+        {
+            load_measurement(device);
+        }
+        return;
+    case 0xF32D:
+        load_word(device, device->status_register);
+        return;
+    case 0x3780:
+        load_word(device, device->serial_number >> 16);
+        load_word(device, device->serial_number & 0xFFFF);
+        return;
+    case 0x3041:
+        device->status_register &= ~(STATUS_ALERT_PENDING | STATUS_RH_ALERT |
+                                     STATUS_T_ALERT | STATUS_RESET_DETECTED);
+        return;
+    case 0x3093:
+        device->periodic     = false;
+        device->converting   = false;
+        device->result_ready = false;
+        return;
+    case 0x30A2:
+        device_reset(device);
+        return;
+    case 0x306D:
+        device->status_register |= STATUS_HEATER_ON;
+        return;
+    case 0x3066:
+        device->status_register &= ~STATUS_HEATER_ON;
+        return;
+    case 0x2B32:
+        device->periodic            = true;
+        device->result_ready        = false;
+        device->period_ns           = 250u * NS_PER_MS;
+        device->next_measurement_ns = sim->time_ns + duration_ns[2];
+        return;
+    default:
+        break;
+    }
+
+    if (start_single_shot(sim, device, msb, lsb) ||
+        start_periodic(sim, device, msb, lsb))
+    {
+        device->status_register &= ~STATUS_COMMAND_FAILED;
+        return;
+    }
+    device->status_register |= STATUS_COMMAND_FAILED;
+}
+
+static i2c_sim_device_t *find_device(i2c_sim_t *sim, uint8_t address)
+{
+    uint8_t i = 0;
+
+    for (i = 0; i < sim->device_count; i++)
+    {
+        if (sim->devices[i].address == address)
+        {
+            return &sim->devices[i];
+        }
+    }
+    return NULL;
+}
+
+static void end_write(i2c_sim_t *sim)
+{
+    i2c_sim_device_t *device = sim->selected;
+
+    if ((NULL != device) && (false == sim->reading) &&
+        (device->command_length >= 2))
+    {
+        run_command(sim, device);
+    }
+    if (NULL != device)
+    {
+        device->command_length = 0;
+    }
+    sim->selected = NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Bus functions
+///////////////////////////////////////////////////////////////////////////////
+
+static void sim_start(void *context)
+{
+    i2c_sim_t *sim = context;
+
+    // A repeated start ends the write phase just like a stop.
+    end_write(sim);
+    clock_periods(sim, 1);
+    sim->starts++;
+}
+
+static void sim_stop(void *context)
+{
+    i2c_sim_t *sim = context;
+
+    end_write(sim);
+    clock_periods(sim, 1);
+    sim->stops++;
+}
+
+static bool nack(i2c_sim_t *sim)
+{
+    sim->nacks++;
+    sim->selected = NULL;
+    return false;
+}
+
+static i2c_sim_device_t *address_device(i2c_sim_t *sim, uint8_t address)
+{
+    i2c_sim_device_t *device = find_device(sim, address);
+
+    clock_byte(sim);
+    sim->bytes_written++;
+
+    if ((NULL == device) || sim->sda_stuck)
+    {
+        return NULL;
+    }
+
+    if (device->nack_address)
+    {
+        device->nack_address--;
+        return NULL;
+    }
+
+    update_device(sim, device);
+    return device;
+}
+
+static bool sim_send_address_write(void *context, uint8_t address)
+{
+    i2c_sim_t *sim           = context;
+    i2c_sim_device_t *device = address_device(sim, address);
+
+    if (NULL == device)
+    {
+        return nack(sim);
+    }
+
+    sim->selected          = device;
+    sim->reading           = false;
+    device->command_length = 0;
+    return true;
+}
+
+static bool sim_send_address_read(void *context, uint8_t address)
+{
+    i2c_sim_t *sim           = context;
+    i2c_sim_device_t *device = address_device(sim, address);
+
+    if (NULL == device)
+    {
+        return nack(sim);
+    }
+
+    if (device->converting)
+    {
+        if (false == device->clock_stretch)
+        {
+            return nack(sim);
+        }
+
+        // The device holds SCL low until the conversion is done.
+        uint64_t stretch = device->ready_at_ns - sim->time_ns;
+        sim->time_ns += stretch;
+        sim->busy_ns += stretch;
+        sim->stretch_ns += stretch;
+        update_device(sim, device);
+    }
+
+    if (device->result_ready && (false == device->periodic) &&
+        (0 == device->read_length))
+    {
+        load_measurement(device);
+    }
+
+    if (device->read_position >= device->read_length)
+    {
+        return nack(sim);
+    }
+
+    sim->selected = device;
+    sim->reading  = true;
+    return true;
+}
+
+static bool sim_send_data(void *context, uint8_t data)
+{
+    i2c_sim_t *sim           = context;
+    i2c_sim_device_t *device = sim->selected;
+
+    clock_byte(sim);
+    sim->bytes_written++;
+
+    if ((NULL == device) || sim->reading ||
+        (device->command_length >= I2C_SIM_MAX_WRITE))
+    {
+        return nack(sim);
+    }
+
+    device->command[device->command_length++] = data;
+    return true;
+}
+
+static uint8_t sim_read_data(void *context, bool ack)
+{
+    i2c_sim_t *sim           = context;
+    i2c_sim_device_t *device = sim->selected;
+    uint8_t data             = 0xFF;
+
+    clock_byte(sim);
+    sim->bytes_read++;
+
+    if ((NULL != device) && sim->reading &&
+        (device->read_position < device->read_length))
+    {
+        data = device->read_data[device->read_position++];
+    }
+
+    if (false == ack)
+    {
+        // Master nacked: the device releases the bus and drops the rest.
+        if (NULL != device)
+        {
+            device->read_length   = 0;
+            device->read_position = 0;
+        }
+    }
+    return data;
+}
+
+static bool sim_bus_clear(void *context)
+{
+    i2c_sim_t *sim = context;
+
+    // Nine clocks let any device finish the byte it thinks it is sending.
+    clock_periods(sim, BITS_PER_BYTE);
+    sim->scl_cycles += BITS_PER_BYTE;
+    sim->sda_stuck = false;
+    sim->bus_clears++;
+    sim_stop(sim);
+
+    return true;
+}
+
+static bool sim_read_block(void *context, uint8_t *data, uint8_t length)
+{
+    uint8_t i = 0;
+
+    for (i = 0; i < length; i++)
+    {
+        data[i] = sim_read_data(context, i + 1 < length);
+    }
+    return true;
+}
+
+static bool sim_write_block(void *context, const uint8_t *data,
+                            uint8_t length)
+{
+    uint8_t i = 0;
+
+    for (i = 0; i < length; i++)
+    {
+        if (false == sim_send_data(context, data[i]))
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Set up and inspection
+///////////////////////////////////////////////////////////////////////////////
+
+void i2c_sim_init(i2c_sim_t *sim, uint32_t scl_hz, i2c_bus_t *bus)
+{
+    sim->scl_hz       = scl_hz;
+    sim->period_ns    = 1000000000u / scl_hz;
+    sim->time_ns      = 0;
+    sim->device_count = 0;
+    sim->selected     = NULL;
+    sim->reading      = false;
+    sim->sda_stuck    = false;
+    i2c_sim_reset_counters(sim);
+    i2c_sim_bus(sim, bus);
+}
+
+void i2c_sim_bus(i2c_sim_t *sim, i2c_bus_t *bus)
+{
+    bus->context            = sim;
+    bus->start              = sim_start;
+    bus->stop               = sim_stop;
+    bus->send_address_write = sim_send_address_write;
+    bus->send_address_read  = sim_send_address_read;
+    bus->send_data          = sim_send_data;
+    bus->read_data          = sim_read_data;
+    bus->read_block         = sim_read_block;
+    bus->write_block        = sim_write_block;
+    bus->transfer           = NULL;
+    bus->bus_clear          = sim_bus_clear;
+}
+
+i2c_sim_device_t *i2c_sim_add_sht31(i2c_sim_t *sim, uint8_t address)
+{
+    if (sim->device_count >= I2C_SIM_MAX_DEVICES)
+    {
+        return NULL;
+    }
+
+    i2c_sim_device_t *device = &sim->devices[sim->device_count++];
+
+    device->address       = address;
+    device->serial_number = 0x5EA10000u | address;
+    device->temperature   = 0x6666;
+    device->humidity      = 0x8000;
+    device->nack_address  = 0;
+    device->corrupt_crc   = 0;
+    device->heater_rise   = 0;
+    device->commands      = 0;
+    device->measurements  = 0;
+    device_reset(device);
+
+    return device;
+}
+
+void i2c_sim_set_environment(i2c_sim_device_t *device, uint16_t temperature,
+                             uint16_t humidity)
+{
+    device->temperature = temperature;
+    device->humidity    = humidity;
+}
+
+void i2c_sim_advance_ns(i2c_sim_t *sim, uint64_t ns)
+{
+    uint8_t i = 0;
+
+    sim->time_ns += ns;
+    for (i = 0; i < sim->device_count; i++)
+    {
+        update_device(sim, &sim->devices[i]);
+    }
+}
+
+void i2c_sim_advance_ms(i2c_sim_t *sim, uint32_t ms)
+{
+    i2c_sim_advance_ns(sim, (uint64_t)ms * NS_PER_MS);
+}
+
+uint64_t i2c_sim_time_ns(const i2c_sim_t *sim)
+{
+    return sim->time_ns;
+}
+
+uint32_t i2c_sim_time_ms(const i2c_sim_t *sim)
+{
+    return (uint32_t)(sim->time_ns / NS_PER_MS);
+}
+
+void i2c_sim_reset_counters(i2c_sim_t *sim)
+{
+    sim->scl_cycles    = 0;
+    sim->stretch_ns    = 0;
+    sim->busy_ns       = 0;
+    sim->starts        = 0;
+    sim->stops         = 0;
+    sim->bytes_written = 0;
+    sim->bytes_read    = 0;
+    sim->nacks         = 0;
+    sim->bus_clears    = 0;
+}
+
+uint64_t i2c_sim_bus_busy_ns(const i2c_sim_t *sim)
+{
+    return sim->busy_ns;
+}
@@ -0,0 +1,165 @@
+/**
+ * @file    i2c_sim.h
+ * @author  Steven Daglish
+ * @brief   Software model of an I2C bus with SHT31 devices on it, for
+ *          running and profiling the driver on a host.
+ * @version 0.1
+ * @date    17 October 2026
+ *
+ * The model keeps simulated time. Every byte costs 9 SCL periods (8 data
+ * bits and the ack), every START and STOP one period. Devices convert for
+ * the datasheet maximum time; reading early either stretches the clock (for
+ * clock stretching commands, the wait is added to bus time) or is nacked.
+ *
+ * Faults can be injected per device: nacking the address a number of times
+ * and corrupting the CRC of a number of read words. The whole bus can be
+ * stuck with SDA held low, which nacks everything until a bus clear.
+ *
+ * Supported commands: single shot (all modes), periodic and ART modes,
+ * fetch data, break, soft reset, read and clear status, heater on and off,
+ * read and write alert limits, read serial number.
+ *
+ * In periodic mode each measurement is checked against the alert limits as
+ * the sensor does: the alert bits in the status register and alert_pin
+ * follow it.
+ */
+
+#ifndef _I2C_SIM_H
+#define _I2C_SIM_H
+
+#include "i2c_bus.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+#define I2C_SIM_MAX_DEVICES 4
+#define I2C_SIM_MAX_READ 6
+
+// A command plus one data word and its CRC.
+#define I2C_SIM_MAX_WRITE 5
+
+// Alert limits, indexed high set, high clear, low clear, low set.
+#define I2C_SIM_ALERT_LIMITS 4
+
+#define I2C_SIM_100KHZ 100000
+#define I2C_SIM_400KHZ 400000
+#define I2C_SIM_1MHZ 1000000
+
+typedef struct
+{
+    uint8_t address;
+    uint32_t serial_number;
+    uint16_t temperature;
+    uint16_t humidity;
+    uint16_t status_register;
+
+    // Measurement state
+    uint16_t measured_temperature;
+    uint16_t measured_humidity;
+    bool converting;
+    bool clock_stretch;
+    bool result_ready;
+    uint64_t ready_at_ns;
+    bool periodic;
+    uint64_t period_ns;
+    uint64_t next_measurement_ns;
+
+    // Alert tracking
+    uint16_t alert_limits[I2C_SIM_ALERT_LIMITS];
+    bool temperature_alert;
+    bool humidity_alert;
+    bool alert_pin;
+
+    // Raw ticks added to the measured temperature while the heater is on
+    uint16_t heater_rise;
+
+    // Command being received and data waiting to be read
+    uint8_t command[I2C_SIM_MAX_WRITE];
+    uint8_t command_length;
+    uint8_t read_data[I2C_SIM_MAX_READ];
+    uint8_t read_length;
+    uint8_t read_position;
+
+    // Fault injection
+    uint16_t nack_address;
+    uint16_t corrupt_crc;
+
+    // Counters
+    uint32_t commands;
+    uint32_t measurements;
+} i2c_sim_device_t;
+
+typedef struct
+{
+    uint32_t scl_hz;
+    uint32_t period_ns;
+    uint64_t time_ns;
+    uint64_t scl_cycles;
+    uint64_t stretch_ns;
+    uint64_t busy_ns;
+    uint32_t starts;
+    uint32_t stops;
+    uint32_t bytes_written;
+    uint32_t bytes_read;
+    uint32_t nacks;
+    uint32_t bus_clears;
+
+    // Fault injection
+    bool sda_stuck;
+
+    i2c_sim_device_t devices[I2C_SIM_MAX_DEVICES];
+    uint8_t device_count;
+    i2c_sim_device_t *selected;
+    bool reading;
+} i2c_sim_t;
+
+/**
+ * @brief   Sets up an empty bus and fills in bus so the driver can use it.
+ *
+ * @param sim
+ * @param scl_hz    Clock, e.g. I2C_SIM_400KHZ
+ * @param bus
+ */
+void i2c_sim_init(i2c_sim_t *sim, uint32_t scl_hz, i2c_bus_t *bus);
+
+/**
+ * @brief   Fills in another bus handle for an existing simulated bus.
+ */
+void i2c_sim_bus(i2c_sim_t *sim, i2c_bus_t *bus);
+
+/**
+ * @brief   Adds an SHT31 at address. Returns NULL if the bus is full.
+ */
+i2c_sim_device_t *i2c_sim_add_sht31(i2c_sim_t *sim, uint8_t address);
+
+/**
+ * @brief   Sets the raw values the device will measure from now on.
+ */
+void i2c_sim_set_environment(i2c_sim_device_t *device, uint16_t temperature,
+                             uint16_t humidity);
+
+/**
+ * @brief   Moves simulated time on, e.g. while the MCU does other work.
+ */
+void i2c_sim_advance_ns(i2c_sim_t *sim, uint64_t ns);
+
+void i2c_sim_advance_ms(i2c_sim_t *sim, uint32_t ms);
+
+uint64_t i2c_sim_time_ns(const i2c_sim_t *sim);
+
+/**
+ * @brief   Simulated time in milliseconds, for APIs that take now_ms.
+ */
+uint32_t i2c_sim_time_ms(const i2c_sim_t *sim);
+
+/**
+ * @brief   Clears the bus counters (time keeps running).
+ */
+void i2c_sim_reset_counters(i2c_sim_t *sim);
+
+/**
+ * @brief   Time the bus was busy (clocking or stretched) since the counters
+ * were last reset.
+ */
+uint64_t i2c_sim_bus_busy_ns(const i2c_sim_t *sim);
+
+#endif // _I2C_SIM_H
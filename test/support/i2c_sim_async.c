@@ -0,0 +1,164 @@
+#include "i2c_sim_async.h"
+#include <stddef.h>
+
+#define READ_BIT 0x01
+
+static void begin_step(i2c_sim_async_t *harness, i2c_sim_async_step_t step)
+{
+    harness->step     = step;
+    harness->executed = false;
+}
+
+static void port_start(void *context)
+{
+    begin_step(context, I2C_SIM_ASYNC_START);
+}
+
+static void port_stop(void *context)
+{
+    begin_step(context, I2C_SIM_ASYNC_STOP);
+}
+
+static void port_write(void *context, uint8_t data)
+{
+    i2c_sim_async_t *harness = context;
+
+    harness->data = data;
+    begin_step(harness, I2C_SIM_ASYNC_WRITE);
+}
+
+static void port_read(void *context, bool ack)
+{
+    i2c_sim_async_t *harness = context;
+
+    harness->ack = ack;
+    begin_step(harness, I2C_SIM_ASYNC_READ);
+}
+
+static bool port_acked(void *context)
+{
+    return ((i2c_sim_async_t *)context)->acked;
+}
+
+static uint8_t port_received(void *context)
+{
+    return ((i2c_sim_async_t *)context)->received;
+}
+
+/*
+ * Carries the step out on the simulated bus, which clocks it.
+ */
+static void execute(i2c_sim_async_t *harness)
+{
+    const i2c_bus_t *bus = &harness->bus;
+    uint8_t address      = harness->data >> 1;
+
+    switch (harness->step)
+    {
+    case I2C_SIM_ASYNC_START:
+        bus->start(bus->context);
+        harness->address_next = true;
+        break;
+    case I2C_SIM_ASYNC_STOP:
+        bus->stop(bus->context);
+        break;
+    case I2C_SIM_ASYNC_WRITE:
+        if (false == harness->address_next)
+        {
+            harness->acked = bus->send_data(bus->context, harness->data);
+        }
+        else if (harness->data & READ_BIT)
+        {
+            harness->acked = bus->send_address_read(bus->context, address);
+        }
+        else
+        {
+            harness->acked = bus->send_address_write(bus->context, address);
+        }
+        harness->address_next = false;
+        break;
+    case I2C_SIM_ASYNC_READ:
+        harness->received = bus->read_data(bus->context, harness->ack);
+        break;
+    default:
+        break;
+    }
+    harness->executed = true;
+}
+
+void i2c_sim_async_init(i2c_sim_async_t *harness, i2c_sim_t *sim,
+                        i2c_async_bus_t *bus)
+{
+    harness->sim          = sim;
+    harness->step         = I2C_SIM_ASYNC_NONE;
+    harness->executed     = false;
+    harness->now_ns       = i2c_sim_time_ns(sim);
+    harness->data         = 0;
+    harness->ack          = false;
+    harness->address_next = false;
+    harness->acked        = false;
+    harness->received     = 0;
+
+    harness->port.context  = harness;
+    harness->port.start    = port_start;
+    harness->port.restart  = port_start;
+    harness->port.stop     = port_stop;
+    harness->port.write    = port_write;
+    harness->port.read     = port_read;
+    harness->port.acked    = port_acked;
+    harness->port.received = port_received;
+
+    i2c_sim_bus(sim, &harness->bus);
+    i2c_async_engine_init(&harness->engine, &harness->port, bus);
+}
+
+void i2c_sim_async_advance_ns(i2c_sim_async_t *harness, uint64_t ns)
+{
+    i2c_sim_t *sim = harness->sim;
+    uint64_t until = 0;
+
+    // Simulated time only runs ahead of the CPU for a step already carried
+    // out whose interrupt is still to come.
+    if ((I2C_SIM_ASYNC_NONE == harness->step) || (false == harness->executed))
+    {
+        harness->now_ns = i2c_sim_time_ns(sim);
+    }
+    until           = harness->now_ns + ns;
+    harness->now_ns = until;
+
+    while (I2C_SIM_ASYNC_NONE != harness->step)
+    {
+        if (false == harness->executed)
+        {
+            execute(harness);
+        }
+
+        // Finishes after this window: the interrupt waits for a later call.
+        if (i2c_sim_time_ns(sim) > until)
+        {
+            return;
+        }
+
+        harness->step = I2C_SIM_ASYNC_NONE;
+        i2c_async_engine_interrupt(&harness->engine);
+    }
+
+    i2c_sim_advance_ns(sim, until - i2c_sim_time_ns(sim));
+}
+
+uint32_t i2c_sim_async_complete(i2c_sim_async_t *harness)
+{
+    uint32_t interrupts = harness->engine.interrupts;
+
+    while (i2c_async_engine_busy(&harness->engine))
+    {
+        if (false == harness->executed)
+        {
+            execute(harness);
+        }
+        harness->step = I2C_SIM_ASYNC_NONE;
+        i2c_async_engine_interrupt(&harness->engine);
+    }
+
+    return harness->engine.interrupts - interrupts;
+}
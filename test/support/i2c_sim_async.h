@@ -0,0 +1,79 @@
+/**
+ * @file    i2c_sim_async.h
+ * @author  Steven Daglish
+ * @brief   Runs i2c_async.h on the simulated bus, standing in for the
+ *          interrupt controller so the async path can be tested on a host.
+ * @version 0.1
+ * @date    17 October 2026
+ *
+ * Each step the engine starts is carried out on the simulated bus, which
+ * moves simulated time on by however long the step takes on the wire. Its
+ * "interrupt" only fires from i2c_sim_async_advance_ns(), once simulated
+ * time has reached the end of the step, the way a real interrupt would cut
+ * into the main loop. Between interrupts the caller is free to do other
+ * work.
+ */
+
+#ifndef _I2C_SIM_ASYNC_H
+#define _I2C_SIM_ASYNC_H
+
+#include "i2c_async.h"
+#include "i2c_bus.h"
+#include "i2c_sim.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef enum
+{
+    I2C_SIM_ASYNC_NONE,
+    I2C_SIM_ASYNC_START,
+    I2C_SIM_ASYNC_STOP,
+    I2C_SIM_ASYNC_WRITE,
+    I2C_SIM_ASYNC_READ
+} i2c_sim_async_step_t;
+
+typedef struct
+{
+    i2c_sim_t *sim;
+    i2c_bus_t bus;
+    i2c_async_port_t port;
+    i2c_async_engine_t engine;
+
+    // Step waiting for its interrupt
+    i2c_sim_async_step_t step;
+    bool executed;
+    uint64_t now_ns; // CPU time; bus time runs ahead while a step is out
+    uint8_t data;
+    bool ack;
+
+    // What the hardware registers would hold
+    bool address_next;
+    bool acked;
+    uint8_t received;
+} i2c_sim_async_t;
+
+/**
+ * @brief   Sets up the harness and fills in bus for drivers to submit to.
+ *
+ * @param harness
+ * @param sim       Initialised simulated bus
+ * @param bus
+ */
+void i2c_sim_async_init(i2c_sim_async_t *harness, i2c_sim_t *sim,
+                        i2c_async_bus_t *bus);
+
+/**
+ * @brief   Moves simulated time on by ns, running the interrupt for every
+ * step that finishes in that time.
+ */
+void i2c_sim_async_advance_ns(i2c_sim_async_t *harness, uint64_t ns);
+
+/**
+ * @brief   Runs interrupts until the bus is idle, including any transaction
+ * a callback submits.
+ *
+ * @return Number of interrupts taken
+ */
+uint32_t i2c_sim_async_complete(i2c_sim_async_t *harness);
+
+#endif // _I2C_SIM_ASYNC_H
@@ -0,0 +1,175 @@
+/**
+ * @file        test_crc8.c
+ * @author      Steven Daglish
+ * @brief
+ * @version     0.1
+ * @date        17 October 2026
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+// Test list
+// ---------
+//
+// Known vector from the datasheet
+// Every engine agrees with the original bit-loop implementation
+// Buffer checks of several words
+///////////////////////////////////////////////////////////////////////////////
+
+#include "unity.h"
+#include "crc8.h"
+
+// The bit-loop CRC that used to live in sht31_driver.c, kept as the reference
+// every engine is checked against.
+static uint8_t reference_crc(uint16_t value)
+{
+    const uint8_t POLYNOMIAL = 0x31;
+    uint8_t data             = 0;
+    uint8_t crc              = 0xFF;
+    uint8_t i                = 0;
+
+    data = value >> 8;
+    crc ^= data;
+
+    for (i = 8; i; --i)
+    {
+        crc = (crc & 0x80) ? (crc << 1) ^ POLYNOMIAL : (crc << 1);
+    }
+
+    data = value & 0x00FF;
+    crc ^= data;
+
+    for (i = 8; i; --i)
+    {
+        crc = (crc & 0x80) ? (crc << 1) ^ POLYNOMIAL : (crc << 1);
+    }
+    return crc;
+}
+
+static void fill_word(uint8_t *buffer, uint16_t value, uint8_t crc)
+{
+    buffer[0] = value >> 8;
+    buffer[1] = value & 0x00FF;
+    buffer[2] = crc;
+}
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Known vectors
+///////////////////////////////////////////////////////////////////////////////
+
+void test_datasheet_vector_beef_gives_92(void)
+{
+    const uint8_t data[2] = {0xBE, 0xEF};
+
+    TEST_ASSERT_EQUAL_HEX8(0x92, crc8_word(0xBEEF));
+    TEST_ASSERT_EQUAL_HEX8(0x92, crc8_calculate(data, 2));
+    TEST_ASSERT_EQUAL_HEX8(0x92, crc8_bitwise(data, 2));
+    TEST_ASSERT_EQUAL_HEX8(0x92, crc8_table_256(data, 2));
+    TEST_ASSERT_EQUAL_HEX8(0x92, crc8_table_16(data, 2));
+}
+
+void test_empty_buffer_returns_initial_value(void)
+{
+    TEST_ASSERT_EQUAL_HEX8(CRC8_INITIAL_VALUE, crc8_calculate(NULL, 0));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Engines agree with the original implementation
+///////////////////////////////////////////////////////////////////////////////
+
+void test_crc8_word_matches_reference_for_every_word(void)
+{
+    uint32_t value = 0;
+
+    for (value = 0; value <= 0xFFFF; value++)
+    {
+        TEST_ASSERT_EQUAL_HEX8(reference_crc(value), crc8_word(value));
+    }
+}
+
+void test_all_engines_match_reference_for_every_word(void)
+{
+    uint32_t value = 0;
+    uint8_t data[2];
+    uint8_t expected = 0;
+
+    for (value = 0; value <= 0xFFFF; value++)
+    {
+        data[0]  = value >> 8;
+        data[1]  = value & 0x00FF;
+        expected = reference_crc(value);
+
+        TEST_ASSERT_EQUAL_HEX8(expected, crc8_bitwise(data, 2));
+        TEST_ASSERT_EQUAL_HEX8(expected, crc8_table_256(data, 2));
+        TEST_ASSERT_EQUAL_HEX8(expected, crc8_table_16(data, 2));
+        TEST_ASSERT_EQUAL_HEX8(expected, crc8_calculate(data, 2));
+    }
+}
+
+void test_all_engines_agree_on_longer_buffers(void)
+{
+    uint8_t data[64];
+    uint16_t i = 0;
+
+    for (i = 0; i < sizeof(data); i++)
+    {
+        data[i] = (i * 37) ^ 0x5A;
+    }
+
+    for (i = 0; i <= sizeof(data); i++)
+    {
+        uint8_t expected = crc8_bitwise(data, i);
+        TEST_ASSERT_EQUAL_HEX8(expected, crc8_table_256(data, i));
+        TEST_ASSERT_EQUAL_HEX8(expected, crc8_table_16(data, i));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Buffer of words
+///////////////////////////////////////////////////////////////////////////////
+
+void test_buffer_all_words_valid_returns_word_count(void)
+{
+    uint8_t buffer[4 * CRC8_WORD_SIZE];
+
+    fill_word(&buffer[0], 0xBEEF, 0x92);
+    fill_word(&buffer[3], 0x1234, 0x37);
+    fill_word(&buffer[6], 0xABCD, 0x6F);
+    fill_word(&buffer[9], 0x0000, reference_crc(0x0000));
+
+    TEST_ASSERT_EQUAL_UINT16(4, crc8_buffer(buffer, 4));
+}
+
+void test_buffer_returns_index_of_first_bad_word(void)
+{
+    uint8_t buffer[3 * CRC8_WORD_SIZE];
+
+    fill_word(&buffer[0], 0xBEEF, 0x92);
+    fill_word(&buffer[3], 0x1234, 0x00);
+    fill_word(&buffer[6], 0xABCD, 0x00);
+
+    TEST_ASSERT_EQUAL_UINT16(1, crc8_buffer(buffer, 3));
+}
+
+void test_buffer_first_word_bad_returns_zero(void)
+{
+    uint8_t buffer[2 * CRC8_WORD_SIZE];
+
+    fill_word(&buffer[0], 0xBEEF, 0x91);
+    fill_word(&buffer[3], 0xBEEF, 0x92);
+
+    TEST_ASSERT_EQUAL_UINT16(0, crc8_buffer(buffer, 2));
+}
+
+void test_buffer_with_no_words_returns_zero(void)
+{
+    TEST_ASSERT_EQUAL_UINT16(0, crc8_buffer(NULL, 0));
+}
@@ -0,0 +1,262 @@
+/**
+ * @file        test_gateway.c
+ * @author      Steven Daglish
+ * @brief
+ * @version     0.1
+ * @date        17 October 2026
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+// Test list
+// ---------
+//
+// Adding buses
+// Every sensor on every simulated bus is published
+// Per bus latency histograms
+// Failed sensors
+// Stopping publishes everything produced
+///////////////////////////////////////////////////////////////////////////////
+
+#include "unity.h"
+#include "gateway.h"
+#include "gateway_queue.h"
+#include "latency_histogram.h"
+#include "sht31_scheduler.h"
+#include "sht31_driver.h"
+#include "i2c_sim.h"
+#include "i2c_driver_sim.h"
+#include "crc8.h"
+#include "i2c_bus.h"
+#include <time.h>
+
+#define BUSES 4
+#define SENSORS_PER_BUS 2
+#define CYCLES_PER_BUS 20
+#define TIMEOUT_MS 10000
+
+static const uint8_t addresses[SENSORS_PER_BUS] = {DEFAULT_ADDRESS,
+                                                   SHT_ALTERNATE_ADDRESS};
+
+static gateway_t gateway;
+static i2c_sim_t sims[BUSES];
+static i2c_bus_t buses[BUSES];
+static i2c_sim_device_t *devices[BUSES][SENSORS_PER_BUS];
+static gateway_clock_t clocks[BUSES];
+
+// Written on the publisher thread, read after gateway_stop().
+static uint32_t samples[BUSES][SENSORS_PER_BUS];
+static uint32_t failures[BUSES][SENSORS_PER_BUS];
+static uint32_t wrong_values;
+
+/*
+ * Each simulated bus keeps its own time. Sleeping moves it on, and yields
+ * for a moment of real time so the publisher keeps up.
+ */
+static uint64_t sim_now_us(void *context)
+{
+    return i2c_sim_time_ns(context) / 1000;
+}
+
+static void sim_sleep_us(void *context, uint32_t us)
+{
+    const struct timespec yield = {.tv_sec = 0, .tv_nsec = 50000};
+
+    i2c_sim_advance_ns(context, (uint64_t)us * 1000);
+    nanosleep(&yield, NULL);
+}
+
+static uint16_t temperature_for(uint8_t bus, uint8_t sensor)
+{
+    return 0x4000 + bus * 0x100 + sensor;
+}
+
+static void record_sample(void *context, const gateway_sample_t *sample)
+{
+    (void)context;
+
+    if (false == sample->success)
+    {
+        failures[sample->bus][sample->sensor]++;
+        return;
+    }
+
+    samples[sample->bus][sample->sensor]++;
+    if (temperature_for(sample->bus, sample->sensor) != sample->temperature)
+    {
+        wrong_values++;
+    }
+}
+
+static void wait_for_cycles(uint32_t cycles)
+{
+    const struct timespec wait = {.tv_sec = 0, .tv_nsec = 1000000};
+    uint32_t waited_ms         = 0;
+    uint8_t bus                = 0;
+
+    for (bus = 0; bus < BUSES; bus++)
+    {
+        while (gateway_bus_produced(&gateway, bus) <
+               cycles * SENSORS_PER_BUS)
+        {
+            TEST_ASSERT(waited_ms++ < TIMEOUT_MS);
+            nanosleep(&wait, NULL);
+        }
+    }
+}
+
+void setUp(void)
+{
+    uint8_t bus    = 0;
+    uint8_t sensor = 0;
+
+    gateway_init(&gateway, SHT_REPEATABILITY_HIGH, 0, record_sample, NULL);
+
+    for (bus = 0; bus < BUSES; bus++)
+    {
+        i2c_sim_init(&sims[bus], I2C_SIM_400KHZ, &buses[bus]);
+        for (sensor = 0; sensor < SENSORS_PER_BUS; sensor++)
+        {
+            devices[bus][sensor] =
+                i2c_sim_add_sht31(&sims[bus], addresses[sensor]);
+            i2c_sim_set_environment(devices[bus][sensor],
+                                    temperature_for(bus, sensor), 0x8000);
+            samples[bus][sensor]  = 0;
+            failures[bus][sensor] = 0;
+        }
+
+        clocks[bus].context  = &sims[bus];
+        clocks[bus].now_us   = sim_now_us;
+        clocks[bus].sleep_us = sim_sleep_us;
+    }
+    wrong_values = 0;
+}
+
+void tearDown(void)
+{
+}
+
+static void add_buses(void)
+{
+    uint8_t bus = 0;
+
+    for (bus = 0; bus < BUSES; bus++)
+    {
+        TEST_ASSERT_EQUAL_INT(bus,
+                              gateway_add_bus(&gateway, &buses[bus], addresses,
+                                              SENSORS_PER_BUS, &clocks[bus]));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Adding buses
+///////////////////////////////////////////////////////////////////////////////
+
+void test_too_many_buses_or_sensors_is_refused(void)
+{
+    uint8_t many[GATEWAY_MAX_SENSORS_PER_BUS + 1] = {0};
+    uint8_t bus                                  = 0;
+
+    TEST_ASSERT_EQUAL_INT(-1, gateway_add_bus(&gateway, &buses[0], many,
+                                              sizeof(many), &clocks[0]));
+
+    for (bus = 0; bus < GATEWAY_MAX_BUSES; bus++)
+    {
+        TEST_ASSERT_EQUAL_INT(bus, gateway_add_bus(&gateway, &buses[0],
+                                                   addresses, 1, &clocks[0]));
+    }
+    TEST_ASSERT_EQUAL_INT(
+        -1, gateway_add_bus(&gateway, &buses[0], addresses, 1, &clocks[0]));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Running
+///////////////////////////////////////////////////////////////////////////////
+
+void test_every_sensor_on_every_bus_is_published(void)
+{
+    uint8_t bus    = 0;
+    uint8_t sensor = 0;
+
+    add_buses();
+    TEST_ASSERT(gateway_start(&gateway));
+    wait_for_cycles(CYCLES_PER_BUS);
+    gateway_stop(&gateway);
+
+    for (bus = 0; bus < BUSES; bus++)
+    {
+        for (sensor = 0; sensor < SENSORS_PER_BUS; sensor++)
+        {
+            TEST_ASSERT(samples[bus][sensor] >= CYCLES_PER_BUS);
+            TEST_ASSERT_EQUAL_UINT32(0, failures[bus][sensor]);
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, wrong_values);
+}
+
+void test_stop_publishes_everything_produced(void)
+{
+    uint32_t produced = 0;
+    uint8_t bus       = 0;
+
+    add_buses();
+    TEST_ASSERT(gateway_start(&gateway));
+    wait_for_cycles(CYCLES_PER_BUS);
+    gateway_stop(&gateway);
+
+    for (bus = 0; bus < BUSES; bus++)
+    {
+        produced += gateway_bus_produced(&gateway, bus);
+    }
+    TEST_ASSERT_EQUAL_UINT32(produced, gateway_published(&gateway) +
+                                           gateway_dropped(&gateway));
+}
+
+void test_latency_histogram_per_bus_counts_every_sample(void)
+{
+    uint8_t bus = 0;
+
+    add_buses();
+    TEST_ASSERT(gateway_start(&gateway));
+    wait_for_cycles(CYCLES_PER_BUS);
+    gateway_stop(&gateway);
+
+    for (bus = 0; bus < BUSES; bus++)
+    {
+        const latency_histogram_t *latency =
+            gateway_bus_latency(&gateway, bus);
+
+        TEST_ASSERT_EQUAL_UINT32(gateway_bus_produced(&gateway, bus),
+                                 latency_histogram_count(latency));
+    }
+}
+
+void test_latency_covers_the_conversion(void)
+{
+    add_buses();
+    TEST_ASSERT(gateway_start(&gateway));
+    wait_for_cycles(CYCLES_PER_BUS);
+    gateway_stop(&gateway);
+
+    const latency_histogram_t *latency = gateway_bus_latency(&gateway, 0);
+
+    // High repeatability converts for 15.5 ms, so nothing is quicker than
+    // 8 ms and nothing should take much over a cycle.
+    TEST_ASSERT_EQUAL_UINT32(0, latency_histogram_bucket(latency, 13));
+    TEST_ASSERT(latency_histogram_percentile_us(latency, 1) >= 15500);
+    TEST_ASSERT(latency_histogram_max_us(latency) < 32768);
+}
+
+void test_failed_sensor_is_published_as_failed(void)
+{
+    add_buses();
+    devices[2][1]->nack_address = 1;
+
+    TEST_ASSERT(gateway_start(&gateway));
+    wait_for_cycles(CYCLES_PER_BUS);
+    gateway_stop(&gateway);
+
+    TEST_ASSERT_EQUAL_UINT32(1, failures[2][1]);
+    TEST_ASSERT(samples[2][1] >= CYCLES_PER_BUS - 1);
+    TEST_ASSERT_EQUAL_UINT32(0, failures[2][0]);
+}
@@ -0,0 +1,182 @@
+/**
+ * @file        test_gateway_queue.c
+ * @author      Steven Daglish
+ * @brief
+ * @version     0.1
+ * @date        17 October 2026
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+// Test list
+// ---------
+//
+// Sizes
+// First in, first out
+// Full and empty
+// Several producer threads at once
+///////////////////////////////////////////////////////////////////////////////
+
+#include "unity.h"
+#include "gateway_queue.h"
+#include <pthread.h>
+
+#define PRODUCERS 4
+#define SAMPLES_PER_PRODUCER 20000
+
+static gateway_queue_cell_t cells[256];
+static gateway_queue_t queue;
+
+static gateway_sample_t make_sample(uint8_t bus, uint16_t value)
+{
+    gateway_sample_t sample = {
+        .timestamp_ms = value,
+        .temperature  = value,
+        .humidity     = (uint16_t)~value,
+        .bus          = bus,
+        .success      = true,
+    };
+    return sample;
+}
+
+static void *produce(void *argument)
+{
+    uint8_t bus    = *(uint8_t *)argument;
+    uint32_t value = 0;
+
+    for (value = 0; value < SAMPLES_PER_PRODUCER; value++)
+    {
+        gateway_sample_t sample = make_sample(bus, value);
+
+        // Retry while full so every sample gets through (each failed try
+        // still counts as a drop).
+        while (false == gateway_queue_push(&queue, &sample))
+        {
+        }
+    }
+    return NULL;
+}
+
+void setUp(void)
+{
+    TEST_ASSERT(gateway_queue_init(&queue, cells, 256));
+}
+
+void tearDown(void)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Sizes
+///////////////////////////////////////////////////////////////////////////////
+
+void test_capacity_must_be_power_of_two(void)
+{
+    TEST_ASSERT_FALSE(gateway_queue_init(&queue, cells, 0));
+    TEST_ASSERT_FALSE(gateway_queue_init(&queue, cells, 1));
+    TEST_ASSERT_FALSE(gateway_queue_init(&queue, cells, 100));
+    TEST_ASSERT(gateway_queue_init(&queue, cells, 2));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// One thread
+///////////////////////////////////////////////////////////////////////////////
+
+void test_empty_queue_pops_nothing(void)
+{
+    gateway_sample_t sample;
+
+    TEST_ASSERT_FALSE(gateway_queue_pop(&queue, &sample));
+}
+
+void test_samples_come_out_in_order(void)
+{
+    gateway_sample_t sample;
+    uint16_t i = 0;
+
+    for (i = 0; i < 10; i++)
+    {
+        gateway_sample_t pushed = make_sample(1, i);
+        TEST_ASSERT(gateway_queue_push(&queue, &pushed));
+    }
+
+    for (i = 0; i < 10; i++)
+    {
+        TEST_ASSERT(gateway_queue_pop(&queue, &sample));
+        TEST_ASSERT_EQUAL_UINT16(i, sample.temperature);
+        TEST_ASSERT_EQUAL_UINT8(1, sample.bus);
+    }
+    TEST_ASSERT_FALSE(gateway_queue_pop(&queue, &sample));
+}
+
+void test_full_queue_drops_and_counts(void)
+{
+    gateway_sample_t sample = make_sample(0, 0);
+    uint16_t i              = 0;
+
+    for (i = 0; i < 256; i++)
+    {
+        TEST_ASSERT(gateway_queue_push(&queue, &sample));
+    }
+
+    TEST_ASSERT_FALSE(gateway_queue_push(&queue, &sample));
+    TEST_ASSERT_FALSE(gateway_queue_push(&queue, &sample));
+    TEST_ASSERT_EQUAL_UINT32(2, gateway_queue_dropped(&queue));
+}
+
+void test_cells_are_reused_after_pop(void)
+{
+    gateway_sample_t sample;
+    uint32_t i = 0;
+
+    for (i = 0; i < 1000; i++)
+    {
+        gateway_sample_t pushed = make_sample(0, i);
+        TEST_ASSERT(gateway_queue_push(&queue, &pushed));
+        TEST_ASSERT(gateway_queue_pop(&queue, &sample));
+        TEST_ASSERT_EQUAL_UINT16(i, sample.temperature);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Several producers
+///////////////////////////////////////////////////////////////////////////////
+
+void test_producers_lose_nothing_and_keep_their_own_order(void)
+{
+    pthread_t threads[PRODUCERS];
+    uint8_t buses[PRODUCERS];
+    uint32_t next[PRODUCERS] = {0};
+    uint32_t received        = 0;
+    gateway_sample_t sample;
+    uint8_t i = 0;
+
+    for (i = 0; i < PRODUCERS; i++)
+    {
+        buses[i] = i;
+        TEST_ASSERT_EQUAL_INT(
+            0, pthread_create(&threads[i], NULL, produce, &buses[i]));
+    }
+
+    while (received < PRODUCERS * SAMPLES_PER_PRODUCER)
+    {
+        if (false == gateway_queue_pop(&queue, &sample))
+        {
+            continue;
+        }
+
+        TEST_ASSERT(sample.bus < PRODUCERS);
+        TEST_ASSERT_EQUAL_UINT32(next[sample.bus], sample.timestamp_ms);
+        TEST_ASSERT_EQUAL_HEX16((uint16_t)~sample.temperature,
+                                sample.humidity);
+        next[sample.bus]++;
+        received++;
+    }
+
+    for (i = 0; i < PRODUCERS; i++)
+    {
+        pthread_join(threads[i], NULL);
+        TEST_ASSERT_EQUAL_UINT32(SAMPLES_PER_PRODUCER, next[i]);
+    }
+    TEST_ASSERT_FALSE(gateway_queue_pop(&queue, &sample));
+}
@@ -0,0 +1,349 @@
+/**
+ * @file        test_i2c_async.c
+ * @author      Steven Daglish
+ * @brief
+ * @version     0.1
+ * @date        17 October 2026
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+// Test list
+// ---------
+//
+// Probing, writing and reading through the engine
+// One interrupt per bus step
+// Busy bus rejects a second transaction; callbacks can chain the next
+// Bus errors end the transaction with a STOP
+// Asynchronous periodic fetch, including NACK and CRC failures
+// The main loop keeps running while a fetch is on the bus
+///////////////////////////////////////////////////////////////////////////////
+
+#include "unity.h"
+#include "i2c_async.h"
+#include "i2c_sim_async.h"
+#include "i2c_sim.h"
+#include "i2c_driver_sim.h"
+#include "sht31_driver.h"
+#include "crc8.h"
+#include "i2c_bus.h"
+
+#define TEMPERATURE 0x6666
+#define HUMIDITY 0x8000
+
+// START, address, 2 command bytes, repeated START, address, 6 data bytes
+// and STOP.
+#define FETCH_INTERRUPTS 13
+
+static i2c_sim_t sim;
+static i2c_bus_t bus;
+static i2c_sim_device_t *device;
+static i2c_sim_async_t harness;
+static i2c_async_bus_t async_bus;
+static sht31_t sensor;
+static sht31_async_t request;
+
+static uint8_t callbacks;
+static i2c_async_result_t last_result;
+static bool last_success;
+
+static void record_result(i2c_async_transfer_t *transfer,
+                          i2c_async_result_t result)
+{
+    (void)transfer;
+    callbacks++;
+    last_result = result;
+}
+
+static void record_success(sht31_async_t *fetch, bool success)
+{
+    (void)fetch;
+    callbacks++;
+    last_success = success;
+}
+
+static i2c_async_transfer_t probe(uint8_t address)
+{
+    i2c_async_transfer_t transfer = {
+        .address  = address,
+        .callback = record_result,
+    };
+    return transfer;
+}
+
+static void start_periodic(void)
+{
+    TEST_ASSERT(sht31_send_periodic_data_acquisition_mode(&sensor, 2, 4));
+    i2c_sim_advance_ms(&sim, 100);
+    i2c_sim_reset_counters(&sim);
+}
+
+void setUp(void)
+{
+    i2c_sim_init(&sim, I2C_SIM_400KHZ, &bus);
+    device = i2c_sim_add_sht31(&sim, DEFAULT_ADDRESS);
+    i2c_sim_set_environment(device, TEMPERATURE, HUMIDITY);
+    i2c_sim_async_init(&harness, &sim, &async_bus);
+
+    sht31_init(&sensor, &bus, DEFAULT_ADDRESS);
+    sht31_async_init(&request, &sensor, &async_bus, record_success, NULL);
+
+    callbacks    = 0;
+    last_result  = I2C_ASYNC_BUS_ERROR;
+    last_success = false;
+}
+
+void tearDown(void)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Engine
+///////////////////////////////////////////////////////////////////////////////
+
+void test_probe_present_device_acks(void)
+{
+    i2c_async_transfer_t transfer = probe(DEFAULT_ADDRESS);
+
+    TEST_ASSERT(async_bus.submit(async_bus.context, &transfer));
+    TEST_ASSERT_EQUAL_UINT32(3, i2c_sim_async_complete(&harness));
+
+    TEST_ASSERT_EQUAL_UINT8(1, callbacks);
+    TEST_ASSERT_EQUAL(I2C_ASYNC_OK, last_result);
+    TEST_ASSERT_EQUAL_UINT32(1, sim.stops);
+}
+
+void test_probe_missing_device_nacks(void)
+{
+    i2c_async_transfer_t transfer = probe(SHT_ALTERNATE_ADDRESS);
+
+    async_bus.submit(async_bus.context, &transfer);
+    i2c_sim_async_complete(&harness);
+
+    TEST_ASSERT_EQUAL(I2C_ASYNC_NACK, last_result);
+    TEST_ASSERT_EQUAL_UINT32(1, harness.engine.nacks);
+    TEST_ASSERT_EQUAL_UINT32(1, sim.stops);
+}
+
+void test_write_then_read_status_register(void)
+{
+    const uint8_t command[2]      = {0xF3, 0x2D};
+    uint8_t word[3]               = {0};
+    i2c_async_transfer_t transfer = {
+        .address      = DEFAULT_ADDRESS,
+        .write        = command,
+        .write_length = sizeof(command),
+        .read         = word,
+        .read_length  = sizeof(word),
+        .callback     = record_result,
+    };
+
+    async_bus.submit(async_bus.context, &transfer);
+
+    // START, address, 2 bytes, repeated START, address, 3 bytes, STOP.
+    TEST_ASSERT_EQUAL_UINT32(10, i2c_sim_async_complete(&harness));
+    TEST_ASSERT_EQUAL(I2C_ASYNC_OK, last_result);
+    TEST_ASSERT_EQUAL_HEX8(0x80, word[0]);
+    TEST_ASSERT_EQUAL_HEX8(0x10, word[1]);
+    TEST_ASSERT_EQUAL_HEX8(crc8_word(0x8010), word[2]);
+}
+
+void test_write_only_runs_command(void)
+{
+    const uint8_t command[2]      = {0x30, 0x6D};
+    i2c_async_transfer_t transfer = {
+        .address      = DEFAULT_ADDRESS,
+        .write        = command,
+        .write_length = sizeof(command),
+        .callback     = record_result,
+    };
+
+    async_bus.submit(async_bus.context, &transfer);
+    i2c_sim_async_complete(&harness);
+
+    TEST_ASSERT_EQUAL(I2C_ASYNC_OK, last_result);
+    TEST_ASSERT_TRUE(device->status_register & 0x2000);
+}
+
+void test_nothing_happens_on_the_bus_until_interrupts_run(void)
+{
+    i2c_async_transfer_t transfer = probe(DEFAULT_ADDRESS);
+
+    async_bus.submit(async_bus.context, &transfer);
+
+    TEST_ASSERT_EQUAL_UINT32(0, sim.starts);
+    TEST_ASSERT_TRUE(i2c_async_engine_busy(&harness.engine));
+    TEST_ASSERT_EQUAL_UINT8(0, callbacks);
+}
+
+void test_submit_while_busy_is_rejected(void)
+{
+    i2c_async_transfer_t first  = probe(DEFAULT_ADDRESS);
+    i2c_async_transfer_t second = probe(DEFAULT_ADDRESS);
+
+    TEST_ASSERT(async_bus.submit(async_bus.context, &first));
+    TEST_ASSERT_FALSE(async_bus.submit(async_bus.context, &second));
+
+    i2c_sim_async_complete(&harness);
+    TEST_ASSERT_EQUAL_UINT8(1, callbacks);
+}
+
+static i2c_async_transfer_t chained;
+
+static void submit_chained(i2c_async_transfer_t *transfer,
+                           i2c_async_result_t result)
+{
+    record_result(transfer, result);
+    TEST_ASSERT(async_bus.submit(async_bus.context, &chained));
+}
+
+void test_callback_can_submit_next_transaction(void)
+{
+    i2c_async_transfer_t first = probe(DEFAULT_ADDRESS);
+
+    first.callback = submit_chained;
+    chained        = probe(SHT_ALTERNATE_ADDRESS);
+
+    async_bus.submit(async_bus.context, &first);
+    i2c_sim_async_complete(&harness);
+
+    TEST_ASSERT_EQUAL_UINT8(2, callbacks);
+    TEST_ASSERT_EQUAL(I2C_ASYNC_NACK, last_result);
+    TEST_ASSERT_EQUAL_UINT32(2, sim.stops);
+}
+
+void test_bus_error_stops_and_fails_transaction(void)
+{
+    uint8_t word[3]               = {0};
+    i2c_async_transfer_t transfer = {
+        .address     = DEFAULT_ADDRESS,
+        .read        = word,
+        .read_length = sizeof(word),
+        .callback    = record_result,
+    };
+
+    async_bus.submit(async_bus.context, &transfer);
+    i2c_sim_async_advance_ns(&harness, 0);
+
+    i2c_async_engine_bus_error(&harness.engine);
+    i2c_sim_async_complete(&harness);
+
+    TEST_ASSERT_EQUAL(I2C_ASYNC_BUS_ERROR, last_result);
+    TEST_ASSERT_EQUAL_UINT32(1, harness.engine.bus_errors);
+    TEST_ASSERT_EQUAL_UINT32(1, sim.stops);
+    TEST_ASSERT_FALSE(i2c_async_engine_busy(&harness.engine));
+}
+
+void test_bus_error_when_idle_is_ignored(void)
+{
+    i2c_async_engine_bus_error(&harness.engine);
+
+    TEST_ASSERT_EQUAL_UINT32(0, harness.engine.bus_errors);
+    TEST_ASSERT_FALSE(i2c_async_engine_busy(&harness.engine));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Asynchronous fetch
+///////////////////////////////////////////////////////////////////////////////
+
+void test_async_fetch_stores_reading(void)
+{
+    start_periodic();
+
+    TEST_ASSERT(sht31_fetch_periodic_data_async(&request));
+    TEST_ASSERT_TRUE(sht31_async_busy(&request));
+    TEST_ASSERT_EQUAL_UINT32(FETCH_INTERRUPTS,
+                             i2c_sim_async_complete(&harness));
+
+    TEST_ASSERT_EQUAL_UINT8(1, callbacks);
+    TEST_ASSERT_TRUE(last_success);
+    TEST_ASSERT_FALSE(sht31_async_busy(&request));
+    TEST_ASSERT_EQUAL_HEX16(TEMPERATURE, sht31_return_temperature(&sensor));
+    TEST_ASSERT_EQUAL_HEX16(HUMIDITY, sht31_return_humidity(&sensor));
+}
+
+void test_async_fetch_uses_same_bus_traffic_as_blocking_fetch(void)
+{
+    uint64_t blocking_ns = 0;
+
+    start_periodic();
+    TEST_ASSERT(sht31_fetch_periodic_data(&sensor));
+    blocking_ns = i2c_sim_bus_busy_ns(&sim);
+
+    i2c_sim_advance_ms(&sim, 100);
+    i2c_sim_reset_counters(&sim);
+    sht31_fetch_periodic_data_async(&request);
+    i2c_sim_async_complete(&harness);
+
+    TEST_ASSERT_EQUAL_UINT64(blocking_ns, i2c_sim_bus_busy_ns(&sim));
+}
+
+void test_async_fetch_with_no_data_fails_with_nack(void)
+{
+    TEST_ASSERT(sht31_send_periodic_data_acquisition_mode(&sensor, 2, 4));
+
+    sht31_fetch_periodic_data_async(&request);
+    i2c_sim_async_complete(&harness);
+
+    TEST_ASSERT_EQUAL_UINT8(1, callbacks);
+    TEST_ASSERT_FALSE(last_success);
+    TEST_ASSERT_EQUAL_UINT16(1, sensor.errors.nack);
+}
+
+void test_async_fetch_crc_failure_fails(void)
+{
+    start_periodic();
+    device->corrupt_crc = 1;
+
+    sht31_fetch_periodic_data_async(&request);
+    i2c_sim_async_complete(&harness);
+
+    TEST_ASSERT_FALSE(last_success);
+    TEST_ASSERT_EQUAL_UINT16(1, sensor.errors.crc);
+}
+
+void test_async_fetch_while_busy_is_rejected(void)
+{
+    start_periodic();
+
+    TEST_ASSERT(sht31_fetch_periodic_data_async(&request));
+    TEST_ASSERT_FALSE(sht31_fetch_periodic_data_async(&request));
+    i2c_sim_async_complete(&harness);
+
+    TEST_ASSERT_EQUAL_UINT8(1, callbacks);
+}
+
+void test_async_fetch_rejected_when_bus_busy(void)
+{
+    i2c_async_transfer_t transfer = probe(DEFAULT_ADDRESS);
+
+    async_bus.submit(async_bus.context, &transfer);
+
+    TEST_ASSERT_FALSE(sht31_fetch_periodic_data_async(&request));
+    TEST_ASSERT_FALSE(sht31_async_busy(&request));
+}
+
+void test_main_loop_runs_while_fetch_is_on_the_bus(void)
+{
+    uint32_t loops  = 0;
+    uint64_t bus_ns = 0;
+
+    start_periodic();
+    sht31_fetch_periodic_data_async(&request);
+
+    // The main loop does a microsecond of its own work per pass; the
+    // interrupts cut in as each bus step ends.
+    while (0 == callbacks)
+    {
+        i2c_sim_async_advance_ns(&harness, 1000);
+        loops++;
+    }
+    bus_ns = i2c_sim_bus_busy_ns(&sim);
+
+    TEST_ASSERT_TRUE(last_success);
+    TEST_ASSERT_EQUAL_UINT32(FETCH_INTERRUPTS, harness.engine.interrupts);
+
+    // A blocking fetch would hold the CPU for all of the bus time; here the
+    // loop ran for all but the last partial microsecond of it.
+    TEST_ASSERT_UINT32_WITHIN(1, (uint32_t)(bus_ns / 1000), loops);
+}
@@ -0,0 +1,237 @@
+/**
+ * @file        test_i2c_linux.c
+ * @author      Steven Daglish
+ * @brief
+ * @version     0.1
+ * @date        17 October 2026
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+// Test list
+// ---------
+//
+// Opening and closing the node
+// One ioctl per transaction through transfer
+// NACKs and polling without clock stretching
+// Byte level calls batched into one ioctl (i2c_driver.h)
+///////////////////////////////////////////////////////////////////////////////
+
+#include "unity.h"
+#include "i2c_linux.h"
+#include "i2c_driver_linux.h"
+#include "mock_i2c_linux_syscalls.h"
+#include "i2c_sim.h"
+#include "sht31_driver.h"
+#include "crc8.h"
+#include "i2c_bus.h"
+
+#define FAKE_FD 7
+
+static i2c_sim_t sim;
+static i2c_bus_t sim_bus;
+static i2c_sim_device_t *device;
+
+static i2c_linux_t port;
+static i2c_bus_t bus;
+static sht31_t sensor;
+
+static uint32_t last_count;
+static struct i2c_msg last_messages[2];
+
+/*
+ * Stands in for the I2C_RDWR ioctl by running the messages on the simulated
+ * bus: a START before each message, one STOP at the end.
+ */
+static int rdwr_on_sim(int fd, struct i2c_msg *messages, uint32_t count,
+                       int num_calls)
+{
+    uint32_t i = 0;
+    bool ack   = true;
+
+    (void)num_calls;
+    TEST_ASSERT_EQUAL_INT(FAKE_FD, fd);
+
+    last_count = count;
+    for (i = 0; (i < count) && (i < 2); i++)
+    {
+        last_messages[i] = messages[i];
+    }
+
+    for (i = 0; (i < count) && ack; i++)
+    {
+        sim_bus.start(sim_bus.context);
+        if (messages[i].flags & I2C_M_RD)
+        {
+            ack = sim_bus.send_address_read(sim_bus.context,
+                                            messages[i].addr) &&
+                  sim_bus.read_block(sim_bus.context, messages[i].buf,
+                                     messages[i].len);
+        }
+        else
+        {
+            ack = sim_bus.send_address_write(sim_bus.context,
+                                             messages[i].addr) &&
+                  sim_bus.write_block(sim_bus.context, messages[i].buf,
+                                      messages[i].len);
+        }
+    }
+    sim_bus.stop(sim_bus.context);
+
+    return ack ? (int)count : -1;
+}
+
+static void open_driver(void)
+{
+    i2c_linux_sys_open_ExpectAndReturn("/dev/i2c-1", FAKE_FD);
+    TEST_ASSERT(i2c_driver_linux_open("/dev/i2c-1"));
+}
+
+void setUp(void)
+{
+    i2c_sim_init(&sim, I2C_SIM_400KHZ, &sim_bus);
+    device = i2c_sim_add_sht31(&sim, DEFAULT_ADDRESS);
+    i2c_sim_set_environment(device, 0x1234, 0xBEEF);
+
+    i2c_linux_sys_rdwr_StubWithCallback(rdwr_on_sim);
+    i2c_linux_sys_open_ExpectAndReturn("/dev/i2c-1", FAKE_FD);
+    TEST_ASSERT(i2c_linux_open(&port, "/dev/i2c-1", &bus));
+    sht31_init(&sensor, &bus, DEFAULT_ADDRESS);
+    last_count = 0;
+}
+
+void tearDown(void)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Opening and closing
+///////////////////////////////////////////////////////////////////////////////
+
+void test_open_failure_returns_false(void)
+{
+    i2c_linux_t other;
+    i2c_bus_t other_bus;
+
+    i2c_linux_sys_open_ExpectAndReturn("/dev/i2c-9", -1);
+
+    TEST_ASSERT_FALSE(i2c_linux_open(&other, "/dev/i2c-9", &other_bus));
+}
+
+void test_close_closes_node_once(void)
+{
+    i2c_linux_sys_close_ExpectAndReturn(FAKE_FD, 0);
+
+    i2c_linux_close(&port);
+    i2c_linux_close(&port);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Whole transactions
+///////////////////////////////////////////////////////////////////////////////
+
+void test_fetch_is_one_ioctl_with_write_and_read_messages(void)
+{
+    TEST_ASSERT(sht31_send_periodic_data_acquisition_mode(&sensor, 2, 4));
+    i2c_sim_advance_ms(&sim, 100);
+    port.ioctls = 0;
+
+    TEST_ASSERT(sht31_fetch_periodic_data(&sensor));
+
+    TEST_ASSERT_EQUAL_UINT32(1, port.ioctls);
+    TEST_ASSERT_EQUAL_UINT32(2, last_count);
+    TEST_ASSERT_EQUAL_HEX16(DEFAULT_ADDRESS, last_messages[0].addr);
+    TEST_ASSERT_EQUAL_HEX16(0, last_messages[0].flags);
+    TEST_ASSERT_EQUAL_UINT16(2, last_messages[0].len);
+    TEST_ASSERT_EQUAL_HEX16(I2C_M_RD, last_messages[1].flags);
+    TEST_ASSERT_EQUAL_UINT16(6, last_messages[1].len);
+    TEST_ASSERT_EQUAL_HEX16(0x1234, sht31_return_temperature(&sensor));
+    TEST_ASSERT_EQUAL_HEX16(0xBEEF, sht31_return_humidity(&sensor));
+}
+
+void test_command_is_one_ioctl_with_one_message(void)
+{
+    TEST_ASSERT(sht31_send_soft_reset(&sensor));
+
+    TEST_ASSERT_EQUAL_UINT32(1, port.ioctls);
+    TEST_ASSERT_EQUAL_UINT32(1, last_count);
+    TEST_ASSERT_EQUAL_UINT16(2, last_messages[0].len);
+    TEST_ASSERT_EQUAL_UINT32(1, device->commands);
+}
+
+void test_clock_stretched_single_shot_is_two_ioctls(void)
+{
+    TEST_ASSERT(sht31_get_single_shot_data(&sensor));
+
+    TEST_ASSERT_EQUAL_UINT32(2, port.ioctls);
+    TEST_ASSERT_EQUAL_HEX16(0x1234, sht31_return_temperature(&sensor));
+}
+
+void test_nack_fails_transaction_and_is_counted(void)
+{
+    device->nack_address = 1;
+
+    TEST_ASSERT_FALSE(sht31_send_soft_reset(&sensor));
+
+    TEST_ASSERT_EQUAL_UINT32(1, port.failed_transfers);
+    TEST_ASSERT_EQUAL_UINT16(1, sensor.errors.nack);
+}
+
+void test_single_shot_without_stretch_polls_one_ioctl_at_a_time(void)
+{
+    TEST_ASSERT(sht31_get_single_shot_data_in_mode(&sensor, 0, false));
+
+    TEST_ASSERT_EQUAL_HEX16(0x1234, sht31_return_temperature(&sensor));
+    TEST_ASSERT_EQUAL_UINT32(sim.nacks + 2, port.ioctls);
+    TEST_ASSERT_EQUAL_UINT16(0, sensor.errors.nack);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// i2c_driver.h
+///////////////////////////////////////////////////////////////////////////////
+
+void test_single_sensor_fetch_is_one_ioctl(void)
+{
+    open_driver();
+    sht30_driver_create();
+    TEST_ASSERT(sht30_driver_send_periodic_data_aquisition_mode(2, 4));
+    i2c_sim_advance_ms(&sim, 100);
+    uint32_t ioctls = i2c_driver_linux_port()->ioctls;
+
+    TEST_ASSERT(sht30_driver_fetch_periodic_data());
+
+    TEST_ASSERT_EQUAL_UINT32(ioctls + 1, i2c_driver_linux_port()->ioctls);
+    TEST_ASSERT_EQUAL_UINT32(2, last_count);
+    TEST_ASSERT_EQUAL_HEX16(0x1234, sht30_driver_return_temperature());
+}
+
+void test_single_sensor_command_is_sent_at_stop(void)
+{
+    open_driver();
+
+    TEST_ASSERT(sht30_driver_send_soft_reset());
+
+    TEST_ASSERT_EQUAL_UINT32(1, i2c_driver_linux_port()->ioctls);
+    TEST_ASSERT_EQUAL_UINT32(1, device->commands);
+}
+
+void test_single_sensor_write_nack_is_counted_on_port(void)
+{
+    open_driver();
+    device->nack_address = 1;
+
+    sht30_driver_send_soft_reset();
+
+    TEST_ASSERT_EQUAL_UINT32(1, i2c_driver_linux_port()->failed_transfers);
+}
+
+void test_handle_on_driver_bus_sees_nacks(void)
+{
+    sht31_t handle;
+
+    open_driver();
+    sht31_init(&handle, i2c_driver_linux_bus(), DEFAULT_ADDRESS);
+    device->nack_address = 1;
+
+    TEST_ASSERT_FALSE(sht31_send_soft_reset(&handle));
+}
@@ -0,0 +1,475 @@
+/**
+ * @file        test_i2c_sim.c
+ * @author      Steven Daglish
+ * @brief
+ * @version     0.1
+ * @date        17 October 2026
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+// Test list
+// ---------
+//
+// Driver talks to simulated sensors
+// Bus time and SCL cycle accounting at 100 kHz, 400 kHz and 1 MHz
+// Clock stretching and conversion delays
+// Fault injection
+// Alert limits and the ALERT pin
+// i2c_driver.h on the simulated bus
+///////////////////////////////////////////////////////////////////////////////
+
+#include "unity.h"
+#include "i2c_sim.h"
+#include "i2c_driver_sim.h"
+#include "sht31_driver.h"
+#include "crc8.h"
+#include "i2c_bus.h"
+
+// Address + 2 command bytes, then address + 6 data bytes.
+#define FETCH_BYTES 10
+#define FETCH_PERIODS (FETCH_BYTES * 9 + 2 + 1)
+
+static i2c_sim_t sim;
+static i2c_bus_t bus;
+static i2c_sim_device_t *device;
+static sht31_t sensor;
+
+static void start_bus(uint32_t scl_hz)
+{
+    i2c_sim_init(&sim, scl_hz, &bus);
+    device = i2c_sim_add_sht31(&sim, DEFAULT_ADDRESS);
+    i2c_sim_set_environment(device, 0x6666, 0x8000);
+    sht31_init(&sensor, &bus, DEFAULT_ADDRESS);
+}
+
+static uint64_t periodic_fetch_busy_ns(uint32_t scl_hz)
+{
+    start_bus(scl_hz);
+    TEST_ASSERT(sht31_send_periodic_data_acquisition_mode(&sensor, 2, 4));
+    i2c_sim_advance_ms(&sim, 100);
+
+    i2c_sim_reset_counters(&sim);
+    TEST_ASSERT(sht31_fetch_periodic_data(&sensor));
+    TEST_ASSERT_EQUAL_UINT64(FETCH_BYTES * 9, sim.scl_cycles);
+
+    return i2c_sim_bus_busy_ns(&sim);
+}
+
+// Set to make the sensor stop answering when the driver first reads the
+// clock, which is after a single shot command has gone out.
+static i2c_sim_device_t *dies_at_first_clock_read;
+
+static uint32_t sim_clock_ms(void)
+{
+    if (NULL != dies_at_first_clock_read)
+    {
+        dies_at_first_clock_read->nack_address = 0xFFFF;
+        dies_at_first_clock_read               = NULL;
+    }
+    return i2c_sim_time_ms(&sim);
+}
+
+void setUp(void)
+{
+    start_bus(I2C_SIM_400KHZ);
+}
+
+void tearDown(void)
+{
+    sht31_set_clock(NULL);
+    dies_at_first_clock_read = NULL;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Talking to the sensor
+///////////////////////////////////////////////////////////////////////////////
+
+void test_single_shot_reads_environment(void)
+{
+    i2c_sim_set_environment(device, 0x1234, 0xBEEF);
+
+    TEST_ASSERT(sht31_get_single_shot_data(&sensor));
+    TEST_ASSERT_EQUAL_HEX16(0x1234, sht31_return_temperature(&sensor));
+    TEST_ASSERT_EQUAL_HEX16(0xBEEF, sht31_return_humidity(&sensor));
+    TEST_ASSERT_EQUAL_UINT32(1, device->measurements);
+}
+
+void test_sensor_at_other_address_is_nacked(void)
+{
+    sht31_t missing;
+    sht31_init(&missing, &bus, SHT_ALTERNATE_ADDRESS);
+
+    TEST_ASSERT_FALSE(sht31_send_soft_reset(&missing));
+    TEST_ASSERT_EQUAL_UINT32(1, sim.nacks);
+}
+
+void test_two_sensors_on_one_bus(void)
+{
+    sht31_t other;
+    i2c_sim_device_t *other_device =
+        i2c_sim_add_sht31(&sim, SHT_ALTERNATE_ADDRESS);
+    i2c_sim_set_environment(other_device, 0x1111, 0x2222);
+    sht31_init(&other, &bus, SHT_ALTERNATE_ADDRESS);
+
+    TEST_ASSERT(sht31_get_single_shot_data(&sensor));
+    TEST_ASSERT(sht31_get_single_shot_data(&other));
+    TEST_ASSERT_EQUAL_HEX16(0x6666, sht31_return_temperature(&sensor));
+    TEST_ASSERT_EQUAL_HEX16(0x1111, sht31_return_temperature(&other));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Bus time
+///////////////////////////////////////////////////////////////////////////////
+
+void test_periodic_fetch_bus_time_at_each_clock(void)
+{
+    TEST_ASSERT_EQUAL_UINT64(FETCH_PERIODS * 10000ull,
+                             periodic_fetch_busy_ns(I2C_SIM_100KHZ));
+    TEST_ASSERT_EQUAL_UINT64(FETCH_PERIODS * 2500ull,
+                             periodic_fetch_busy_ns(I2C_SIM_400KHZ));
+    TEST_ASSERT_EQUAL_UINT64(FETCH_PERIODS * 1000ull,
+                             periodic_fetch_busy_ns(I2C_SIM_1MHZ));
+}
+
+void test_periodic_fetch_counts_starts_stops_and_bytes(void)
+{
+    periodic_fetch_busy_ns(I2C_SIM_400KHZ);
+
+    TEST_ASSERT_EQUAL_UINT32(2, sim.starts);
+    TEST_ASSERT_EQUAL_UINT32(1, sim.stops);
+    TEST_ASSERT_EQUAL_UINT32(4, sim.bytes_written);
+    TEST_ASSERT_EQUAL_UINT32(6, sim.bytes_read);
+}
+
+void test_clock_stretching_holds_bus_for_conversion(void)
+{
+    TEST_ASSERT(sht31_get_single_shot_data_in_mode(&sensor, 2, true));
+
+    // High repeatability converts for 15.5 ms, less the command's stop and
+    // the read's start and address byte, which overlap the conversion.
+    TEST_ASSERT_EQUAL_UINT64(15500000ull - 11 * 2500ull, sim.stretch_ns);
+    TEST_ASSERT_EQUAL_UINT64(sim.stretch_ns + (FETCH_PERIODS + 1) * 2500ull,
+                             i2c_sim_bus_busy_ns(&sim));
+}
+
+void test_low_repeatability_converts_faster(void)
+{
+    TEST_ASSERT(sht31_get_single_shot_data_in_mode(&sensor, 0, true));
+    TEST_ASSERT_EQUAL_UINT64(4500000ull - 11 * 2500ull, sim.stretch_ns);
+}
+
+void test_no_stretch_read_during_conversion_is_nacked(void)
+{
+    TEST_ASSERT(sht31_begin_measurement(&sensor, 2, i2c_sim_time_ms(&sim)));
+
+    i2c_sim_advance_ms(&sim, 10);
+    bus.start(bus.context);
+    TEST_ASSERT_FALSE(bus.send_address_read(bus.context, DEFAULT_ADDRESS));
+    bus.stop(bus.context);
+}
+
+void test_non_blocking_measurement_leaves_bus_idle_while_converting(void)
+{
+    TEST_ASSERT(sht31_begin_measurement(&sensor, 2, i2c_sim_time_ms(&sim)));
+    uint64_t busy = i2c_sim_bus_busy_ns(&sim);
+
+    i2c_sim_advance_ms(&sim, 10);
+    TEST_ASSERT_EQUAL(SHT31_POLL_BUSY,
+                      sht31_poll(&sensor, i2c_sim_time_ms(&sim)));
+    TEST_ASSERT_EQUAL_UINT64(busy, i2c_sim_bus_busy_ns(&sim));
+
+    i2c_sim_advance_ms(&sim, 7);
+    TEST_ASSERT_EQUAL(SHT31_POLL_DONE,
+                      sht31_poll(&sensor, i2c_sim_time_ms(&sim)));
+    TEST_ASSERT_EQUAL_UINT64(0, sim.stretch_ns);
+}
+
+void test_measurement_started_late_in_a_millisecond_is_not_lost(void)
+{
+    uint8_t repeatability = 0;
+    sht31_poll_t state    = SHT31_POLL_BUSY;
+
+    for (repeatability = 0; repeatability < 3; repeatability++)
+    {
+        // Started 0.9 ms into the tick it is stamped with.
+        i2c_sim_advance_ns(&sim, 1000000 - (i2c_sim_time_ns(&sim) % 1000000) +
+                                     900000);
+        TEST_ASSERT(sht31_begin_measurement(&sensor, repeatability,
+                                            i2c_sim_time_ms(&sim)));
+
+        do
+        {
+            i2c_sim_advance_ns(&sim, 100000);
+            state = sht31_poll(&sensor, i2c_sim_time_ms(&sim));
+        } while (SHT31_POLL_BUSY == state);
+
+        TEST_ASSERT_EQUAL(SHT31_POLL_DONE, state);
+    }
+    TEST_ASSERT_EQUAL_UINT16(0, sensor.errors.nack);
+}
+
+void test_blocking_no_stretch_polls_until_ready(void)
+{
+    start_bus(I2C_SIM_1MHZ);
+
+    TEST_ASSERT(sht31_get_single_shot_data_in_mode(&sensor, 0, false));
+    TEST_ASSERT(sim.nacks > 0);
+    TEST_ASSERT(i2c_sim_time_ns(&sim) >= 4500000ull);
+}
+
+void test_blocking_no_stretch_gives_up_on_time_at_100khz(void)
+{
+    uint32_t limit_ms = SHT_DURATION_HIGH_MS + SHT_SINGLE_SHOT_POLL_MARGIN_MS;
+
+    start_bus(I2C_SIM_100KHZ);
+    sht31_set_clock(sim_clock_ms);
+    dies_at_first_clock_read = device;
+    uint64_t started_ns      = i2c_sim_time_ns(&sim);
+
+    TEST_ASSERT_FALSE(sht31_get_single_shot_data_in_mode(&sensor, 2, false));
+
+    uint64_t elapsed_ns = i2c_sim_time_ns(&sim) - started_ns;
+    TEST_ASSERT(elapsed_ns >= (uint64_t)limit_ms * 1000000u);
+    TEST_ASSERT(elapsed_ns <= (uint64_t)(limit_ms + 2) * 1000000u);
+}
+
+void test_blocking_no_stretch_high_repeatability_at_1mhz(void)
+{
+    start_bus(I2C_SIM_1MHZ);
+
+    TEST_ASSERT(sht31_get_single_shot_data_in_mode(&sensor, 2, false));
+    TEST_ASSERT(i2c_sim_time_ns(&sim) >= 15500000ull);
+    TEST_ASSERT_EQUAL_UINT16(0, sensor.errors.nack);
+}
+
+void test_periodic_fetch_before_first_measurement_is_nacked(void)
+{
+    TEST_ASSERT(sht31_send_periodic_data_acquisition_mode(&sensor, 2, 4));
+
+    TEST_ASSERT_FALSE(sht31_fetch_periodic_data(&sensor));
+
+    i2c_sim_advance_ms(&sim, 100);
+    TEST_ASSERT(sht31_fetch_periodic_data(&sensor));
+    TEST_ASSERT_FALSE(sht31_fetch_periodic_data(&sensor));
+}
+
+void test_break_stops_periodic_measurements(void)
+{
+    TEST_ASSERT(sht31_send_periodic_data_acquisition_mode(&sensor, 2, 4));
+    i2c_sim_advance_ms(&sim, 250);
+    uint32_t measurements = device->measurements;
+
+    TEST_ASSERT(sht31_break_command(&sensor));
+    i2c_sim_advance_ms(&sim, 1000);
+    TEST_ASSERT_FALSE(sht31_fetch_periodic_data(&sensor));
+    TEST_ASSERT_EQUAL_UINT32(measurements, device->measurements);
+}
+
+void test_driver_stats_agree_with_bus(void)
+{
+    start_bus(I2C_SIM_1MHZ);
+    sht31_stats_reset(&sensor);
+    i2c_sim_reset_counters(&sim);
+
+    TEST_ASSERT(sht31_get_single_shot_data_in_mode(&sensor, 1, false));
+
+    const sht31_stats_t *stats = sht31_stats(&sensor);
+    TEST_ASSERT_EQUAL_UINT32(sim.starts, stats->starts);
+    TEST_ASSERT_EQUAL_UINT32(sim.bytes_written, stats->bytes_written);
+    TEST_ASSERT_EQUAL_UINT32(sim.bytes_read, stats->bytes_read);
+    TEST_ASSERT_EQUAL_UINT32(sim.nacks, stats->nacks);
+    TEST_ASSERT_EQUAL_UINT32(sim.nacks, stats->retries);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Fault injection
+///////////////////////////////////////////////////////////////////////////////
+
+void test_injected_address_nack(void)
+{
+    device->nack_address = 1;
+
+    TEST_ASSERT_FALSE(sht31_send_soft_reset(&sensor));
+    TEST_ASSERT(sht31_send_soft_reset(&sensor));
+    TEST_ASSERT_EQUAL_UINT16(1, sensor.errors.nack);
+}
+
+void test_every_failed_transaction_ends_with_one_stop(void)
+{
+    sht31_t missing;
+    sht31_init(&missing, &bus, SHT_ALTERNATE_ADDRESS);
+
+    TEST_ASSERT_FALSE(sht31_send_soft_reset(&missing));
+    TEST_ASSERT_FALSE(
+        sht31_send_periodic_data_acquisition_mode(&missing, 2, 4));
+    TEST_ASSERT_FALSE(sht31_fetch_periodic_data(&missing));
+    TEST_ASSERT_FALSE(sht31_read_status_register(&missing));
+    TEST_ASSERT_FALSE(sht31_clear_status_register(&missing));
+    TEST_ASSERT_FALSE(sht31_break_command(&missing));
+    TEST_ASSERT_FALSE(sht31_send_art_command(&missing));
+    TEST_ASSERT_FALSE(sht31_get_single_shot_data(&missing));
+    TEST_ASSERT_FALSE(sht31_begin_measurement(&missing, 2, 0));
+
+    TEST_ASSERT_EQUAL_UINT32(9, sim.starts);
+    TEST_ASSERT_EQUAL_UINT32(9, sim.stops);
+}
+
+void test_injected_crc_corruption(void)
+{
+    device->corrupt_crc = 1;
+
+    TEST_ASSERT_FALSE(sht31_get_single_shot_data(&sensor));
+    TEST_ASSERT(sht31_get_single_shot_data(&sensor));
+    TEST_ASSERT_EQUAL_UINT16(1, sensor.errors.crc);
+}
+
+void test_serial_number_reads_back(void)
+{
+    uint32_t serial = 0;
+
+    device->serial_number = 0xCAFE1234;
+
+    TEST_ASSERT(sht31_read_serial_number(&sensor, &serial));
+    TEST_ASSERT_EQUAL_HEX32(0xCAFE1234, serial);
+}
+
+void test_serial_number_crc_failure_leaves_value(void)
+{
+    uint32_t serial = 7;
+
+    device->corrupt_crc = 1;
+
+    TEST_ASSERT_FALSE(sht31_read_serial_number(&sensor, &serial));
+    TEST_ASSERT_EQUAL_UINT32(7, serial);
+    TEST_ASSERT_EQUAL_UINT16(1, sensor.errors.crc);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Alert limits
+///////////////////////////////////////////////////////////////////////////////
+
+// 30 C and 50 %RH.
+#define ROOM_TEMPERATURE 0x6666
+#define ROOM_HUMIDITY 0x8000
+
+static void set_temperature_limits(uint16_t high_set, uint16_t high_clear)
+{
+    TEST_ASSERT(sht31_write_alert_limit(&sensor, SHT31_ALERT_HIGH_SET,
+                                        high_set, 0xFFFF));
+    TEST_ASSERT(sht31_write_alert_limit(&sensor, SHT31_ALERT_HIGH_CLEAR,
+                                        high_clear, 0xFFFF));
+}
+
+void test_alert_limits_power_up_at_defaults(void)
+{
+    uint16_t temperature = 0;
+    uint16_t humidity    = 0;
+
+    TEST_ASSERT(sht31_read_alert_limit(&sensor, SHT31_ALERT_HIGH_SET,
+                                       &temperature, &humidity));
+    TEST_ASSERT_EQUAL_HEX16(sht31_alert_limit_pack(0x9999, 0xCCCC),
+                            sht31_alert_limit_pack(temperature, humidity));
+}
+
+void test_alert_limit_written_reads_back(void)
+{
+    uint16_t temperature = 0;
+    uint16_t humidity    = 0;
+
+    TEST_ASSERT(sht31_write_alert_limit(&sensor, SHT31_ALERT_LOW_SET, 0x4000,
+                                        0x2000));
+    TEST_ASSERT(sht31_read_alert_limit(&sensor, SHT31_ALERT_LOW_SET,
+                                       &temperature, &humidity));
+
+    TEST_ASSERT_EQUAL_HEX16(0x4000, temperature);
+    TEST_ASSERT_EQUAL_HEX16(0x2000, humidity);
+    TEST_ASSERT_FALSE(device->status_register & 0x0003);
+}
+
+void test_alert_pin_follows_temperature_with_hysteresis(void)
+{
+    sht31_status_t status;
+
+    set_temperature_limits(ROOM_TEMPERATURE + 0x0800,
+                           ROOM_TEMPERATURE + 0x0400);
+    TEST_ASSERT(sht31_clear_status_register(&sensor));
+    TEST_ASSERT(sht31_send_periodic_data_acquisition_mode(&sensor, 2, 4));
+
+    i2c_sim_advance_ms(&sim, 1000);
+    TEST_ASSERT_FALSE(device->alert_pin);
+
+    i2c_sim_set_environment(device, ROOM_TEMPERATURE + 0x0900, ROOM_HUMIDITY);
+    i2c_sim_advance_ms(&sim, 250);
+    TEST_ASSERT_TRUE(device->alert_pin);
+
+    TEST_ASSERT(sht31_read_status(&sensor, &status));
+    TEST_ASSERT_TRUE(status.alert_pending);
+    TEST_ASSERT_TRUE(status.temperature_alert);
+    TEST_ASSERT_FALSE(status.humidity_alert);
+
+    // Between the clear and set limits the alert holds...
+    i2c_sim_set_environment(device, ROOM_TEMPERATURE + 0x0600, ROOM_HUMIDITY);
+    i2c_sim_advance_ms(&sim, 250);
+    TEST_ASSERT_TRUE(device->alert_pin);
+
+    // ...and below the clear limit it goes, leaving alert pending latched.
+    i2c_sim_set_environment(device, ROOM_TEMPERATURE, ROOM_HUMIDITY);
+    i2c_sim_advance_ms(&sim, 250);
+    TEST_ASSERT_FALSE(device->alert_pin);
+
+    TEST_ASSERT(sht31_read_status(&sensor, &status));
+    TEST_ASSERT_TRUE(status.alert_pending);
+    TEST_ASSERT_FALSE(status.temperature_alert);
+}
+
+void test_low_humidity_raises_alert(void)
+{
+    sht31_status_t status;
+
+    TEST_ASSERT(sht31_send_periodic_data_acquisition_mode(&sensor, 2, 4));
+    i2c_sim_set_environment(device, ROOM_TEMPERATURE, 0x1000);
+    i2c_sim_advance_ms(&sim, 250);
+
+    TEST_ASSERT_TRUE(device->alert_pin);
+    TEST_ASSERT(sht31_read_status(&sensor, &status));
+    TEST_ASSERT_TRUE(status.humidity_alert);
+    TEST_ASSERT_FALSE(status.temperature_alert);
+}
+
+void test_alerts_not_checked_outside_periodic_mode(void)
+{
+    i2c_sim_set_environment(device, 0xF000, ROOM_HUMIDITY);
+
+    TEST_ASSERT(sht31_get_single_shot_data(&sensor));
+    TEST_ASSERT_FALSE(device->alert_pin);
+}
+
+void test_soft_reset_restores_default_limits(void)
+{
+    uint16_t temperature = 0;
+    uint16_t humidity    = 0;
+
+    set_temperature_limits(0x1000, 0x0800);
+    TEST_ASSERT(sht31_send_soft_reset(&sensor));
+    TEST_ASSERT(sht31_read_alert_limit(&sensor, SHT31_ALERT_HIGH_SET,
+                                       &temperature, &humidity));
+
+    TEST_ASSERT_EQUAL_HEX16(0xCD33,
+                            sht31_alert_limit_pack(temperature, humidity));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// i2c_driver.h on the simulated bus
+///////////////////////////////////////////////////////////////////////////////
+
+void test_single_sensor_api_runs_on_simulated_bus(void)
+{
+    i2c_sim_set_environment(device, 0xABCD, 0x1234);
+    i2c_driver_sim_attach(&sim);
+    sht30_driver_create();
+
+    TEST_ASSERT(sht30_driver_get_single_shot_data());
+    TEST_ASSERT_EQUAL_HEX16(0xABCD, sht30_driver_return_temperature());
+    TEST_ASSERT_EQUAL_HEX16(0x1234, sht30_driver_return_humidity());
+}
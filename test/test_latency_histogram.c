@@ -0,0 +1,98 @@
+/**
+ * @file        test_latency_histogram.c
+ * @author      Steven Daglish
+ * @brief
+ * @version     0.1
+ * @date        17 October 2026
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+// Test list
+// ---------
+//
+// Bucket edges
+// Counts and maximum
+// Percentiles
+///////////////////////////////////////////////////////////////////////////////
+
+#include "unity.h"
+#include "latency_histogram.h"
+
+static latency_histogram_t histogram;
+
+void setUp(void)
+{
+    latency_histogram_init(&histogram);
+}
+
+void tearDown(void)
+{
+}
+
+void test_new_histogram_is_empty(void)
+{
+    TEST_ASSERT_EQUAL_UINT32(0, latency_histogram_count(&histogram));
+    TEST_ASSERT_EQUAL_UINT32(0, latency_histogram_max_us(&histogram));
+    TEST_ASSERT_EQUAL_UINT32(0,
+                             latency_histogram_percentile_us(&histogram, 50));
+}
+
+void test_values_land_in_power_of_two_buckets(void)
+{
+    latency_histogram_record(&histogram, 0);
+    latency_histogram_record(&histogram, 1);
+    latency_histogram_record(&histogram, 2);
+    latency_histogram_record(&histogram, 3);
+    latency_histogram_record(&histogram, 4);
+    latency_histogram_record(&histogram, 15500);
+
+    TEST_ASSERT_EQUAL_UINT32(1, latency_histogram_bucket(&histogram, 0));
+    TEST_ASSERT_EQUAL_UINT32(1, latency_histogram_bucket(&histogram, 1));
+    TEST_ASSERT_EQUAL_UINT32(2, latency_histogram_bucket(&histogram, 2));
+    TEST_ASSERT_EQUAL_UINT32(1, latency_histogram_bucket(&histogram, 3));
+    TEST_ASSERT_EQUAL_UINT32(1, latency_histogram_bucket(&histogram, 14));
+    TEST_ASSERT_EQUAL_UINT32(6, latency_histogram_count(&histogram));
+    TEST_ASSERT_EQUAL_UINT32(15500, latency_histogram_max_us(&histogram));
+}
+
+void test_largest_value_has_a_bucket(void)
+{
+    latency_histogram_record(&histogram, UINT32_MAX);
+
+    TEST_ASSERT_EQUAL_UINT32(
+        1, latency_histogram_bucket(&histogram, LATENCY_HISTOGRAM_BUCKETS - 1));
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, latency_histogram_bucket_upper_us(
+                                             LATENCY_HISTOGRAM_BUCKETS - 1));
+}
+
+void test_bucket_upper_bounds(void)
+{
+    TEST_ASSERT_EQUAL_UINT32(0, latency_histogram_bucket_upper_us(0));
+    TEST_ASSERT_EQUAL_UINT32(1, latency_histogram_bucket_upper_us(1));
+    TEST_ASSERT_EQUAL_UINT32(16383, latency_histogram_bucket_upper_us(14));
+}
+
+void test_percentiles(void)
+{
+    uint8_t i = 0;
+
+    // 90 fast samples and 10 slow ones.
+    for (i = 0; i < 90; i++)
+    {
+        latency_histogram_record(&histogram, 100);
+    }
+    for (i = 0; i < 10; i++)
+    {
+        latency_histogram_record(&histogram, 20000);
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(127,
+                             latency_histogram_percentile_us(&histogram, 50));
+    TEST_ASSERT_EQUAL_UINT32(127,
+                             latency_histogram_percentile_us(&histogram, 90));
+    TEST_ASSERT_EQUAL_UINT32(32767,
+                             latency_histogram_percentile_us(&histogram, 91));
+    TEST_ASSERT_EQUAL_UINT32(32767,
+                             latency_histogram_percentile_us(&histogram, 100));
+}
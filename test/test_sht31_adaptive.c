@@ -0,0 +1,350 @@
+/**
+ * @file        test_sht31_adaptive.c
+ * @author      Steven Daglish
+ * @brief
+ * @version     0.1
+ * @date        17 October 2026
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+// Test list
+// ---------
+//
+// Configuration checks
+// Starting and stopping periodic mode
+// Fetches only when a result is due
+// Jumping to the fastest rate when readings change quickly
+// Stepping back down when readings are stable
+// Fewer transactions than a fixed fast rate for the same detection latency
+///////////////////////////////////////////////////////////////////////////////
+
+#include "unity.h"
+#include "sht31_adaptive.h"
+#include "sht31_driver.h"
+#include "i2c_sim.h"
+#include "i2c_driver_sim.h"
+#include "crc8.h"
+#include "i2c_bus.h"
+
+#define START_TEMPERATURE 0x6000
+#define HUMIDITY 0x8000
+
+// A steady minute, then 200 ticks/s (about 32 C/min) for 15 s.
+#define RAMP_START_MS 60000
+#define RAMP_END_MS 75000
+#define RAMP_TICKS_PER_S 200
+#define ALARM_TEMPERATURE (START_TEMPERATURE + 900)
+#define ALARM_CROSSED_MS (RAMP_START_MS + (900 * 1000 / RAMP_TICKS_PER_S))
+#define RUN_MS 120000
+
+static i2c_sim_t sim;
+static i2c_bus_t bus;
+static i2c_sim_device_t *device;
+static sht31_t sensor;
+static sht31_adaptive_t adaptive;
+static sht31_adaptive_config_t config;
+
+typedef struct
+{
+    uint32_t transactions;
+    uint32_t detected_ms;
+} run_result_t;
+
+static sht31_poll_t service_at(uint32_t now_ms)
+{
+    uint64_t now_ns = (uint64_t)now_ms * 1000000u;
+
+    if (now_ns > i2c_sim_time_ns(&sim))
+    {
+        i2c_sim_advance_ns(&sim, now_ns - i2c_sim_time_ns(&sim));
+    }
+    return sht31_adaptive_service(&adaptive, now_ms);
+}
+
+static void setup_bus(void)
+{
+    i2c_sim_init(&sim, I2C_SIM_400KHZ, &bus);
+    device = i2c_sim_add_sht31(&sim, DEFAULT_ADDRESS);
+    i2c_sim_set_environment(device, START_TEMPERATURE, HUMIDITY);
+    sht31_init(&sensor, &bus, DEFAULT_ADDRESS);
+}
+
+static uint16_t ramp_temperature(uint32_t now_ms)
+{
+    if (now_ms < RAMP_START_MS)
+    {
+        return START_TEMPERATURE;
+    }
+    if (now_ms > RAMP_END_MS)
+    {
+        now_ms = RAMP_END_MS;
+    }
+    return START_TEMPERATURE +
+           ((now_ms - RAMP_START_MS) * RAMP_TICKS_PER_S) / 1000;
+}
+
+/*
+ * Runs the ramp through the controller a millisecond at a time and notes
+ * when a reading first shows the alarm level.
+ */
+static run_result_t run_ramp(void)
+{
+    run_result_t result = {0, 0};
+    uint32_t now_ms     = 0;
+
+    // Each run starts on a fresh bus at time zero.
+    setup_bus();
+    TEST_ASSERT_TRUE(sht31_adaptive_start(&adaptive, 0));
+
+    for (now_ms = 0; now_ms < RUN_MS; now_ms++)
+    {
+        i2c_sim_set_environment(device, ramp_temperature(now_ms), HUMIDITY);
+
+        if ((SHT31_POLL_DONE == service_at(now_ms)) &&
+            (0 == result.detected_ms) &&
+            (sht31_return_temperature(&sensor) >= ALARM_TEMPERATURE))
+        {
+            result.detected_ms = now_ms;
+        }
+    }
+
+    result.transactions = sim.stops;
+    return result;
+}
+
+void setUp(void)
+{
+    setup_bus();
+
+    sht31_adaptive_default_config(&config);
+    TEST_ASSERT_TRUE(sht31_adaptive_init(&adaptive, &sensor, &config));
+}
+
+void tearDown(void)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Configuration
+///////////////////////////////////////////////////////////////////////////////
+
+void test_init_rejects_bad_levels(void)
+{
+    config.max_level = SHT31_ADAPTIVE_LEVELS;
+    TEST_ASSERT_FALSE(sht31_adaptive_init(&adaptive, &sensor, &config));
+
+    config.max_level = 1;
+    config.min_level = 2;
+    TEST_ASSERT_FALSE(sht31_adaptive_init(&adaptive, &sensor, &config));
+}
+
+void test_service_before_start_is_idle(void)
+{
+    TEST_ASSERT_EQUAL(SHT31_POLL_IDLE, service_at(5000));
+    TEST_ASSERT_EQUAL_UINT32(0, sim.starts);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Starting, stopping and fetching
+///////////////////////////////////////////////////////////////////////////////
+
+void test_start_runs_periodic_mode_at_min_level(void)
+{
+    config.min_level = 1;
+    sht31_adaptive_init(&adaptive, &sensor, &config);
+
+    TEST_ASSERT_TRUE(sht31_adaptive_start(&adaptive, 0));
+
+    TEST_ASSERT_TRUE(device->periodic);
+    TEST_ASSERT_EQUAL_UINT64(1000000000ull, device->period_ns);
+    TEST_ASSERT_EQUAL_UINT8(1, sht31_adaptive_level(&adaptive));
+}
+
+void test_start_fails_if_sensor_does_not_answer(void)
+{
+    device->nack_address = 1;
+
+    TEST_ASSERT_FALSE(sht31_adaptive_start(&adaptive, 0));
+    TEST_ASSERT_EQUAL(SHT31_POLL_IDLE, service_at(100));
+}
+
+void test_stop_sends_break(void)
+{
+    sht31_adaptive_start(&adaptive, 0);
+
+    TEST_ASSERT_TRUE(sht31_adaptive_stop(&adaptive));
+
+    TEST_ASSERT_FALSE(device->periodic);
+    TEST_ASSERT_EQUAL(SHT31_POLL_IDLE, service_at(5000));
+}
+
+void test_fetches_only_when_a_result_is_due(void)
+{
+    uint32_t now_ms = 0;
+    uint8_t results = 0;
+
+    sht31_adaptive_start(&adaptive, 0);
+
+    for (now_ms = 0; now_ms <= 4100; now_ms++)
+    {
+        if (SHT31_POLL_DONE == service_at(now_ms))
+        {
+            results++;
+        }
+    }
+
+    // Ready at 16 ms, 2016 ms and 4016 ms; one transaction to start and one
+    // per fetch.
+    TEST_ASSERT_EQUAL_UINT8(3, results);
+    TEST_ASSERT_EQUAL_UINT32(4, sim.stops);
+    TEST_ASSERT_EQUAL_UINT16(START_TEMPERATURE,
+                             sht31_return_temperature(&sensor));
+}
+
+void test_late_service_skips_missed_results(void)
+{
+    sht31_adaptive_start(&adaptive, 0);
+
+    TEST_ASSERT_EQUAL(SHT31_POLL_DONE, service_at(7000));
+    TEST_ASSERT_EQUAL(SHT31_POLL_BUSY, service_at(7001));
+    TEST_ASSERT_EQUAL(SHT31_POLL_BUSY, service_at(8016));
+    TEST_ASSERT_EQUAL(SHT31_POLL_DONE, service_at(8017));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Changing rate
+///////////////////////////////////////////////////////////////////////////////
+
+void test_fast_change_jumps_to_max_level(void)
+{
+    uint32_t now_ms = 0;
+
+    sht31_adaptive_start(&adaptive, 0);
+    for (now_ms = 0; now_ms < 2000; now_ms++)
+    {
+        service_at(now_ms);
+    }
+
+    // 0.5 C in two seconds.
+    i2c_sim_set_environment(device, START_TEMPERATURE + 200, HUMIDITY);
+    for (; now_ms < 2100; now_ms++)
+    {
+        service_at(now_ms);
+    }
+
+    TEST_ASSERT_EQUAL_UINT8(SHT31_ADAPTIVE_LEVELS - 1,
+                            sht31_adaptive_level(&adaptive));
+    TEST_ASSERT_EQUAL_UINT32(1, sht31_adaptive_level_changes(&adaptive));
+    TEST_ASSERT_TRUE(device->periodic);
+    TEST_ASSERT_EQUAL_UINT64(100000000ull, device->period_ns);
+}
+
+void test_humidity_change_also_raises_rate(void)
+{
+    uint32_t now_ms = 0;
+
+    sht31_adaptive_start(&adaptive, 0);
+    for (now_ms = 0; now_ms < 2000; now_ms++)
+    {
+        service_at(now_ms);
+    }
+
+    i2c_sim_set_environment(device, START_TEMPERATURE, HUMIDITY - 1000);
+    for (; now_ms < 2100; now_ms++)
+    {
+        service_at(now_ms);
+    }
+
+    TEST_ASSERT_EQUAL_UINT8(SHT31_ADAPTIVE_LEVELS - 1,
+                            sht31_adaptive_level(&adaptive));
+}
+
+void test_small_changes_keep_lowest_rate(void)
+{
+    uint32_t now_ms = 0;
+
+    sht31_adaptive_start(&adaptive, 0);
+    for (now_ms = 0; now_ms < 30000; now_ms++)
+    {
+        // 1 tick every 200 ms: 5 ticks/s, under the rise threshold.
+        i2c_sim_set_environment(device, START_TEMPERATURE + now_ms / 200,
+                                HUMIDITY);
+        service_at(now_ms);
+    }
+
+    TEST_ASSERT_EQUAL_UINT8(0, sht31_adaptive_level(&adaptive));
+    TEST_ASSERT_EQUAL_UINT32(0, sht31_adaptive_level_changes(&adaptive));
+}
+
+void test_stable_readings_step_down_one_level_at_a_time(void)
+{
+    uint32_t now_ms = 0;
+
+    config.min_level = 2;
+    config.max_level = 4;
+    sht31_adaptive_init(&adaptive, &sensor, &config);
+    adaptive.config.min_level = 4;
+    sht31_adaptive_start(&adaptive, 0);
+    adaptive.config.min_level = 2;
+
+    // Three stable two second windows per step.
+    for (now_ms = 0; now_ms < 6100; now_ms++)
+    {
+        service_at(now_ms);
+    }
+    TEST_ASSERT_EQUAL_UINT8(3, sht31_adaptive_level(&adaptive));
+    TEST_ASSERT_EQUAL_UINT64(250000000ull, device->period_ns);
+
+    for (; now_ms < 30000; now_ms++)
+    {
+        service_at(now_ms);
+    }
+    TEST_ASSERT_EQUAL_UINT8(2, sht31_adaptive_level(&adaptive));
+    TEST_ASSERT_EQUAL_UINT32(2, sht31_adaptive_level_changes(&adaptive));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Against fixed rates
+///////////////////////////////////////////////////////////////////////////////
+
+void test_fewer_transactions_than_fixed_fast_rate_for_same_latency(void)
+{
+    const uint32_t fast_latency_ms =
+        sht31_result_ready_ms(SHT_REPEATABILITY_MEDIUM,
+                              sht31_adaptive_period_ms(4));
+    run_result_t adaptive_run;
+    run_result_t fast_run;
+    run_result_t slow_run;
+
+    adaptive_run = run_ramp();
+    TEST_ASSERT_EQUAL_UINT8(0, sht31_adaptive_level(&adaptive));
+    sht31_adaptive_stop(&adaptive);
+
+    config.min_level = 4;
+    sht31_adaptive_init(&adaptive, &sensor, &config);
+    fast_run = run_ramp();
+    sht31_adaptive_stop(&adaptive);
+
+    config.min_level = 0;
+    config.max_level = 0;
+    sht31_adaptive_init(&adaptive, &sensor, &config);
+    slow_run = run_ramp();
+
+    // The adaptive run sees the alarm level as soon as 10 mps does...
+    TEST_ASSERT_UINT32_WITHIN(fast_latency_ms, ALARM_CROSSED_MS,
+                              fast_run.detected_ms);
+    TEST_ASSERT_UINT32_WITHIN(fast_latency_ms, ALARM_CROSSED_MS,
+                              adaptive_run.detected_ms);
+
+    // ...with under a third of the transactions.
+    TEST_ASSERT_LESS_THAN_UINT32(fast_run.transactions / 3,
+                                 adaptive_run.transactions);
+
+    // Sampling at the slowest rate throughout uses fewer still, but sees the
+    // alarm level more than a second late.
+    TEST_ASSERT_LESS_THAN_UINT32(adaptive_run.transactions,
+                                 slow_run.transactions);
+    TEST_ASSERT_GREATER_THAN_UINT32(ALARM_CROSSED_MS + 1000,
+                                    slow_run.detected_ms);
+}
@@ -0,0 +1,232 @@
+/**
+ * @file        test_sht31_aggregate.c
+ * @author      Steven Daglish
+ * @brief
+ * @version     0.1
+ * @date        17 October 2026
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+// Test list
+// ---------
+//
+// Summary values match a direct calculation
+// Window boundaries, gaps and timestamp wrap
+// Closing windows on time and on flush
+// Very full windows
+///////////////////////////////////////////////////////////////////////////////
+
+#include "unity.h"
+#include "sht31_aggregate.h"
+#include <math.h>
+
+#define MAX_RECORDS 16
+
+static sht31_aggregate_t aggregate;
+static sht31_aggregate_record_t records[MAX_RECORDS];
+static uint8_t record_count;
+
+static void store_record(void *context, const sht31_aggregate_record_t *record)
+{
+    (void)context;
+
+    TEST_ASSERT_LESS_THAN(MAX_RECORDS, record_count);
+    records[record_count++] = *record;
+}
+
+static void add(uint32_t timestamp_ms, uint16_t temperature, uint16_t humidity)
+{
+    sht31_reading_t reading = {
+        .timestamp_ms = timestamp_ms,
+        .temperature  = temperature,
+        .humidity     = humidity,
+    };
+
+    sht31_aggregate_add(&aggregate, &reading);
+}
+
+void setUp(void)
+{
+    record_count = 0;
+    sht31_aggregate_init(&aggregate, 60000, store_record, NULL);
+}
+
+void tearDown(void)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Summary values
+///////////////////////////////////////////////////////////////////////////////
+
+void test_nothing_is_emitted_before_a_window_closes(void)
+{
+    add(0, 100, 200);
+    add(59999, 100, 200);
+    sht31_aggregate_service(&aggregate, 59999);
+
+    TEST_ASSERT_EQUAL_UINT8(0, record_count);
+}
+
+void test_summary_of_known_values(void)
+{
+    // Temperature 2, 4, 4, 4, 5, 5, 7, 9: mean 5, variance 4.
+    const uint16_t values[8] = {2, 4, 4, 4, 5, 5, 7, 9};
+    uint8_t i                = 0;
+
+    for (i = 0; i < 8; i++)
+    {
+        add(1000 + i * 100, values[i], 50000);
+    }
+    sht31_aggregate_flush(&aggregate);
+
+    TEST_ASSERT_EQUAL_UINT8(1, record_count);
+    TEST_ASSERT_EQUAL_UINT32(1000, records[0].start_ms);
+    TEST_ASSERT_EQUAL_UINT16(8, records[0].count);
+    TEST_ASSERT_EQUAL_UINT16(2, records[0].temperature.min);
+    TEST_ASSERT_EQUAL_UINT16(9, records[0].temperature.max);
+    TEST_ASSERT_EQUAL_UINT16(5, records[0].temperature.mean);
+    TEST_ASSERT_EQUAL_UINT32(4, records[0].temperature.variance);
+    TEST_ASSERT_EQUAL_UINT16(50000, records[0].humidity.mean);
+    TEST_ASSERT_EQUAL_UINT32(0, records[0].humidity.variance);
+}
+
+void test_summary_matches_floating_point_for_a_minute_at_10hz(void)
+{
+    double sum       = 0;
+    double squares   = 0;
+    double mean      = 0;
+    uint32_t seed    = 99;
+    uint16_t minimum = UINT16_MAX;
+    uint16_t maximum = 0;
+    uint16_t i       = 0;
+
+    for (i = 0; i < 600; i++)
+    {
+        uint16_t value = 0;
+
+        seed  = seed * 1103515245u + 12345u;
+        value = 20000 + ((seed >> 16) % 4000);
+        add(i * 100, value, 0xFFFF - value);
+
+        sum += value;
+        squares += (double)value * value;
+        minimum = (value < minimum) ? value : minimum;
+        maximum = (value > maximum) ? value : maximum;
+    }
+    add(60000, 0, 0);
+
+    mean = sum / 600;
+    TEST_ASSERT_EQUAL_UINT8(1, record_count);
+    TEST_ASSERT_EQUAL_UINT16(600, records[0].count);
+    TEST_ASSERT_EQUAL_UINT16(minimum, records[0].temperature.min);
+    TEST_ASSERT_EQUAL_UINT16(maximum, records[0].temperature.max);
+    TEST_ASSERT_EQUAL_UINT16((uint16_t)lround(mean),
+                             records[0].temperature.mean);
+    TEST_ASSERT_UINT32_WITHIN(1, (uint32_t)(squares / 600 - mean * mean),
+                              records[0].temperature.variance);
+    TEST_ASSERT_EQUAL_UINT16(0xFFFF - maximum, records[0].humidity.min);
+    TEST_ASSERT_EQUAL_UINT16(0xFFFF - minimum, records[0].humidity.max);
+}
+
+void test_extreme_values_do_not_overflow(void)
+{
+    uint16_t i = 0;
+
+    for (i = 0; i < 1000; i++)
+    {
+        add(i, (i & 1) ? 0xFFFF : 0, 0xFFFF);
+    }
+    sht31_aggregate_flush(&aggregate);
+
+    TEST_ASSERT_EQUAL_UINT16(0x8000, records[0].temperature.mean);
+    TEST_ASSERT_EQUAL_UINT32(1073709056, records[0].temperature.variance);
+    TEST_ASSERT_EQUAL_UINT16(0xFFFF, records[0].humidity.mean);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Windows
+///////////////////////////////////////////////////////////////////////////////
+
+void test_windows_follow_on_from_first_reading(void)
+{
+    add(500, 10, 10);
+    add(60499, 20, 20);
+    add(60500, 30, 30);
+    add(120499, 40, 40);
+    add(120500, 50, 50);
+
+    TEST_ASSERT_EQUAL_UINT8(2, record_count);
+    TEST_ASSERT_EQUAL_UINT32(500, records[0].start_ms);
+    TEST_ASSERT_EQUAL_UINT16(2, records[0].count);
+    TEST_ASSERT_EQUAL_UINT16(15, records[0].temperature.mean);
+    TEST_ASSERT_EQUAL_UINT32(60500, records[1].start_ms);
+    TEST_ASSERT_EQUAL_UINT16(35, records[1].temperature.mean);
+}
+
+void test_empty_windows_are_skipped(void)
+{
+    add(0, 10, 10);
+    add(250000, 20, 20);
+    sht31_aggregate_flush(&aggregate);
+
+    TEST_ASSERT_EQUAL_UINT8(2, record_count);
+    TEST_ASSERT_EQUAL_UINT32(0, records[0].start_ms);
+    TEST_ASSERT_EQUAL_UINT32(240000, records[1].start_ms);
+}
+
+void test_windows_carry_on_across_timestamp_wrap(void)
+{
+    add(0xFFFFFF00u, 10, 10);
+    add(0x00000100u, 20, 20);
+    add(0xFFFFFF00u + 60000, 30, 30);
+
+    TEST_ASSERT_EQUAL_UINT8(1, record_count);
+    TEST_ASSERT_EQUAL_UINT16(2, records[0].count);
+}
+
+void test_service_closes_window_when_readings_stop(void)
+{
+    add(0, 10, 10);
+
+    sht31_aggregate_service(&aggregate, 59999);
+    TEST_ASSERT_EQUAL_UINT8(0, record_count);
+
+    sht31_aggregate_service(&aggregate, 60000);
+    TEST_ASSERT_EQUAL_UINT8(1, record_count);
+
+    // Nothing more to emit until there are readings again.
+    sht31_aggregate_service(&aggregate, 200000);
+    sht31_aggregate_flush(&aggregate);
+    TEST_ASSERT_EQUAL_UINT8(1, record_count);
+    TEST_ASSERT_EQUAL_UINT32(1, sht31_aggregate_records(&aggregate));
+}
+
+void test_service_before_any_reading_does_nothing(void)
+{
+    sht31_aggregate_service(&aggregate, 1000000);
+    sht31_aggregate_flush(&aggregate);
+
+    TEST_ASSERT_EQUAL_UINT8(0, record_count);
+}
+
+void test_full_window_is_split(void)
+{
+    uint32_t i = 0;
+
+    sht31_aggregate_init(&aggregate, 1000000, store_record, NULL);
+    for (i = 0; i < 70000; i++)
+    {
+        add(i, 0xFFFF, 0xFFFF);
+    }
+    sht31_aggregate_flush(&aggregate);
+
+    TEST_ASSERT_EQUAL_UINT8(2, record_count);
+    TEST_ASSERT_EQUAL_UINT16(SHT31_AGGREGATE_MAX_COUNT, records[0].count);
+    TEST_ASSERT_EQUAL_UINT16(0xFFFF, records[0].temperature.mean);
+    TEST_ASSERT_EQUAL_UINT32(0, records[0].temperature.variance);
+    TEST_ASSERT_EQUAL_UINT16(70000 - SHT31_AGGREGATE_MAX_COUNT,
+                             records[1].count);
+    TEST_ASSERT_EQUAL_UINT32(0, records[1].start_ms);
+}
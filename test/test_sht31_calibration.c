@@ -0,0 +1,138 @@
+/**
+ * @file        test_sht31_calibration.c
+ * @author      Steven Daglish
+ * @brief
+ * @version     0.1
+ * @date        17 October 2026
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+// Test list
+// ---------
+//
+// Tables must be in strictly ascending serial number order
+// Every entry of a large table is found, and nothing else
+// Devices missing from the table fall back to no correction
+///////////////////////////////////////////////////////////////////////////////
+
+#include "unity.h"
+#include "sht31_calibration.h"
+#include "sht31_conversion.h"
+
+#define LARGE_TABLE 500
+
+static sht31_calibration_t entries[LARGE_TABLE];
+static sht31_calibration_table_t table;
+
+static uint32_t serial_of(uint16_t index)
+{
+    // Spread out, with gaps between neighbours.
+    return 0x01000000u + (uint32_t)index * 7919u;
+}
+
+void setUp(void)
+{
+    uint16_t i = 0;
+
+    for (i = 0; i < LARGE_TABLE; i++)
+    {
+        entries[i]                    = sht31_calibration_none;
+        entries[i].serial             = serial_of(i);
+        entries[i].temperature_offset = (int16_t)i;
+    }
+}
+
+void tearDown(void)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Building a table
+///////////////////////////////////////////////////////////////////////////////
+
+void test_sorted_table_is_accepted(void)
+{
+    TEST_ASSERT_TRUE(
+        sht31_calibration_table_init(&table, entries, LARGE_TABLE));
+    TEST_ASSERT_EQUAL_UINT16(LARGE_TABLE, table.count);
+}
+
+void test_empty_table_is_accepted(void)
+{
+    TEST_ASSERT_TRUE(sht31_calibration_table_init(&table, entries, 0));
+    TEST_ASSERT_NULL(sht31_calibration_find(&table, serial_of(0)));
+}
+
+void test_out_of_order_table_is_rejected(void)
+{
+    entries[10].serial = serial_of(200);
+
+    TEST_ASSERT_FALSE(
+        sht31_calibration_table_init(&table, entries, LARGE_TABLE));
+}
+
+void test_repeated_serial_is_rejected(void)
+{
+    entries[11].serial = entries[10].serial;
+
+    TEST_ASSERT_FALSE(
+        sht31_calibration_table_init(&table, entries, LARGE_TABLE));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Lookups
+///////////////////////////////////////////////////////////////////////////////
+
+void test_every_entry_is_found(void)
+{
+    uint16_t i = 0;
+
+    sht31_calibration_table_init(&table, entries, LARGE_TABLE);
+
+    for (i = 0; i < LARGE_TABLE; i++)
+    {
+        TEST_ASSERT_EQUAL_PTR(&entries[i],
+                              sht31_calibration_find(&table, serial_of(i)));
+    }
+}
+
+void test_serials_between_entries_are_not_found(void)
+{
+    uint16_t i = 0;
+
+    sht31_calibration_table_init(&table, entries, LARGE_TABLE);
+
+    TEST_ASSERT_NULL(sht31_calibration_find(&table, 0));
+    TEST_ASSERT_NULL(sht31_calibration_find(&table, 0xFFFFFFFF));
+    for (i = 0; i < LARGE_TABLE; i++)
+    {
+        TEST_ASSERT_NULL(sht31_calibration_find(&table, serial_of(i) + 1));
+    }
+}
+
+void test_lookup_falls_back_to_no_correction(void)
+{
+    sht31_calibration_table_init(&table, entries, LARGE_TABLE);
+
+    TEST_ASSERT_EQUAL_PTR(&sht31_calibration_none,
+                          sht31_calibration_lookup(&table, 42));
+    TEST_ASSERT_EQUAL_PTR(&entries[3],
+                          sht31_calibration_lookup(&table, serial_of(3)));
+}
+
+void test_looked_up_entry_corrects_conversion(void)
+{
+    const sht31_calibration_t *calibration = NULL;
+
+    sht31_calibration_table_init(&table, entries, LARGE_TABLE);
+    calibration = sht31_calibration_lookup(&table, serial_of(25));
+
+    // 0x6666 is 25.00 C, plus this entry's offset of 0.25 C.
+    TEST_ASSERT_EQUAL_INT16(
+        2525, sht31_temperature_to_calibrated_centi_celsius(0x6666,
+                                                            calibration));
+    TEST_ASSERT_EQUAL_INT16(
+        2500, sht31_temperature_to_calibrated_centi_celsius(
+                  0x6666, sht31_calibration_lookup(&table, 1)));
+}
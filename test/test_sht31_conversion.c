@@ -0,0 +1,276 @@
+/**
+ * @file        test_sht31_conversion.c
+ * @author      Steven Daglish
+ * @brief
+ * @version     0.1
+ * @date        17 October 2026
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+// Test list
+// ---------
+//
+// End points of each range
+// Every raw value matches the datasheet formula
+// Batch conversions match single conversions
+// Calibrated conversions apply gain and offset, rounded and limited
+///////////////////////////////////////////////////////////////////////////////
+
+#include "unity.h"
+#include "sht31_conversion.h"
+#include <math.h>
+
+static long datasheet_centi_celsius(uint16_t raw)
+{
+    return lround(100.0 * (-45.0 + 175.0 * raw / 65535.0));
+}
+
+static long datasheet_centi_fahrenheit(uint16_t raw)
+{
+    return lround(100.0 * (-49.0 + 315.0 * raw / 65535.0));
+}
+
+static long datasheet_centi_percent(uint16_t raw)
+{
+    return lround(100.0 * (100.0 * raw / 65535.0));
+}
+
+static const sht31_calibration_t unity = {
+    .serial             = 1,
+    .temperature_gain   = SHT31_CALIBRATION_UNITY_GAIN,
+    .temperature_offset = 0,
+    .humidity_gain      = SHT31_CALIBRATION_UNITY_GAIN,
+    .humidity_offset    = 0,
+};
+
+void setUp(void)
+{
+}
+
+void tearDown(void)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// End points
+///////////////////////////////////////////////////////////////////////////////
+
+void test_celsius_end_points(void)
+{
+    TEST_ASSERT_EQUAL_INT16(-4500, sht31_temperature_to_centi_celsius(0));
+    TEST_ASSERT_EQUAL_INT16(13000, sht31_temperature_to_centi_celsius(0xFFFF));
+}
+
+void test_fahrenheit_end_points(void)
+{
+    TEST_ASSERT_EQUAL_INT16(-4900, sht31_temperature_to_centi_fahrenheit(0));
+    TEST_ASSERT_EQUAL_INT16(26600,
+                            sht31_temperature_to_centi_fahrenheit(0xFFFF));
+}
+
+void test_humidity_end_points(void)
+{
+    TEST_ASSERT_EQUAL_UINT16(0, sht31_humidity_to_centi_percent(0));
+    TEST_ASSERT_EQUAL_UINT16(10000, sht31_humidity_to_centi_percent(0xFFFF));
+}
+
+void test_room_temperature_reading(void)
+{
+    // 0x6666 is 25.00 C / 77.00 F
+    TEST_ASSERT_EQUAL_INT16(2500, sht31_temperature_to_centi_celsius(0x6666));
+    TEST_ASSERT_EQUAL_INT16(7700,
+                            sht31_temperature_to_centi_fahrenheit(0x6666));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Full range against the datasheet formulas
+///////////////////////////////////////////////////////////////////////////////
+
+void test_celsius_matches_datasheet_for_every_raw_value(void)
+{
+    uint32_t raw = 0;
+
+    for (raw = 0; raw <= 0xFFFF; raw++)
+    {
+        TEST_ASSERT_EQUAL_INT32(datasheet_centi_celsius(raw),
+                                sht31_temperature_to_centi_celsius(raw));
+    }
+}
+
+void test_fahrenheit_matches_datasheet_for_every_raw_value(void)
+{
+    uint32_t raw = 0;
+
+    for (raw = 0; raw <= 0xFFFF; raw++)
+    {
+        TEST_ASSERT_EQUAL_INT32(datasheet_centi_fahrenheit(raw),
+                                sht31_temperature_to_centi_fahrenheit(raw));
+    }
+}
+
+void test_humidity_matches_datasheet_for_every_raw_value(void)
+{
+    uint32_t raw = 0;
+
+    for (raw = 0; raw <= 0xFFFF; raw++)
+    {
+        TEST_ASSERT_EQUAL_INT32(datasheet_centi_percent(raw),
+                                sht31_humidity_to_centi_percent(raw));
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Batches
+///////////////////////////////////////////////////////////////////////////////
+
+void test_batch_conversions_match_single_conversions(void)
+{
+    uint16_t raw[64];
+    int16_t celsius[64];
+    int16_t fahrenheit[64];
+    uint16_t humidity[64];
+    uint16_t i = 0;
+
+    for (i = 0; i < 64; i++)
+    {
+        raw[i] = i * 1021;
+    }
+
+    sht31_temperatures_to_centi_celsius(raw, celsius, 64);
+    sht31_temperatures_to_centi_fahrenheit(raw, fahrenheit, 64);
+    sht31_humidities_to_centi_percent(raw, humidity, 64);
+
+    for (i = 0; i < 64; i++)
+    {
+        TEST_ASSERT_EQUAL_INT16(sht31_temperature_to_centi_celsius(raw[i]),
+                                celsius[i]);
+        TEST_ASSERT_EQUAL_INT16(sht31_temperature_to_centi_fahrenheit(raw[i]),
+                                fahrenheit[i]);
+        TEST_ASSERT_EQUAL_UINT16(sht31_humidity_to_centi_percent(raw[i]),
+                                 humidity[i]);
+    }
+}
+
+void test_batch_of_zero_writes_nothing(void)
+{
+    uint16_t raw    = 0x1234;
+    int16_t celsius = 0x55;
+
+    sht31_temperatures_to_centi_celsius(&raw, &celsius, 0);
+    TEST_ASSERT_EQUAL_INT16(0x55, celsius);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Calibrated conversions
+///////////////////////////////////////////////////////////////////////////////
+
+void test_unity_calibration_matches_plain_conversion(void)
+{
+    uint32_t raw = 0;
+
+    for (raw = 0; raw <= 0xFFFF; raw++)
+    {
+        TEST_ASSERT_EQUAL_INT16(
+            sht31_temperature_to_centi_celsius(raw),
+            sht31_temperature_to_calibrated_centi_celsius(raw, &unity));
+        TEST_ASSERT_EQUAL_UINT16(
+            sht31_humidity_to_centi_percent(raw),
+            sht31_humidity_to_calibrated_centi_percent(raw, &unity));
+    }
+}
+
+void test_offsets_are_added(void)
+{
+    sht31_calibration_t calibration = unity;
+
+    calibration.temperature_offset = -35;
+    calibration.humidity_offset    = 120;
+
+    // 0x6666 is 25.00 C, 0x8000 is 50.00 %RH
+    TEST_ASSERT_EQUAL_INT16(
+        2465, sht31_temperature_to_calibrated_centi_celsius(0x6666,
+                                                            &calibration));
+    TEST_ASSERT_EQUAL_UINT16(
+        5120, sht31_humidity_to_calibrated_centi_percent(0x8000,
+                                                         &calibration));
+}
+
+void test_gain_scales_and_rounds(void)
+{
+    sht31_calibration_t calibration = unity;
+
+    // 1.02 and 0.99
+    calibration.temperature_gain = 33423;
+    calibration.humidity_gain    = 32440;
+
+    // 2500 * 1.02 = 2550 and -4500 * 1.02 = -4590, both to within a step.
+    TEST_ASSERT_EQUAL_INT16(
+        2550, sht31_temperature_to_calibrated_centi_celsius(0x6666,
+                                                            &calibration));
+    TEST_ASSERT_EQUAL_INT16(
+        -4590, sht31_temperature_to_calibrated_centi_celsius(0, &calibration));
+    TEST_ASSERT_EQUAL_UINT16(
+        4950, sht31_humidity_to_calibrated_centi_percent(0x8000,
+                                                         &calibration));
+}
+
+void test_calibrated_humidity_is_limited_to_range(void)
+{
+    sht31_calibration_t calibration = unity;
+
+    calibration.humidity_offset = 300;
+    TEST_ASSERT_EQUAL_UINT16(
+        10000, sht31_humidity_to_calibrated_centi_percent(0xFFFF,
+                                                          &calibration));
+
+    calibration.humidity_offset = -300;
+    TEST_ASSERT_EQUAL_UINT16(
+        0, sht31_humidity_to_calibrated_centi_percent(0, &calibration));
+}
+
+void test_calibrated_temperature_saturates(void)
+{
+    sht31_calibration_t calibration = unity;
+
+    calibration.temperature_gain   = 0xFFFF;
+    calibration.temperature_offset = 32767;
+
+    TEST_ASSERT_EQUAL_INT16(
+        INT16_MAX, sht31_temperature_to_calibrated_centi_celsius(0xFFFF,
+                                                                 &calibration));
+}
+
+void test_calibrated_batches_match_single_conversions(void)
+{
+    sht31_calibration_t calibration = unity;
+    uint16_t raw[64];
+    int16_t celsius[64];
+    uint16_t humidity[64];
+    uint16_t i = 0;
+
+    calibration.temperature_gain   = 32000;
+    calibration.temperature_offset = 17;
+    calibration.humidity_gain      = 33000;
+    calibration.humidity_offset    = -40;
+
+    for (i = 0; i < 64; i++)
+    {
+        raw[i] = i * 1021;
+    }
+
+    sht31_temperatures_to_calibrated_centi_celsius(raw, celsius, 64,
+                                                   &calibration);
+    sht31_humidities_to_calibrated_centi_percent(raw, humidity, 64,
+                                                 &calibration);
+
+    for (i = 0; i < 64; i++)
+    {
+        TEST_ASSERT_EQUAL_INT16(sht31_temperature_to_calibrated_centi_celsius(
+                                    raw[i], &calibration),
+                                celsius[i]);
+        TEST_ASSERT_EQUAL_UINT16(sht31_humidity_to_calibrated_centi_percent(
+                                     raw[i], &calibration),
+                                 humidity[i]);
+    }
+}
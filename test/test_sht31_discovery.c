@@ -0,0 +1,364 @@
+/**
+ * @file        test_sht31_discovery.c
+ * @author      Steven Daglish
+ * @brief
+ * @version     0.1
+ * @date        17 October 2026
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+// Test list
+// ---------
+//
+// A cold start scans every bus and reads each sensor's serial number
+// Devices whose status register fails its CRC are not taken as sensors
+// A saved table loads on a warm start without any bus traffic
+// Damaged or mismatched tables fall back to a scan
+// Only a sensor that keeps failing triggers a rescan, of its own bus
+// A rescan keeps the slots and handles of sensors that still answer
+///////////////////////////////////////////////////////////////////////////////
+
+#include "unity.h"
+#include "sht31_discovery.h"
+#include "sht31_driver.h"
+#include "i2c_sim.h"
+#include "i2c_driver_sim.h"
+#include "crc8.h"
+#include "i2c_bus.h"
+
+#define BUSES 2
+
+static i2c_sim_t sims[BUSES];
+static i2c_bus_t buses[BUSES];
+static const i2c_bus_t *bus_list[BUSES] = {&buses[0], &buses[1]};
+static i2c_sim_device_t *bus0_default;
+static i2c_sim_device_t *bus1_alternate;
+static sht31_discovery_t discovery;
+static uint8_t stored[SHT31_TOPOLOGY_SIZE(SHT31_DISCOVERY_MAX_SENSORS)];
+
+static uint32_t total_starts(void)
+{
+    return sims[0].starts + sims[1].starts;
+}
+
+static void reset_counters(void)
+{
+    i2c_sim_reset_counters(&sims[0]);
+    i2c_sim_reset_counters(&sims[1]);
+}
+
+static uint16_t cold_start_and_save(void)
+{
+    sht31_discovery_boot(&discovery, NULL, 0);
+    return sht31_discovery_save(&discovery, stored, sizeof(stored));
+}
+
+void setUp(void)
+{
+    i2c_sim_init(&sims[0], I2C_SIM_400KHZ, &buses[0]);
+    i2c_sim_init(&sims[1], I2C_SIM_400KHZ, &buses[1]);
+    bus0_default   = i2c_sim_add_sht31(&sims[0], DEFAULT_ADDRESS);
+    bus1_alternate = i2c_sim_add_sht31(&sims[1], SHT_ALTERNATE_ADDRESS);
+    bus0_default->serial_number   = 0x11112222;
+    bus1_alternate->serial_number = 0x33334444;
+
+    TEST_ASSERT_TRUE(sht31_discovery_init(&discovery, bus_list, BUSES));
+}
+
+void tearDown(void)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Scanning
+///////////////////////////////////////////////////////////////////////////////
+
+void test_init_rejects_bad_bus_count(void)
+{
+    TEST_ASSERT_FALSE(sht31_discovery_init(&discovery, bus_list, 0));
+    TEST_ASSERT_FALSE(sht31_discovery_init(&discovery, bus_list,
+                                           SHT31_DISCOVERY_MAX_BUSES + 1));
+}
+
+void test_cold_start_finds_sensors_on_each_bus(void)
+{
+    TEST_ASSERT_EQUAL_UINT8(2, sht31_discovery_boot(&discovery, NULL, 0));
+
+    TEST_ASSERT_EQUAL_UINT8(0, discovery.entries[0].bus);
+    TEST_ASSERT_EQUAL_HEX8(DEFAULT_ADDRESS, discovery.entries[0].address);
+    TEST_ASSERT_EQUAL_HEX32(0x11112222, discovery.entries[0].serial);
+    TEST_ASSERT_EQUAL_UINT8(1, discovery.entries[1].bus);
+    TEST_ASSERT_EQUAL_HEX8(SHT_ALTERNATE_ADDRESS, discovery.entries[1].address);
+    TEST_ASSERT_EQUAL_HEX32(0x33334444, discovery.entries[1].serial);
+    TEST_ASSERT_TRUE(discovery.changed);
+    TEST_ASSERT_EQUAL_UINT16(2, discovery.scans);
+}
+
+void test_sensor_handles_are_ready_to_use(void)
+{
+    sht31_discovery_boot(&discovery, NULL, 0);
+
+    TEST_ASSERT_TRUE(sht31_get_single_shot_data(
+        sht31_discovery_sensor(&discovery, 1)));
+    TEST_ASSERT_EQUAL_UINT32(1, bus1_alternate->measurements);
+    TEST_ASSERT_NULL(sht31_discovery_sensor(&discovery, 2));
+}
+
+void test_both_addresses_on_one_bus_are_found_in_order(void)
+{
+    i2c_sim_add_sht31(&sims[1], DEFAULT_ADDRESS);
+
+    TEST_ASSERT_EQUAL_UINT8(3, sht31_discovery_scan(&discovery));
+    TEST_ASSERT_EQUAL_HEX8(DEFAULT_ADDRESS, discovery.entries[1].address);
+    TEST_ASSERT_EQUAL_HEX8(SHT_ALTERNATE_ADDRESS, discovery.entries[2].address);
+    TEST_ASSERT_EQUAL_UINT8(1, discovery.entries[2].bus);
+}
+
+void test_status_crc_failure_is_not_a_sensor(void)
+{
+    bus1_alternate->corrupt_crc = 1;
+
+    TEST_ASSERT_EQUAL_UINT8(1, sht31_discovery_scan(&discovery));
+    TEST_ASSERT_EQUAL_UINT8(0, discovery.entries[0].bus);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Stored table
+///////////////////////////////////////////////////////////////////////////////
+
+void test_save_writes_table_and_clears_changed(void)
+{
+    TEST_ASSERT_EQUAL_UINT16(SHT31_TOPOLOGY_SIZE(2), cold_start_and_save());
+
+    TEST_ASSERT_EQUAL_HEX8(SHT31_TOPOLOGY_MAGIC, stored[0]);
+    TEST_ASSERT_EQUAL_UINT8(BUSES, stored[2]);
+    TEST_ASSERT_EQUAL_UINT8(2, stored[3]);
+    TEST_ASSERT_EQUAL_HEX8(0x22, stored[6]);
+    TEST_ASSERT_EQUAL_HEX8(0x11, stored[9]);
+    TEST_ASSERT_FALSE(discovery.changed);
+}
+
+void test_save_into_small_buffer_fails(void)
+{
+    sht31_discovery_boot(&discovery, NULL, 0);
+
+    TEST_ASSERT_EQUAL_UINT16(0, sht31_discovery_save(&discovery, stored,
+                                                     SHT31_TOPOLOGY_SIZE(1)));
+    TEST_ASSERT_TRUE(discovery.changed);
+}
+
+void test_warm_start_loads_table_without_bus_traffic(void)
+{
+    uint16_t length = cold_start_and_save();
+
+    sht31_discovery_init(&discovery, bus_list, BUSES);
+    reset_counters();
+
+    TEST_ASSERT_EQUAL_UINT8(2, sht31_discovery_boot(&discovery, stored,
+                                                    length));
+    TEST_ASSERT_EQUAL_UINT32(0, total_starts());
+    TEST_ASSERT_EQUAL_UINT16(0, discovery.scans);
+    TEST_ASSERT_FALSE(discovery.changed);
+    TEST_ASSERT_EQUAL_HEX32(0x33334444, discovery.entries[1].serial);
+
+    TEST_ASSERT_TRUE(sht31_get_single_shot_data(
+        sht31_discovery_sensor(&discovery, 0)));
+    TEST_ASSERT_EQUAL_UINT32(1, bus0_default->measurements);
+}
+
+void test_damaged_table_falls_back_to_scan(void)
+{
+    uint16_t length = cold_start_and_save();
+
+    stored[5] ^= 0x01;
+    sht31_discovery_init(&discovery, bus_list, BUSES);
+
+    TEST_ASSERT_EQUAL_UINT8(2, sht31_discovery_boot(&discovery, stored,
+                                                    length));
+    TEST_ASSERT_EQUAL_UINT16(BUSES, discovery.scans);
+    TEST_ASSERT_EQUAL_HEX8(DEFAULT_ADDRESS, discovery.entries[0].address);
+}
+
+void test_truncated_table_falls_back_to_scan(void)
+{
+    uint16_t length = cold_start_and_save();
+
+    sht31_discovery_init(&discovery, bus_list, BUSES);
+    sht31_discovery_boot(&discovery, stored, length - 1);
+
+    TEST_ASSERT_EQUAL_UINT16(BUSES, discovery.scans);
+}
+
+void test_table_for_other_bus_count_falls_back_to_scan(void)
+{
+    uint16_t length = cold_start_and_save();
+
+    sht31_discovery_init(&discovery, bus_list, 1);
+
+    TEST_ASSERT_EQUAL_UINT8(1, sht31_discovery_boot(&discovery, stored,
+                                                    length));
+    TEST_ASSERT_EQUAL_UINT16(1, discovery.scans);
+}
+
+void test_empty_table_is_not_trusted(void)
+{
+    sht31_discovery_t empty;
+    uint16_t length = 0;
+
+    sht31_discovery_init(&empty, bus_list, BUSES);
+    length = sht31_discovery_save(&empty, stored, sizeof(stored));
+
+    TEST_ASSERT_EQUAL_UINT8(2, sht31_discovery_boot(&discovery, stored,
+                                                    length));
+    TEST_ASSERT_EQUAL_UINT16(BUSES, discovery.scans);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Rescanning
+///////////////////////////////////////////////////////////////////////////////
+
+void test_successes_never_rescan(void)
+{
+    uint8_t i = 0;
+
+    sht31_discovery_boot(&discovery, NULL, 0);
+    for (i = 0; i < 10; i++)
+    {
+        TEST_ASSERT_FALSE(sht31_discovery_report(&discovery, 0, true));
+    }
+    TEST_ASSERT_EQUAL_UINT16(BUSES, discovery.scans);
+}
+
+void test_a_success_resets_the_misses(void)
+{
+    sht31_discovery_boot(&discovery, NULL, 0);
+
+    sht31_discovery_report(&discovery, 0, false);
+    sht31_discovery_report(&discovery, 0, false);
+    sht31_discovery_report(&discovery, 0, true);
+    TEST_ASSERT_FALSE(sht31_discovery_report(&discovery, 0, false));
+    TEST_ASSERT_EQUAL_UINT16(BUSES, discovery.scans);
+}
+
+void test_missing_sensor_rescans_only_its_bus(void)
+{
+    sht31_discovery_boot(&discovery, NULL, 0);
+    sht31_discovery_save(&discovery, stored, sizeof(stored));
+    reset_counters();
+
+    bus1_alternate->nack_address = 0xFFFF;
+    sht31_discovery_report(&discovery, 1, false);
+    sht31_discovery_report(&discovery, 1, false);
+    TEST_ASSERT_TRUE(sht31_discovery_report(&discovery, 1, false));
+
+    TEST_ASSERT_EQUAL_UINT32(0, sims[0].starts);
+    TEST_ASSERT_EQUAL_UINT16(BUSES + 1, discovery.scans);
+    TEST_ASSERT_EQUAL_UINT8(1, sht31_discovery_count(&discovery));
+    TEST_ASSERT_TRUE(discovery.changed);
+}
+
+void test_rescan_finding_same_sensor_is_unchanged(void)
+{
+    sht31_discovery_boot(&discovery, NULL, 0);
+    sht31_discovery_save(&discovery, stored, sizeof(stored));
+
+    sht31_discovery_report(&discovery, 0, false);
+    sht31_discovery_report(&discovery, 0, false);
+    TEST_ASSERT_TRUE(sht31_discovery_report(&discovery, 0, false));
+
+    TEST_ASSERT_EQUAL_UINT8(2, sht31_discovery_count(&discovery));
+    TEST_ASSERT_FALSE(discovery.changed);
+}
+
+void test_rescan_notices_replaced_sensor(void)
+{
+    sht31_discovery_boot(&discovery, NULL, 0);
+    sht31_discovery_save(&discovery, stored, sizeof(stored));
+
+    bus0_default->serial_number = 0x55556666;
+    sht31_discovery_report(&discovery, 0, false);
+    sht31_discovery_report(&discovery, 0, false);
+    sht31_discovery_report(&discovery, 0, false);
+
+    TEST_ASSERT_TRUE(discovery.changed);
+    TEST_ASSERT_EQUAL_HEX32(0x55556666, discovery.entries[0].serial);
+}
+
+void test_missing_sensor_leaves_its_slot_empty(void)
+{
+    i2c_sim_add_sht31(&sims[0], SHT_ALTERNATE_ADDRESS);
+    sht31_discovery_boot(&discovery, NULL, 0);
+    sht31_discovery_save(&discovery, stored, sizeof(stored));
+
+    bus0_default->nack_address = 0xFFFF;
+    sht31_discovery_report(&discovery, 0, false);
+    sht31_discovery_report(&discovery, 0, false);
+    sht31_discovery_report(&discovery, 0, false);
+
+    TEST_ASSERT_EQUAL_UINT8(3, sht31_discovery_count(&discovery));
+    TEST_ASSERT_NULL(sht31_discovery_sensor(&discovery, 0));
+    TEST_ASSERT_FALSE(sht31_discovery_report(&discovery, 0, false));
+    TEST_ASSERT_EQUAL_UINT8(0, discovery.entries[1].bus);
+    TEST_ASSERT_EQUAL_HEX8(SHT_ALTERNATE_ADDRESS, discovery.entries[1].address);
+    TEST_ASSERT_EQUAL_UINT8(1, discovery.entries[2].bus);
+    TEST_ASSERT_EQUAL_HEX32(0x33334444, discovery.entries[2].serial);
+    TEST_ASSERT_EQUAL_UINT16(SHT31_TOPOLOGY_SIZE(2),
+                             sht31_discovery_save(&discovery, stored,
+                                                  sizeof(stored)));
+}
+
+void test_new_sensor_takes_the_empty_slot(void)
+{
+    i2c_sim_add_sht31(&sims[0], SHT_ALTERNATE_ADDRESS);
+    sht31_discovery_boot(&discovery, NULL, 0);
+    bus0_default->nack_address = 0xFFFF;
+    sht31_discovery_scan(&discovery);
+
+    i2c_sim_add_sht31(&sims[1], DEFAULT_ADDRESS);
+    sht31_discovery_scan(&discovery);
+
+    TEST_ASSERT_EQUAL_UINT8(3, sht31_discovery_count(&discovery));
+    TEST_ASSERT_EQUAL_UINT8(1, discovery.entries[0].bus);
+    TEST_ASSERT_EQUAL_HEX8(DEFAULT_ADDRESS, discovery.entries[0].address);
+    TEST_ASSERT_NOT_NULL(sht31_discovery_sensor(&discovery, 0));
+}
+
+void test_rescan_keeps_handles_on_a_shared_bus(void)
+{
+    i2c_sim_device_t *bus0_alternate =
+        i2c_sim_add_sht31(&sims[0], SHT_ALTERNATE_ADDRESS);
+    sht31_t *converting = NULL;
+    sht31_t *other      = NULL;
+
+    bus0_alternate->serial_number = 0x77778888;
+    sht31_discovery_boot(&discovery, NULL, 0);
+    sht31_discovery_save(&discovery, stored, sizeof(stored));
+    converting = sht31_discovery_sensor(&discovery, 0);
+    other      = sht31_discovery_sensor(&discovery, 1);
+
+    // The sensor in slot 0 nacks everything while it converts.
+    TEST_ASSERT_TRUE(sht31_begin_measurement(converting, 2,
+                                             i2c_sim_time_ms(&sims[0])));
+    sht31_discovery_report(&discovery, 1, false);
+    sht31_discovery_report(&discovery, 1, false);
+    TEST_ASSERT_TRUE(sht31_discovery_report(&discovery, 1, false));
+
+    TEST_ASSERT_EQUAL_UINT8(3, sht31_discovery_count(&discovery));
+    TEST_ASSERT_EQUAL_PTR(converting, sht31_discovery_sensor(&discovery, 0));
+    TEST_ASSERT_EQUAL_PTR(other, sht31_discovery_sensor(&discovery, 1));
+    TEST_ASSERT_EQUAL_UINT8(0, discovery.misses[1]);
+    TEST_ASSERT_FALSE(discovery.changed);
+
+    i2c_sim_advance_ms(&sims[0], SHT_DURATION_HIGH_MS + 1);
+    TEST_ASSERT_EQUAL(SHT31_POLL_DONE,
+                      sht31_poll(converting, i2c_sim_time_ms(&sims[0])));
+    TEST_ASSERT_EQUAL_UINT32(1, bus0_default->measurements);
+}
+
+void test_report_out_of_range_is_ignored(void)
+{
+    sht31_discovery_boot(&discovery, NULL, 0);
+
+    TEST_ASSERT_FALSE(sht31_discovery_report(&discovery, 5, false));
+}
@@ -17,23 +17,60 @@
 // Parameter changes
 ///////////////////////////////////////////////////////////////////////////////
 
-// TODO:    Add more stop conditions when things fail to make sure clock isn't
-// left hanging (something that I think will be a further problem going
-// further).
-
 #include "unity.h"
 #include "sht31_driver.h"
+#include "crc8.h"
+#include "i2c_bus.h"
 #include "mock_i2c_driver.h"
 
 static const uint8_t periodic_mode_msb[5]    = {0x20, 0x21, 0x22, 0x23, 0x27};
-static const uint8_t periodic_mode_lsb[5][3] = {{0x32, 0x24, 0x2F},
-                                                {0x30, 0x26, 0x2D},
-                                                {0x36, 0x20, 0x2B},
-                                                {0x34, 0x22, 0x29},
-                                                {0x37, 0x21, 0x2A}};
-
-static void expect_start_and_send_address_write(bool address_ack, bool msb_ack,
-                                                bool lsb_ack,
+static const uint8_t periodic_mode_lsb[5][3] = {{0x2F, 0x24, 0x32},
+                                                {0x2D, 0x26, 0x30},
+                                                {0x2B, 0x20, 0x36},
+                                                {0x29, 0x22, 0x34},
+                                                {0x2A, 0x21, 0x37}};
+
+static sht31_t default_test_sensor;
+
+// CMock keeps a pointer to the expected bytes rather than a copy, so they
+// are kept here until the test is over.
+#define EXPECTED_WRITES 16
+static uint8_t expected_writes[EXPECTED_WRITES][5];
+static uint8_t expected_write_count;
+
+static void expect_write_block(const uint8_t *data, uint8_t length, bool ack)
+{
+    uint8_t *expected = expected_writes[expected_write_count++];
+    uint8_t i         = 0;
+
+    for (i = 0; i < length; i++)
+    {
+        expected[i] = data[i];
+    }
+    i2c_driver_write_block_ExpectWithArrayAndReturn(expected, length, length,
+                                                    ack);
+}
+
+static void expect_command_bytes(uint8_t msb, uint8_t lsb, bool ack)
+{
+    const uint8_t command[2] = {msb, lsb};
+
+    expect_write_block(command, sizeof(command), ack);
+}
+
+static void expect_start_and_write_word(uint16_t command, uint16_t word,
+                                        bool ack)
+{
+    const uint8_t frame[5] = {command >> 8, command & 0x00FF, word >> 8,
+                              word & 0x00FF, crc8_word(word)};
+
+    i2c_driver_start_Expect();
+    i2c_driver_send_address_write_ExpectAndReturn(DEFAULT_ADDRESS, true);
+    expect_write_block(frame, sizeof(frame), ack);
+}
+
+static void expect_start_and_send_address_write(bool address_ack,
+                                                bool command_ack,
                                                 uint16_t reg_address)
 {
     i2c_driver_start_Expect();
@@ -42,12 +79,7 @@ static void expect_start_and_send_address_write(bool address_ack, bool msb_ack,
     {
         return;
     }
-    i2c_driver_send_data_ExpectAndReturn(reg_address >> 8, msb_ack);
-    if (false == msb_ack)
-    {
-        return;
-    }
-    i2c_driver_send_data_ExpectAndReturn(reg_address & 0x00FF, lsb_ack);
+    expect_command_bytes(reg_address >> 8, reg_address & 0x00FF, command_ack);
 }
 
 static void expect_start_and_send_address_read(bool address_ack)
@@ -56,19 +88,19 @@ static void expect_start_and_send_address_read(bool address_ack)
     i2c_driver_send_address_read_ExpectAndReturn(DEFAULT_ADDRESS, address_ack);
 }
 
-static void expect_read_three_data_values(bool ack1, bool ack2, bool ack3,
-                                          uint8_t data1, uint8_t data2,
-                                          uint8_t data3)
+static void expect_read_block(const uint8_t *data, uint8_t length)
 {
-    i2c_driver_read_data_ExpectAndReturn(ack1, data1);
-    i2c_driver_read_data_ExpectAndReturn(ack2, data2);
-    i2c_driver_read_data_ExpectAndReturn(ack3, data3);
+    i2c_driver_read_block_ExpectAndReturn(NULL, length, true);
+    i2c_driver_read_block_IgnoreArg_data();
+    i2c_driver_read_block_ReturnArrayThruPtr_data((uint8_t *)data, length);
 }
 
 void setUp(void)
 {
+    expected_write_count = 0;
     i2c_driver_create_Expect();
     sht30_driver_create();
+    sht31_init(&default_test_sensor, &i2c_driver_bus, DEFAULT_ADDRESS);
 }
 
 // TODO: Check if I need to add something about turning off module
@@ -84,8 +116,7 @@ void test_soft_reset_successful(void)
 {
     i2c_driver_start_Expect();
     i2c_driver_send_address_write_ExpectAndReturn(DEFAULT_ADDRESS, true);
-    i2c_driver_send_data_ExpectAndReturn(SOFT_RESET_MSB, true);
-    i2c_driver_send_data_ExpectAndReturn(SOFT_RESET_LSB, true);
+    expect_command_bytes(SOFT_RESET_MSB, SOFT_RESET_LSB, true);
     i2c_driver_stop_Expect();
 
     sht30_driver_send_soft_reset();
@@ -95,8 +126,7 @@ void test_soft_reset_successful_will_return_true(void)
 {
     i2c_driver_start_Expect();
     i2c_driver_send_address_write_ExpectAndReturn(DEFAULT_ADDRESS, true);
-    i2c_driver_send_data_ExpectAndReturn(SOFT_RESET_MSB, true);
-    i2c_driver_send_data_ExpectAndReturn(SOFT_RESET_LSB, true);
+    expect_command_bytes(SOFT_RESET_MSB, SOFT_RESET_LSB, true);
     i2c_driver_stop_Expect();
 
     bool success = sht30_driver_send_soft_reset();
@@ -107,6 +137,7 @@ void test_soft_reset_send_address_fail_function_stops(void)
 {
     i2c_driver_start_Expect();
     i2c_driver_send_address_write_ExpectAndReturn(DEFAULT_ADDRESS, false);
+    i2c_driver_stop_Expect();
 
     sht30_driver_send_soft_reset();
 }
@@ -115,26 +146,18 @@ void test_soft_reset_send_address_fail_function_stops_returns_false(void)
 {
     i2c_driver_start_Expect();
     i2c_driver_send_address_write_ExpectAndReturn(DEFAULT_ADDRESS, false);
+    i2c_driver_stop_Expect();
 
     bool success = sht30_driver_send_soft_reset();
     TEST_ASSERT_FALSE(success);
 }
 
-void test_soft_reset_no_ack_after_msb_function_returns(void)
-{
-    i2c_driver_start_Expect();
-    i2c_driver_send_address_write_ExpectAndReturn(DEFAULT_ADDRESS, true);
-    i2c_driver_send_data_ExpectAndReturn(SOFT_RESET_MSB, false);
-
-    sht30_driver_send_soft_reset();
-}
-
-void test_soft_reset_no_ack_after_lsb_function_returns(void)
+void test_soft_reset_no_ack_on_command_function_returns(void)
 {
     i2c_driver_start_Expect();
     i2c_driver_send_address_write_ExpectAndReturn(DEFAULT_ADDRESS, true);
-    i2c_driver_send_data_ExpectAndReturn(SOFT_RESET_MSB, true);
-    i2c_driver_send_data_ExpectAndReturn(SOFT_RESET_LSB, false);
+    expect_command_bytes(SOFT_RESET_MSB, SOFT_RESET_LSB, false);
+    i2c_driver_stop_Expect();
 
     sht30_driver_send_soft_reset();
 }
@@ -147,8 +170,7 @@ void test_set_periodic_measurement_mode_all_ok(void)
 {
     i2c_driver_start_Expect();
     i2c_driver_send_address_write_ExpectAndReturn(DEFAULT_ADDRESS, true);
-    i2c_driver_send_data_ExpectAndReturn(periodic_mode_msb[0], true);
-    i2c_driver_send_data_ExpectAndReturn(periodic_mode_lsb[0][0], true);
+    expect_command_bytes(periodic_mode_msb[0], periodic_mode_lsb[0][0], true);
     i2c_driver_stop_Expect();
 
     bool success = sht30_driver_send_periodic_data_aquisition_mode(0, 0);
@@ -159,33 +181,18 @@ void test_set_periodic_measurement_mode_no_ack_after_address(void)
 {
     i2c_driver_start_Expect();
     i2c_driver_send_address_write_ExpectAndReturn(DEFAULT_ADDRESS, false);
-    // i2c_driver_send_data_ExpectAndReturn(periodic_mode_msb[0], true);
-    // i2c_driver_send_data_ExpectAndReturn(periodic_mode_lsb[0][0], true);
-    // i2c_driver_stop_Expect();
-
-    bool success = sht30_driver_send_periodic_data_aquisition_mode(0, 0);
-    TEST_ASSERT_FALSE(success);
-}
-
-void test_set_periodic_measurement_mode_no_ack_after_msb(void)
-{
-    i2c_driver_start_Expect();
-    i2c_driver_send_address_write_ExpectAndReturn(DEFAULT_ADDRESS, true);
-    i2c_driver_send_data_ExpectAndReturn(periodic_mode_msb[0], false);
-    // i2c_driver_send_data_ExpectAndReturn(periodic_mode_lsb[0][0], true);
-    // i2c_driver_stop_Expect();
+    i2c_driver_stop_Expect();
 
     bool success = sht30_driver_send_periodic_data_aquisition_mode(0, 0);
     TEST_ASSERT_FALSE(success);
 }
 
-void test_set_periodic_measurement_mode_no_ack_after_lsb(void)
+void test_set_periodic_measurement_mode_no_ack_on_command(void)
 {
     i2c_driver_start_Expect();
     i2c_driver_send_address_write_ExpectAndReturn(DEFAULT_ADDRESS, true);
-    i2c_driver_send_data_ExpectAndReturn(periodic_mode_msb[0], true);
-    i2c_driver_send_data_ExpectAndReturn(periodic_mode_lsb[0][0], false);
-    // i2c_driver_stop_Expect();
+    expect_command_bytes(periodic_mode_msb[0], periodic_mode_lsb[0][0], false);
+    i2c_driver_stop_Expect();
 
     bool success = sht30_driver_send_periodic_data_aquisition_mode(0, 0);
     TEST_ASSERT_FALSE(success);
@@ -200,19 +207,13 @@ void test_fetch_periodic_data_all_ok(void)
 {
     i2c_driver_start_Expect();
     i2c_driver_send_address_write_ExpectAndReturn(DEFAULT_ADDRESS, true);
-    i2c_driver_send_data_ExpectAndReturn(FETCH_DATA_MSB, true);
-    i2c_driver_send_data_ExpectAndReturn(FETCH_DATA_LSB, true);
+    expect_command_bytes(FETCH_DATA_MSB, FETCH_DATA_LSB, true);
 
     i2c_driver_start_Expect();
     i2c_driver_send_address_read_ExpectAndReturn(DEFAULT_ADDRESS, true);
 
-    i2c_driver_read_data_ExpectAndReturn(true, 0xBE);
-    i2c_driver_read_data_ExpectAndReturn(true, 0xEF);
-    i2c_driver_read_data_ExpectAndReturn(true, 0x92);
-
-    i2c_driver_read_data_ExpectAndReturn(true, 0xBE);
-    i2c_driver_read_data_ExpectAndReturn(true, 0xEF);
-    i2c_driver_read_data_ExpectAndReturn(false, 0x92);
+    const uint8_t data[6] = {0xBE, 0xEF, 0x92, 0xBE, 0xEF, 0x92};
+    expect_read_block(data, sizeof(data));
 
     i2c_driver_stop_Expect();
 
@@ -224,92 +225,44 @@ void test_fetch_periodic_data_no_ack_after_sending_address(void)
 {
     i2c_driver_start_Expect();
     i2c_driver_send_address_write_ExpectAndReturn(DEFAULT_ADDRESS, false);
-    // i2c_driver_send_data_ExpectAndReturn(FETCH_DATA_MSB, true);
-    // i2c_driver_send_data_ExpectAndReturn(FETCH_DATA_LSB, true);
-
-    // i2c_driver_start_Expect();
-    // i2c_driver_send_address_read_ExpectAndReturn(DEFAULT_ADDRESS, true);
-
-    // i2c_driver_read_data_ExpectAndReturn(true, 0xBE);
-    // i2c_driver_read_data_ExpectAndReturn(true, 0xEF);
-    // i2c_driver_read_data_ExpectAndReturn(true, 0x92);
-
-    // i2c_driver_read_data_ExpectAndReturn(true, 0xBE);
-    // i2c_driver_read_data_ExpectAndReturn(true, 0xEF);
-    // i2c_driver_read_data_ExpectAndReturn(false, 0x92);
-
-    // i2c_driver_stop_Expect();
+    i2c_driver_stop_Expect();
 
     bool success = sht30_driver_fetch_periodic_data();
     TEST_ASSERT_FALSE(success);
 }
 
-void test_fetch_periodic_data_no_ack_after_sending_MBS(void)
+void test_fetch_periodic_data_no_ack_after_sending_command(void)
 {
     i2c_driver_start_Expect();
     i2c_driver_send_address_write_ExpectAndReturn(DEFAULT_ADDRESS, true);
-    i2c_driver_send_data_ExpectAndReturn(FETCH_DATA_MSB, false);
-    // i2c_driver_send_data_ExpectAndReturn(FETCH_DATA_LSB, true);
-
-    // i2c_driver_start_Expect();
-    // i2c_driver_send_address_read_ExpectAndReturn(DEFAULT_ADDRESS, true);
-
-    // i2c_driver_read_data_ExpectAndReturn(true, 0xBE);
-    // i2c_driver_read_data_ExpectAndReturn(true, 0xEF);
-    // i2c_driver_read_data_ExpectAndReturn(true, 0x92);
-
-    // i2c_driver_read_data_ExpectAndReturn(true, 0xBE);
-    // i2c_driver_read_data_ExpectAndReturn(true, 0xEF);
-    // i2c_driver_read_data_ExpectAndReturn(false, 0x92);
-
-    // i2c_driver_stop_Expect();
+    expect_command_bytes(FETCH_DATA_MSB, FETCH_DATA_LSB, false);
+    i2c_driver_stop_Expect();
 
     bool success = sht30_driver_fetch_periodic_data();
     TEST_ASSERT_FALSE(success);
 }
 
-void test_fetch_periodic_data_no_ack_after_sending_LBS(void)
+void test_fetch_periodic_data_no_ack_after_address_read(void)
 {
     i2c_driver_start_Expect();
     i2c_driver_send_address_write_ExpectAndReturn(DEFAULT_ADDRESS, true);
-    i2c_driver_send_data_ExpectAndReturn(FETCH_DATA_MSB, true);
-    i2c_driver_send_data_ExpectAndReturn(FETCH_DATA_LSB, false);
+    expect_command_bytes(FETCH_DATA_MSB, FETCH_DATA_LSB, true);
 
-    // i2c_driver_start_Expect();
-    // i2c_driver_send_address_read_ExpectAndReturn(DEFAULT_ADDRESS, true);
-
-    // i2c_driver_read_data_ExpectAndReturn(true, 0xBE);
-    // i2c_driver_read_data_ExpectAndReturn(true, 0xEF);
-    // i2c_driver_read_data_ExpectAndReturn(true, 0x92);
-
-    // i2c_driver_read_data_ExpectAndReturn(true, 0xBE);
-    // i2c_driver_read_data_ExpectAndReturn(true, 0xEF);
-    // i2c_driver_read_data_ExpectAndReturn(false, 0x92);
+    i2c_driver_start_Expect();
+    i2c_driver_send_address_read_ExpectAndReturn(DEFAULT_ADDRESS, false);
 
-    // i2c_driver_stop_Expect();
+    i2c_driver_stop_Expect();
 
     bool success = sht30_driver_fetch_periodic_data();
     TEST_ASSERT_FALSE(success);
 }
 
-void test_fetch_periodic_data_no_ack_after_address_read(void)
+void test_fetch_periodic_data_block_read_fails_stops_and_returns_false(void)
 {
-    i2c_driver_start_Expect();
-    i2c_driver_send_address_write_ExpectAndReturn(DEFAULT_ADDRESS, true);
-    i2c_driver_send_data_ExpectAndReturn(FETCH_DATA_MSB, true);
-    i2c_driver_send_data_ExpectAndReturn(FETCH_DATA_LSB, true);
-
-    i2c_driver_start_Expect();
-    i2c_driver_send_address_read_ExpectAndReturn(DEFAULT_ADDRESS, false);
-
-    // i2c_driver_read_data_ExpectAndReturn(true, 0xBE);
-    // i2c_driver_read_data_ExpectAndReturn(true, 0xEF);
-    // i2c_driver_read_data_ExpectAndReturn(true, 0x92);
-
-    // i2c_driver_read_data_ExpectAndReturn(true, 0xBE);
-    // i2c_driver_read_data_ExpectAndReturn(true, 0xEF);
-    // i2c_driver_read_data_ExpectAndReturn(false, 0x92);
-
+    expect_start_and_send_address_write(true, true, FETCH_DATA);
+    expect_start_and_send_address_read(true);
+    i2c_driver_read_block_ExpectAndReturn(NULL, 6, false);
+    i2c_driver_read_block_IgnoreArg_data();
     i2c_driver_stop_Expect();
 
     bool success = sht30_driver_fetch_periodic_data();
@@ -320,18 +273,12 @@ void test_when_fetch_data_ok_temp_stored_unchecked(void)
 {
     i2c_driver_start_Ignore();
     i2c_driver_send_address_write_IgnoreAndReturn(true);
-    i2c_driver_send_data_IgnoreAndReturn(true);
-    i2c_driver_send_data_IgnoreAndReturn(true);
+    i2c_driver_write_block_IgnoreAndReturn(true);
 
     i2c_driver_start_Ignore();
     i2c_driver_send_address_read_IgnoreAndReturn(true);
-    i2c_driver_read_data_IgnoreAndReturn(0xAB);
-    i2c_driver_read_data_IgnoreAndReturn(0xCD);
-    i2c_driver_read_data_IgnoreAndReturn(0x00);
-
-    i2c_driver_read_data_IgnoreAndReturn(0x01);
-    i2c_driver_read_data_IgnoreAndReturn(0x23);
-    i2c_driver_read_data_IgnoreAndReturn(0x00);
+    const uint8_t data[6] = {0xAB, 0xCD, 0x00, 0x01, 0x23, 0x00};
+    expect_read_block(data, sizeof(data));
 
     i2c_driver_stop_Ignore();
 
@@ -345,18 +292,12 @@ void test_when_fetch_data_ok_humidity_stored_unchecked(void)
 {
     i2c_driver_start_Ignore();
     i2c_driver_send_address_write_IgnoreAndReturn(true);
-    i2c_driver_send_data_IgnoreAndReturn(true);
-    i2c_driver_send_data_IgnoreAndReturn(true);
+    i2c_driver_write_block_IgnoreAndReturn(true);
 
     i2c_driver_start_Ignore();
     i2c_driver_send_address_read_IgnoreAndReturn(true);
-    i2c_driver_read_data_IgnoreAndReturn(0xAB);
-    i2c_driver_read_data_IgnoreAndReturn(0xCD);
-    i2c_driver_read_data_IgnoreAndReturn(0x00);
-
-    i2c_driver_read_data_IgnoreAndReturn(0xBE);
-    i2c_driver_read_data_IgnoreAndReturn(0xEF);
-    i2c_driver_read_data_IgnoreAndReturn(0x00);
+    const uint8_t data[6] = {0xAB, 0xCD, 0x00, 0xBE, 0xEF, 0x00};
+    expect_read_block(data, sizeof(data));
 
     i2c_driver_stop_Ignore();
 
@@ -370,18 +311,12 @@ void test_when_fetch_data_temperature_CRC_correct_return_true(void)
 {
     i2c_driver_start_Ignore();
     i2c_driver_send_address_write_IgnoreAndReturn(true);
-    i2c_driver_send_data_IgnoreAndReturn(true);
-    i2c_driver_send_data_IgnoreAndReturn(true);
+    i2c_driver_write_block_IgnoreAndReturn(true);
 
     i2c_driver_start_Ignore();
     i2c_driver_send_address_read_IgnoreAndReturn(true);
-    i2c_driver_read_data_IgnoreAndReturn(0xBE);
-    i2c_driver_read_data_IgnoreAndReturn(0xEF);
-    i2c_driver_read_data_IgnoreAndReturn(0x92);
-
-    i2c_driver_read_data_IgnoreAndReturn(0xBE);
-    i2c_driver_read_data_IgnoreAndReturn(0xEF);
-    i2c_driver_read_data_IgnoreAndReturn(0x92);
+    const uint8_t data[6] = {0xBE, 0xEF, 0x92, 0xBE, 0xEF, 0x92};
+    expect_read_block(data, sizeof(data));
 
     i2c_driver_stop_Ignore();
 
@@ -393,18 +328,12 @@ void test_when_fetch_data_temperature_second_CRC_correct_return_true(void)
 {
     i2c_driver_start_Ignore();
     i2c_driver_send_address_write_IgnoreAndReturn(true);
-    i2c_driver_send_data_IgnoreAndReturn(true);
-    i2c_driver_send_data_IgnoreAndReturn(true);
+    i2c_driver_write_block_IgnoreAndReturn(true);
 
     i2c_driver_start_Ignore();
     i2c_driver_send_address_read_IgnoreAndReturn(true);
-    i2c_driver_read_data_IgnoreAndReturn(0x12);
-    i2c_driver_read_data_IgnoreAndReturn(0x34);
-    i2c_driver_read_data_IgnoreAndReturn(0x37);
-
-    i2c_driver_read_data_IgnoreAndReturn(0xBE);
-    i2c_driver_read_data_IgnoreAndReturn(0xEF);
-    i2c_driver_read_data_IgnoreAndReturn(0x92);
+    const uint8_t data[6] = {0x12, 0x34, 0x37, 0xBE, 0xEF, 0x92};
+    expect_read_block(data, sizeof(data));
 
     i2c_driver_stop_Ignore();
 
@@ -416,18 +345,12 @@ void test_when_fetch_data_temperature_third_CRC_correct_return_true(void)
 {
     i2c_driver_start_Ignore();
     i2c_driver_send_address_write_IgnoreAndReturn(true);
-    i2c_driver_send_data_IgnoreAndReturn(true);
-    i2c_driver_send_data_IgnoreAndReturn(true);
+    i2c_driver_write_block_IgnoreAndReturn(true);
 
     i2c_driver_start_Ignore();
     i2c_driver_send_address_read_IgnoreAndReturn(true);
-    i2c_driver_read_data_IgnoreAndReturn(0xAB);
-    i2c_driver_read_data_IgnoreAndReturn(0xCD);
-    i2c_driver_read_data_IgnoreAndReturn(0x6F);
-
-    i2c_driver_read_data_IgnoreAndReturn(0xBE);
-    i2c_driver_read_data_IgnoreAndReturn(0xEF);
-    i2c_driver_read_data_IgnoreAndReturn(0x92);
+    const uint8_t data[6] = {0xAB, 0xCD, 0x6F, 0xBE, 0xEF, 0x92};
+    expect_read_block(data, sizeof(data));
 
     i2c_driver_stop_Ignore();
 
@@ -439,14 +362,12 @@ void test_when_fetch_data_temperature_CRC_failed_return_false(void)
 {
     i2c_driver_start_Ignore();
     i2c_driver_send_address_write_IgnoreAndReturn(true);
-    i2c_driver_send_data_IgnoreAndReturn(true);
-    i2c_driver_send_data_IgnoreAndReturn(true);
+    i2c_driver_write_block_IgnoreAndReturn(true);
 
     i2c_driver_start_Ignore();
     i2c_driver_send_address_read_IgnoreAndReturn(true);
-    i2c_driver_read_data_IgnoreAndReturn(0xBE);
-    i2c_driver_read_data_IgnoreAndReturn(0xEF);
-    i2c_driver_read_data_IgnoreAndReturn(0x00);
+    const uint8_t data[6] = {0xBE, 0xEF, 0x00, 0xBE, 0xEF, 0x92};
+    expect_read_block(data, sizeof(data));
 
     i2c_driver_stop_Ignore();
 
@@ -458,18 +379,12 @@ void test_when_fetch_data_humidity_CRC_ok_passed(void)
 {
     i2c_driver_start_Ignore();
     i2c_driver_send_address_write_IgnoreAndReturn(true);
-    i2c_driver_send_data_IgnoreAndReturn(true);
-    i2c_driver_send_data_IgnoreAndReturn(true);
+    i2c_driver_write_block_IgnoreAndReturn(true);
 
     i2c_driver_start_Ignore();
     i2c_driver_send_address_read_IgnoreAndReturn(true);
-    i2c_driver_read_data_IgnoreAndReturn(0xBE);
-    i2c_driver_read_data_IgnoreAndReturn(0xEF);
-    i2c_driver_read_data_IgnoreAndReturn(0x92);
-
-    i2c_driver_read_data_IgnoreAndReturn(0xBE);
-    i2c_driver_read_data_IgnoreAndReturn(0xEF);
-    i2c_driver_read_data_IgnoreAndReturn(0x92);
+    const uint8_t data[6] = {0xBE, 0xEF, 0x92, 0xBE, 0xEF, 0x92};
+    expect_read_block(data, sizeof(data));
 
     i2c_driver_stop_Ignore();
 
@@ -481,18 +396,12 @@ void test_when_fetch_data_humidity_CRC_not_ok_failed(void)
 {
     i2c_driver_start_Ignore();
     i2c_driver_send_address_write_IgnoreAndReturn(true);
-    i2c_driver_send_data_IgnoreAndReturn(true);
-    i2c_driver_send_data_IgnoreAndReturn(true);
+    i2c_driver_write_block_IgnoreAndReturn(true);
 
     i2c_driver_start_Ignore();
     i2c_driver_send_address_read_IgnoreAndReturn(true);
-    i2c_driver_read_data_IgnoreAndReturn(0xBE);
-    i2c_driver_read_data_IgnoreAndReturn(0xEF);
-    i2c_driver_read_data_IgnoreAndReturn(0x92);
-
-    i2c_driver_read_data_IgnoreAndReturn(0xBE);
-    i2c_driver_read_data_IgnoreAndReturn(0xEF);
-    i2c_driver_read_data_IgnoreAndReturn(0x00);
+    const uint8_t data[6] = {0xBE, 0xEF, 0x92, 0xBE, 0xEF, 0x00};
+    expect_read_block(data, sizeof(data));
 
     i2c_driver_stop_Ignore();
 
@@ -505,13 +414,12 @@ void test_when_fetch_data_humidity_CRC_not_ok_failed(void)
 ///////////////////////////////////////////////////////////////////////////////
 void test_read_status_register_all_ok(void)
 {
-    expect_start_and_send_address_write(true, true, true, READ_STATUS_ADDRESS);
+    expect_start_and_send_address_write(true, true, READ_STATUS_ADDRESS);
 
     expect_start_and_send_address_read(true);
 
-    i2c_driver_read_data_ExpectAndReturn(true, 0xBE);
-    i2c_driver_read_data_ExpectAndReturn(true, 0xEF);
-    i2c_driver_read_data_ExpectAndReturn(false, 0x92);
+    const uint8_t data[3] = {0xBE, 0xEF, 0x92};
+    expect_read_block(data, sizeof(data));
 
     i2c_driver_stop_Expect();
 
@@ -521,31 +429,18 @@ void test_read_status_register_all_ok(void)
 
 void test_read_status_register_no_ack_after_address(void)
 {
-    expect_start_and_send_address_write(false, true, true, READ_STATUS_ADDRESS);
+    expect_start_and_send_address_write(false, true, READ_STATUS_ADDRESS);
     // expect_start_and_send_address_read(true);
-    // expect_read_three_data_values(true, true, false, 0xBE, 0xEF, 0x92);
     i2c_driver_stop_Expect();
 
     bool success = sht30_driver_read_status_register();
     TEST_ASSERT_FALSE(success);
 }
 
-void test_read_status_register_no_ack_after_msb(void)
+void test_read_status_register_no_ack_after_command(void)
 {
-    expect_start_and_send_address_write(true, false, true, READ_STATUS_ADDRESS);
+    expect_start_and_send_address_write(true, false, READ_STATUS_ADDRESS);
     // expect_start_and_send_address_read(true);
-    // expect_read_three_data_values(true, true, false, 0xBE, 0xEF, 0x92);
-    i2c_driver_stop_Expect();
-
-    bool success = sht30_driver_read_status_register();
-    TEST_ASSERT_FALSE(success);
-}
-
-void test_read_status_register_no_ack_after_lsb(void)
-{
-    expect_start_and_send_address_write(true, true, false, READ_STATUS_ADDRESS);
-    // expect_start_and_send_address_read(true);
-    // expect_read_three_data_values(true, true, false, 0xBE, 0xEF, 0x92);
     i2c_driver_stop_Expect();
 
     bool success = sht30_driver_read_status_register();
@@ -554,9 +449,8 @@ void test_read_status_register_no_ack_after_lsb(void)
 
 void test_read_status_register_no_ack_after_address_read(void)
 {
-    expect_start_and_send_address_write(true, true, true, READ_STATUS_ADDRESS);
+    expect_start_and_send_address_write(true, true, READ_STATUS_ADDRESS);
     expect_start_and_send_address_read(false);
-    // expect_read_three_data_values(true, true, false, 0xBE, 0xEF, 0x92);
     i2c_driver_stop_Expect();
 
     bool success = sht30_driver_read_status_register();
@@ -565,9 +459,10 @@ void test_read_status_register_no_ack_after_address_read(void)
 
 void test_read_status_register_crc_incorrect_function_fails(void)
 {
-    expect_start_and_send_address_write(true, true, true, READ_STATUS_ADDRESS);
+    expect_start_and_send_address_write(true, true, READ_STATUS_ADDRESS);
     expect_start_and_send_address_read(true);
-    expect_read_three_data_values(true, true, false, 0xBE, 0xEF, 0x91);
+    const uint8_t data[3] = {0xBE, 0xEF, 0x91};
+    expect_read_block(data, sizeof(data));
     i2c_driver_stop_Expect();
 
     bool success = sht30_driver_read_status_register();
@@ -576,9 +471,10 @@ void test_read_status_register_crc_incorrect_function_fails(void)
 
 void test_status_register_stored_after_successful_read(void)
 {
-    expect_start_and_send_address_write(true, true, true, READ_STATUS_ADDRESS);
+    expect_start_and_send_address_write(true, true, READ_STATUS_ADDRESS);
     expect_start_and_send_address_read(true);
-    expect_read_three_data_values(true, true, false, 0xBE, 0xEF, 0x92);
+    const uint8_t data[3] = {0xBE, 0xEF, 0x92};
+    expect_read_block(data, sizeof(data));
     i2c_driver_stop_Expect();
 
     bool success = sht30_driver_read_status_register();
@@ -588,9 +484,178 @@ void test_status_register_stored_after_successful_read(void)
     TEST_ASSERT_EQUAL_HEX16(0xBEEF, status);
 }
 
+static void expect_status_read(const uint8_t *data)
+{
+    expect_start_and_send_address_write(true, true, READ_STATUS_ADDRESS);
+    expect_start_and_send_address_read(true);
+    expect_read_block(data, CRC8_WORD_SIZE);
+    i2c_driver_stop_Expect();
+}
+
+void test_status_register_crc_is_over_the_status_word(void)
+{
+    const uint8_t good[3] = {0x80, 0x10, crc8_word(0x8010)};
+    const uint8_t bad[3]  = {0x00, 0x10, crc8_word(0x8010)};
+
+    default_test_sensor.temperature = 0x1234;
+    expect_status_read(good);
+    TEST_ASSERT(sht31_read_status_register(&default_test_sensor));
+
+    expect_status_read(bad);
+    TEST_ASSERT_FALSE(sht31_read_status_register(&default_test_sensor));
+}
+
+void test_status_register_kept_when_crc_fails(void)
+{
+    const uint8_t good[3] = {0x80, 0x10, crc8_word(0x8010)};
+    const uint8_t bad[3]  = {0xBE, 0xEF, 0x91};
+
+    expect_status_read(good);
+    sht31_read_status_register(&default_test_sensor);
+    expect_status_read(bad);
+    sht31_read_status_register(&default_test_sensor);
+
+    TEST_ASSERT_EQUAL_HEX16(
+        0x8010, sht31_return_status_register(&default_test_sensor));
+}
+
+void test_decode_status_sets_each_bit(void)
+{
+    sht31_status_t status = sht31_decode_status(0xAC13);
+
+    TEST_ASSERT_TRUE(status.alert_pending);
+    TEST_ASSERT_TRUE(status.heater_on);
+    TEST_ASSERT_TRUE(status.humidity_alert);
+    TEST_ASSERT_TRUE(status.temperature_alert);
+    TEST_ASSERT_TRUE(status.reset_detected);
+    TEST_ASSERT_TRUE(status.command_failed);
+    TEST_ASSERT_TRUE(status.write_checksum_failed);
+
+    status = sht31_decode_status(0x53EC);
+
+    TEST_ASSERT_FALSE(status.alert_pending);
+    TEST_ASSERT_FALSE(status.heater_on);
+    TEST_ASSERT_FALSE(status.humidity_alert);
+    TEST_ASSERT_FALSE(status.temperature_alert);
+    TEST_ASSERT_FALSE(status.reset_detected);
+    TEST_ASSERT_FALSE(status.command_failed);
+    TEST_ASSERT_FALSE(status.write_checksum_failed);
+}
+
+void test_read_status_decodes_register(void)
+{
+    const uint8_t data[3] = {0x84, 0x00, crc8_word(0x8400)};
+    sht31_status_t status;
+
+    expect_status_read(data);
+    TEST_ASSERT(sht30_driver_read_status(&status));
+
+    TEST_ASSERT_TRUE(status.alert_pending);
+    TEST_ASSERT_TRUE(status.temperature_alert);
+    TEST_ASSERT_FALSE(status.humidity_alert);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Alert limits
+///////////////////////////////////////////////////////////////////////////////
+
+void test_alert_limit_pack_keeps_top_bits(void)
+{
+    uint16_t temperature = 0;
+    uint16_t humidity    = 0;
+
+    // 60 C and 80 %RH, the default high set limit.
+    TEST_ASSERT_EQUAL_HEX16(0xCD33, sht31_alert_limit_pack(0x9999, 0xCCCC));
+
+    sht31_alert_limit_unpack(0xCD33, &temperature, &humidity);
+    TEST_ASSERT_EQUAL_HEX16(0x9980, temperature);
+    TEST_ASSERT_EQUAL_HEX16(0xCC00, humidity);
+}
+
+void test_write_alert_limit_sends_word_and_crc(void)
+{
+    expect_start_and_write_word(SHT_ALERT_WRITE_HIGH_SET, 0xCD33, true);
+    i2c_driver_stop_Expect();
+
+    TEST_ASSERT(sht31_write_alert_limit(&default_test_sensor,
+                                        SHT31_ALERT_HIGH_SET, 0x9999, 0xCCCC));
+}
+
+void test_write_alert_limit_uses_command_for_each_limit(void)
+{
+    const uint16_t commands[SHT31_ALERT_LIMITS] = {
+        SHT_ALERT_WRITE_HIGH_SET, SHT_ALERT_WRITE_HIGH_CLEAR,
+        SHT_ALERT_WRITE_LOW_CLEAR, SHT_ALERT_WRITE_LOW_SET};
+    uint8_t limit = 0;
+
+    for (limit = 0; limit < SHT31_ALERT_LIMITS; limit++)
+    {
+        expect_start_and_write_word(commands[limit], 0x0000, true);
+        i2c_driver_stop_Expect();
+
+        TEST_ASSERT(
+            sht31_write_alert_limit(&default_test_sensor, limit, 0, 0));
+    }
+}
+
+void test_write_alert_limit_nack_stops_and_returns_false(void)
+{
+    i2c_driver_start_Expect();
+    i2c_driver_send_address_write_ExpectAndReturn(DEFAULT_ADDRESS, true);
+    i2c_driver_write_block_ExpectAndReturn(NULL, 5, false);
+    i2c_driver_write_block_IgnoreArg_data();
+    i2c_driver_stop_Expect();
+
+    TEST_ASSERT_FALSE(sht31_write_alert_limit(
+        &default_test_sensor, SHT31_ALERT_LOW_SET, 0x3333, 0x3333));
+}
+
+void test_write_alert_limit_rejects_unknown_limit(void)
+{
+    TEST_ASSERT_FALSE(sht31_write_alert_limit(&default_test_sensor,
+                                              SHT31_ALERT_LIMITS, 0, 0));
+}
+
+void test_read_alert_limit_unpacks_word(void)
+{
+    const uint8_t data[3] = {0x38, 0x69, crc8_word(0x3869)};
+    uint16_t temperature  = 0;
+    uint16_t humidity     = 0;
+
+    expect_start_and_send_address_write(true, true,
+                                        SHT_ALERT_READ_LOW_CLEAR);
+    expect_start_and_send_address_read(true);
+    expect_read_block(data, sizeof(data));
+    i2c_driver_stop_Expect();
+
+    TEST_ASSERT(sht31_read_alert_limit(&default_test_sensor,
+                                       SHT31_ALERT_LOW_CLEAR, &temperature,
+                                       &humidity));
+    TEST_ASSERT_EQUAL_HEX16(0x3480, temperature);
+    TEST_ASSERT_EQUAL_HEX16(0x3800, humidity);
+}
+
+void test_read_alert_limit_crc_failure_returns_false(void)
+{
+    const uint8_t data[3] = {0x38, 0x69, crc8_word(0x3869) ^ 0x01};
+    uint16_t temperature  = 0;
+    uint16_t humidity     = 0;
+
+    expect_start_and_send_address_write(true, true,
+                                        SHT_ALERT_READ_HIGH_CLEAR);
+    expect_start_and_send_address_read(true);
+    expect_read_block(data, sizeof(data));
+    i2c_driver_stop_Expect();
+
+    TEST_ASSERT_FALSE(sht31_read_alert_limit(&default_test_sensor,
+                                             SHT31_ALERT_HIGH_CLEAR,
+                                             &temperature, &humidity));
+    TEST_ASSERT_EQUAL_UINT16(1, default_test_sensor.errors.crc);
+}
+
 void test_clear_status_register_all_ok(void)
 {
-    expect_start_and_send_address_write(true, true, true, CLEAR_STATUS_ADDRESS);
+    expect_start_and_send_address_write(true, true, CLEAR_STATUS_ADDRESS);
     i2c_driver_stop_Expect();
 
     bool success = sht30_driver_clear_status_register();
@@ -599,7 +664,7 @@ void test_clear_status_register_all_ok(void)
 
 void test_clear_status_register_all_fail(void)
 {
-    expect_start_and_send_address_write(true, true, false,
+    expect_start_and_send_address_write(true, false,
                                         CLEAR_STATUS_ADDRESS);
     i2c_driver_stop_Expect();
 
@@ -609,7 +674,7 @@ void test_clear_status_register_all_fail(void)
 
 void test_break_command_successful(void)
 {
-    expect_start_and_send_address_write(true, true, true,
+    expect_start_and_send_address_write(true, true,
                                         BREAK_COMMAND_ADDRESS);
     i2c_driver_stop_Expect();
 
@@ -617,19 +682,41 @@ void test_break_command_successful(void)
     TEST_ASSERT(success);
 }
 
+void test_heater_on_and_off_send_their_commands(void)
+{
+    expect_start_and_send_address_write(true, true,
+                                        HEATER_ENABLE_ADDRESS);
+    i2c_driver_stop_Expect();
+    TEST_ASSERT(sht30_driver_set_heater(true));
+
+    expect_start_and_send_address_write(true, true,
+                                        HEATER_DISABLE_ADDRESS);
+    i2c_driver_stop_Expect();
+    TEST_ASSERT(sht30_driver_set_heater(false));
+}
+
+void test_heater_nack_stops_and_returns_false(void)
+{
+    expect_start_and_send_address_write(false, true,
+                                        HEATER_ENABLE_ADDRESS);
+    i2c_driver_stop_Expect();
+
+    TEST_ASSERT_FALSE(sht31_set_heater(&default_test_sensor, true));
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 // Single shot data acquisition
 ///////////////////////////////////////////////////////////////////////////////
 
 void test_single_shot_data_acquisition_mode_all_ok_no_clock_stretching(void)
 {
-    expect_start_and_send_address_write(true, true, true, 
+    expect_start_and_send_address_write(true, true, 
             SHT_SINGLE_SHOT_MODE_HIGH_CLOCK_STRETCH);
     i2c_driver_stop_Expect();
     expect_start_and_send_address_read(true);
 
-    expect_read_three_data_values(true, true, true, 0xBE, 0xEF, 0x92);
-    expect_read_three_data_values(true, true, false, 0xBE, 0xEF, 0x92);
+    const uint8_t data[6] = {0xBE, 0xEF, 0x92, 0xBE, 0xEF, 0x92};
+    expect_read_block(data, sizeof(data));
 
     i2c_driver_stop_Expect();
 
@@ -640,13 +727,13 @@ void test_single_shot_data_acquisition_mode_all_ok_no_clock_stretching(void)
 
 void test_single_shot_data_get_temperature_incorrect_returns_false(void)
 {
-    expect_start_and_send_address_write(true, true, true, 
+    expect_start_and_send_address_write(true, true, 
             SHT_SINGLE_SHOT_MODE_HIGH_CLOCK_STRETCH);
     i2c_driver_stop_Expect();
     expect_start_and_send_address_read(true);
 
-    expect_read_three_data_values(true, true, true, 0xBE, 0xEF, 0x00);
-    //expect_read_three_data_values(true, true, false, 0xBE, 0xEF, 0x00);
+    const uint8_t data[6] = {0xBE, 0xEF, 0x00, 0xBE, 0xEF, 0x92};
+    expect_read_block(data, sizeof(data));
 
     i2c_driver_stop_Expect();
 
@@ -656,18 +743,750 @@ void test_single_shot_data_get_temperature_incorrect_returns_false(void)
 
 void test_single_shot_data_get_humidity_incorrect_returns_false(void)
 {
-    expect_start_and_send_address_write(true, true, true, 
+    expect_start_and_send_address_write(true, true, 
             SHT_SINGLE_SHOT_MODE_HIGH_CLOCK_STRETCH);
     i2c_driver_stop_Expect();
     expect_start_and_send_address_read(true);
 
-    expect_read_three_data_values(true, true, true, 0xBE, 0xEF, 0x92);
-    expect_read_three_data_values(true, true, false, 0xBE, 0xEF, 0x00);
+    const uint8_t data[6] = {0xBE, 0xEF, 0x92, 0xBE, 0xEF, 0x00};
+    expect_read_block(data, sizeof(data));
 
     i2c_driver_stop_Expect();
 
     bool success = sht30_driver_get_single_shot_data();
     TEST_ASSERT_FALSE(success);
-} 
+}
+
+void test_periodic_mode_repeatability_runs_low_to_high(void)
+{
+    i2c_driver_start_Expect();
+    i2c_driver_send_address_write_ExpectAndReturn(DEFAULT_ADDRESS, true);
+    expect_command_bytes(0x27, 0x37, true);
+    i2c_driver_stop_Expect();
+
+    bool success = sht30_driver_send_periodic_data_aquisition_mode(
+        SHT_REPEATABILITY_HIGH, 4);
+    TEST_ASSERT(success);
+}
+
+static void expect_single_shot_command(uint16_t command)
+{
+    expect_start_and_send_address_write(true, true, command);
+    i2c_driver_stop_Expect();
+}
+
+static void expect_single_shot_read(void)
+{
+    static const uint8_t data[6] = {0x12, 0x34, 0x37, 0xBE, 0xEF, 0x92};
+
+    expect_read_block(data, sizeof(data));
+    i2c_driver_stop_Expect();
+}
+
+void test_single_shot_in_mode_sends_command_for_every_combination(void)
+{
+    const uint16_t commands[2][3] = {
+        {0x2416, 0x240B, 0x2400},
+        {0x2C10, 0x2C0D, 0x2C06},
+    };
+    uint8_t stretch       = 0;
+    uint8_t repeatability = 0;
+
+    for (stretch = 0; stretch < 2; stretch++)
+    {
+        for (repeatability = 0; repeatability < 3; repeatability++)
+        {
+            expect_single_shot_command(commands[stretch][repeatability]);
+            expect_start_and_send_address_read(true);
+            expect_single_shot_read();
+
+            TEST_ASSERT(sht31_get_single_shot_data_in_mode(
+                &default_test_sensor, repeatability, stretch));
+        }
+    }
+}
+
+void test_single_shot_without_stretch_retries_read_until_ack(void)
+{
+    expect_single_shot_command(SHT_SINGLE_SHOT_MODE_LOW);
+    expect_start_and_send_address_read(false);
+    i2c_driver_stop_Expect();
+    expect_start_and_send_address_read(false);
+    i2c_driver_stop_Expect();
+    expect_start_and_send_address_read(true);
+    expect_single_shot_read();
+
+    TEST_ASSERT(sht31_get_single_shot_data_in_mode(
+        &default_test_sensor, SHT_REPEATABILITY_LOW, false));
+    TEST_ASSERT_EQUAL_HEX16(0x1234,
+                            sht31_return_temperature(&default_test_sensor));
+    TEST_ASSERT_EQUAL_UINT16(0, default_test_sensor.errors.nack);
+}
+
+static uint16_t address_read_calls;
+
+static bool nack_address_read(uint8_t address, int num_calls)
+{
+    (void)address;
+    (void)num_calls;
+    address_read_calls++;
+    return false;
+}
+
+void test_single_shot_without_stretch_gives_up_after_conversion_time(void)
+{
+    address_read_calls = 0;
+    i2c_driver_start_Ignore();
+    i2c_driver_stop_Ignore();
+    i2c_driver_send_address_write_IgnoreAndReturn(true);
+    i2c_driver_write_block_IgnoreAndReturn(true);
+    i2c_driver_send_address_read_StubWithCallback(nack_address_read);
+
+    TEST_ASSERT_FALSE(sht31_get_single_shot_data_in_mode(
+        &default_test_sensor, SHT_REPEATABILITY_HIGH, false));
+    TEST_ASSERT_EQUAL_UINT16(
+        (SHT_DURATION_HIGH_MS + SHT_SINGLE_SHOT_POLL_MARGIN_MS) *
+            SHT_SINGLE_SHOT_POLLS_PER_MS,
+        address_read_calls);
+    TEST_ASSERT_EQUAL_UINT16(1, default_test_sensor.errors.nack);
+}
+
+void test_single_shot_command_nack_stops_and_returns_false(void)
+{
+    expect_start_and_send_address_write(true, false,
+                                        SHT_SINGLE_SHOT_MODE_MEDIUM);
+    i2c_driver_stop_Expect();
+
+    TEST_ASSERT_FALSE(sht31_get_single_shot_data_in_mode(
+        &default_test_sensor, SHT_REPEATABILITY_MEDIUM, false));
+}
+
+void test_single_shot_clock_stretch_read_nack_stops_and_returns_false(void)
+{
+    expect_single_shot_command(SHT_SINGLE_SHOT_MODE_LOW_CLOCK_STRETCH);
+    expect_start_and_send_address_read(false);
+    i2c_driver_stop_Expect();
+
+    TEST_ASSERT_FALSE(sht31_get_single_shot_data_in_mode(
+        &default_test_sensor, SHT_REPEATABILITY_LOW, true));
+}
+
+void test_single_shot_durations_get_longer_with_repeatability(void)
+{
+    TEST_ASSERT_EQUAL_UINT8(5, sht31_single_shot_duration_ms(0));
+    TEST_ASSERT_EQUAL_UINT8(7, sht31_single_shot_duration_ms(1));
+    TEST_ASSERT_EQUAL_UINT8(16, sht31_single_shot_duration_ms(2));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Sensor handles
+///////////////////////////////////////////////////////////////////////////////
+
+static int fake_bus_starts;
+static int fake_bus_stops;
+static void *fake_bus_last_context;
+static uint8_t fake_bus_last_address;
+
+static void fake_start(void *context)
+{
+    fake_bus_last_context = context;
+    fake_bus_starts++;
+}
+
+static void fake_stop(void *context)
+{
+    fake_bus_last_context = context;
+    fake_bus_stops++;
+}
+
+static bool fake_send_address(void *context, uint8_t address)
+{
+    fake_bus_last_context = context;
+    fake_bus_last_address = address;
+    return true;
+}
+
+static bool fake_write_block(void *context, const uint8_t *data,
+                             uint8_t length)
+{
+    (void)data;
+    (void)length;
+    fake_bus_last_context = context;
+    return true;
+}
+
+static bool fake_read_block(void *context, uint8_t *data, uint8_t length)
+{
+    const uint8_t frame[6] = {0x12, 0x34, 0x37, 0xBE, 0xEF, 0x92};
+    uint8_t i              = 0;
+
+    fake_bus_last_context = context;
+    for (i = 0; i < length; i++)
+    {
+        data[i] = frame[i];
+    }
+    return true;
+}
+
+void test_sensor_on_alternate_address_uses_that_address(void)
+{
+    sht31_t sensor;
+    sht31_init(&sensor, &i2c_driver_bus, SHT_ALTERNATE_ADDRESS);
+
+    i2c_driver_start_Expect();
+    i2c_driver_send_address_write_ExpectAndReturn(SHT_ALTERNATE_ADDRESS, true);
+    expect_command_bytes(SOFT_RESET_MSB, SOFT_RESET_LSB, true);
+    i2c_driver_stop_Expect();
 
+    bool success = sht31_send_soft_reset(&sensor);
+    TEST_ASSERT(success);
+}
+
+void test_two_sensors_keep_their_own_readings(void)
+{
+    sht31_t sensor_a;
+    sht31_t sensor_b;
+    const uint8_t data_a[6] = {0x12, 0x34, 0x37, 0xBE, 0xEF, 0x92};
+    const uint8_t data_b[6] = {0xAB, 0xCD, 0x6F, 0x12, 0x34, 0x37};
+
+    sht31_init(&sensor_a, &i2c_driver_bus, DEFAULT_ADDRESS);
+    sht31_init(&sensor_b, &i2c_driver_bus, SHT_ALTERNATE_ADDRESS);
+
+    i2c_driver_start_Ignore();
+    i2c_driver_send_address_write_IgnoreAndReturn(true);
+    i2c_driver_send_address_read_IgnoreAndReturn(true);
+    i2c_driver_write_block_IgnoreAndReturn(true);
+    i2c_driver_stop_Ignore();
+    expect_read_block(data_a, sizeof(data_a));
+    expect_read_block(data_b, sizeof(data_b));
+
+    TEST_ASSERT(sht31_fetch_periodic_data(&sensor_a));
+    TEST_ASSERT(sht31_fetch_periodic_data(&sensor_b));
+
+    TEST_ASSERT_EQUAL_HEX16(0x1234, sht31_return_temperature(&sensor_a));
+    TEST_ASSERT_EQUAL_HEX16(0xBEEF, sht31_return_humidity(&sensor_a));
+    TEST_ASSERT_EQUAL_HEX16(0xABCD, sht31_return_temperature(&sensor_b));
+    TEST_ASSERT_EQUAL_HEX16(0x1234, sht31_return_humidity(&sensor_b));
+}
+
+void test_nack_is_counted_on_the_sensor(void)
+{
+    sht31_t sensor;
+    sht31_init(&sensor, &i2c_driver_bus, DEFAULT_ADDRESS);
+
+    i2c_driver_start_Expect();
+    i2c_driver_send_address_write_ExpectAndReturn(DEFAULT_ADDRESS, false);
+    i2c_driver_stop_Expect();
+
+    TEST_ASSERT_FALSE(sht31_send_soft_reset(&sensor));
+    TEST_ASSERT_EQUAL_UINT16(1, sensor.errors.nack);
+    TEST_ASSERT_EQUAL_UINT16(0, sensor.errors.crc);
+}
+
+void test_crc_failure_is_counted_on_the_sensor(void)
+{
+    sht31_t sensor;
+    const uint8_t data[6] = {0xBE, 0xEF, 0x92, 0xBE, 0xEF, 0x00};
+
+    sht31_init(&sensor, &i2c_driver_bus, DEFAULT_ADDRESS);
+
+    expect_start_and_send_address_write(true, true, FETCH_DATA);
+    expect_start_and_send_address_read(true);
+    expect_read_block(data, sizeof(data));
+    i2c_driver_stop_Expect();
+
+    TEST_ASSERT_FALSE(sht31_fetch_periodic_data(&sensor));
+    TEST_ASSERT_EQUAL_UINT16(0, sensor.errors.nack);
+    TEST_ASSERT_EQUAL_UINT16(1, sensor.errors.crc);
+}
+
+void test_sensor_on_another_bus_uses_that_bus_and_context(void)
+{
+    int context = 0;
+    const i2c_bus_t other_bus = {
+        .context            = &context,
+        .start              = fake_start,
+        .stop               = fake_stop,
+        .send_address_write = fake_send_address,
+        .send_address_read  = fake_send_address,
+        .read_block         = fake_read_block,
+        .write_block        = fake_write_block,
+    };
+    sht31_t sensor;
+
+    fake_bus_starts       = 0;
+    fake_bus_stops        = 0;
+    fake_bus_last_context = NULL;
+    sht31_init(&sensor, &other_bus, SHT_ALTERNATE_ADDRESS);
+
+    TEST_ASSERT(sht31_fetch_periodic_data(&sensor));
+
+    TEST_ASSERT_EQUAL(2, fake_bus_starts);
+    TEST_ASSERT_EQUAL(1, fake_bus_stops);
+    TEST_ASSERT_EQUAL_PTR(&context, fake_bus_last_context);
+    TEST_ASSERT_EQUAL_HEX8(SHT_ALTERNATE_ADDRESS, fake_bus_last_address);
+    TEST_ASSERT_EQUAL_HEX16(0x1234, sht31_return_temperature(&sensor));
+    TEST_ASSERT_EQUAL_HEX16(0xBEEF, sht31_return_humidity(&sensor));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Non-blocking measurements
+///////////////////////////////////////////////////////////////////////////////
+
+static void begin_measurement(sht31_t *sensor, uint16_t command,
+                              uint8_t repeatability, uint32_t now_ms)
+{
+    expect_start_and_send_address_write(true, true, command);
+    i2c_driver_stop_Expect();
+
+    TEST_ASSERT(sht31_begin_measurement(sensor, repeatability, now_ms));
+}
+
+void test_begin_measurement_sends_no_clock_stretch_command(void)
+{
+    sht31_t sensor;
+    sht31_init(&sensor, &i2c_driver_bus, DEFAULT_ADDRESS);
+
+    begin_measurement(&sensor, SHT_SINGLE_SHOT_MODE_HIGH, 2, 0);
+}
+
+void test_begin_measurement_uses_command_for_repeatability(void)
+{
+    sht31_t low;
+    sht31_t medium;
+    sht31_init(&low, &i2c_driver_bus, DEFAULT_ADDRESS);
+    sht31_init(&medium, &i2c_driver_bus, DEFAULT_ADDRESS);
+
+    begin_measurement(&low, SHT_SINGLE_SHOT_MODE_LOW, 0, 0);
+    begin_measurement(&medium, SHT_SINGLE_SHOT_MODE_MEDIUM, 1, 0);
+}
+
+void test_begin_measurement_nack_stops_and_returns_false(void)
+{
+    sht31_t sensor;
+    sht31_init(&sensor, &i2c_driver_bus, DEFAULT_ADDRESS);
+
+    expect_start_and_send_address_write(false, true,
+                                        SHT_SINGLE_SHOT_MODE_HIGH);
+    i2c_driver_stop_Expect();
+
+    TEST_ASSERT_FALSE(sht31_begin_measurement(&sensor, 2, 0));
+    TEST_ASSERT_EQUAL(SHT31_POLL_IDLE, sht31_poll(&sensor, 100));
+}
+
+void test_begin_measurement_while_measuring_returns_false(void)
+{
+    sht31_t sensor;
+    sht31_init(&sensor, &i2c_driver_bus, DEFAULT_ADDRESS);
+
+    begin_measurement(&sensor, SHT_SINGLE_SHOT_MODE_HIGH, 2, 0);
+
+    TEST_ASSERT_FALSE(sht31_begin_measurement(&sensor, 2, 1));
+}
+
+void test_poll_with_nothing_started_is_idle(void)
+{
+    sht31_t sensor;
+    sht31_init(&sensor, &i2c_driver_bus, DEFAULT_ADDRESS);
+
+    TEST_ASSERT_EQUAL(SHT31_POLL_IDLE, sht31_poll(&sensor, 0));
+}
+
+void test_poll_is_busy_until_high_repeatability_time_passed(void)
+{
+    sht31_t sensor;
+    sht31_init(&sensor, &i2c_driver_bus, DEFAULT_ADDRESS);
+
+    begin_measurement(&sensor, SHT_SINGLE_SHOT_MODE_HIGH, 2, 1000);
+
+    TEST_ASSERT_EQUAL(SHT31_POLL_BUSY, sht31_poll(&sensor, 1000));
+    TEST_ASSERT_EQUAL(SHT31_POLL_BUSY, sht31_poll(&sensor, 1016));
+}
+
+void test_poll_is_busy_until_low_repeatability_time_passed(void)
+{
+    sht31_t sensor;
+    const uint8_t data[6] = {0x12, 0x34, 0x37, 0xBE, 0xEF, 0x92};
+    sht31_init(&sensor, &i2c_driver_bus, DEFAULT_ADDRESS);
+
+    begin_measurement(&sensor, SHT_SINGLE_SHOT_MODE_LOW, 0, 1000);
+    TEST_ASSERT_EQUAL(SHT31_POLL_BUSY, sht31_poll(&sensor, 1005));
+
+    expect_start_and_send_address_read(true);
+    expect_read_block(data, sizeof(data));
+    i2c_driver_stop_Expect();
+
+    TEST_ASSERT_EQUAL(SHT31_POLL_DONE, sht31_poll(&sensor, 1006));
+}
+
+void test_poll_reads_result_once_conversion_time_passed(void)
+{
+    sht31_t sensor;
+    const uint8_t data[6] = {0x12, 0x34, 0x37, 0xBE, 0xEF, 0x92};
+    sht31_init(&sensor, &i2c_driver_bus, DEFAULT_ADDRESS);
+
+    begin_measurement(&sensor, SHT_SINGLE_SHOT_MODE_HIGH, 2, 1000);
+
+    expect_start_and_send_address_read(true);
+    expect_read_block(data, sizeof(data));
+    i2c_driver_stop_Expect();
+
+    TEST_ASSERT_EQUAL(SHT31_POLL_DONE, sht31_poll(&sensor, 1017));
+    TEST_ASSERT_EQUAL_HEX16(0x1234, sht31_return_temperature(&sensor));
+    TEST_ASSERT_EQUAL_HEX16(0xBEEF, sht31_return_humidity(&sensor));
+    TEST_ASSERT_EQUAL(SHT31_POLL_IDLE, sht31_poll(&sensor, 1018));
+}
+
+void test_poll_handles_millisecond_counter_wrapping(void)
+{
+    sht31_t sensor;
+    const uint8_t data[6] = {0x12, 0x34, 0x37, 0xBE, 0xEF, 0x92};
+    sht31_init(&sensor, &i2c_driver_bus, DEFAULT_ADDRESS);
+
+    begin_measurement(&sensor, SHT_SINGLE_SHOT_MODE_HIGH, 2, 0xFFFFFFF8);
+    TEST_ASSERT_EQUAL(SHT31_POLL_BUSY, sht31_poll(&sensor, 0xFFFFFFFF));
+    TEST_ASSERT_EQUAL(SHT31_POLL_BUSY, sht31_poll(&sensor, 0x00000008));
+
+    expect_start_and_send_address_read(true);
+    expect_read_block(data, sizeof(data));
+    i2c_driver_stop_Expect();
+
+    TEST_ASSERT_EQUAL(SHT31_POLL_DONE, sht31_poll(&sensor, 0x00000009));
+}
+
+void test_poll_read_nack_returns_error_and_stops(void)
+{
+    sht31_t sensor;
+    sht31_init(&sensor, &i2c_driver_bus, DEFAULT_ADDRESS);
+
+    begin_measurement(&sensor, SHT_SINGLE_SHOT_MODE_HIGH, 2, 0);
+
+    expect_start_and_send_address_read(false);
+    i2c_driver_stop_Expect();
+
+    TEST_ASSERT_EQUAL(SHT31_POLL_ERROR, sht31_poll(&sensor, 17));
+    TEST_ASSERT_EQUAL(SHT31_POLL_IDLE, sht31_poll(&sensor, 18));
+}
+
+void test_poll_crc_failure_returns_error(void)
+{
+    sht31_t sensor;
+    const uint8_t data[6] = {0x12, 0x34, 0x00, 0xBE, 0xEF, 0x92};
+    sht31_init(&sensor, &i2c_driver_bus, DEFAULT_ADDRESS);
+
+    begin_measurement(&sensor, SHT_SINGLE_SHOT_MODE_HIGH, 2, 0);
+
+    expect_start_and_send_address_read(true);
+    expect_read_block(data, sizeof(data));
+    i2c_driver_stop_Expect();
+
+    TEST_ASSERT_EQUAL(SHT31_POLL_ERROR, sht31_poll(&sensor, 17));
+}
 
+void test_read_serial_number_combines_both_words(void)
+{
+    const uint8_t data[6] = {0xBE, 0xEF, 0x92, 0x12, 0x34, 0x37};
+    uint32_t serial       = 0;
+
+    expect_start_and_send_address_write(true, true,
+                                        SHT_READ_SERIAL_NUMBER);
+    expect_start_and_send_address_read(true);
+    expect_read_block(data, sizeof(data));
+    i2c_driver_stop_Expect();
+
+    TEST_ASSERT(sht31_read_serial_number(&default_test_sensor, &serial));
+    TEST_ASSERT_EQUAL_HEX32(0xBEEF1234, serial);
+}
+
+void test_read_serial_number_checks_second_word_crc(void)
+{
+    const uint8_t data[6] = {0xBE, 0xEF, 0x92, 0x12, 0x34, 0x38};
+    uint32_t serial       = 0;
+
+    expect_start_and_send_address_write(true, true,
+                                        SHT_READ_SERIAL_NUMBER);
+    expect_start_and_send_address_read(true);
+    expect_read_block(data, sizeof(data));
+    i2c_driver_stop_Expect();
+
+    TEST_ASSERT_FALSE(sht31_read_serial_number(&default_test_sensor, &serial));
+    TEST_ASSERT_EQUAL_HEX32(0, serial);
+    TEST_ASSERT_EQUAL_UINT16(1, default_test_sensor.errors.crc);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Samples
+///////////////////////////////////////////////////////////////////////////////
+
+static void expect_fetch(const uint8_t *data)
+{
+    expect_start_and_send_address_write(true, true, FETCH_DATA);
+    expect_start_and_send_address_read(true);
+    expect_read_block(data, SHT_MEASUREMENT_FRAME_SIZE);
+    i2c_driver_stop_Expect();
+}
+
+void test_sample_is_twelve_bytes(void)
+{
+    TEST_ASSERT_EQUAL(12, sizeof(sht31_sample_t));
+}
+
+void test_fetch_sample_decodes_into_sample(void)
+{
+    const uint8_t data[6] = {0x12, 0x34, 0x37, 0xBE, 0xEF, 0x92};
+    sht31_sample_t sample;
+
+    expect_fetch(data);
+
+    TEST_ASSERT(sht31_fetch_sample(&default_test_sensor, 5000, &sample));
+    TEST_ASSERT_EQUAL_HEX16(0x1234, sample.temperature);
+    TEST_ASSERT_EQUAL_HEX16(0xBEEF, sample.humidity);
+    TEST_ASSERT_EQUAL_UINT32(5000, sample.timestamp_ms);
+    TEST_ASSERT_EQUAL_UINT8(0, sample.sequence);
+    TEST_ASSERT_EQUAL_HEX8(SHT31_SAMPLE_MEASUREMENT_VALID, sample.flags);
+}
+
+void test_fetch_sample_leaves_handle_reading_alone(void)
+{
+    const uint8_t data[6] = {0x12, 0x34, 0x37, 0xBE, 0xEF, 0x92};
+    sht31_sample_t sample;
+
+    expect_fetch(data);
+    sht31_fetch_sample(&default_test_sensor, 0, &sample);
+
+    TEST_ASSERT_EQUAL_HEX16(0, sht31_return_temperature(&default_test_sensor));
+    TEST_ASSERT_EQUAL_HEX16(0, sht31_return_humidity(&default_test_sensor));
+}
+
+void test_fetch_sample_checks_each_word(void)
+{
+    const uint8_t data[6] = {0x12, 0x34, 0x37, 0xBE, 0xEF, 0x00};
+    sht31_sample_t sample;
+
+    expect_fetch(data);
+
+    TEST_ASSERT_FALSE(sht31_fetch_sample(&default_test_sensor, 0, &sample));
+    TEST_ASSERT_EQUAL_HEX8(SHT31_SAMPLE_TEMPERATURE_VALID, sample.flags);
+    TEST_ASSERT_EQUAL_HEX16(0x1234, sample.temperature);
+    TEST_ASSERT_EQUAL_UINT16(1, default_test_sensor.errors.crc);
+}
+
+void test_fetch_sample_nack_leaves_no_valid_values(void)
+{
+    sht31_sample_t sample;
+
+    expect_start_and_send_address_write(false, true, FETCH_DATA);
+    i2c_driver_stop_Expect();
+
+    TEST_ASSERT_FALSE(sht31_fetch_sample(&default_test_sensor, 7, &sample));
+    TEST_ASSERT_EQUAL_HEX8(0, sample.flags);
+    TEST_ASSERT_EQUAL_UINT32(7, sample.timestamp_ms);
+}
+
+void test_sample_sequence_counts_every_attempt(void)
+{
+    const uint8_t data[6] = {0x12, 0x34, 0x37, 0xBE, 0xEF, 0x92};
+    sht31_sample_t sample;
+
+    expect_fetch(data);
+    sht31_fetch_sample(&default_test_sensor, 0, &sample);
+
+    expect_start_and_send_address_write(false, true, FETCH_DATA);
+    i2c_driver_stop_Expect();
+    sht31_fetch_sample(&default_test_sensor, 0, &sample);
+
+    expect_fetch(data);
+    sht31_fetch_sample(&default_test_sensor, 0, &sample);
+    TEST_ASSERT_EQUAL_UINT8(2, sample.sequence);
+}
+
+void test_fetch_samples_fills_one_sample_per_sensor(void)
+{
+    const uint8_t first[6]  = {0x12, 0x34, 0x37, 0xBE, 0xEF, 0x92};
+    const uint8_t second[6] = {0x66, 0x66, 0x93, 0x80, 0x00, 0xA2};
+    sht31_t sensors[3];
+    sht31_sample_t samples[3];
+    uint8_t i = 0;
+
+    for (i = 0; i < 3; i++)
+    {
+        sht31_init(&sensors[i], &i2c_driver_bus, DEFAULT_ADDRESS);
+    }
+
+    expect_fetch(first);
+    expect_start_and_send_address_write(false, true, FETCH_DATA);
+    i2c_driver_stop_Expect();
+    expect_fetch(second);
+
+    TEST_ASSERT_EQUAL_UINT8(2, sht31_fetch_samples(sensors, 3, 100, samples));
+
+    TEST_ASSERT_EQUAL_HEX16(0x1234, samples[0].temperature);
+    TEST_ASSERT_EQUAL_HEX8(0, samples[1].flags);
+    TEST_ASSERT_EQUAL_HEX16(0x6666, samples[2].temperature);
+    TEST_ASSERT_EQUAL_HEX16(0x8000, samples[2].humidity);
+    TEST_ASSERT_EQUAL_UINT32(100, samples[2].timestamp_ms);
+}
+
+void test_read_status_sample_adds_status_to_sample(void)
+{
+    const uint8_t data[6]   = {0x12, 0x34, 0x37, 0xBE, 0xEF, 0x92};
+    const uint8_t status[3] = {0x80, 0x10, 0xE1};
+    sht31_sample_t sample;
+
+    expect_fetch(data);
+    sht31_fetch_sample(&default_test_sensor, 0, &sample);
+
+    expect_start_and_send_address_write(true, true,
+                                        READ_STATUS_ADDRESS);
+    expect_start_and_send_address_read(true);
+    expect_read_block(status, sizeof(status));
+    i2c_driver_stop_Expect();
+
+    TEST_ASSERT(sht31_read_status_sample(&default_test_sensor, &sample));
+    TEST_ASSERT_EQUAL_HEX16(0x8010, sample.status_register);
+    TEST_ASSERT_EQUAL_HEX8(SHT31_SAMPLE_MEASUREMENT_VALID |
+                               SHT31_SAMPLE_STATUS_VALID,
+                           sample.flags);
+    TEST_ASSERT_EQUAL_HEX16(0x1234, sample.temperature);
+}
+
+void test_poll_sample_decodes_result(void)
+{
+    const uint8_t data[6] = {0x12, 0x34, 0x37, 0xBE, 0xEF, 0x92};
+    sht31_sample_t sample;
+
+    begin_measurement(&default_test_sensor, SHT_SINGLE_SHOT_MODE_HIGH, 2, 0);
+    TEST_ASSERT_EQUAL(SHT31_POLL_BUSY,
+                      sht31_poll_sample(&default_test_sensor, 10, &sample));
+
+    expect_start_and_send_address_read(true);
+    expect_read_block(data, sizeof(data));
+    i2c_driver_stop_Expect();
+
+    TEST_ASSERT_EQUAL(SHT31_POLL_DONE,
+                      sht31_poll_sample(&default_test_sensor, 17, &sample));
+    TEST_ASSERT_EQUAL_HEX16(0xBEEF, sample.humidity);
+    TEST_ASSERT_EQUAL_UINT32(17, sample.timestamp_ms);
+}
+
+void test_poll_sample_read_nack_is_an_error(void)
+{
+    sht31_sample_t sample;
+
+    begin_measurement(&default_test_sensor, SHT_SINGLE_SHOT_MODE_HIGH, 2, 0);
+
+    expect_start_and_send_address_read(false);
+    i2c_driver_stop_Expect();
+
+    TEST_ASSERT_EQUAL(SHT31_POLL_ERROR,
+                      sht31_poll_sample(&default_test_sensor, 17, &sample));
+    TEST_ASSERT_EQUAL_HEX8(0, sample.flags);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Instrumentation
+///////////////////////////////////////////////////////////////////////////////
+
+static uint32_t fake_ticks;
+
+static uint32_t fake_clock(void)
+{
+    // Every read moves the clock on, so each timed call takes one tick.
+    return fake_ticks++;
+}
+
+void test_stats_count_periodic_fetch_traffic(void)
+{
+    const uint8_t data[6] = {0x12, 0x34, 0x37, 0xBE, 0xEF, 0x92};
+
+    expect_start_and_send_address_write(true, true, FETCH_DATA);
+    expect_start_and_send_address_read(true);
+    expect_read_block(data, sizeof(data));
+    i2c_driver_stop_Expect();
+
+    TEST_ASSERT(sht31_fetch_periodic_data(&default_test_sensor));
+
+    const sht31_stats_t *stats = sht31_stats(&default_test_sensor);
+    TEST_ASSERT_EQUAL_UINT32(2, stats->starts);
+    TEST_ASSERT_EQUAL_UINT32(4, stats->bytes_written);
+    TEST_ASSERT_EQUAL_UINT32(6, stats->bytes_read);
+    TEST_ASSERT_EQUAL_UINT32(0, stats->nacks);
+    TEST_ASSERT_EQUAL_UINT32(1, stats->calls[SHT31_CALL_FETCH]);
+}
+
+void test_stats_count_nacks_and_crc_failures(void)
+{
+    const uint8_t data[6] = {0xBE, 0xEF, 0x00, 0xBE, 0xEF, 0x92};
+
+    i2c_driver_start_Expect();
+    i2c_driver_send_address_write_ExpectAndReturn(DEFAULT_ADDRESS, false);
+    i2c_driver_stop_Expect();
+    TEST_ASSERT_FALSE(sht31_send_soft_reset(&default_test_sensor));
+
+    expect_start_and_send_address_write(true, true, FETCH_DATA);
+    expect_start_and_send_address_read(true);
+    expect_read_block(data, sizeof(data));
+    i2c_driver_stop_Expect();
+    TEST_ASSERT_FALSE(sht31_fetch_periodic_data(&default_test_sensor));
+
+    const sht31_stats_t *stats = sht31_stats(&default_test_sensor);
+    TEST_ASSERT_EQUAL_UINT32(1, stats->nacks);
+    TEST_ASSERT_EQUAL_UINT32(1, stats->crc_failures);
+    TEST_ASSERT_EQUAL_UINT32(1, stats->calls[SHT31_CALL_SOFT_RESET]);
+    TEST_ASSERT_EQUAL_UINT32(1, stats->calls[SHT31_CALL_FETCH]);
+}
+
+void test_stats_count_polling_nacks_as_retries(void)
+{
+    const uint8_t data[6] = {0x12, 0x34, 0x37, 0xBE, 0xEF, 0x92};
+
+    expect_start_and_send_address_write(true, true,
+                                        SHT_SINGLE_SHOT_MODE_HIGH);
+    i2c_driver_stop_Expect();
+    expect_start_and_send_address_read(false);
+    i2c_driver_stop_Expect();
+    expect_start_and_send_address_read(false);
+    i2c_driver_stop_Expect();
+    expect_start_and_send_address_read(true);
+    expect_read_block(data, sizeof(data));
+    i2c_driver_stop_Expect();
+
+    TEST_ASSERT(sht31_get_single_shot_data_in_mode(&default_test_sensor, 2,
+                                                   false));
+
+    const sht31_stats_t *stats = sht31_stats(&default_test_sensor);
+    TEST_ASSERT_EQUAL_UINT32(2, stats->retries);
+    TEST_ASSERT_EQUAL_UINT32(2, stats->nacks);
+    TEST_ASSERT_EQUAL_UINT32(4, stats->starts);
+    TEST_ASSERT_EQUAL_UINT16(0, default_test_sensor.errors.nack);
+}
+
+void test_stats_time_each_public_call_with_clock(void)
+{
+    fake_ticks = 0;
+    sht31_stats_set_clock(fake_clock);
+
+    TEST_ASSERT_EQUAL(SHT31_POLL_IDLE, sht31_poll(&default_test_sensor, 0));
+    TEST_ASSERT_EQUAL(SHT31_POLL_IDLE, sht31_poll(&default_test_sensor, 0));
+
+    sht31_stats_set_clock(NULL);
+
+    const sht31_stats_t *stats = sht31_stats(&default_test_sensor);
+    TEST_ASSERT_EQUAL_UINT32(2, stats->calls[SHT31_CALL_POLL]);
+    TEST_ASSERT_EQUAL_UINT32(2, stats->call_ticks[SHT31_CALL_POLL]);
+}
+
+void test_stats_reset_clears_counters(void)
+{
+    i2c_driver_start_Expect();
+    i2c_driver_send_address_write_ExpectAndReturn(DEFAULT_ADDRESS, false);
+    i2c_driver_stop_Expect();
+    sht31_send_soft_reset(&default_test_sensor);
+
+    sht31_stats_reset(&default_test_sensor);
+
+    const sht31_stats_t *stats = sht31_stats(&default_test_sensor);
+    TEST_ASSERT_EQUAL_UINT32(0, stats->starts);
+    TEST_ASSERT_EQUAL_UINT32(0, stats->nacks);
+    TEST_ASSERT_EQUAL_UINT32(0, stats->calls[SHT31_CALL_SOFT_RESET]);
+}
@@ -0,0 +1,295 @@
+/**
+ * @file        test_sht31_heater.c
+ * @author      Steven Daglish
+ * @brief
+ * @version     0.1
+ * @date        17 October 2026
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+// Test list
+// ---------
+//
+// Starting a cycle confirms the heater came on
+// Bursts and cool downs follow the configured times
+// Failed heater commands are retried on the next service
+// Readings taken while heating or cooling are rejected
+// High humidity starts a cycle
+// A sampling loop keeps running through a cycle
+///////////////////////////////////////////////////////////////////////////////
+
+#include "unity.h"
+#include "sht31_heater.h"
+#include "sht31_driver.h"
+#include "i2c_sim.h"
+#include "i2c_driver_sim.h"
+#include "crc8.h"
+#include "i2c_bus.h"
+
+#define HEATER_BIT 0x2000
+#define TEMPERATURE 0x6666
+#define DRY_HUMIDITY 0x8000
+#define WET_HUMIDITY 0xFD00
+#define HEATER_RISE 0x0300
+
+static i2c_sim_t sim;
+static i2c_bus_t bus;
+static i2c_sim_device_t *device;
+static sht31_t sensor;
+static sht31_heater_t heater;
+static sht31_heater_config_t config;
+
+static bool sim_heater_on(void)
+{
+    return 0 != (device->status_register & HEATER_BIT);
+}
+
+static void init_heater(uint32_t burst_ms, uint32_t cooldown_ms,
+                        uint8_t bursts)
+{
+    config.burst_ms    = burst_ms;
+    config.cooldown_ms = cooldown_ms;
+    config.bursts      = bursts;
+    sht31_heater_init(&heater, &sensor, &config);
+}
+
+void setUp(void)
+{
+    i2c_sim_init(&sim, I2C_SIM_400KHZ, &bus);
+    device = i2c_sim_add_sht31(&sim, DEFAULT_ADDRESS);
+    i2c_sim_set_environment(device, TEMPERATURE, DRY_HUMIDITY);
+    sht31_init(&sensor, &bus, DEFAULT_ADDRESS);
+
+    sht31_heater_default_config(&config);
+    init_heater(1000, 2000, 2);
+}
+
+void tearDown(void)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Starting and stopping
+///////////////////////////////////////////////////////////////////////////////
+
+void test_idle_service_sends_nothing(void)
+{
+    TEST_ASSERT_EQUAL(SHT31_HEATER_IDLE, sht31_heater_service(&heater, 5000));
+    TEST_ASSERT_EQUAL_UINT32(0, sim.starts);
+}
+
+void test_start_turns_heater_on_and_confirms_it(void)
+{
+    TEST_ASSERT_TRUE(sht31_heater_start(&heater, 0));
+
+    TEST_ASSERT_TRUE(sim_heater_on());
+    TEST_ASSERT_EQUAL(SHT31_HEATER_HEATING, sht31_heater_state(&heater));
+    TEST_ASSERT_EQUAL_UINT32(1, heater.bursts);
+
+    // Heater command, then status read.
+    TEST_ASSERT_EQUAL_UINT32(2, sim.stops);
+}
+
+void test_start_while_running_returns_false(void)
+{
+    sht31_heater_start(&heater, 0);
+
+    TEST_ASSERT_FALSE(sht31_heater_start(&heater, 10));
+    TEST_ASSERT_EQUAL_UINT32(1, heater.bursts);
+}
+
+void test_start_fails_when_heater_does_not_come_on(void)
+{
+    device->nack_address = 1;
+
+    TEST_ASSERT_FALSE(sht31_heater_start(&heater, 0));
+
+    TEST_ASSERT_FALSE(sim_heater_on());
+    TEST_ASSERT_EQUAL(SHT31_HEATER_IDLE, sht31_heater_state(&heater));
+    TEST_ASSERT_EQUAL_UINT32(1, heater.failures);
+}
+
+void test_stop_ends_burst_and_cools_down(void)
+{
+    sht31_heater_start(&heater, 0);
+
+    TEST_ASSERT_TRUE(sht31_heater_stop(&heater, 300));
+
+    TEST_ASSERT_FALSE(sim_heater_on());
+    TEST_ASSERT_EQUAL(SHT31_HEATER_COOLING, sht31_heater_state(&heater));
+    TEST_ASSERT_EQUAL(SHT31_HEATER_COOLING,
+                      sht31_heater_service(&heater, 2299));
+    TEST_ASSERT_EQUAL(SHT31_HEATER_IDLE, sht31_heater_service(&heater, 2300));
+    TEST_ASSERT_EQUAL_UINT32(1, heater.bursts);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Cycle timing
+///////////////////////////////////////////////////////////////////////////////
+
+void test_cycle_runs_each_burst_and_cool_down(void)
+{
+    sht31_heater_start(&heater, 0);
+
+    TEST_ASSERT_EQUAL(SHT31_HEATER_HEATING, sht31_heater_service(&heater, 999));
+    TEST_ASSERT_EQUAL(SHT31_HEATER_COOLING,
+                      sht31_heater_service(&heater, 1000));
+    TEST_ASSERT_FALSE(sim_heater_on());
+
+    TEST_ASSERT_EQUAL(SHT31_HEATER_COOLING,
+                      sht31_heater_service(&heater, 2999));
+    TEST_ASSERT_EQUAL(SHT31_HEATER_HEATING,
+                      sht31_heater_service(&heater, 3000));
+    TEST_ASSERT_TRUE(sim_heater_on());
+
+    TEST_ASSERT_EQUAL(SHT31_HEATER_COOLING,
+                      sht31_heater_service(&heater, 4000));
+    TEST_ASSERT_EQUAL(SHT31_HEATER_IDLE, sht31_heater_service(&heater, 6000));
+
+    TEST_ASSERT_FALSE(sim_heater_on());
+    TEST_ASSERT_EQUAL_UINT32(2, heater.bursts);
+    TEST_ASSERT_EQUAL_UINT32(1, heater.cycles);
+    TEST_ASSERT_EQUAL_UINT32(0, heater.failures);
+}
+
+void test_service_between_phase_ends_sends_nothing(void)
+{
+    uint32_t now_ms = 0;
+
+    sht31_heater_start(&heater, 0);
+    i2c_sim_reset_counters(&sim);
+
+    for (now_ms = 1; now_ms < 1000; now_ms++)
+    {
+        sht31_heater_service(&heater, now_ms);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, sim.starts);
+}
+
+void test_cycle_handles_millisecond_counter_wrapping(void)
+{
+    sht31_heater_start(&heater, 0xFFFFFF00);
+
+    TEST_ASSERT_EQUAL(SHT31_HEATER_HEATING, sht31_heater_service(&heater, 10));
+    TEST_ASSERT_EQUAL(SHT31_HEATER_COOLING,
+                      sht31_heater_service(&heater, 1000));
+}
+
+void test_failed_heater_off_is_retried_on_next_service(void)
+{
+    sht31_heater_start(&heater, 0);
+    device->nack_address = 1;
+
+    TEST_ASSERT_EQUAL(SHT31_HEATER_HEATING,
+                      sht31_heater_service(&heater, 1000));
+    TEST_ASSERT_EQUAL_UINT32(1, heater.failures);
+
+    TEST_ASSERT_EQUAL(SHT31_HEATER_COOLING,
+                      sht31_heater_service(&heater, 1001));
+    TEST_ASSERT_FALSE(sim_heater_on());
+}
+
+void test_unconfirmed_heater_off_is_retried(void)
+{
+    sht31_heater_start(&heater, 0);
+
+    // The command goes through but the status read back is corrupt.
+    device->corrupt_crc = 1;
+
+    TEST_ASSERT_EQUAL(SHT31_HEATER_HEATING,
+                      sht31_heater_service(&heater, 1000));
+    TEST_ASSERT_EQUAL(SHT31_HEATER_COOLING,
+                      sht31_heater_service(&heater, 1001));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Readings
+///////////////////////////////////////////////////////////////////////////////
+
+void test_readings_rejected_while_heating_and_cooling(void)
+{
+    TEST_ASSERT_TRUE(sht31_heater_accept(&heater, DRY_HUMIDITY, 0));
+
+    sht31_heater_start(&heater, 0);
+    TEST_ASSERT_FALSE(sht31_heater_accept(&heater, DRY_HUMIDITY, 500));
+
+    sht31_heater_service(&heater, 1000);
+    TEST_ASSERT_FALSE(sht31_heater_accept(&heater, DRY_HUMIDITY, 1500));
+
+    sht31_heater_stop(&heater, 1500);
+    sht31_heater_service(&heater, 3000);
+    TEST_ASSERT_TRUE(sht31_heater_accept(&heater, DRY_HUMIDITY, 3000));
+
+    TEST_ASSERT_EQUAL_UINT32(2, heater.rejected);
+}
+
+void test_high_humidity_starts_a_cycle(void)
+{
+    TEST_ASSERT_FALSE(sht31_heater_accept(&heater, WET_HUMIDITY, 0));
+
+    TEST_ASSERT_EQUAL(SHT31_HEATER_HEATING, sht31_heater_state(&heater));
+    TEST_ASSERT_TRUE(sim_heater_on());
+}
+
+void test_no_trigger_humidity_never_starts_a_cycle(void)
+{
+    config.trigger_humidity = 0;
+    sht31_heater_init(&heater, &sensor, &config);
+
+    TEST_ASSERT_TRUE(sht31_heater_accept(&heater, 0xFFFF, 0));
+    TEST_ASSERT_EQUAL(SHT31_HEATER_IDLE, sht31_heater_state(&heater));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// In a sampling loop
+///////////////////////////////////////////////////////////////////////////////
+
+void test_sampling_carries_on_through_a_cycle(void)
+{
+    uint32_t now_ms   = 0;
+    uint32_t fetched  = 0;
+    uint32_t accepted = 0;
+
+    device->heater_rise = HEATER_RISE;
+    i2c_sim_set_environment(device, TEMPERATURE, WET_HUMIDITY);
+    init_heater(3000, 5000, 2);
+    TEST_ASSERT(sht31_send_periodic_data_acquisition_mode(&sensor, 2, 3));
+
+    for (now_ms = 0; now_ms < 30000; now_ms++)
+    {
+        uint64_t now_ns = (uint64_t)now_ms * 1000000u;
+
+        i2c_sim_advance_ns(&sim, now_ns - i2c_sim_time_ns(&sim));
+
+        // The water has gone by the end of the first burst.
+        if (2000 == now_ms)
+        {
+            i2c_sim_set_environment(device, TEMPERATURE, DRY_HUMIDITY);
+        }
+
+        sht31_heater_service(&heater, now_ms);
+
+        if ((0 != (now_ms % 250)) ||
+            (false == sht31_fetch_periodic_data(&sensor)))
+        {
+            continue;
+        }
+        fetched++;
+
+        if (sht31_heater_accept(&heater, sht31_return_humidity(&sensor),
+                                now_ms))
+        {
+            accepted++;
+            TEST_ASSERT_EQUAL_HEX16(TEMPERATURE,
+                                    sht31_return_temperature(&sensor));
+        }
+    }
+
+    // Readings kept coming at the full rate; those from the two bursts and
+    // cool downs (16 s) and the wet reading that started it were dropped.
+    TEST_ASSERT_EQUAL_UINT32(119, fetched);
+    TEST_ASSERT_EQUAL_UINT32(1, heater.cycles);
+    TEST_ASSERT_EQUAL_UINT32(fetched - 64, accepted);
+    TEST_ASSERT_FALSE(sim_heater_on());
+}
@@ -0,0 +1,437 @@
+/**
+ * @file        test_sht31_log.c
+ * @author      Steven Daglish
+ * @brief
+ * @version     0.1
+ * @date        17 October 2026
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+// Test list
+// ---------
+//
+// Readings come back exactly as written, across blocks and wraps
+// Slowly changing 10 Hz readings are at least 4x smaller than raw
+// Damaged and truncated blocks are skipped
+// Seeking by timestamp
+// Failed writes
+// Reading a mapped file
+///////////////////////////////////////////////////////////////////////////////
+
+#include "unity.h"
+#include "crc8.h"
+#include "sht31_log.h"
+#include "sht31_log_file.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define MAX_READINGS 40000
+#define RAW_READING_SIZE 8
+
+static uint8_t log_data[MAX_READINGS * 2];
+static uint32_t log_length;
+static uint32_t blocks_written;
+static bool refuse_writes;
+
+static sht31_reading_t readings[MAX_READINGS];
+static sht31_log_encoder_t encoder;
+static sht31_log_reader_t reader;
+
+static bool store_block(void *context, const uint8_t *data, uint16_t length)
+{
+    (void)context;
+
+    if (refuse_writes || (log_length + length > sizeof(log_data)))
+    {
+        return false;
+    }
+    memcpy(&log_data[log_length], data, length);
+    log_length += length;
+    blocks_written++;
+
+    return true;
+}
+
+/*
+ * 10 Hz readings drifting slowly with a little noise, as a sensor on a desk
+ * gives.
+ */
+static void make_steady_readings(uint32_t count)
+{
+    uint32_t seed = 12345;
+    uint32_t i    = 0;
+
+    for (i = 0; i < count; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+
+        readings[i].timestamp_ms = 1000 + i * 100;
+        readings[i].temperature  = 26000 + i / 50 + ((seed >> 16) % 3);
+        readings[i].humidity     = 30000 - i / 80 + ((seed >> 20) % 7);
+    }
+}
+
+static void encode(uint32_t count, uint8_t block_readings)
+{
+    uint32_t i = 0;
+
+    TEST_ASSERT_TRUE(sht31_log_encoder_init(&encoder, block_readings,
+                                            store_block, NULL));
+    for (i = 0; i < count; i++)
+    {
+        TEST_ASSERT_TRUE(sht31_log_append(&encoder, &readings[i]));
+    }
+    TEST_ASSERT_TRUE(sht31_log_flush(&encoder));
+
+    sht31_log_reader_init(&reader, log_data, log_length);
+}
+
+static void assert_reading(const sht31_reading_t *expected,
+                           const sht31_reading_t *actual)
+{
+    TEST_ASSERT_EQUAL_UINT32(expected->timestamp_ms, actual->timestamp_ms);
+    TEST_ASSERT_EQUAL_HEX16(expected->temperature, actual->temperature);
+    TEST_ASSERT_EQUAL_HEX16(expected->humidity, actual->humidity);
+}
+
+static void assert_reads_back(uint32_t first, uint32_t count)
+{
+    sht31_reading_t reading;
+    uint32_t i = 0;
+
+    for (i = first; i < first + count; i++)
+    {
+        TEST_ASSERT_TRUE(sht31_log_read(&reader, &reading));
+        assert_reading(&readings[i], &reading);
+    }
+    TEST_ASSERT_FALSE(sht31_log_read(&reader, &reading));
+}
+
+void setUp(void)
+{
+    log_length     = 0;
+    blocks_written = 0;
+    refuse_writes  = false;
+    memset(readings, 0, sizeof(readings));
+}
+
+void tearDown(void)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Round trips
+///////////////////////////////////////////////////////////////////////////////
+
+void test_empty_log_has_no_readings(void)
+{
+    sht31_reading_t reading;
+
+    encode(0, 16);
+
+    TEST_ASSERT_EQUAL_UINT32(0, log_length);
+    TEST_ASSERT_FALSE(sht31_log_read(&reader, &reading));
+}
+
+void test_single_reading_round_trips(void)
+{
+    readings[0].timestamp_ms = 0xDEADBEEF;
+    readings[0].temperature  = 0x6666;
+    readings[0].humidity     = 0xA0A0;
+
+    encode(1, 16);
+
+    TEST_ASSERT_EQUAL_UINT32(1, blocks_written);
+    assert_reads_back(0, 1);
+}
+
+void test_irregular_readings_round_trip_across_blocks(void)
+{
+    uint32_t seed = 1;
+    uint32_t i    = 0;
+
+    // Large jumps, wrapping words and uneven, sometimes repeated timestamps.
+    for (i = 0; i < 1000; i++)
+    {
+        seed = seed * 1103515245u + 12345u;
+
+        readings[i].temperature = (i % 7) ? (uint16_t)(seed >> 8) : 0xFFFF;
+        readings[i].humidity    = (i % 5) ? (uint16_t)(seed >> 16) : 0x0000;
+        readings[i].timestamp_ms =
+            (i ? readings[i - 1].timestamp_ms : 0) + ((seed >> 24) % 4) * 333;
+    }
+
+    encode(1000, 64);
+
+    TEST_ASSERT_EQUAL_UINT32(16, blocks_written);
+    assert_reads_back(0, 1000);
+    TEST_ASSERT_EQUAL_UINT32(0, sht31_log_corrupt_blocks(&reader));
+}
+
+void test_timestamp_wrap_round_trips(void)
+{
+    uint32_t i = 0;
+
+    make_steady_readings(100);
+    for (i = 0; i < 100; i++)
+    {
+        readings[i].timestamp_ms = 0xFFFFF000u + i * 100;
+    }
+
+    encode(100, 32);
+
+    assert_reads_back(0, 100);
+}
+
+void test_every_block_size_round_trips(void)
+{
+    uint8_t block_readings = 0;
+
+    make_steady_readings(200);
+
+    for (block_readings = 1; block_readings <= SHT31_LOG_MAX_BLOCK_READINGS;
+         block_readings++)
+    {
+        log_length = 0;
+        encode(200, block_readings);
+        assert_reads_back(0, 200);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Size
+///////////////////////////////////////////////////////////////////////////////
+
+void test_steady_readings_are_at_least_four_times_smaller_than_raw(void)
+{
+    make_steady_readings(36000);
+
+    encode(36000, SHT31_LOG_MAX_BLOCK_READINGS);
+
+    TEST_ASSERT_EQUAL_UINT32(log_length, sht31_log_bytes(&encoder));
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(36000 * RAW_READING_SIZE / 4, log_length);
+    assert_reads_back(0, 36000);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Damage
+///////////////////////////////////////////////////////////////////////////////
+
+void test_damaged_block_is_skipped_and_counted(void)
+{
+    sht31_reading_t reading;
+    uint32_t block_size = 0;
+    uint32_t i          = 0;
+
+    make_steady_readings(64);
+    encode(64, 16);
+    block_size = log_length / 4;
+
+    // Flip a bit in the second block's payload.
+    log_data[block_size + SHT31_LOG_HEADER_SIZE + 10] ^= 0x04;
+
+    for (i = 0; i < 16; i++)
+    {
+        TEST_ASSERT_TRUE(sht31_log_read(&reader, &reading));
+        assert_reading(&readings[i], &reading);
+    }
+    for (i = 32; i < 64; i++)
+    {
+        TEST_ASSERT_TRUE(sht31_log_read(&reader, &reading));
+        assert_reading(&readings[i], &reading);
+    }
+    TEST_ASSERT_FALSE(sht31_log_read(&reader, &reading));
+    TEST_ASSERT_EQUAL_UINT32(1, sht31_log_corrupt_blocks(&reader));
+}
+
+void test_damaged_header_is_skipped_and_counted(void)
+{
+    sht31_reading_t reading;
+    uint32_t i = 0;
+
+    make_steady_readings(48);
+    encode(48, 16);
+    log_data[0] = 0x00;
+
+    for (i = 16; i < 48; i++)
+    {
+        TEST_ASSERT_TRUE(sht31_log_read(&reader, &reading));
+        assert_reading(&readings[i], &reading);
+    }
+    TEST_ASSERT_FALSE(sht31_log_read(&reader, &reading));
+    TEST_ASSERT_EQUAL_UINT32(1, sht31_log_corrupt_blocks(&reader));
+}
+
+void test_truncated_last_block_is_ignored(void)
+{
+    make_steady_readings(40);
+    encode(40, 16);
+
+    // Lose the end of the last block, e.g. power failed mid write.
+    sht31_log_reader_init(&reader, log_data, log_length - 3);
+
+    assert_reads_back(0, 32);
+    TEST_ASSERT_EQUAL_UINT32(1, sht31_log_corrupt_blocks(&reader));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Seeking
+///////////////////////////////////////////////////////////////////////////////
+
+void test_seek_returns_first_reading_at_or_after_time(void)
+{
+    sht31_reading_t reading;
+
+    make_steady_readings(1000);
+    encode(1000, 64);
+
+    // Exactly on a reading in the middle of a block.
+    TEST_ASSERT_TRUE(sht31_log_seek(&reader, readings[500].timestamp_ms));
+    TEST_ASSERT_TRUE(sht31_log_read(&reader, &reading));
+    assert_reading(&readings[500], &reading);
+
+    // Between readings.
+    TEST_ASSERT_TRUE(sht31_log_seek(&reader, readings[700].timestamp_ms - 1));
+    TEST_ASSERT_TRUE(sht31_log_read(&reader, &reading));
+    assert_reading(&readings[700], &reading);
+
+    // On a keyframe, and going backwards.
+    TEST_ASSERT_TRUE(sht31_log_seek(&reader, readings[128].timestamp_ms));
+    assert_reads_back(128, 872);
+
+    // Before the start.
+    TEST_ASSERT_TRUE(sht31_log_seek(&reader, 0));
+    TEST_ASSERT_TRUE(sht31_log_read(&reader, &reading));
+    assert_reading(&readings[0], &reading);
+}
+
+void test_seek_past_end_fails(void)
+{
+    make_steady_readings(100);
+    encode(100, 64);
+
+    TEST_ASSERT_FALSE(
+        sht31_log_seek(&reader, readings[99].timestamp_ms + 1));
+}
+
+void test_seek_reads_through_a_damaged_block(void)
+{
+    sht31_reading_t reading;
+
+    make_steady_readings(64);
+    encode(64, 16);
+    log_data[(log_length / 4) + SHT31_LOG_HEADER_SIZE + 2] ^= 0x80;
+
+    // The reading wanted is in the damaged block, so the next good one is
+    // returned.
+    TEST_ASSERT_TRUE(sht31_log_seek(&reader, readings[20].timestamp_ms));
+    TEST_ASSERT_TRUE(sht31_log_read(&reader, &reading));
+    assert_reading(&readings[32], &reading);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Writing
+///////////////////////////////////////////////////////////////////////////////
+
+void test_init_rejects_bad_block_size(void)
+{
+    TEST_ASSERT_FALSE(sht31_log_encoder_init(&encoder, 0, store_block, NULL));
+    TEST_ASSERT_FALSE(sht31_log_encoder_init(
+        &encoder, SHT31_LOG_MAX_BLOCK_READINGS + 1, store_block, NULL));
+}
+
+void test_failed_write_drops_block_and_next_block_decodes(void)
+{
+    uint32_t i = 0;
+
+    make_steady_readings(48);
+    TEST_ASSERT_TRUE(sht31_log_encoder_init(&encoder, 16, store_block, NULL));
+
+    for (i = 0; i < 48; i++)
+    {
+        refuse_writes = (i >= 16) && (i < 32);
+        TEST_ASSERT_EQUAL(i != 31, sht31_log_append(&encoder, &readings[i]));
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, encoder.failed_blocks);
+
+    sht31_log_reader_init(&reader, log_data, log_length);
+    for (i = 0; i < 48; i++)
+    {
+        sht31_reading_t reading;
+
+        if ((i >= 16) && (i < 32))
+        {
+            continue;
+        }
+        TEST_ASSERT_TRUE(sht31_log_read(&reader, &reading));
+        assert_reading(&readings[i], &reading);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, sht31_log_corrupt_blocks(&reader));
+}
+
+void test_flush_of_empty_block_writes_nothing(void)
+{
+    TEST_ASSERT_TRUE(sht31_log_encoder_init(&encoder, 16, store_block, NULL));
+
+    TEST_ASSERT_TRUE(sht31_log_flush(&encoder));
+    TEST_ASSERT_EQUAL_UINT32(0, blocks_written);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Mapped file
+///////////////////////////////////////////////////////////////////////////////
+
+void test_file_reader_maps_and_seeks(void)
+{
+    char path[]  = "/tmp/test_sht31_log_XXXXXX";
+    int fd       = mkstemp(path);
+    FILE *stream = NULL;
+    sht31_log_file_t file;
+    sht31_reading_t reading;
+
+    TEST_ASSERT_TRUE(fd >= 0);
+    make_steady_readings(5000);
+    encode(5000, 64);
+
+    stream = fdopen(fd, "wb");
+    TEST_ASSERT_EQUAL(log_length, fwrite(log_data, 1, log_length, stream));
+    fclose(stream);
+
+    TEST_ASSERT_TRUE(sht31_log_file_open(&file, path));
+    unlink(path);
+
+    TEST_ASSERT_TRUE(
+        sht31_log_seek(sht31_log_file_reader(&file), readings[4321].timestamp_ms));
+    TEST_ASSERT_TRUE(sht31_log_read(sht31_log_file_reader(&file), &reading));
+    assert_reading(&readings[4321], &reading);
+
+    sht31_log_file_close(&file);
+}
+
+void test_file_reader_accepts_empty_file(void)
+{
+    char path[] = "/tmp/test_sht31_log_XXXXXX";
+    int fd      = mkstemp(path);
+    sht31_log_file_t file;
+    sht31_reading_t reading;
+
+    TEST_ASSERT_TRUE(fd >= 0);
+    close(fd);
+
+    TEST_ASSERT_TRUE(sht31_log_file_open(&file, path));
+    unlink(path);
+
+    TEST_ASSERT_FALSE(sht31_log_read(sht31_log_file_reader(&file), &reading));
+    sht31_log_file_close(&file);
+}
+
+void test_file_reader_fails_on_missing_file(void)
+{
+    sht31_log_file_t file;
+
+    TEST_ASSERT_FALSE(
+        sht31_log_file_open(&file, "/tmp/test_sht31_log_does_not_exist"));
+}
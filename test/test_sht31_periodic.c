@@ -0,0 +1,205 @@
+/**
+ * @file        test_sht31_periodic.c
+ * @author      Steven Daglish
+ * @brief
+ * @version     0.1
+ * @date        17 October 2026
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+// Test list
+// ---------
+//
+// Starting periodic and ART modes
+// Fetching on schedule and queueing timestamped readings
+// Failed fetches and full buffers
+// Stopping
+///////////////////////////////////////////////////////////////////////////////
+
+#include "unity.h"
+#include "sht31_periodic.h"
+#include "sht31_driver.h"
+#include "sht31_ring_buffer.h"
+#include "crc8.h"
+#include "i2c_bus.h"
+#include "mock_i2c_driver.h"
+
+static sht31_t sensor;
+static sht31_reading_t storage[4];
+static sht31_ring_buffer_t ring;
+static sht31_periodic_t periodic;
+
+// CMock keeps a pointer to the expected bytes, so each command gets its own.
+#define EXPECTED_COMMANDS 16
+static uint8_t expected_commands[EXPECTED_COMMANDS][2];
+static uint8_t expected_command_count;
+
+static void expect_command_bytes(uint16_t command)
+{
+    uint8_t *expected = expected_commands[expected_command_count++];
+
+    expected[0] = command >> 8;
+    expected[1] = command & 0x00FF;
+    i2c_driver_start_Expect();
+    i2c_driver_send_address_write_ExpectAndReturn(DEFAULT_ADDRESS, true);
+    i2c_driver_write_block_ExpectWithArrayAndReturn(expected, 2, 2, true);
+}
+
+static void expect_command(uint16_t command)
+{
+    expect_command_bytes(command);
+    i2c_driver_stop_Expect();
+}
+
+static void expect_fetch(const uint8_t *data)
+{
+    expect_command_bytes(FETCH_DATA);
+    i2c_driver_start_Expect();
+    i2c_driver_send_address_read_ExpectAndReturn(DEFAULT_ADDRESS, true);
+    i2c_driver_read_block_ExpectAndReturn(NULL, 6, true);
+    i2c_driver_read_block_IgnoreArg_data();
+    i2c_driver_read_block_ReturnArrayThruPtr_data((uint8_t *)data, 6);
+    i2c_driver_stop_Expect();
+}
+
+static void start_10_mps(uint32_t now_ms)
+{
+    expect_command(0x2737);
+    TEST_ASSERT(sht31_periodic_start(&periodic, &sensor, &ring, 2, 4, now_ms));
+}
+
+void setUp(void)
+{
+    expected_command_count = 0;
+    sht31_init(&sensor, &i2c_driver_bus, DEFAULT_ADDRESS);
+    sht31_ring_buffer_init(&ring, storage, 4);
+}
+
+void tearDown(void)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Starting
+///////////////////////////////////////////////////////////////////////////////
+
+void test_start_sends_periodic_mode_command(void)
+{
+    start_10_mps(0);
+}
+
+void test_start_nack_returns_false_and_does_not_fetch(void)
+{
+    i2c_driver_start_Expect();
+    i2c_driver_send_address_write_ExpectAndReturn(DEFAULT_ADDRESS, false);
+    i2c_driver_stop_Expect();
+
+    TEST_ASSERT_FALSE(
+        sht31_periodic_start(&periodic, &sensor, &ring, 2, 4, 0));
+    TEST_ASSERT_FALSE(sht31_periodic_service(&periodic, 1000));
+}
+
+void test_start_art_sends_art_command(void)
+{
+    expect_command(ART_COMMAND_ADDRESS);
+
+    TEST_ASSERT(sht31_periodic_start_art(&periodic, &sensor, &ring, 0));
+    TEST_ASSERT_EQUAL_UINT32(SHT31_ART_PERIOD_MS, periodic.period_ms);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Servicing
+///////////////////////////////////////////////////////////////////////////////
+
+void test_service_before_period_does_nothing(void)
+{
+    start_10_mps(1000);
+
+    TEST_ASSERT_FALSE(sht31_periodic_service(&periodic, 1099));
+}
+
+void test_service_fetches_and_queues_timestamped_reading(void)
+{
+    const uint8_t data[6] = {0x12, 0x34, 0x37, 0xBE, 0xEF, 0x92};
+    sht31_reading_t out[4];
+
+    start_10_mps(1000);
+    expect_fetch(data);
+
+    TEST_ASSERT(sht31_periodic_service(&periodic, 1100));
+
+    TEST_ASSERT_EQUAL_UINT16(1, sht31_ring_buffer_pop_batch(&ring, out, 4));
+    TEST_ASSERT_EQUAL_UINT32(1100, out[0].timestamp_ms);
+    TEST_ASSERT_EQUAL_HEX16(0x1234, out[0].temperature);
+    TEST_ASSERT_EQUAL_HEX16(0xBEEF, out[0].humidity);
+}
+
+void test_service_fetches_once_per_period(void)
+{
+    const uint8_t data[6] = {0x12, 0x34, 0x37, 0xBE, 0xEF, 0x92};
+
+    start_10_mps(0);
+    expect_fetch(data);
+    expect_fetch(data);
+
+    TEST_ASSERT(sht31_periodic_service(&periodic, 100));
+    TEST_ASSERT_FALSE(sht31_periodic_service(&periodic, 150));
+    TEST_ASSERT(sht31_periodic_service(&periodic, 200));
+    TEST_ASSERT_EQUAL_UINT16(2, sht31_ring_buffer_count(&ring));
+}
+
+void test_service_late_resynchronises_instead_of_catching_up(void)
+{
+    const uint8_t data[6] = {0x12, 0x34, 0x37, 0xBE, 0xEF, 0x92};
+
+    start_10_mps(0);
+    expect_fetch(data);
+
+    TEST_ASSERT(sht31_periodic_service(&periodic, 550));
+    TEST_ASSERT_FALSE(sht31_periodic_service(&periodic, 600));
+    TEST_ASSERT_EQUAL_UINT32(650, periodic.next_fetch_ms);
+}
+
+void test_service_crc_failure_queues_nothing(void)
+{
+    const uint8_t data[6] = {0x12, 0x34, 0x00, 0xBE, 0xEF, 0x92};
+
+    start_10_mps(0);
+    expect_fetch(data);
+
+    TEST_ASSERT_FALSE(sht31_periodic_service(&periodic, 100));
+    TEST_ASSERT_EQUAL_UINT16(0, sht31_ring_buffer_count(&ring));
+}
+
+void test_service_with_full_ring_drops_reading(void)
+{
+    const uint8_t data[6] = {0x12, 0x34, 0x37, 0xBE, 0xEF, 0x92};
+    uint32_t now          = 0;
+
+    start_10_mps(0);
+    for (now = 100; now <= 500; now += 100)
+    {
+        expect_fetch(data);
+    }
+
+    for (now = 100; now <= 400; now += 100)
+    {
+        TEST_ASSERT(sht31_periodic_service(&periodic, now));
+    }
+    TEST_ASSERT_FALSE(sht31_periodic_service(&periodic, 500));
+    TEST_ASSERT_EQUAL_UINT16(1, sht31_ring_buffer_dropped(&ring));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Stopping
+///////////////////////////////////////////////////////////////////////////////
+
+void test_stop_sends_break_and_stops_fetching(void)
+{
+    start_10_mps(0);
+    expect_command(BREAK_COMMAND_ADDRESS);
+
+    TEST_ASSERT(sht31_periodic_stop(&periodic));
+    TEST_ASSERT_FALSE(sht31_periodic_service(&periodic, 1000));
+}
@@ -0,0 +1,348 @@
+/**
+ * @file        test_sht31_power.c
+ * @author      Steven Daglish
+ * @brief
+ * @version     0.1
+ * @date        17 October 2026
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+// Test list
+// ---------
+//
+// Configurations are checked before use
+// Energy estimates match the datasheet typical figures
+// Periodic mode fetches once a period
+// Single shot mode starts a burst once a period and never uses periodic mode
+// Sleep times cover the period and the latency
+// A sleep driven loop keeps to the period and latency
+// Reconfiguring and stopping send a break
+///////////////////////////////////////////////////////////////////////////////
+
+#include "unity.h"
+#include "sht31_power.h"
+#include "sht31_driver.h"
+#include "i2c_sim.h"
+#include "i2c_driver_sim.h"
+#include "crc8.h"
+#include "i2c_bus.h"
+
+#define TEMPERATURE 0x6666
+#define HUMIDITY 0x8000
+
+static i2c_sim_t sim;
+static i2c_bus_t bus;
+static i2c_sim_device_t *device;
+static sht31_t sensor;
+static sht31_power_t power;
+static sht31_power_config_t config;
+
+static uint32_t now_ms(void)
+{
+    return (uint32_t)(i2c_sim_time_ns(&sim) / 1000000u);
+}
+
+/*
+ * Services once a millisecond until until_ms, counting new samples.
+ */
+static uint32_t run_until(uint32_t until_ms)
+{
+    uint32_t samples = 0;
+
+    while (now_ms() < until_ms)
+    {
+        if (SHT31_POLL_DONE == sht31_power_service(&power, now_ms()))
+        {
+            samples++;
+        }
+        i2c_sim_advance_ms(&sim, 1);
+    }
+    return samples;
+}
+
+static void init_power(sht31_power_mode_t mode, uint32_t period_ms)
+{
+    config.mode             = mode;
+    config.sample_period_ms = period_ms;
+    TEST_ASSERT_TRUE(sht31_power_init(&power, &sensor, &config));
+}
+
+void setUp(void)
+{
+    i2c_sim_init(&sim, I2C_SIM_400KHZ, &bus);
+    device = i2c_sim_add_sht31(&sim, DEFAULT_ADDRESS);
+    i2c_sim_set_environment(device, TEMPERATURE, HUMIDITY);
+    sht31_init(&sensor, &bus, DEFAULT_ADDRESS);
+
+    sht31_power_default_config(&config);
+    init_power(SHT31_POWER_SINGLE_SHOT, 1000);
+}
+
+void tearDown(void)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Configuration
+///////////////////////////////////////////////////////////////////////////////
+
+void test_default_config_is_valid(void)
+{
+    TEST_ASSERT_TRUE(sht31_power_config_valid(&config));
+}
+
+void test_periodic_period_must_be_a_sensor_rate(void)
+{
+    config.mode             = SHT31_POWER_PERIODIC;
+    config.sample_period_ms = 250;
+    TEST_ASSERT_TRUE(sht31_power_config_valid(&config));
+
+    config.sample_period_ms = 300;
+    TEST_ASSERT_FALSE(sht31_power_config_valid(&config));
+}
+
+void test_burst_must_fit_in_the_period(void)
+{
+    config.sample_period_ms = 50;
+    config.burst            = 3;
+    TEST_ASSERT_TRUE(sht31_power_config_valid(&config));
+
+    config.burst = 4;
+    TEST_ASSERT_FALSE(sht31_power_config_valid(&config));
+
+    config.burst = 0;
+    TEST_ASSERT_FALSE(sht31_power_config_valid(&config));
+}
+
+void test_latency_must_be_shorter_than_the_period(void)
+{
+    config.max_latency_ms = 1000;
+    TEST_ASSERT_FALSE(sht31_power_config_valid(&config));
+}
+
+void test_init_rejects_invalid_config(void)
+{
+    config.repeatability = 3;
+    TEST_ASSERT_FALSE(sht31_power_init(&power, &sensor, &config));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Energy estimates
+///////////////////////////////////////////////////////////////////////////////
+
+void test_single_shot_energy_per_sample(void)
+{
+    // 12.5 ms at 600 uA plus 987.5 ms at 0.2 uA, at 3.3 V.
+    TEST_ASSERT_EQUAL_UINT32(
+        25401, sht31_power_energy_per_sample_nj(NULL, &config));
+}
+
+void test_periodic_energy_per_sample(void)
+{
+    config.mode = SHT31_POWER_PERIODIC;
+
+    // 12.5 ms at 600 uA plus 987.5 ms at 45 uA, at 3.3 V.
+    TEST_ASSERT_EQUAL_UINT32(
+        171393, sht31_power_energy_per_sample_nj(NULL, &config));
+}
+
+void test_single_shot_is_cheaper_at_low_rates(void)
+{
+    uint32_t single_shot = sht31_power_energy_per_sample_nj(NULL, &config);
+
+    config.mode = SHT31_POWER_PERIODIC;
+    TEST_ASSERT_LESS_THAN_UINT32(
+        sht31_power_energy_per_sample_nj(NULL, &config) / 6, single_shot);
+}
+
+void test_burst_shares_the_idle_energy(void)
+{
+    uint32_t single = sht31_power_energy_per_sample_nj(NULL, &config);
+
+    config.burst = 4;
+    TEST_ASSERT_LESS_THAN_UINT32(
+        single, sht31_power_energy_per_sample_nj(NULL, &config));
+}
+
+void test_average_current_uses_the_model(void)
+{
+    sht31_power_model_t model;
+
+    sht31_power_default_model(&model);
+    model.measuring_na = 0;
+    model.idle_na      = 1000;
+
+    // 987.5 ms of the second at 1 uA.
+    TEST_ASSERT_EQUAL_UINT32(987,
+                             sht31_power_average_current_na(&model, &config));
+}
+
+void test_estimates_of_invalid_config_are_zero(void)
+{
+    config.burst = 0;
+
+    TEST_ASSERT_EQUAL_UINT32(0,
+                             sht31_power_energy_per_sample_nj(NULL, &config));
+    TEST_ASSERT_EQUAL_UINT32(0, sht31_power_average_current_na(NULL, &config));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Sampling
+///////////////////////////////////////////////////////////////////////////////
+
+void test_service_before_start_is_idle(void)
+{
+    TEST_ASSERT_EQUAL(SHT31_POLL_IDLE, sht31_power_service(&power, 0));
+    TEST_ASSERT_EQUAL_UINT32(0, sim.starts);
+}
+
+void test_periodic_fetches_once_a_period(void)
+{
+    init_power(SHT31_POWER_PERIODIC, 500);
+    TEST_ASSERT_TRUE(sht31_power_start(&power, now_ms()));
+    TEST_ASSERT_TRUE(device->periodic);
+
+    TEST_ASSERT_EQUAL_UINT32(10, run_until(5000));
+    TEST_ASSERT_EQUAL_UINT32(0, power.failures);
+    TEST_ASSERT_EQUAL_HEX16(HUMIDITY, sensor.humidity);
+}
+
+void test_single_shot_samples_once_a_period(void)
+{
+    TEST_ASSERT_TRUE(sht31_power_start(&power, now_ms()));
+
+    TEST_ASSERT_EQUAL_UINT32(5, run_until(5000));
+    TEST_ASSERT_EQUAL_UINT32(5, device->measurements);
+    TEST_ASSERT_FALSE(device->periodic);
+    TEST_ASSERT_EQUAL_HEX16(TEMPERATURE, sensor.temperature);
+}
+
+void test_single_shot_burst(void)
+{
+    config.burst = 3;
+    init_power(SHT31_POWER_SINGLE_SHOT, 1000);
+    sht31_power_start(&power, now_ms());
+
+    TEST_ASSERT_EQUAL_UINT32(3, run_until(100));
+    TEST_ASSERT_EQUAL_UINT32(0, run_until(1000));
+    TEST_ASSERT_EQUAL_UINT32(3, run_until(1100));
+    TEST_ASSERT_EQUAL_UINT32(6, power.samples);
+}
+
+void test_failed_fetch_is_counted_and_sampling_carries_on(void)
+{
+    sht31_power_start(&power, now_ms());
+    run_until(500);
+
+    device->nack_address = 1;
+    TEST_ASSERT_EQUAL_UINT32(0, run_until(1500));
+    TEST_ASSERT_EQUAL_UINT32(1, power.failures);
+
+    TEST_ASSERT_EQUAL_UINT32(1, run_until(2500));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Sleep
+///////////////////////////////////////////////////////////////////////////////
+
+void test_sleep_when_stopped_is_unbounded(void)
+{
+    TEST_ASSERT_EQUAL_UINT32(UINT32_MAX, sht31_power_sleep_ms(&power, 0));
+}
+
+void test_sleep_covers_measurement_then_period(void)
+{
+    sht31_power_start(&power, 0);
+    TEST_ASSERT_EQUAL_UINT32(0, sht31_power_sleep_ms(&power, 0));
+
+    sht31_power_service(&power, 0);
+
+    // Result ready at 17 ms, read within 10 ms, 1 ms to wake.
+    TEST_ASSERT_EQUAL_UINT32(26, sht31_power_sleep_ms(&power, 0));
+
+    i2c_sim_advance_ms(&sim, 20);
+    TEST_ASSERT_EQUAL(SHT31_POLL_DONE, sht31_power_service(&power, 20));
+    TEST_ASSERT_EQUAL_UINT32(1000 - 20 - 1, sht31_power_sleep_ms(&power, 20));
+}
+
+void test_sleep_in_periodic_mode_allows_latency(void)
+{
+    init_power(SHT31_POWER_PERIODIC, 1000);
+    sht31_power_start(&power, 0);
+
+    // First result fetched from 17 ms, within 10 ms.
+    TEST_ASSERT_EQUAL_UINT32(17 + 10 - 1, sht31_power_sleep_ms(&power, 0));
+}
+
+void test_sleep_driven_loop_keeps_period_and_latency(void)
+{
+    uint32_t wakes   = 0;
+    uint32_t samples = 0;
+    uint32_t sleep   = 0;
+    uint32_t woke_ms = 0;
+
+    sht31_power_start(&power, now_ms());
+
+    while (now_ms() < 10000)
+    {
+        woke_ms = now_ms();
+        if (SHT31_POLL_DONE == sht31_power_service(&power, woke_ms))
+        {
+            samples++;
+            TEST_ASSERT_TRUE(woke_ms <=
+                             sensor.ready_at_ms + config.max_latency_ms);
+        }
+        sleep = sht31_power_sleep_ms(&power, now_ms());
+        i2c_sim_advance_ms(&sim, sleep + config.wake_up_ms);
+        wakes++;
+    }
+
+    TEST_ASSERT_EQUAL_UINT32(10, samples);
+
+    // One wake to start each sample and one to read it.
+    TEST_ASSERT_EQUAL_UINT32(20, wakes);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Reconfigure and stop
+///////////////////////////////////////////////////////////////////////////////
+
+void test_reconfigure_from_periodic_to_single_shot(void)
+{
+    sht31_power_config_t single_shot = config;
+
+    init_power(SHT31_POWER_PERIODIC, 1000);
+    sht31_power_start(&power, now_ms());
+    run_until(1100);
+    TEST_ASSERT_TRUE(device->periodic);
+
+    TEST_ASSERT_TRUE(sht31_power_reconfigure(&power, &single_shot, now_ms()));
+    TEST_ASSERT_FALSE(device->periodic);
+    TEST_ASSERT_EQUAL(SHT31_POLL_BUSY, sht31_power_service(&power, now_ms()));
+
+    TEST_ASSERT_EQUAL_UINT32(2, run_until(3000));
+    TEST_ASSERT_FALSE(device->periodic);
+}
+
+void test_reconfigure_rejects_invalid_config(void)
+{
+    sht31_power_config_t bad = config;
+
+    bad.burst = 0;
+    sht31_power_start(&power, 0);
+
+    TEST_ASSERT_FALSE(sht31_power_reconfigure(&power, &bad, 0));
+    TEST_ASSERT_EQUAL_UINT8(1, power.config.burst);
+    TEST_ASSERT_TRUE(power.running);
+}
+
+void test_stop_sends_break(void)
+{
+    init_power(SHT31_POWER_PERIODIC, 1000);
+    sht31_power_start(&power, now_ms());
+
+    TEST_ASSERT_TRUE(sht31_power_stop(&power));
+    TEST_ASSERT_FALSE(device->periodic);
+    TEST_ASSERT_EQUAL(SHT31_POLL_IDLE, sht31_power_service(&power, now_ms()));
+}
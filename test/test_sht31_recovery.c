@@ -0,0 +1,274 @@
+/**
+ * @file        test_sht31_recovery.c
+ * @author      Steven Daglish
+ * @brief
+ * @version     0.1
+ * @date        17 October 2026
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+// Test list
+// ---------
+//
+// No retries when the first attempt works
+// NACKs and CRC failures retried with doubling backoff
+// Bus clear frees a stuck bus
+// Soft reset, restoring periodic mode
+// Giving up after max attempts
+// Never running past the time budget
+///////////////////////////////////////////////////////////////////////////////
+
+#include "unity.h"
+#include "sht31_recovery.h"
+#include "sht31_driver.h"
+#include "i2c_sim.h"
+#include "i2c_driver_sim.h"
+#include "crc8.h"
+#include "i2c_bus.h"
+
+static i2c_sim_t sim;
+static i2c_bus_t bus;
+static i2c_sim_device_t *device;
+static sht31_t sensor;
+static sht31_recovery_config_t config;
+static sht31_recovery_t recovery;
+
+static uint32_t sleeps;
+static uint32_t slept_us[8];
+
+static uint32_t sim_now_us(void *context)
+{
+    return (uint32_t)(i2c_sim_time_ns(context) / 1000u);
+}
+
+static void sim_sleep_us(void *context, uint32_t us)
+{
+    if (sleeps < 8)
+    {
+        slept_us[sleeps] = us;
+    }
+    sleeps++;
+    i2c_sim_advance_ns(context, (uint64_t)us * 1000u);
+}
+
+static const sht31_recovery_clock_t sim_clock = {
+    .context  = &sim,
+    .now_us   = sim_now_us,
+    .sleep_us = sim_sleep_us,
+};
+
+static void init_recovery(void)
+{
+    sht31_recovery_init(&recovery, &sensor, &config, &sim_clock);
+}
+
+void setUp(void)
+{
+    i2c_sim_init(&sim, I2C_SIM_400KHZ, &bus);
+    device = i2c_sim_add_sht31(&sim, DEFAULT_ADDRESS);
+    i2c_sim_set_environment(device, 0x1234, 0x5678);
+    sht31_init(&sensor, &bus, DEFAULT_ADDRESS);
+
+    sleeps = 0;
+    sht31_recovery_default_config(&config);
+    init_recovery();
+}
+
+void tearDown(void)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Retries
+///////////////////////////////////////////////////////////////////////////////
+
+void test_first_attempt_works_without_retries(void)
+{
+    TEST_ASSERT_TRUE(sht31_recovery_get_single_shot_data(&recovery, 2, true));
+
+    TEST_ASSERT_EQUAL_HEX16(0x1234, sht31_return_temperature(&sensor));
+    TEST_ASSERT_EQUAL_UINT32(1, recovery.calls);
+    TEST_ASSERT_EQUAL_UINT32(0, recovery.retries);
+    TEST_ASSERT_EQUAL_UINT32(0, recovery.recovered);
+    TEST_ASSERT_EQUAL_UINT32(0, sleeps);
+}
+
+void test_nacks_are_retried_with_doubling_backoff(void)
+{
+    config.clear_after = 0;
+    config.reset_after = 0;
+    init_recovery();
+    device->nack_address = 3;
+
+    TEST_ASSERT_TRUE(sht31_recovery_get_single_shot_data(&recovery, 2, true));
+
+    TEST_ASSERT_EQUAL_UINT32(3, recovery.retries);
+    TEST_ASSERT_EQUAL_UINT32(1, recovery.recovered);
+    TEST_ASSERT_EQUAL_UINT32(3, sleeps);
+    TEST_ASSERT_EQUAL_UINT32(500, slept_us[0]);
+    TEST_ASSERT_EQUAL_UINT32(1000, slept_us[1]);
+    TEST_ASSERT_EQUAL_UINT32(2000, slept_us[2]);
+    TEST_ASSERT_EQUAL_UINT32(3, sht31_stats(&sensor)->retries);
+}
+
+void test_backoff_stops_doubling_at_max(void)
+{
+    config.max_attempts   = 6;
+    config.backoff_max_us = 1500;
+    config.clear_after    = 0;
+    config.reset_after    = 0;
+    init_recovery();
+    device->nack_address = 5;
+
+    TEST_ASSERT_TRUE(sht31_recovery_get_single_shot_data(&recovery, 2, true));
+
+    TEST_ASSERT_EQUAL_UINT32(500, slept_us[0]);
+    TEST_ASSERT_EQUAL_UINT32(1000, slept_us[1]);
+    TEST_ASSERT_EQUAL_UINT32(1500, slept_us[2]);
+    TEST_ASSERT_EQUAL_UINT32(1500, slept_us[4]);
+}
+
+void test_crc_failure_is_retried(void)
+{
+    device->corrupt_crc = 1;
+
+    TEST_ASSERT_TRUE(sht31_recovery_get_single_shot_data(&recovery, 2, true));
+
+    TEST_ASSERT_EQUAL_HEX16(0x1234, sht31_return_temperature(&sensor));
+    TEST_ASSERT_EQUAL_UINT32(1, recovery.retries);
+    TEST_ASSERT_EQUAL_UINT16(1, sensor.errors.crc);
+}
+
+void test_gives_up_after_max_attempts(void)
+{
+    device->nack_address = 100;
+
+    TEST_ASSERT_FALSE(sht31_recovery_get_single_shot_data(&recovery, 2, true));
+
+    TEST_ASSERT_EQUAL_UINT32(3, recovery.retries);
+    TEST_ASSERT_EQUAL_UINT32(1, recovery.failed);
+    TEST_ASSERT_EQUAL_UINT32(0, recovery.over_budget);
+}
+
+void test_every_failed_attempt_ends_with_a_stop(void)
+{
+    config.clear_after = 0;
+    config.reset_after = 0;
+    init_recovery();
+    device->nack_address = 100;
+
+    sht31_recovery_get_single_shot_data(&recovery, 2, true);
+
+    TEST_ASSERT_EQUAL_UINT32(4, sim.starts);
+    TEST_ASSERT_EQUAL_UINT32(4, sim.stops);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Escalation
+///////////////////////////////////////////////////////////////////////////////
+
+void test_bus_clear_frees_a_stuck_bus(void)
+{
+    sim.sda_stuck = true;
+
+    TEST_ASSERT_TRUE(sht31_recovery_get_single_shot_data(&recovery, 2, true));
+
+    TEST_ASSERT_EQUAL_UINT32(1, recovery.bus_clears);
+    TEST_ASSERT_EQUAL_UINT32(1, sim.bus_clears);
+    TEST_ASSERT_EQUAL_UINT32(0, recovery.soft_resets);
+    TEST_ASSERT_EQUAL_UINT32(2, recovery.retries);
+}
+
+void test_bus_without_clear_skips_that_step(void)
+{
+    bus.bus_clear        = NULL;
+    device->nack_address = 3;
+
+    TEST_ASSERT_TRUE(sht31_recovery_get_single_shot_data(&recovery, 2, true));
+
+    TEST_ASSERT_EQUAL_UINT32(0, recovery.bus_clears);
+    TEST_ASSERT_EQUAL_UINT32(1, recovery.soft_resets);
+}
+
+void test_soft_reset_after_repeated_failures(void)
+{
+    // Three failed attempts, then the reset command gets through.
+    device->status_register = 0;
+    device->nack_address    = 3;
+
+    TEST_ASSERT_TRUE(sht31_recovery_get_single_shot_data(&recovery, 2, true));
+
+    TEST_ASSERT_EQUAL_UINT32(1, recovery.soft_resets);
+    // Reset detected flag set again by the reset.
+    TEST_ASSERT_EQUAL_HEX16(0x0010, device->status_register & 0x0010);
+}
+
+void test_soft_reset_restores_periodic_mode(void)
+{
+    TEST_ASSERT_TRUE(sht31_recovery_start_periodic(&recovery, 2, 4));
+    i2c_sim_advance_ms(&sim, 20);
+
+    // Fetches keep failing; the reset stops periodic mode and the layer
+    // starts it again.
+    device->nack_address = 3;
+    sht31_recovery_fetch_periodic_data(&recovery);
+
+    TEST_ASSERT_EQUAL_UINT32(1, recovery.soft_resets);
+    TEST_ASSERT_TRUE(device->periodic);
+    TEST_ASSERT_EQUAL_UINT64(100000000ull, device->period_ns);
+}
+
+void test_stop_forgets_periodic_mode(void)
+{
+    sht31_recovery_start_periodic(&recovery, 2, 4);
+    TEST_ASSERT_TRUE(sht31_recovery_stop_periodic(&recovery));
+
+    device->nack_address = 3;
+    sht31_recovery_get_single_shot_data(&recovery, 2, true);
+
+    TEST_ASSERT_EQUAL_UINT32(1, recovery.soft_resets);
+    TEST_ASSERT_FALSE(device->periodic);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Budget
+///////////////////////////////////////////////////////////////////////////////
+
+void test_budget_is_never_exceeded(void)
+{
+    uint32_t budget_us = 0;
+
+    for (budget_us = 1000; budget_us <= 60000; budget_us += 700)
+    {
+        uint32_t started_us = sim_now_us(&sim);
+
+        config.max_attempts = 50;
+        config.budget_us    = budget_us;
+        init_recovery();
+        device->nack_address = 1000;
+
+        TEST_ASSERT_FALSE(
+            sht31_recovery_get_single_shot_data(&recovery, 2, true));
+        TEST_ASSERT_LESS_OR_EQUAL_UINT32(budget_us,
+                                         sim_now_us(&sim) - started_us);
+        TEST_ASSERT_EQUAL_UINT32(1, recovery.over_budget);
+    }
+}
+
+void test_budget_covers_slow_clock_stretched_attempts(void)
+{
+    uint32_t started_us = 0;
+
+    // Each attempt stretches for the whole conversion, then fails its CRC.
+    config.max_attempts = 50;
+    config.budget_us    = 40000;
+    init_recovery();
+    device->corrupt_crc = 1000;
+    started_us          = sim_now_us(&sim);
+
+    TEST_ASSERT_FALSE(sht31_recovery_get_single_shot_data(&recovery, 2, true));
+
+    TEST_ASSERT_LESS_OR_EQUAL_UINT32(40000, sim_now_us(&sim) - started_us);
+    TEST_ASSERT_EQUAL_UINT32(1, recovery.over_budget);
+}
@@ -0,0 +1,159 @@
+/**
+ * @file        test_sht31_ring_buffer.c
+ * @author      Steven Daglish
+ * @brief
+ * @version     0.1
+ * @date        17 October 2026
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+// Test list
+// ---------
+//
+// Initialising with good and bad capacities
+// Push and pop in order
+// Full buffer drops and counts
+// Batches smaller and larger than the fill
+// Index wrap around
+///////////////////////////////////////////////////////////////////////////////
+
+#include "unity.h"
+#include "sht31_ring_buffer.h"
+
+#define CAPACITY 8
+
+static sht31_reading_t storage[CAPACITY];
+static sht31_ring_buffer_t ring;
+
+static sht31_reading_t make_reading(uint32_t n)
+{
+    sht31_reading_t reading = {
+        .timestamp_ms = n * 100,
+        .temperature  = (uint16_t)n,
+        .humidity     = (uint16_t)(n ^ 0xFFFF),
+    };
+    return reading;
+}
+
+static void push_readings(uint32_t first, uint32_t count)
+{
+    uint32_t n = 0;
+
+    for (n = first; n < first + count; n++)
+    {
+        sht31_reading_t reading = make_reading(n);
+        TEST_ASSERT(sht31_ring_buffer_push(&ring, &reading));
+    }
+}
+
+static void assert_reading(uint32_t n, const sht31_reading_t *reading)
+{
+    TEST_ASSERT_EQUAL_UINT32(n * 100, reading->timestamp_ms);
+    TEST_ASSERT_EQUAL_HEX16((uint16_t)n, reading->temperature);
+    TEST_ASSERT_EQUAL_HEX16((uint16_t)(n ^ 0xFFFF), reading->humidity);
+}
+
+void setUp(void)
+{
+    TEST_ASSERT(sht31_ring_buffer_init(&ring, storage, CAPACITY));
+}
+
+void tearDown(void)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Initialising
+///////////////////////////////////////////////////////////////////////////////
+
+void test_init_starts_empty(void)
+{
+    TEST_ASSERT_EQUAL_UINT16(0, sht31_ring_buffer_count(&ring));
+    TEST_ASSERT_EQUAL_UINT16(0, sht31_ring_buffer_dropped(&ring));
+}
+
+void test_init_rejects_capacity_that_is_not_power_of_two(void)
+{
+    sht31_ring_buffer_t other;
+
+    TEST_ASSERT_FALSE(sht31_ring_buffer_init(&other, storage, 0));
+    TEST_ASSERT_FALSE(sht31_ring_buffer_init(&other, storage, 6));
+    TEST_ASSERT_FALSE(sht31_ring_buffer_init(&other, storage, 65535));
+    TEST_ASSERT(sht31_ring_buffer_init(&other, storage, 1));
+    TEST_ASSERT(sht31_ring_buffer_init(&other, storage, 32768));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Pushing and popping
+///////////////////////////////////////////////////////////////////////////////
+
+void test_readings_come_out_in_order(void)
+{
+    sht31_reading_t out[CAPACITY];
+    uint16_t i = 0;
+
+    push_readings(0, 5);
+    TEST_ASSERT_EQUAL_UINT16(5, sht31_ring_buffer_count(&ring));
+
+    TEST_ASSERT_EQUAL_UINT16(5, sht31_ring_buffer_pop_batch(&ring, out, 8));
+    for (i = 0; i < 5; i++)
+    {
+        assert_reading(i, &out[i]);
+    }
+    TEST_ASSERT_EQUAL_UINT16(0, sht31_ring_buffer_count(&ring));
+}
+
+void test_pop_from_empty_returns_nothing(void)
+{
+    sht31_reading_t out[1];
+
+    TEST_ASSERT_EQUAL_UINT16(0, sht31_ring_buffer_pop_batch(&ring, out, 1));
+}
+
+void test_full_buffer_drops_and_counts(void)
+{
+    sht31_reading_t extra = make_reading(99);
+    sht31_reading_t out[CAPACITY];
+
+    push_readings(0, CAPACITY);
+
+    TEST_ASSERT_FALSE(sht31_ring_buffer_push(&ring, &extra));
+    TEST_ASSERT_FALSE(sht31_ring_buffer_push(&ring, &extra));
+    TEST_ASSERT_EQUAL_UINT16(2, sht31_ring_buffer_dropped(&ring));
+
+    TEST_ASSERT_EQUAL_UINT16(CAPACITY,
+                             sht31_ring_buffer_pop_batch(&ring, out, CAPACITY));
+    assert_reading(CAPACITY - 1, &out[CAPACITY - 1]);
+}
+
+void test_batch_smaller_than_fill_leaves_the_rest(void)
+{
+    sht31_reading_t out[3];
+
+    push_readings(0, 6);
+
+    TEST_ASSERT_EQUAL_UINT16(3, sht31_ring_buffer_pop_batch(&ring, out, 3));
+    assert_reading(0, &out[0]);
+    assert_reading(2, &out[2]);
+
+    TEST_ASSERT_EQUAL_UINT16(3, sht31_ring_buffer_pop_batch(&ring, out, 3));
+    assert_reading(3, &out[0]);
+    assert_reading(5, &out[2]);
+}
+
+void test_readings_survive_index_wrap_around(void)
+{
+    sht31_reading_t out[CAPACITY];
+    uint32_t n = 0;
+
+    // Enough traffic for the 16 bit indexes to wrap several times.
+    for (n = 0; n < 200000; n += 5)
+    {
+        push_readings(n, 5);
+        TEST_ASSERT_EQUAL_UINT16(5, sht31_ring_buffer_pop_batch(&ring, out, 8));
+        assert_reading(n, &out[0]);
+        assert_reading(n + 4, &out[4]);
+    }
+    TEST_ASSERT_EQUAL_UINT16(0, sht31_ring_buffer_dropped(&ring));
+}
@@ -0,0 +1,239 @@
+/**
+ * @file        test_sht31_scheduler.c
+ * @author      Steven Daglish
+ * @brief
+ * @version     0.1
+ * @date        17 October 2026
+ *
+ */
+
+///////////////////////////////////////////////////////////////////////////////
+// Test list
+// ---------
+//
+// Starting conversions on every sensor back to back
+// Collecting results in order once the conversion time has passed
+// Failed sensors reported in turn
+// Cycle period
+// Aggregate sample rate against one sensor at a time
+///////////////////////////////////////////////////////////////////////////////
+
+#include "unity.h"
+#include "sht31_scheduler.h"
+#include "sht31_driver.h"
+#include "i2c_sim.h"
+#include "i2c_driver_sim.h"
+#include "crc8.h"
+#include "i2c_bus.h"
+
+#define SENSOR_COUNT 4
+
+static i2c_sim_t sim;
+static i2c_bus_t bus;
+static i2c_sim_device_t *devices[SENSOR_COUNT];
+static sht31_t sensors[SENSOR_COUNT];
+static sht31_scheduler_t scheduler;
+
+static uint8_t results;
+static uint8_t result_index[2 * SENSOR_COUNT];
+static bool result_success[2 * SENSOR_COUNT];
+static uint16_t result_temperature[2 * SENSOR_COUNT];
+
+static void record_result(void *context, uint8_t index, const sht31_t *sensor,
+                          bool success)
+{
+    (void)context;
+
+    if (results < 2 * SENSOR_COUNT)
+    {
+        result_index[results]       = index;
+        result_success[results]     = success;
+        result_temperature[results] = sht31_return_temperature(sensor);
+    }
+    results++;
+}
+
+// Moves simulated time on to now_ms (unless bus traffic has already taken it
+// past) and services the scheduler.
+static uint8_t service_at(uint32_t now_ms)
+{
+    uint64_t now_ns = (uint64_t)now_ms * 1000000u;
+
+    if (now_ns > i2c_sim_time_ns(&sim))
+    {
+        i2c_sim_advance_ns(&sim, now_ns - i2c_sim_time_ns(&sim));
+    }
+    return sht31_scheduler_service(&scheduler, now_ms);
+}
+
+void setUp(void)
+{
+    uint8_t i = 0;
+
+    i2c_sim_init(&sim, I2C_SIM_400KHZ, &bus);
+
+    // The model takes any address, standing in for sensors behind a mux.
+    for (i = 0; i < SENSOR_COUNT; i++)
+    {
+        devices[i] = i2c_sim_add_sht31(&sim, DEFAULT_ADDRESS + i);
+        i2c_sim_set_environment(devices[i], 0x1000 * (i + 1), 0x8000);
+        sht31_init(&sensors[i], &bus, DEFAULT_ADDRESS + i);
+    }
+
+    results = 0;
+    sht31_scheduler_init(&scheduler, sensors, SENSOR_COUNT, 2, 0,
+                         record_result, NULL);
+}
+
+void tearDown(void)
+{
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// One cycle
+///////////////////////////////////////////////////////////////////////////////
+
+void test_first_service_starts_every_sensor(void)
+{
+    uint8_t i = 0;
+
+    TEST_ASSERT_EQUAL_UINT8(0, service_at(0));
+
+    for (i = 0; i < SENSOR_COUNT; i++)
+    {
+        TEST_ASSERT(devices[i]->converting);
+        TEST_ASSERT_EQUAL_UINT32(1, devices[i]->commands);
+    }
+    TEST_ASSERT_EQUAL_UINT32(SENSOR_COUNT, sim.stops);
+}
+
+void test_nothing_sent_until_conversion_time_passed(void)
+{
+    service_at(0);
+    uint32_t stops = sim.stops;
+
+    TEST_ASSERT_EQUAL_UINT8(0, service_at(SHT_DURATION_HIGH_MS));
+    TEST_ASSERT_EQUAL_UINT32(stops, sim.stops);
+    TEST_ASSERT_EQUAL_UINT8(0, results);
+}
+
+void test_results_collected_in_order(void)
+{
+    uint8_t i = 0;
+
+    service_at(0);
+
+    TEST_ASSERT_EQUAL_UINT8(SENSOR_COUNT,
+                            service_at(sht31_result_ready_ms(
+                                SHT_REPEATABILITY_HIGH, 0)));
+
+    TEST_ASSERT_EQUAL_UINT8(SENSOR_COUNT, results);
+    for (i = 0; i < SENSOR_COUNT; i++)
+    {
+        TEST_ASSERT_EQUAL_UINT8(i, result_index[i]);
+        TEST_ASSERT(result_success[i]);
+        TEST_ASSERT_EQUAL_HEX16(0x1000 * (i + 1), result_temperature[i]);
+    }
+    TEST_ASSERT_EQUAL_UINT32(1, sht31_scheduler_cycles(&scheduler));
+    TEST_ASSERT_EQUAL_UINT32(0, sim.nacks);
+}
+
+void test_low_repeatability_collects_sooner(void)
+{
+    sht31_scheduler_init(&scheduler, sensors, SENSOR_COUNT, 0, 0,
+                         record_result, NULL);
+    service_at(0);
+
+    TEST_ASSERT_EQUAL_UINT8(SENSOR_COUNT,
+                            service_at(sht31_result_ready_ms(
+                                SHT_REPEATABILITY_LOW, 0)));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Failures
+///////////////////////////////////////////////////////////////////////////////
+
+void test_sensor_that_nacks_start_is_reported_failed_in_turn(void)
+{
+    devices[1]->nack_address = 1;
+
+    service_at(0);
+    service_at(20);
+
+    TEST_ASSERT_EQUAL_UINT8(SENSOR_COUNT, results);
+    TEST_ASSERT(result_success[0]);
+    TEST_ASSERT_EQUAL_UINT8(1, result_index[1]);
+    TEST_ASSERT_FALSE(result_success[1]);
+    TEST_ASSERT(result_success[2]);
+    TEST_ASSERT(result_success[3]);
+}
+
+void test_crc_failure_is_reported_failed(void)
+{
+    devices[2]->corrupt_crc = 1;
+
+    service_at(0);
+    service_at(20);
+
+    TEST_ASSERT(result_success[1]);
+    TEST_ASSERT_FALSE(result_success[2]);
+    TEST_ASSERT(result_success[3]);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// Cycles
+///////////////////////////////////////////////////////////////////////////////
+
+void test_next_cycle_waits_for_period(void)
+{
+    sht31_scheduler_init(&scheduler, sensors, SENSOR_COUNT, 2, 100,
+                         record_result, NULL);
+    service_at(0);
+    service_at(20);
+    uint32_t commands = devices[0]->commands;
+
+    service_at(99);
+    TEST_ASSERT_EQUAL_UINT32(commands, devices[0]->commands);
+
+    service_at(100);
+    TEST_ASSERT_EQUAL_UINT32(commands + 1, devices[0]->commands);
+}
+
+void test_back_to_back_cycles_restart_immediately(void)
+{
+    service_at(0);
+    service_at(20);
+    uint32_t commands = devices[0]->commands;
+
+    service_at(20);
+    TEST_ASSERT_EQUAL_UINT32(commands + 1, devices[0]->commands);
+}
+
+void test_pipelined_rate_beats_one_sensor_at_a_time(void)
+{
+    uint32_t now_ms     = 0;
+    uint32_t sequential = 0;
+    uint8_t i           = 0;
+
+    // One second serviced every millisecond.
+    for (now_ms = 0; now_ms < 1000; now_ms++)
+    {
+        service_at(now_ms);
+    }
+    uint32_t pipelined = results;
+
+    // The same second reading each sensor in turn with clock stretching.
+    i2c_sim_init(&sim, I2C_SIM_400KHZ, &bus);
+    for (i = 0; i < SENSOR_COUNT; i++)
+    {
+        i2c_sim_add_sht31(&sim, DEFAULT_ADDRESS + i);
+    }
+    while (i2c_sim_time_ms(&sim) < 1000)
+    {
+        TEST_ASSERT(sht31_get_single_shot_data(
+            &sensors[sequential % SENSOR_COUNT]));
+        sequential++;
+    }
+
+    TEST_ASSERT(pipelined >= 3 * sequential);
+}